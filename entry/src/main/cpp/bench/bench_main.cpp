@@ -0,0 +1,453 @@
+// higit_bench：在工作站上对 RepoManager 做基准测试
+// 先按参数生成合成仓库（或使用 --source 指定的仓库），再逐项计时：
+// 提交历史分页、文件树、读取文件、引用列表，以及通过 file:// 和本地路径两种本地传输 fetch
+
+#include "global.h"
+#include "metrics.h"
+#include "repo_manager.h"
+#include "synthetic_repo.h"
+#include "utils/log.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct BenchOptions {
+    SyntheticRepoOptions repo;    ///< 合成仓库规模
+    std::string source;           ///< 已有仓库路径，非空时不生成
+    std::string workdir;          ///< 工作目录，为空时在临时目录下创建
+    std::string filter;           ///< 只运行名称包含该字符串的用例
+    int iterations = 10;          ///< 每个用例计时的次数
+    int warmup = 1;               ///< 每个用例不计时的预热次数
+    int pageSize = 50;            ///< 历史分页大小
+    int pages = 20;               ///< 分页用例翻页数上限
+    size_t readFiles = 64;        ///< 读取文件用例每次读取的文件数
+    bool keep = false;            ///< 结束后保留工作目录
+    bool json = false;            ///< 以 JSON 输出结果
+    bool metrics = false;         ///< 结束后输出 Metrics 汇总
+};
+
+/**
+ * @brief 一个基准用例
+ * setup 不计时，用于准备全新的 RepoManager 等状态；run 计时，返回处理的条目数，失败时抛出异常
+ */
+struct BenchCase {
+    std::string name;
+    std::function<void()> setup;
+    std::function<size_t()> run;
+};
+
+struct BenchResult {
+    std::string name;
+    std::vector<double> samples; ///< 每次耗时（毫秒）
+    size_t items = 0;            ///< 最后一次处理的条目数
+    std::string error;           ///< 失败原因
+};
+
+void PrintUsage() {
+    printf("Usage: higit_bench [options]\n"
+           "Synthetic repository:\n%s"
+           "Benchmark:\n"
+           "  --source PATH        benchmark an existing repository instead of generating one\n"
+           "  --workdir PATH       working directory (default: a new directory under the system temp dir)\n"
+           "  --filter TEXT        only run cases whose name contains TEXT\n"
+           "  --iterations N       timed iterations per case (default 10)\n"
+           "  --warmup N           untimed iterations per case (default 1)\n"
+           "  --page-size N        history page size (default 50)\n"
+           "  --pages N            pages walked by the pagination case (default 20)\n"
+           "  --read-files N       files read per readFile iteration (default 64)\n"
+           "  --keep               keep the working directory\n"
+           "  --json               print results as JSON\n"
+           "  --metrics            print the Metrics summary after the run\n"
+           "  --verbose            print info logs from the core library\n",
+           SyntheticRepo::OptionsUsage());
+}
+
+bool ParseArguments(int argc, char **argv, BenchOptions &options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> const char * {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        auto number = [&]() -> unsigned long long { return std::stoull(value()); };
+
+        if (arg == "--shape") {
+            std::string shape = value();
+            if (!SyntheticRepo::ApplyShape(shape, options.repo)) {
+                throw std::invalid_argument("unknown shape " + shape);
+            }
+        } else if (arg == "--source") {
+            options.source = value();
+        } else if (arg == "--workdir") {
+            options.workdir = value();
+        } else if (arg == "--filter") {
+            options.filter = value();
+        } else if (arg == "--iterations") {
+            options.iterations = std::max(1, static_cast<int>(number()));
+        } else if (arg == "--warmup") {
+            options.warmup = static_cast<int>(number());
+        } else if (arg == "--page-size") {
+            options.pageSize = std::max(1, static_cast<int>(number()));
+        } else if (arg == "--pages") {
+            options.pages = std::max(1, static_cast<int>(number()));
+        } else if (arg == "--read-files") {
+            options.readFiles = std::max<size_t>(1, number());
+        } else if (arg == "--keep") {
+            options.keep = true;
+        } else if (arg == "--json") {
+            options.json = true;
+        } else if (arg == "--metrics") {
+            options.metrics = true;
+        } else if (arg == "--verbose") {
+            Log::SetMinLevel(Log::Debug);
+        } else if (arg == "--help" || arg == "-h") {
+            PrintUsage();
+            return false;
+        } else if (i + 1 >= argc || !SyntheticRepo::ApplyOption(arg, std::stoull(argv[i + 1]), options.repo)) {
+            throw std::invalid_argument("unknown option " + arg);
+        } else {
+            ++i;
+        }
+    }
+    return true;
+}
+
+// 全新打开仓库，不共享任何结果缓存
+std::unique_ptr<RepoManager> OpenFresh(const std::string &path) {
+    auto manager = std::make_unique<RepoManager>();
+    if (!manager->openRepository(path)) {
+        throw std::runtime_error("open " + path + ": " + manager->getLastError());
+    }
+    return manager;
+}
+
+// 打开（不存在时创建）本地裸仓库并把 origin 指向 url
+std::unique_ptr<RepoManager> OpenMirror(const std::string &url, const std::string &path) {
+    auto manager = std::make_unique<RepoManager>();
+    if (!manager->openLocal(url, path)) {
+        throw std::runtime_error("open " + path + ": " + manager->getLastError());
+    }
+    return manager;
+}
+
+size_t Require(size_t items, const RepoManager &manager, const char *operation) {
+    if (items == 0) {
+        throw std::runtime_error(std::string(operation) + ": " + manager.getLastError());
+    }
+    return items;
+}
+
+double Percentile(std::vector<double> sorted, double p) {
+    std::sort(sorted.begin(), sorted.end());
+    size_t rank = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+BenchResult RunCase(const BenchCase &bench, const BenchOptions &options) {
+    BenchResult result;
+    result.name = bench.name;
+    try {
+        for (int i = 0; i < options.warmup + options.iterations; ++i) {
+            bench.setup();
+            auto start = std::chrono::steady_clock::now();
+            result.items = bench.run();
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            if (i >= options.warmup) {
+                result.samples.push_back(std::chrono::duration<double, std::milli>(elapsed).count());
+            }
+        }
+    } catch (const std::exception &e) {
+        result.error = e.what();
+    }
+    return result;
+}
+
+void PrintTable(const std::vector<BenchResult> &results) {
+    printf("%-28s %8s %10s %10s %10s %10s %10s\n", "case", "items", "mean(ms)", "p50(ms)", "p90(ms)", "min(ms)",
+           "max(ms)");
+    for (const auto &result : results) {
+        if (!result.error.empty()) {
+            printf("%-28s FAILED: %s\n", result.name.c_str(), result.error.c_str());
+            continue;
+        }
+        double sum = 0;
+        for (double sample : result.samples) {
+            sum += sample;
+        }
+        printf("%-28s %8zu %10.3f %10.3f %10.3f %10.3f %10.3f\n", result.name.c_str(), result.items,
+               sum / result.samples.size(), Percentile(result.samples, 0.5), Percentile(result.samples, 0.9),
+               *std::min_element(result.samples.begin(), result.samples.end()),
+               *std::max_element(result.samples.begin(), result.samples.end()));
+    }
+}
+
+void PrintJson(const std::vector<BenchResult> &results, const BenchOptions &options) {
+    nlohmann::json output = {
+        {"repo",
+         {{"source", options.source},
+          {"commits", options.repo.commits},
+          {"files", options.repo.files},
+          {"fileBytes", options.repo.fileBytes},
+          {"topics", options.repo.topics},
+          {"mergeEvery", options.repo.mergeEvery},
+          {"largeFiles", options.repo.largeFiles},
+          {"largeFileBytes", options.repo.largeFileBytes},
+          {"branches", options.repo.branches},
+          {"tags", options.repo.tags},
+          {"seed", options.repo.seed}}},
+        {"cases", nlohmann::json::array()},
+    };
+    for (const auto &result : results) {
+        nlohmann::json entry = {{"name", result.name}};
+        if (!result.error.empty()) {
+            entry["error"] = result.error;
+        } else {
+            entry["items"] = result.items;
+            entry["samplesMs"] = result.samples;
+            entry["p50Ms"] = Percentile(result.samples, 0.5);
+            entry["p90Ms"] = Percentile(result.samples, 0.9);
+        }
+        output["cases"].push_back(std::move(entry));
+    }
+    if (options.metrics) {
+        output["metrics"] = nlohmann::json::parse(Metrics::Shared().exportJson());
+    }
+    printf("%s\n", output.dump(2).c_str());
+}
+
+std::vector<BenchCase> BuildCases(const std::string &source, const std::string &workdir, const BenchOptions &options) {
+    // 各用例共享的状态，由 setup 重置
+    struct State {
+        std::unique_ptr<RepoManager> manager;
+        std::vector<std::string> paths; ///< 读取文件用例的路径
+        std::string mirror;             ///< fetch 的目标仓库
+        size_t fetches = 0;             ///< 用于生成不重复的目标路径
+    };
+    auto state = std::make_shared<State>();
+    std::string fileUrl = "file://" + source;
+
+    auto fresh = [state, source]() { state->manager = OpenFresh(source); };
+    // 只在第一次打开，之后复用同一个实例及其缓存
+    auto warm = [state, source]() {
+        if (!state->manager || state->manager->getRepositoryPath() != source) {
+            state->manager = OpenFresh(source);
+        }
+    };
+    // 每次 fetch 到新的空仓库，传输全部对象
+    auto emptyMirror = [state, workdir](const std::string &url) {
+        return [state, workdir, url]() {
+            state->manager.reset();
+            if (!state->mirror.empty()) {
+                std::error_code ec;
+                std::filesystem::remove_all(state->mirror, ec);
+            }
+            state->mirror = workdir + "/mirror-" + std::to_string(state->fetches++);
+            state->manager = OpenMirror(url, state->mirror);
+        };
+    };
+    // 返回收到的对象数
+    auto fetchObjects = [state]() -> size_t {
+        size_t received = 0;
+        auto progress = [&received](unsigned int objects, unsigned int) { received = objects; };
+        if (!state->manager->fetch("origin", {}, 0, progress)) {
+            throw std::runtime_error("fetch: " + state->manager->getLastError());
+        }
+        return received;
+    };
+    auto fetchAll = [state, fetchObjects]() -> size_t { return Require(fetchObjects(), *state->manager, "fetch"); };
+
+    std::vector<BenchCase> cases;
+    auto firstPage = [state, &options]() -> size_t {
+        std::vector<CommitInfo> commits;
+        state->manager->getCommitHistory(commits, "HEAD", options.pageSize, 0);
+        return Require(commits.size(), *state->manager, "getCommitHistory");
+    };
+    cases.push_back({"history/first-page", fresh, firstPage});
+    cases.push_back({"history/first-page-warm", warm, firstPage});
+    cases.push_back({"history/paginate", fresh, [state, &options]() -> size_t {
+                         size_t total = 0;
+                         for (int page = 0; page < options.pages; ++page) {
+                             std::vector<CommitInfo> commits;
+                             if (!state->manager->getCommitHistory(commits, "HEAD", options.pageSize,
+                                                                   page * options.pageSize)) {
+                                 break;
+                             }
+                             total += commits.size();
+                             if (commits.size() < static_cast<size_t>(options.pageSize)) {
+                                 break;
+                             }
+                         }
+                         return Require(total, *state->manager, "getCommitHistory");
+                     }});
+    cases.push_back({"fileTree/compact", fresh, [state]() -> size_t {
+                         auto tree = state->manager->getCompactFileTree("HEAD");
+                         return Require(tree ? tree->size() : 0, *state->manager, "getCompactFileTree");
+                     }});
+    cases.push_back({"fileTree/compact-warm", warm, [state]() -> size_t {
+                         auto tree = state->manager->getCompactFileTree("HEAD");
+                         return Require(tree ? tree->size() : 0, *state->manager, "getCompactFileTree");
+                     }});
+    cases.push_back({"fileTree/nodes", fresh, [state]() -> size_t {
+                         return Require(state->manager->getBranchFileTree("HEAD").size(), *state->manager,
+                                        "getBranchFileTree");
+                     }});
+    cases.push_back({"readFile",
+                     [state, source, &options]() {
+                         state->manager = OpenFresh(source);
+                         if (!state->paths.empty()) {
+                             return;
+                         }
+                         // 从文件树中均匀挑选
+                         auto tree = state->manager->getCompactFileTree("HEAD");
+                         std::vector<std::string> files;
+                         for (uint32_t i = 0; tree && i < tree->size(); ++i) {
+                             if (!tree->isDirectory(i)) {
+                                 files.push_back(tree->path(i));
+                             }
+                         }
+                         size_t step = std::max<size_t>(1, files.size() / options.readFiles);
+                         for (size_t i = 0; i < files.size() && state->paths.size() < options.readFiles; i += step) {
+                             state->paths.push_back(files[i]);
+                         }
+                         state->manager = OpenFresh(source);
+                     },
+                     [state]() -> size_t {
+                         size_t bytes = 0;
+                         for (const auto &path : state->paths) {
+                             FileContent content = state->manager->readFile("HEAD", path);
+                             if (!content.exists) {
+                                 throw std::runtime_error("readFile " + path + ": " + state->manager->getLastError());
+                             }
+                             bytes += content.content.size();
+                         }
+                         return Require(bytes, *state->manager, "readFile");
+                     }});
+    cases.push_back({"refs/local-branches", fresh, [state]() -> size_t {
+                         return Require(state->manager->getLocalBranches().size(), *state->manager,
+                                        "getLocalBranches");
+                     }});
+    // ls-remote 不需要本地对象，目标仓库只创建一次
+    for (const auto &[name, url] : {std::pair<std::string, std::string>{"file", fileUrl}, {"local", source}}) {
+        std::string mirror = workdir + "/refs-" + name;
+        cases.push_back({"refs/ls-remote-" + name,
+                         [state, url, mirror]() {
+                             if (!state->manager || state->manager->getRepositoryPath() != mirror) {
+                                 state->manager = OpenMirror(url, mirror);
+                             }
+                         },
+                         [state]() -> size_t {
+                             std::vector<BranchInfo> branches;
+                             std::vector<TagInfo> tags;
+                             if (!state->manager->getRemoteBranches(branches) ||
+                                 !state->manager->getRemoteTags(tags)) {
+                                 return Require(0, *state->manager, "ls-remote");
+                             }
+                             return branches.size() + tags.size();
+                         }});
+    }
+    cases.push_back({"fetch/file-full", emptyMirror(fileUrl), fetchAll});
+    cases.push_back({"fetch/local-full", emptyMirror(source), fetchAll});
+    // 已是最新时只有协商
+    cases.push_back({"fetch/file-up-to-date",
+                     [state, fileUrl, workdir, fetchObjects]() {
+                         std::string mirror = workdir + "/mirror-up-to-date";
+                         if (!state->manager || state->manager->getRepositoryPath() != mirror) {
+                             state->manager = OpenMirror(fileUrl, mirror);
+                             fetchObjects();
+                         }
+                     },
+                     fetchObjects});
+
+    std::vector<BenchCase> selected;
+    for (auto &bench : cases) {
+        if (options.filter.empty() || bench.name.find(options.filter) != std::string::npos) {
+            selected.push_back(std::move(bench));
+        }
+    }
+    return selected;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    BenchOptions options;
+    Log::SetMinLevel(Log::Warn);
+    try {
+        if (!ParseArguments(argc, argv, options)) {
+            return 0;
+        }
+    } catch (const std::exception &e) {
+        fprintf(stderr, "%s\n", e.what());
+        PrintUsage();
+        return 2;
+    }
+
+    namespace fs = std::filesystem;
+    bool ownWorkdir = options.workdir.empty();
+    if (ownWorkdir) {
+        std::string pattern = (fs::temp_directory_path() / "higit-bench-XXXXXX").string();
+        if (mkdtemp(pattern.data()) == nullptr) {
+            perror("mkdtemp");
+            return 1;
+        }
+        options.workdir = pattern;
+    } else {
+        fs::create_directories(options.workdir);
+    }
+    options.workdir = fs::absolute(options.workdir).string();
+    // 凭据提供者在该目录下查找 SSH 密钥，本地传输用不到
+    Globals::files_directory = options.workdir;
+
+    std::string source = options.source;
+    if (source.empty()) {
+        source = options.workdir + "/source.git";
+        auto start = std::chrono::steady_clock::now();
+        std::string error;
+        if (!fs::exists(source) && !SyntheticRepo::Generate(source, options.repo, error)) {
+            fprintf(stderr, "generate repository: %s\n", error.c_str());
+            return 1;
+        }
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        fprintf(stderr, "source: %s (%zu commits, %zu files, %.1fs)\n", source.c_str(), options.repo.commits,
+                options.repo.files, elapsed);
+    } else {
+        source = fs::absolute(source).string();
+    }
+
+    std::vector<BenchResult> results;
+    for (const auto &bench : BuildCases(source, options.workdir, options)) {
+        fprintf(stderr, "running %s\n", bench.name.c_str());
+        results.push_back(RunCase(bench, options));
+    }
+
+    if (options.json) {
+        PrintJson(results, options);
+    } else {
+        PrintTable(results);
+        if (options.metrics) {
+            printf("%s\n", Metrics::Shared().exportJson().c_str());
+        }
+    }
+
+    if (!options.keep && ownWorkdir) {
+        std::error_code ec;
+        fs::remove_all(options.workdir, ec);
+    } else {
+        fprintf(stderr, "workdir kept: %s\n", options.workdir.c_str());
+    }
+    bool failed = std::any_of(results.begin(), results.end(), [](const BenchResult &r) { return !r.error.empty(); });
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,547 @@
+#include "synthetic_repo.h"
+#include <algorithm>
+#include <cstdio>
+#include <git2.h>
+#include <git2/sys/mempack.h>
+#include <iterator>
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+constexpr size_t LINE_BYTES = 49;                   // 每行固定长度
+constexpr int64_t BASE_TIME = 1700000000;           // 第一个提交的时间
+constexpr int64_t COMMIT_INTERVAL = 3600;           // 相邻提交的时间间隔（秒）
+constexpr size_t FLUSH_BYTES = 256 * 1024 * 1024;   // 内存中的对象超过该大小时写出 pack
+constexpr size_t FLUSH_OBJECTS = 1000000;           // 内存中的对象超过该数量时写出 pack
+constexpr size_t STREAM_CHUNK = 1024 * 1024;        // 大文件每次写入的大小
+constexpr const char *EXTENSIONS[] = {".txt", ".cpp", ".h", ".md", ".json", ".ts"};
+constexpr const char *AUTHORS[] = {"Alice", "Bob", "Carol", "Dave", "Erin", "Frank", "Grace", "Heidi"};
+
+// 由种子和若干序号推导出的伪随机数，与调用顺序无关
+uint64_t Mix(uint64_t seed, uint64_t a, uint64_t b = 0, uint64_t c = 0) {
+    uint64_t x = seed ^ (a * 0x9E3779B97F4A7C15ULL) ^ (b * 0xC2B2AE3D27D4EB4FULL) ^ (c * 0x165667B19E3779F9ULL);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+class Generator {
+public:
+    Generator(const SyntheticRepoOptions &options, std::string &error, SyntheticRepoStats &stats)
+        : options_(options), error_(error), stats_(stats), random_(options.seed) {}
+
+    ~Generator() {
+        git_odb_free(odb_);
+        git_repository_free(repo_);
+    }
+
+    bool run(const std::string &path) {
+        if (options_.commits == 0 || options_.files == 0 || options_.filesPerDirectory == 0) {
+            error_ = "commits, files and filesPerDirectory must be positive";
+            return false;
+        }
+        git_repository_init_options init = GIT_REPOSITORY_INIT_OPTIONS_INIT;
+        init.flags = GIT_REPOSITORY_INIT_BARE | GIT_REPOSITORY_INIT_MKPATH | GIT_REPOSITORY_INIT_NO_REINIT;
+        init.initial_head = "main";
+        if (!check(git_repository_init_ext(&repo_, path.c_str(), &init), "init repository") ||
+            !check(git_repository_odb(&odb_, repo_), "open odb")) {
+            return false;
+        }
+        // 大文件在挂上内存后端之前写入，直接成为松散对象，不参与打包时的增量计算
+        if (!writeLargeFiles() || !check(git_mempack_new(&mempack_), "mempack") ||
+            !check(git_odb_add_backend(odb_, mempack_, 1000), "add mempack backend")) {
+            return false;
+        }
+
+        if (!writeHistory() || !writeTags() || !flush() || !writeRefs()) {
+            return false;
+        }
+        stats_.head = git_oid_tostr_s(&tips_[0]);
+        return true;
+    }
+
+private:
+    bool check(int result, const char *operation) {
+        if (result >= 0) {
+            return true;
+        }
+        const git_error *e = git_error_last();
+        error_ = std::string(operation) + ": " + (e != nullptr ? e->message : "unknown error");
+        return false;
+    }
+
+    size_t linesPerFile() const { return std::max<size_t>(1, options_.fileBytes / LINE_BYTES); }
+
+    // 按当前的修改记录生成文件内容
+    std::string fileContent(size_t file) const {
+        size_t lines = linesPerFile();
+        std::string content(lines * LINE_BYTES, '\0');
+        auto revisions = revisions_.find(file);
+        for (size_t line = 0; line < lines; ++line) {
+            uint64_t revision = 0;
+            if (revisions != revisions_.end()) {
+                auto it = revisions->second.find(line);
+                revision = it != revisions->second.end() ? it->second : 0;
+            }
+            char buffer[LINE_BYTES + 1];
+            snprintf(buffer, sizeof(buffer), "let v%05zu = 0x%016llx; // rev %08llu\n", line % 100000,
+                     static_cast<unsigned long long>(Mix(options_.seed, file, line, revision)),
+                     static_cast<unsigned long long>(revision % 100000000));
+            std::copy(buffer, buffer + LINE_BYTES, &content[line * LINE_BYTES]);
+        }
+        return content;
+    }
+
+    bool writeBlob(size_t file) {
+        std::string content = fileContent(file);
+        pendingBytes_ += content.size();
+        ++pendingObjects_;
+        ++stats_.blobs;
+        return check(git_blob_create_from_buffer(&blobs_[file], repo_, content.data(), content.size()), "write blob");
+    }
+
+    // 内容不可压缩的二进制大文件，分块写入
+    bool writeLargeFiles() {
+        largeBlobs_.resize(options_.largeFiles);
+        std::vector<uint64_t> chunk(STREAM_CHUNK / sizeof(uint64_t));
+        for (size_t file = 0; file < options_.largeFiles; ++file) {
+            git_writestream *stream = nullptr;
+            if (!check(git_blob_create_from_stream(&stream, repo_, nullptr), "open blob stream")) {
+                return false;
+            }
+            bool ok = true;
+            uint64_t counter = 0;
+            for (size_t written = 0; ok && written < options_.largeFileBytes; written += STREAM_CHUNK) {
+                for (auto &word : chunk) {
+                    word = Mix(options_.seed, ~file, counter++);
+                }
+                size_t size = std::min(STREAM_CHUNK, options_.largeFileBytes - written);
+                ok = check(stream->write(stream, reinterpret_cast<const char *>(chunk.data()), size), "write blob");
+            }
+            // 成功时由 commit 释放流
+            if (!ok || !check(git_blob_create_from_stream_commit(&largeBlobs_[file], stream), "commit blob")) {
+                if (!ok) {
+                    stream->free(stream);
+                }
+                return false;
+            }
+            ++stats_.blobs;
+        }
+        return true;
+    }
+
+    bool writeTree(git_treebuilder *builder, git_oid &out) {
+        ++pendingObjects_;
+        ++stats_.trees;
+        bool ok = check(git_treebuilder_write(&out, builder), "write tree");
+        git_treebuilder_free(builder);
+        return ok;
+    }
+
+    bool writeDirectory(size_t directory) {
+        git_treebuilder *builder = nullptr;
+        if (!check(git_treebuilder_new(&builder, repo_, nullptr), "create tree builder")) {
+            return false;
+        }
+        size_t begin = directory * options_.filesPerDirectory;
+        size_t end = std::min(begin + options_.filesPerDirectory, options_.files);
+        for (size_t file = begin; file < end; ++file) {
+            char name[32];
+            snprintf(name, sizeof(name), "file%06zu%s", file, EXTENSIONS[file % std::size(EXTENSIONS)]);
+            if (!check(git_treebuilder_insert(nullptr, builder, name, &blobs_[file], GIT_FILEMODE_BLOB),
+                       "insert blob")) {
+                git_treebuilder_free(builder);
+                return false;
+            }
+        }
+        return writeTree(builder, directories_[directory]);
+    }
+
+    bool writeAssets() {
+        git_treebuilder *builder = nullptr;
+        if (!check(git_treebuilder_new(&builder, repo_, nullptr), "create tree builder")) {
+            return false;
+        }
+        for (size_t file = 0; file < largeBlobs_.size(); ++file) {
+            char name[32];
+            snprintf(name, sizeof(name), "blob%03zu.bin", file);
+            if (!check(git_treebuilder_insert(nullptr, builder, name, &largeBlobs_[file], GIT_FILEMODE_BLOB),
+                       "insert blob")) {
+                git_treebuilder_free(builder);
+                return false;
+            }
+        }
+        return writeTree(builder, assets_);
+    }
+
+    bool writeRoot(git_oid &root) {
+        git_treebuilder *builder = nullptr;
+        if (!check(git_treebuilder_new(&builder, repo_, nullptr), "create tree builder")) {
+            return false;
+        }
+        bool ok = check(git_treebuilder_insert(nullptr, builder, "README.md", &readme_, GIT_FILEMODE_BLOB),
+                        "insert readme");
+        if (ok && !largeBlobs_.empty()) {
+            ok = check(git_treebuilder_insert(nullptr, builder, "assets", &assets_, GIT_FILEMODE_TREE), "insert tree");
+        }
+        for (size_t directory = 0; ok && directory < directories_.size(); ++directory) {
+            char name[32];
+            snprintf(name, sizeof(name), "dir%04zu", directory);
+            ok = check(git_treebuilder_insert(nullptr, builder, name, &directories_[directory], GIT_FILEMODE_TREE),
+                       "insert tree");
+        }
+        if (!ok) {
+            git_treebuilder_free(builder);
+            return false;
+        }
+        return writeTree(builder, root);
+    }
+
+    bool writeCommit(size_t index, const git_oid &rootId, const std::vector<git_oid> &parentIds,
+                     const char *message, git_oid &out) {
+        git_tree *tree = nullptr;
+        if (!check(git_tree_lookup(&tree, repo_, &rootId), "lookup tree")) {
+            return false;
+        }
+        std::vector<git_commit *> parents;
+        bool ok = true;
+        for (const auto &id : parentIds) {
+            git_commit *parent = nullptr;
+            ok = ok && check(git_commit_lookup(&parent, repo_, &id), "lookup parent");
+            parents.push_back(parent);
+        }
+
+        const char *author = AUTHORS[random_() % std::size(AUTHORS)];
+        std::string email = std::string(author) + "@example.com";
+        git_signature *signature = nullptr;
+        ok = ok && check(git_signature_new(&signature, author, email.c_str(), BASE_TIME + index * COMMIT_INTERVAL, 0),
+                         "create signature");
+        ok = ok && check(git_commit_create(&out, repo_, nullptr, signature, signature, nullptr, message, tree,
+                                           parents.size(), const_cast<const git_commit **>(parents.data())),
+                         "create commit");
+        if (ok) {
+            commits_.push_back(out);
+            ++pendingObjects_;
+            ++stats_.commits;
+        }
+        git_signature_free(signature);
+        for (auto *parent : parents) {
+            git_commit_free(parent);
+        }
+        git_tree_free(tree);
+        return ok;
+    }
+
+    // 修改若干文件中的一行，只重写变化的目录
+    bool modifyFiles(size_t index, size_t changes, git_oid &root) {
+        std::vector<size_t> dirty;
+        for (size_t change = 0; change < changes; ++change) {
+            size_t file = random_() % options_.files;
+            revisions_[file][random_() % linesPerFile()] = index;
+            if (!writeBlob(file)) {
+                return false;
+            }
+            dirty.push_back(file / options_.filesPerDirectory);
+        }
+        std::sort(dirty.begin(), dirty.end());
+        dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+        for (size_t directory : dirty) {
+            if (!writeDirectory(directory)) {
+                return false;
+            }
+        }
+        return writeRoot(root);
+    }
+
+    bool writeHistory() {
+        size_t directoryCount = (options_.files + options_.filesPerDirectory - 1) / options_.filesPerDirectory;
+        blobs_.resize(options_.files);
+        directories_.resize(directoryCount);
+        commits_.reserve(options_.commits);
+
+        const char readme[] = "# Synthetic repository\n\nGenerated for higit_bench.\n";
+        if (!check(git_blob_create_from_buffer(&readme_, repo_, readme, sizeof(readme) - 1), "write readme")) {
+            return false;
+        }
+
+        // 第一个提交写入全部文件
+        for (size_t file = 0; file < options_.files; ++file) {
+            if (!writeBlob(file) || !maybeFlush()) {
+                return false;
+            }
+        }
+        for (size_t directory = 0; directory < directoryCount; ++directory) {
+            if (!writeDirectory(directory)) {
+                return false;
+            }
+        }
+        git_oid root;
+        git_oid id;
+        if ((!largeBlobs_.empty() && !writeAssets()) || !writeRoot(root) ||
+            !writeCommit(0, root, {}, "Initial commit\n", id)) {
+            return false;
+        }
+        // tips_[0] 为 main，其余为主题分支
+        tips_.assign(options_.topics + 1, id);
+
+        size_t changes = std::max<size_t>(1, options_.changesPerCommit);
+        bool merging = options_.topics > 0 && options_.mergeEvery > 0;
+        for (size_t index = 1; index < options_.commits; ++index) {
+            char message[160];
+            if (merging && index % options_.mergeEvery == 0) {
+                // 合并一个主题分支，之后该主题从新的 main 重新开始
+                size_t lane = 1 + random_() % options_.topics;
+                snprintf(message, sizeof(message), "Merge branch 'topic/%03zu'\n", lane - 1);
+                if (!writeCommit(index, root, {tips_[0], tips_[lane]}, message, id)) {
+                    return false;
+                }
+                tips_[0] = id;
+                tips_[lane] = id;
+                ++stats_.merges;
+            } else {
+                size_t lane = options_.topics > 0 ? random_() % (options_.topics + 1) : 0;
+                snprintf(message, sizeof(message), "Update %zu files (change %zu)\n\nSynthetic commit %zu of %zu.\n",
+                         changes, index, index + 1, options_.commits);
+                if (!modifyFiles(index, changes, root) || !writeCommit(index, root, {tips_[lane]}, message, id)) {
+                    return false;
+                }
+                tips_[lane] = id;
+            }
+            if (!maybeFlush()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 均匀分布在历史上的第 i 个（共 count 个）提交
+    const git_oid &spread(size_t i, size_t count) const {
+        return commits_[(i + 1) * (commits_.size() - 1) / (count + 1)];
+    }
+
+    bool writeTags() {
+        tags_.resize(options_.tags);
+        for (size_t i = 0; i < options_.tags; ++i) {
+            git_object *target = nullptr;
+            if (!check(git_object_lookup(&target, repo_, &spread(i, options_.tags), GIT_OBJECT_COMMIT),
+                       "lookup tag target")) {
+                return false;
+            }
+            git_signature *tagger = nullptr;
+            bool ok = check(git_signature_new(&tagger, "Release", "release@example.com",
+                                              git_commit_time(reinterpret_cast<git_commit *>(target)), 0),
+                            "create signature");
+            char name[32];
+            snprintf(name, sizeof(name), "v1.%zu", i);
+            ok = ok && check(git_tag_annotation_create(&tags_[i], repo_, name, target, tagger, "Synthetic release\n"),
+                             "create tag");
+            git_signature_free(tagger);
+            git_object_free(target);
+            ++pendingObjects_;
+            if (!ok || !maybeFlush()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool maybeFlush() {
+        if (pendingBytes_ < FLUSH_BYTES && pendingObjects_ < FLUSH_OBJECTS) {
+            return true;
+        }
+        return flush();
+    }
+
+    // 内存中的对象打包写入仓库，之后从磁盘读取
+    bool flush() {
+        if (pendingObjects_ == 0) {
+            return true;
+        }
+        // 只打包内存中的对象（包括标签），已写入磁盘的对象不重复打包
+        git_packbuilder *builder = nullptr;
+        git_buf pack = GIT_BUF_INIT;
+        bool ok = check(git_packbuilder_new(&builder, repo_), "create pack builder");
+        if (ok) {
+            // 增量查找按 CPU 核数并行
+            git_packbuilder_set_threads(builder, 0);
+        }
+        ok = ok && check(git_mempack_write_thin_pack(mempack_, builder), "collect objects") &&
+                  check(git_packbuilder_write_buf(&pack, builder), "build pack");
+        git_packbuilder_free(builder);
+        git_odb_writepack *writer = nullptr;
+        ok = ok && check(git_odb_write_pack(&writer, odb_, nullptr, nullptr), "open pack writer");
+        if (ok) {
+            git_indexer_progress stats = {};
+            ok = check(writer->append(writer, pack.ptr, pack.size, &stats), "append pack") &&
+                 check(writer->commit(writer, &stats), "index pack");
+            writer->free(writer);
+        }
+        git_buf_dispose(&pack);
+        if (ok) {
+            git_mempack_reset(mempack_);
+            pendingBytes_ = 0;
+            pendingObjects_ = 0;
+            ++stats_.packs;
+        }
+        return ok;
+    }
+
+    bool createRef(const char *name, const git_oid &target) {
+        git_reference *ref = nullptr;
+        if (!check(git_reference_create(&ref, repo_, name, &target, 0, nullptr), "create reference")) {
+            return false;
+        }
+        git_reference_free(ref);
+        return true;
+    }
+
+    bool writeRefs() {
+        if (!createRef("refs/heads/main", tips_[0])) {
+            return false;
+        }
+        char name[48];
+        for (size_t lane = 1; lane < tips_.size(); ++lane) {
+            snprintf(name, sizeof(name), "refs/heads/topic/%03zu", lane - 1);
+            if (!createRef(name, tips_[lane])) {
+                return false;
+            }
+        }
+        for (size_t i = 0; i < options_.branches; ++i) {
+            snprintf(name, sizeof(name), "refs/heads/feature/%03zu", i);
+            if (!createRef(name, spread(i, options_.branches))) {
+                return false;
+            }
+        }
+        for (size_t i = 0; i < tags_.size(); ++i) {
+            snprintf(name, sizeof(name), "refs/tags/v1.%zu", i);
+            if (!createRef(name, tags_[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const SyntheticRepoOptions &options_;
+    std::string &error_;
+    SyntheticRepoStats &stats_;
+    std::mt19937_64 random_;
+    git_repository *repo_ = nullptr;
+    git_odb *odb_ = nullptr;
+    git_odb_backend *mempack_ = nullptr; ///< 由 odb 持有
+    size_t pendingBytes_ = 0;            ///< 内存中尚未打包的 blob 字节数
+    size_t pendingObjects_ = 0;          ///< 内存中尚未打包的对象数
+    git_oid readme_ = {};
+    git_oid assets_ = {};
+    std::unordered_map<size_t, std::map<size_t, uint64_t>> revisions_; ///< 被修改过的行：文件 -> 行号 -> 修改次数
+    std::vector<git_oid> blobs_;       ///< 各文件当前的 blob
+    std::vector<git_oid> largeBlobs_;  ///< 各大文件的 blob
+    std::vector<git_oid> directories_; ///< 各目录当前的树
+    std::vector<git_oid> commits_;     ///< 按顺序生成的提交
+    std::vector<git_oid> tips_;        ///< main 和各主题分支的最新提交
+    std::vector<git_oid> tags_;        ///< 附注标签对象
+};
+
+struct Shape {
+    const char *name;
+    void (*apply)(SyntheticRepoOptions &options);
+};
+
+constexpr Shape SHAPES[] = {
+    {"linear", [](SyntheticRepoOptions &o) { o.commits = 100000; }},
+    {"merges",
+     [](SyntheticRepoOptions &o) {
+         o.commits = 20000;
+         o.topics = 32;
+         o.mergeEvery = 4;
+     }},
+    {"wide-tree",
+     [](SyntheticRepoOptions &o) {
+         o.commits = 50;
+         o.files = 300000;
+         o.fileBytes = 512;
+     }},
+    {"tags",
+     [](SyntheticRepoOptions &o) {
+         o.commits = 20000;
+         o.tags = 10000;
+     }},
+    {"large-blobs",
+     [](SyntheticRepoOptions &o) {
+         o.commits = 100;
+         o.largeFiles = 4;
+         o.largeFileBytes = 256 * 1024 * 1024;
+     }},
+};
+
+struct Option {
+    const char *name;
+    size_t SyntheticRepoOptions::*field;
+};
+
+constexpr Option OPTIONS[] = {
+    {"--commits", &SyntheticRepoOptions::commits},
+    {"--files", &SyntheticRepoOptions::files},
+    {"--files-per-dir", &SyntheticRepoOptions::filesPerDirectory},
+    {"--file-bytes", &SyntheticRepoOptions::fileBytes},
+    {"--changes", &SyntheticRepoOptions::changesPerCommit},
+    {"--topics", &SyntheticRepoOptions::topics},
+    {"--merge-every", &SyntheticRepoOptions::mergeEvery},
+    {"--large-files", &SyntheticRepoOptions::largeFiles},
+    {"--large-file-bytes", &SyntheticRepoOptions::largeFileBytes},
+    {"--branches", &SyntheticRepoOptions::branches},
+    {"--tags", &SyntheticRepoOptions::tags},
+};
+} // namespace
+
+namespace SyntheticRepo {
+
+bool Generate(const std::string &path, const SyntheticRepoOptions &options, std::string &error,
+              SyntheticRepoStats *stats) {
+    SyntheticRepoStats local;
+    Generator generator(options, error, stats != nullptr ? *stats : local);
+    return generator.run(path);
+}
+
+bool ApplyShape(const std::string &shape, SyntheticRepoOptions &options) {
+    for (const auto &entry : SHAPES) {
+        if (shape == entry.name) {
+            entry.apply(options);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ApplyOption(const std::string &name, uint64_t value, SyntheticRepoOptions &options) {
+    if (name == "--seed") {
+        options.seed = value;
+        return true;
+    }
+    for (const auto &entry : OPTIONS) {
+        if (name == entry.name) {
+            options.*entry.field = static_cast<size_t>(value);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char *OptionsUsage() {
+    return "  --shape NAME         preset: linear, merges, wide-tree, tags, large-blobs\n"
+           "  --commits N          commits including merges (default 1000)\n"
+           "  --files N            text files in the tree (default 2000)\n"
+           "  --files-per-dir N    files per directory (default 64)\n"
+           "  --file-bytes N       approximate size of each text file (default 2048)\n"
+           "  --changes N          files changed per commit (default 4)\n"
+           "  --topics N           parallel topic branches, 0 for linear history (default 0)\n"
+           "  --merge-every N      merge a topic into main every N commits (default 0)\n"
+           "  --large-files N      incompressible binary files (default 0)\n"
+           "  --large-file-bytes N size of each binary file (default 0)\n"
+           "  --branches N         extra branches spread over history (default 16)\n"
+           "  --tags N             annotated tags spread over history (default 64)\n"
+           "  --seed N             generator seed (default 1)\n";
+}
+
+} // namespace SyntheticRepo
@@ -0,0 +1,86 @@
+#ifndef HIGIT_SYNTHETIC_REPO_H
+#define HIGIT_SYNTHETIC_REPO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief 合成仓库的规模参数
+ */
+struct SyntheticRepoOptions {
+    size_t commits = 1000;          ///< 提交总数（含合并提交）
+    size_t files = 2000;            ///< 文本文件数
+    size_t filesPerDirectory = 64;  ///< 每个目录的文件数
+    size_t fileBytes = 2048;        ///< 每个文本文件的大致大小
+    size_t changesPerCommit = 4;    ///< 每次提交修改的文件数
+    size_t topics = 0;              ///< 并行的主题分支数，0 表示线性历史
+    size_t mergeEvery = 0;          ///< 每隔多少个提交把一个主题分支合并回 main，0 表示不合并
+    size_t largeFiles = 0;          ///< 大文件（二进制）数
+    size_t largeFileBytes = 0;      ///< 每个大文件的大小
+    size_t branches = 16;           ///< 额外分支数，均匀指向历史上的提交
+    size_t tags = 64;               ///< 附注标签数，均匀指向历史上的提交
+    uint64_t seed = 1;              ///< 随机种子
+};
+
+/**
+ * @brief 生成结果统计
+ */
+struct SyntheticRepoStats {
+    size_t commits = 0; ///< 提交数
+    size_t merges = 0;  ///< 其中的合并提交数
+    size_t blobs = 0;   ///< 写入的 blob 数
+    size_t trees = 0;   ///< 写入的树对象数
+    size_t packs = 0;   ///< 生成的 pack 数
+    std::string head;   ///< main 指向的提交ID
+};
+
+/**
+ * @brief 基准测试用的合成仓库
+ * 通过 libgit2 生成裸仓库：第一个提交写入全部文件，之后每个提交修改若干文件中的一行；
+ * 可选并行的主题分支和合并提交、二进制大文件、大量标签。
+ * 对象先写入内存，积累到一定量后打包写入仓库，结构接近 clone 得到的仓库；大文件直接写为松散对象。
+ * 参数和种子相同时生成的对象ID完全相同，可在不同机器、不同版本之间对比
+ *
+ * 文件内容由种子、文件序号、行号和修改次数推导，只记录被修改过的行，三十万文件的树也不需要在内存中保存全部内容
+ */
+namespace SyntheticRepo {
+
+/**
+ * @brief 生成裸仓库，HEAD 指向 main
+ * @param path 仓库路径，须不存在或为空目录
+ * @param options 规模参数
+ * @param error 失败时写入错误信息
+ * @param stats 可选，写入生成结果统计
+ * @return 成功返回true
+ */
+bool Generate(const std::string &path, const SyntheticRepoOptions &options, std::string &error,
+              SyntheticRepoStats *stats = nullptr);
+
+/**
+ * @brief 按预设形状设置参数
+ * linear：十万个线性提交；merges：32 个主题分支反复合并的宽历史；wide-tree：三十万文件的树；
+ * tags：一万个标签；large-blobs：4 个 256MB 的二进制文件
+ * @param shape 形状名
+ * @param options 要修改的参数
+ * @return 形状名无效时返回false
+ */
+bool ApplyShape(const std::string &shape, SyntheticRepoOptions &options);
+
+/**
+ * @brief 按命令行选项设置单个参数，如 --commits、--files、--topics
+ * @param name 选项名
+ * @param value 选项值
+ * @param options 要修改的参数
+ * @return 不是规模参数选项时返回false
+ */
+bool ApplyOption(const std::string &name, uint64_t value, SyntheticRepoOptions &options);
+
+/**
+ * @brief 规模参数选项的说明，供命令行帮助使用
+ */
+const char *OptionsUsage();
+
+} // namespace SyntheticRepo
+
+#endif // HIGIT_SYNTHETIC_REPO_H
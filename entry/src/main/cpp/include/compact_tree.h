@@ -0,0 +1,111 @@
+#ifndef HIGIT_COMPACT_TREE_H
+#define HIGIT_COMPACT_TREE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 紧凑的文件树
+ * 以并列数组（结构体数组转数组结构体）存储节点：父节点下标、文件名在字符串池中的位置、模式、大小和20字节的二进制对象ID；
+ * 相同的文件名只在字符串池中保存一份，完整路径在需要时沿父节点拼出
+ *
+ * 节点按先序排列，目录之后紧跟其子节点，父节点下标总是小于子节点下标
+ */
+class CompactFileTree {
+public:
+    static constexpr uint32_t NO_PARENT = UINT32_MAX; ///< 根层节点的父节点下标
+    static constexpr size_t OID_SIZE = 20;            ///< 二进制对象ID长度
+    static constexpr uint16_t MODE_TREE = 0040000;    ///< 目录的文件模式
+
+    CompactFileTree() = default;
+
+    /**
+     * @brief 设置路径前缀
+     * 只加载子目录时，所有路径都以该目录为前缀
+     * @param rootPath 路径前缀
+     */
+    void setRootPath(const std::string &rootPath) { rootPath_ = rootPath; }
+
+    /**
+     * @brief 预分配节点空间
+     * @param count 节点数量
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief 追加节点
+     * @param parent 父节点下标，根层节点为 NO_PARENT
+     * @param name 文件名
+     * @param mode 文件模式
+     * @param oid 20字节的二进制对象ID
+     * @return 新节点下标
+     */
+    uint32_t append(uint32_t parent, std::string_view name, uint16_t mode, const unsigned char *oid);
+
+    /**
+     * @brief 设置文件大小
+     * @param index 节点下标
+     * @param size 文件大小
+     */
+    void setFileSize(uint32_t index, uint64_t size);
+
+    /**
+     * @brief 构建完成，释放构建期间使用的辅助结构并收缩内存
+     */
+    void finish();
+
+    size_t size() const { return parents_.size(); }
+    uint32_t parent(uint32_t index) const { return parents_[index]; }
+    uint16_t mode(uint32_t index) const { return modes_[index]; }
+    bool isDirectory(uint32_t index) const { return modes_[index] == MODE_TREE; }
+    uint32_t fileSize(uint32_t index) const { return sizes_[index]; }
+    const unsigned char *oid(uint32_t index) const { return oids_.data() + index * OID_SIZE; }
+
+    std::string_view name(uint32_t index) const {
+        return std::string_view(namePool_).substr(nameOffsets_[index], nameLengths_[index]);
+    }
+
+    /**
+     * @brief 获取文件扩展名（不含点），目录和无扩展名的文件返回空
+     * @param index 节点下标
+     * @return 扩展名
+     */
+    std::string_view extension(uint32_t index) const;
+
+    /**
+     * @brief 获取节点的完整路径
+     * @param index 节点下标
+     * @return 完整路径
+     */
+    std::string path(uint32_t index) const;
+
+    /**
+     * @brief 获取对象ID的十六进制字符串
+     * @param index 节点下标
+     * @return 40位十六进制字符串
+     */
+    std::string oidHex(uint32_t index) const;
+
+    /**
+     * @brief 估算占用的内存
+     * @return 字节数
+     */
+    size_t memoryUsage() const;
+
+private:
+    std::string rootPath_;              ///< 路径前缀
+    std::vector<uint32_t> parents_;     ///< 父节点下标
+    std::vector<uint32_t> nameOffsets_; ///< 文件名在字符串池中的偏移
+    std::vector<uint16_t> nameLengths_; ///< 文件名长度
+    std::vector<uint16_t> modes_;       ///< 文件模式
+    std::vector<uint32_t> sizes_;       ///< 文件大小，超过4GB时为 UINT32_MAX
+    std::vector<unsigned char> oids_;   ///< 二进制对象ID，每个节点20字节
+    std::string namePool_;              ///< 去重后的文件名
+
+    std::unordered_map<std::string, uint32_t> internTable_; ///< 构建期间文件名到偏移的映射
+};
+
+#endif // HIGIT_COMPACT_TREE_H
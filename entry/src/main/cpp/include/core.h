@@ -8,12 +8,37 @@
 #define HIGIT_CORE_H
 
 #include "ssh_manager.h"
+#include <condition_variable>
 #include <js_native_api.h>
 #include <js_native_api_types.h>
 #include <memory>
+#include <mutex>
 #include <repo_manager.h>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
+
+/**
+ * @brief SSH密钥状态
+ */
+enum class SSHKeyState {
+    Missing,    ///< 尚未初始化
+    Generating, ///< 正在后台生成
+    Ready,      ///< 密钥可用
+    Failed,     ///< 加载或生成失败
+};
+
+/**
+ * @brief SSH密钥状态快照
+ */
+struct SSHKeyStatus {
+    SSHKeyState state = SSHKeyState::Missing; ///< 密钥状态
+    std::string keyType;                      ///< 密钥类型
+    std::string publicKey;                    ///< OpenSSH格式公钥
+    std::string fingerprint;                  ///< 密钥指纹
+    std::string message;                      ///< 失败原因
+};
 
 class Core final {
 public:
@@ -34,6 +59,8 @@ public:
     [[nodiscard]] static napi_value InitSystem(napi_env env, napi_callback_info info) noexcept;
     // 初始化仓库
     [[nodiscard]] static napi_value InitRepo(napi_env env, napi_callback_info info) noexcept;
+    // 启动时并行打开并预热所有本地仓库，逐个回调就绪状态
+    [[nodiscard]] static napi_value OpenAll(napi_env env, napi_callback_info info) noexcept;
     // 获取分支
     [[nodiscard]] static napi_value GetBranches(napi_env env, napi_callback_info info) noexcept;
     // 获取标签
@@ -44,31 +71,96 @@ public:
     [[nodiscard]] static napi_value GetHistory(napi_env env, napi_callback_info info) noexcept;
     // 获取 SSH Key
     [[nodiscard]] static napi_value GetSSHKey(napi_env env, napi_callback_info info) noexcept;
-    // 生成 SSH Key
+    // 生成 SSH Key（后台进行，同步版本立即返回）
     [[nodiscard]] static napi_value GenerateSSHKey(napi_env env, napi_callback_info info) noexcept;
+    // 获取 SSH Key 状态
+    [[nodiscard]] static napi_value GetSSHKeyStatus(napi_env env, napi_callback_info info) noexcept;
     // 删除仓库
     [[nodiscard]] static napi_value DeleteRepo(napi_env env, napi_callback_info info) noexcept;
     // 获取文件树
     [[nodiscard]] static napi_value GetFileTree(napi_env env, napi_callback_info info) noexcept;
     // 读取文件
     [[nodiscard]] static napi_value ReadFile(napi_env env, napi_callback_info info) noexcept;
+    // 获取提交变更
+    [[nodiscard]] static napi_value GetCommitChanges(napi_env env, napi_callback_info info) noexcept;
+    // 获取文件补丁（流式）
+    [[nodiscard]] static napi_value GetFilePatch(napi_env env, napi_callback_info info) noexcept;
+    // 搜索代码（流式）
+    [[nodiscard]] static napi_value SearchTree(napi_env env, napi_callback_info info) noexcept;
+    // 模糊查找文件
+    [[nodiscard]] static napi_value FindFiles(napi_env env, napi_callback_info info) noexcept;
+    // 获取文件Blame（流式）
+    [[nodiscard]] static napi_value BlameFile(napi_env env, napi_callback_info info) noexcept;
+    // 取消Blame
+    [[nodiscard]] static napi_value CancelBlame(napi_env env, napi_callback_info info) noexcept;
+    // 按内存压力级别清理缓存
+    [[nodiscard]] static napi_value TrimCaches(napi_env env, napi_callback_info info) noexcept;
+    // 设置 libgit2 内存预算（MB），0 表示按设备内存自动推算
+    [[nodiscard]] static napi_value SetMemoryBudget(napi_env env, napi_callback_info info) noexcept;
+    // 开启或关闭原生耗时追踪
+    [[nodiscard]] static napi_value SetTracing(napi_env env, napi_callback_info info) noexcept;
+    // 导出追踪记录（Chrome trace-event JSON）
+    [[nodiscard]] static napi_value ExportTrace(napi_env env, napi_callback_info info) noexcept;
+    // 获取各操作的耗时分位数、缓存命中和传输量
+    [[nodiscard]] static napi_value GetMetrics(napi_env env, napi_callback_info info) noexcept;
+    // 列式二进制版本的列表接口，结果通过 ArrayBuffer 返回
+    [[nodiscard]] static napi_value GetBranchesColumns(napi_env env, napi_callback_info info) noexcept;
+    [[nodiscard]] static napi_value GetTagsColumns(napi_env env, napi_callback_info info) noexcept;
+    [[nodiscard]] static napi_value GetHistoryColumns(napi_env env, napi_callback_info info) noexcept;
+    [[nodiscard]] static napi_value GetFileTreeColumns(napi_env env, napi_callback_info info) noexcept;
+    // 以下为返回 Promise 的异步版本，参数与同步版本相同；libgit2 操作在工作线程执行，参数解析和结果转换留在 JS 线程
+    [[nodiscard]] static napi_value InitSystemAsync(napi_env env, napi_callback_info info) noexcept;
+    [[nodiscard]] static napi_value InitRepoAsync(napi_env env, napi_callback_info info) noexcept;
+    [[nodiscard]] static napi_value GetBranchesAsync(napi_env env, napi_callback_info info) noexcept;
+    [[nodiscard]] static napi_value GetTagsAsync(napi_env env, napi_callback_info info) noexcept;
+    [[nodiscard]] static napi_value FetchAsync(napi_env env, napi_callback_info info) noexcept;
+    [[nodiscard]] static napi_value GetHistoryAsync(napi_env env, napi_callback_info info) noexcept;
+    [[nodiscard]] static napi_value GetSSHKeyAsync(napi_env env, napi_callback_info info) noexcept;
+    [[nodiscard]] static napi_value GenerateSSHKeyAsync(napi_env env, napi_callback_info info) noexcept;
+    [[nodiscard]] static napi_value DeleteRepoAsync(napi_env env, napi_callback_info info) noexcept;
+    [[nodiscard]] static napi_value GetFileTreeAsync(napi_env env, napi_callback_info info) noexcept;
+    [[nodiscard]] static napi_value ReadFileAsync(napi_env env, napi_callback_info info) noexcept;
+    [[nodiscard]] static napi_value GetCommitChangesAsync(napi_env env, napi_callback_info info) noexcept;
+    [[nodiscard]] static napi_value FindFilesAsync(napi_env env, napi_callback_info info) noexcept;
+    [[nodiscard]] static napi_value GetBranchesColumnsAsync(napi_env env, napi_callback_info info) noexcept;
+    [[nodiscard]] static napi_value GetTagsColumnsAsync(napi_env env, napi_callback_info info) noexcept;
+    [[nodiscard]] static napi_value GetHistoryColumnsAsync(napi_env env, napi_callback_info info) noexcept;
+    [[nodiscard]] static napi_value GetFileTreeColumnsAsync(napi_env env, napi_callback_info info) noexcept;
+
+    // 仓库缓存可在任意线程访问；返回的 shared_ptr 保证仓库在操作结束前不被释放
+    // 已存在同一 url 的仓库时不替换，返回 false
+    bool StoreRepoManager(const std::string &repoUrl, std::unique_ptr<RepoManager> manager);
+    std::shared_ptr<RepoManager> FindRepoManager(const std::string &repoUrl);
+    // 返回被移除的仓库，调用方可在其执行器上等待进行中的操作结束
+    std::shared_ptr<RepoManager> DeleteRepoManager(const std::string &repoUrl);
+    // 当前所有仓库的快照
+    std::vector<std::shared_ptr<RepoManager>> ListRepoManagers();
+
+    // 同步和异步两种导出共用，由 handler 在 JS 线程或工作线程调用
+    // 已有密钥时直接加载；没有密钥时在后台生成，不阻塞启动
+    void InitSSH(std::string const &basePath);
+
+    // 在线程池上生成新密钥，成功后替换旧密钥；已有生成任务时不重复启动，返回 false
+    bool GenerateSSHKey(SSHKeyAlgorithm algorithm);
 
-    void StoreRepoManager(const std::string &repoUrl, std::unique_ptr<RepoManager> manager);
-    RepoManager *FindRepoManager(const std::string &repoUrl);
-    void DeleteRepoManager(const std::string &repoUrl);
+    // 当前密钥状态，wait 为 true 时等待进行中的生成结束（只能在工作线程等待）
+    SSHKeyStatus GetSSHKeyStatus(bool wait);
 
 private:
+    // 生成密钥并写入文件，返回失败原因，成功时为空
+    static std::string CreateSSHKey(SSHManager &manager, std::string const &sshDir, SSHKeyAlgorithm algorithm);
+
     static Core instance_;
-    std::unique_ptr<SSHManager> ssh_manager_;
     napi_env core_env;
 
-    std::unordered_map<std::string, std::unique_ptr<RepoManager>> repo_registry_;
-
-    void InitSSH(std::string const &basePath);
-
-    std::string GetSSHKey() const;
+    std::shared_ptr<SSHManager> ssh_manager_; ///< 当前密钥，由 ssh_mutex_ 保护
+    SSHKeyState ssh_state_ = SSHKeyState::Missing;
+    std::string ssh_error_;
+    std::mutex ssh_mutex_;
+    std::condition_variable ssh_cv_;
 
-    std::string GenerateSSHKey() const;
+    std::unordered_map<std::string, std::shared_ptr<RepoManager>> repo_registry_;
+    std::shared_mutex registry_mutex_;
 };
 
 
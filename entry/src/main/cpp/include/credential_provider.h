@@ -0,0 +1,71 @@
+#ifndef HIGIT_CREDENTIAL_PROVIDER_H
+#define HIGIT_CREDENTIAL_PROVIDER_H
+
+#include <atomic>
+#include <git2.h>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * @brief 认证使用的SSH密钥内容
+ * 创建后不再修改，可在多个线程间共享
+ */
+struct SSHCredential {
+    std::string publicKey;  ///< OpenSSH格式公钥
+    std::string privateKey; ///< PEM格式私钥
+};
+
+/**
+ * @brief 进程共享的凭据提供者
+ * 缓存当前SSH密钥的内容，libgit2 请求凭据时直接从内存创建，不再每次读取并解析密钥文件。
+ * 密钥加载或更换后由 Core 更新；缓存为空或 libgit2 不支持内存凭据时退回到密钥文件
+ *
+ * 注意：该类不支持拷贝构造和赋值操作
+ */
+class CredentialProvider {
+public:
+    /**
+     * @brief 获取进程共享的凭据提供者
+     * @return 凭据提供者引用
+     */
+    static CredentialProvider &Shared();
+
+    // 禁止拷贝
+    CredentialProvider(const CredentialProvider &) = delete;
+    CredentialProvider &operator=(const CredentialProvider &) = delete;
+
+    /**
+     * @brief 设置当前SSH密钥，替换之前的缓存
+     * @param credential 密钥内容，为空时等同于 invalidate
+     */
+    void setSSHKey(std::shared_ptr<const SSHCredential> credential);
+
+    /**
+     * @brief 清空缓存，之后的认证从密钥文件读取
+     */
+    void invalidate();
+
+    /**
+     * @brief 当前缓存的SSH密钥
+     * @return 密钥内容，未缓存时为空
+     */
+    std::shared_ptr<const SSHCredential> sshKey() const;
+
+    /**
+     * @brief 为 libgit2 创建SSH密钥凭据
+     * @param out 输出凭据
+     * @param username 用户名
+     * @return 0 成功，否则为 libgit2 错误码
+     */
+    int createSSHKey(git_credential **out, const char *username) const;
+
+private:
+    CredentialProvider() = default;
+
+    mutable std::mutex mutex_;                           ///< 保护 sshKey_
+    std::shared_ptr<const SSHCredential> sshKey_;        ///< 当前密钥
+    mutable std::atomic<bool> memoryUnsupported_{false}; ///< libgit2 未启用内存凭据
+};
+
+#endif // HIGIT_CREDENTIAL_PROVIDER_H
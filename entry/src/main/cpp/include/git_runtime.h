@@ -0,0 +1,111 @@
+#ifndef HIGIT_GIT_RUNTIME_H
+#define HIGIT_GIT_RUNTIME_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+
+/**
+ * @brief 进程级的 libgit2 运行时
+ * 只初始化一次 libgit2，并统一管理其全局选项（内存映射窗口、对象缓存、超时、证书），
+ * 同时注册共享CA证书链的 TLS 流（见 TlsStream）和复用会话的SSH传输（见 SshTransport）。
+ * 缓存大小按内存预算分配，预算未配置时按设备内存推算；收到内存压力通知时按级别收紧，
+ * 系统不会通知压力解除，因此一段时间内没有新的通知后自动恢复完整预算
+ *
+ * 注意：运行时在进程内常驻，不调用 git_libgit2_shutdown，避免静态析构时仍有仓库句柄未释放
+ */
+class GitRuntime {
+public:
+    /**
+     * @brief 内存压力级别，取值与 AbilityConstant.MemoryLevel 一致
+     */
+    enum class MemoryLevel {
+        Moderate = 0, ///< 内存适中：恢复完整预算，只清理可重建的结果缓存
+        Low = 1,      ///< 内存较低：预算减半，释放空闲句柄和空闲连接
+        Critical = 2, ///< 内存严重不足：预算降到四分之一，同时清空 libgit2 对象缓存和TLS会话缓存
+    };
+
+    /**
+     * @brief 获取进程唯一的运行时，首次调用时初始化 libgit2
+     * @return 运行时引用
+     */
+    static GitRuntime &Instance();
+
+    // 禁止拷贝
+    GitRuntime(const GitRuntime &) = delete;
+    GitRuntime &operator=(const GitRuntime &) = delete;
+
+    /**
+     * @brief 设置证书目录，目录下存在 cert.pem 时作为 HTTPS 的 CA 证书
+     * 证书包在后台解析一次，DER 缓存保存在同一目录的 cert.der
+     * @param filesDirectory 应用文件目录
+     */
+    void setCertificateDirectory(const std::string &filesDirectory);
+
+    /**
+     * @brief 设置内存预算并重新分配 libgit2 缓存
+     * @param bytes 预算字节数，为0时按设备内存推算
+     */
+    void setMemoryBudget(size_t bytes);
+
+    /**
+     * @brief 当前生效的内存预算（已按内存压力折减）
+     * @return 字节数
+     */
+    size_t memoryBudget() const;
+
+    /**
+     * @brief 预算中留给各仓库结果缓存的部分，由所有打开的仓库均分
+     * @return 字节数
+     */
+    size_t resultCacheBudget() const;
+
+    /**
+     * @brief 按内存压力级别调整 libgit2 全局缓存上限
+     * 各仓库自身的缓存由调用方另行清理；Low 及以上的级别在 PRESSURE_HOLD 内没有新的通知时恢复为 Moderate
+     * @param level 内存压力级别
+     */
+    void trimCaches(MemoryLevel level);
+
+    /// 收紧预算后保持的时长，期间没有新的内存压力通知则恢复完整预算
+    static constexpr std::chrono::seconds PRESSURE_HOLD{120};
+
+    /**
+     * @brief 设备物理内存大小
+     * @return 字节数，无法获取时返回0
+     */
+    static size_t PhysicalMemory();
+
+private:
+    GitRuntime();
+
+    /**
+     * @brief 按当前预算和压力级别设置 libgit2 选项，调用时须持有锁
+     */
+    void applyBudgetLocked();
+
+    /**
+     * @brief 安排在 restoreAt_ 恢复完整预算，调用时须持有锁
+     * 等待线程只在收紧期间存在，恢复后退出
+     */
+    void scheduleRestoreLocked();
+
+    /**
+     * @brief 等待线程主循环，到期且期间没有新的通知时恢复为 Moderate
+     */
+    void restoreLoop();
+
+    mutable std::mutex mutex_;                          ///< 保护以下成员
+    std::condition_variable restoreCv_;                 ///< 恢复时间变化通知
+    size_t configuredBudget_ = 0;                       ///< 配置的预算，0表示自动
+    size_t budget_ = 0;                                 ///< 当前生效的预算
+    size_t resultBudget_ = 0;                           ///< 当前预算中留给结果缓存的部分
+    MemoryLevel level_ = MemoryLevel::Moderate;         ///< 当前生效的内存压力级别
+    std::chrono::steady_clock::time_point restoreAt_{}; ///< 恢复完整预算的时间
+    bool restoreWaiting_ = false;                       ///< 是否已有等待恢复的线程
+    bool tlsRegistered_ = false;                        ///< 是否已注册自有 TLS 流
+};
+
+#endif // HIGIT_GIT_RUNTIME_H
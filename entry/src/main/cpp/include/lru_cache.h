@@ -0,0 +1,163 @@
+#ifndef HIGIT_LRU_CACHE_H
+#define HIGIT_LRU_CACHE_H
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @brief 线程安全的LRU缓存
+ * 值以 shared_ptr<const Value> 形式保存，读取方拿到的结果在被淘汰后依然有效；
+ * 除条目数量外还可按写入时给出的开销（通常为字节数）限制总量
+ * @tparam Key 键类型（需支持 std::hash）
+ * @tparam Value 值类型
+ */
+template <typename Key, typename Value> class LruCache {
+public:
+    using ValuePtr = std::shared_ptr<const Value>;
+
+    /**
+     * @brief 构造函数
+     * @param capacity 最大条目数量
+     * @param maxCost 最大总开销，0表示不限制
+     */
+    explicit LruCache(size_t capacity, size_t maxCost = 0) : capacity_(capacity), maxCost_(maxCost) {}
+
+    // 禁止拷贝
+    LruCache(const LruCache &) = delete;
+    LruCache &operator=(const LruCache &) = delete;
+
+    /**
+     * @brief 查找缓存条目，命中时将其移到最近使用位置
+     * @param key 键
+     * @return 命中返回缓存值，未命中返回nullptr
+     */
+    ValuePtr get(const Key &key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            return nullptr;
+        }
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return it->second->value;
+    }
+
+    /**
+     * @brief 写入缓存条目，超出容量或总开销时淘汰最久未使用的条目
+     * 单个条目的开销超过总开销上限时不保留，但仍返回写入的值
+     * @param key 键
+     * @param value 值
+     * @param cost 条目开销
+     * @return 写入后的缓存值
+     */
+    ValuePtr put(const Key &key, Value value, size_t cost = 0) {
+        auto ptr = std::make_shared<const Value>(std::move(value));
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (maxCost_ > 0 && cost > maxCost_) {
+            // 放不下的条目不挤掉其他条目
+            if (it != index_.end()) {
+                totalCost_ -= it->second->cost;
+                entries_.erase(it->second);
+                index_.erase(it);
+            }
+            return ptr;
+        }
+        if (it != index_.end()) {
+            totalCost_ = totalCost_ - it->second->cost + cost;
+            it->second->value = ptr;
+            it->second->cost = cost;
+            entries_.splice(entries_.begin(), entries_, it->second);
+        } else {
+            entries_.push_front({key, ptr, cost});
+            index_.emplace(key, entries_.begin());
+            totalCost_ += cost;
+        }
+        evictLocked(capacity_);
+        return ptr;
+    }
+
+    /**
+     * @brief 删除缓存条目
+     * @param key 键
+     */
+    void erase(const Key &key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            return;
+        }
+        totalCost_ -= it->second->cost;
+        entries_.erase(it->second);
+        index_.erase(it);
+    }
+
+    /**
+     * @brief 淘汰条目直到数量不超过 keep
+     * @param keep 保留的条目数量
+     */
+    void trim(size_t keep) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        evictLocked(keep);
+    }
+
+    /**
+     * @brief 设置最大总开销，超出时立即淘汰
+     * @param maxCost 最大总开销，0表示不限制
+     */
+    void setMaxCost(size_t maxCost) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        maxCost_ = maxCost;
+        evictLocked(capacity_);
+    }
+
+    /**
+     * @brief 清空缓存
+     */
+    void clear() { trim(0); }
+
+    /**
+     * @brief 获取当前条目数量
+     * @return 条目数量
+     */
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return index_.size();
+    }
+
+    /**
+     * @brief 获取当前总开销
+     * @return 所有条目开销之和
+     */
+    size_t cost() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return totalCost_;
+    }
+
+private:
+    struct Entry {
+        Key key;        ///< 键
+        ValuePtr value; ///< 缓存值
+        size_t cost;    ///< 写入时给出的开销
+    };
+
+    size_t capacity_;                                                   ///< 最大条目数量
+    size_t maxCost_;                                                    ///< 最大总开销，0表示不限制
+    size_t totalCost_ = 0;                                              ///< 当前总开销
+    std::list<Entry> entries_;                                          ///< 按使用时间排序的条目
+    std::unordered_map<Key, typename std::list<Entry>::iterator> index_; ///< 键到条目的索引
+    mutable std::mutex mutex_;                                          ///< 保护以上成员
+
+    void evictLocked(size_t keep) {
+        while (!entries_.empty() && (index_.size() > keep || (maxCost_ > 0 && totalCost_ > maxCost_))) {
+            totalCost_ -= entries_.back().cost;
+            index_.erase(entries_.back().key);
+            entries_.pop_back();
+        }
+    }
+};
+
+#endif // HIGIT_LRU_CACHE_H
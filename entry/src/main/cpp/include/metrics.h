@@ -0,0 +1,152 @@
+#ifndef HIGIT_METRICS_H
+#define HIGIT_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 常驻的性能指标
+ * 按操作记录耗时直方图（对数分桶，每个2的幂区间再分16档，相对误差约6%），
+ * 并统计各结果缓存的命中与未命中、传给 JS 的字节数和加载的对象数，导出时给出 p50/p90/p99。
+ *
+ * 每个线程写自己的分片，记录时没有锁和原子读改写；导出时汇总所有分片，
+ * 线程退出后分片保留，数据不丢失
+ */
+class Metrics {
+public:
+    /**
+     * @brief 记录耗时的操作
+     */
+    enum class Operation {
+        History,       ///< 提交历史分页
+        FileTree,      ///< 文件树
+        ReadFile,      ///< 读取文件
+        CommitChanges, ///< 提交变更列表
+        Fetch,         ///< 拉取
+        LsRemote,      ///< 列出远程引用
+        Count,
+    };
+
+    /**
+     * @brief 统计命中率的结果缓存
+     */
+    enum class Cache {
+        History,   ///< 提交历史
+        Changes,   ///< 提交变更
+        FileTree,  ///< 文件树
+        PathIndex, ///< 文件查找索引
+        Search,    ///< 代码搜索
+        Blame,     ///< Blame
+        Count,
+    };
+
+    /**
+     * @brief 累加计数
+     */
+    enum class Counter {
+        MarshalledBytes,       ///< 以字符串传给 JS 的字节数
+        MarshalledBinaryBytes, ///< 以 ArrayBuffer 传给 JS 的字节数
+        ObjectsLoaded,         ///< 读取的提交、树和文件对象数
+        Count,
+    };
+
+    /**
+     * @brief 获取进程唯一的指标注册表
+     * @return 注册表引用
+     */
+    static Metrics &Shared();
+
+    // 禁止拷贝
+    Metrics(const Metrics &) = delete;
+    Metrics &operator=(const Metrics &) = delete;
+
+    /**
+     * @brief 记录一次操作耗时
+     * @param operation 操作
+     * @param micros 耗时（微秒）
+     */
+    void recordLatency(Operation operation, uint64_t micros);
+
+    /**
+     * @brief 记录一次缓存查询
+     * @param cache 缓存
+     * @param hit 是否命中
+     */
+    void recordCache(Cache cache, bool hit);
+
+    /**
+     * @brief 累加计数
+     * @param counter 计数项
+     * @param value 增量
+     */
+    void add(Counter counter, uint64_t value = 1);
+
+    /**
+     * @brief 汇总所有分片
+     * @return JSON，包含各操作的次数、平均值、分位数和最大值（微秒），各缓存的命中数和计数项
+     */
+    std::string exportJson() const;
+
+private:
+    static constexpr size_t SUB_BUCKET_BITS = 4;                  // 每个2的幂区间分 2^4 档
+    static constexpr size_t SUB_BUCKETS = 1U << SUB_BUCKET_BITS;
+    static constexpr size_t MAX_EXPONENT = 36;                    // 上限约 19 小时，超出按上限记
+    static constexpr size_t BUCKETS = SUB_BUCKETS + (MAX_EXPONENT - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+    using Cell = std::atomic<uint64_t>;
+
+    struct Histogram {
+        std::array<Cell, BUCKETS> buckets{};
+        Cell count{0};
+        Cell sum{0};
+        Cell max{0};
+    };
+
+    // 一个线程的分片，只由所属线程写入
+    struct Shard {
+        std::array<Histogram, static_cast<size_t>(Operation::Count)> histograms;
+        std::array<Cell, static_cast<size_t>(Cache::Count) * 2> caches{};
+        std::array<Cell, static_cast<size_t>(Counter::Count)> counters{};
+    };
+
+    Metrics() = default;
+
+    Shard &localShard();
+
+    static size_t BucketIndex(uint64_t value);
+    static uint64_t BucketValue(size_t index);
+
+    mutable std::mutex mutex_;                  ///< 保护分片列表
+    std::vector<std::unique_ptr<Shard>> shards_; ///< 所有线程的分片
+};
+
+/**
+ * @brief 作用域内的操作耗时，析构时记录
+ */
+class MetricsTimer {
+public:
+    explicit MetricsTimer(Metrics::Operation operation)
+        : operation_(operation), start_(std::chrono::steady_clock::now()) {}
+
+    ~MetricsTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        Metrics::Shared().recordLatency(
+            operation_, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+    }
+
+    MetricsTimer(const MetricsTimer &) = delete;
+    MetricsTimer &operator=(const MetricsTimer &) = delete;
+
+private:
+    Metrics::Operation operation_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#endif // HIGIT_METRICS_H
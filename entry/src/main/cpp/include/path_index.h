@@ -0,0 +1,84 @@
+#ifndef HIGIT_PATH_INDEX_H
+#define HIGIT_PATH_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief 文件查找结果结构体
+ */
+struct PathMatch {
+    std::string path;                ///< 文件路径
+    int score;                       ///< 匹配得分，越高越相关
+    std::vector<uint32_t> positions; ///< 命中字符在路径中的字节下标，用于高亮
+};
+
+/**
+ * @brief 文件路径索引
+ * 对完整路径（忽略大小写）建立三元组倒排表，并为每个路径记录字符集掩码：
+ * 查询先用倒排表求交集得到连续匹配的候选，不足时再用掩码过滤其余路径做模糊子序列匹配（评分的路径数有上限）
+ *
+ * 索引与树对象一一对应，构建后只读，可在多个线程中同时查询
+ */
+class PathIndex {
+public:
+    PathIndex() = default;
+
+    /**
+     * @brief 由路径列表构建索引
+     * @param paths 文件路径列表
+     */
+    void build(const std::vector<std::string> &paths);
+
+    /**
+     * @brief 从文件加载索引
+     * @param file 索引文件路径
+     * @return 成功返回true，文件不存在或格式不匹配返回false
+     */
+    bool load(const std::string &file);
+
+    /**
+     * @brief 保存索引到文件
+     * 先写临时文件再重命名，避免并发读取到写了一半的文件
+     * @param file 索引文件路径
+     * @return 成功返回true，失败返回false
+     */
+    bool save(const std::string &file) const;
+
+    /**
+     * @brief 模糊查找文件
+     * @param query 查询内容，空格会被忽略
+     * @param limit 最多返回的结果数量
+     * @return 按得分从高到低排序的结果
+     */
+    std::vector<PathMatch> find(const std::string &query, size_t limit) const;
+
+    /**
+     * @brief 获取索引中的路径数量
+     * @return 路径数量
+     */
+    size_t size() const { return pathOffsets_.empty() ? 0 : pathOffsets_.size() - 1; }
+
+private:
+    std::string pool_;                     ///< 所有路径首尾相接存放
+    std::vector<uint32_t> pathOffsets_;    ///< 第i个路径为 pool_[pathOffsets_[i], pathOffsets_[i+1])
+    std::vector<uint64_t> charMasks_;      ///< 每个路径出现过的字符集合
+    std::vector<uint32_t> trigrams_;       ///< 升序排列的三元组
+    std::vector<uint32_t> postingOffsets_; ///< 第i个三元组的倒排表为 postings_[postingOffsets_[i], postingOffsets_[i+1])
+    std::vector<uint32_t> postings_;       ///< 路径编号，每个倒排表内升序
+
+    std::string_view pathAt(uint32_t id) const {
+        return std::string_view(pool_).substr(pathOffsets_[id], pathOffsets_[id + 1] - pathOffsets_[id]);
+    }
+
+    /**
+     * @brief 求包含查询中所有三元组的路径
+     * @param query 已转为小写的查询
+     * @return 升序的路径编号
+     */
+    std::vector<uint32_t> intersectTrigrams(std::string_view query) const;
+};
+
+#endif // HIGIT_PATH_INDEX_H
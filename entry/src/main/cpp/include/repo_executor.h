@@ -0,0 +1,111 @@
+#ifndef HIGIT_REPO_EXECUTOR_H
+#define HIGIT_REPO_EXECUTOR_H
+
+#include "thread_pool.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief 仓库执行器
+ * 任务分为共享（只读）和独占（写入）两类，按提交顺序调度：相邻的共享任务可以同时运行，
+ * 独占任务要等之前的任务全部结束才开始，运行期间不会有其他任务；只提交独占任务时即为串行执行器
+ *
+ * 执行器不独占线程，有任务可运行时才向线程池投递。每个仓库持有一个执行器，
+ * 同一仓库的读操作可以并行，写操作与其他操作互斥，不同仓库之间互不影响
+ *
+ * 注意：必须通过 Create 创建，由 shared_ptr 管理
+ */
+class RepoExecutor : public std::enable_shared_from_this<RepoExecutor> {
+public:
+    /**
+     * @brief 任务的访问方式
+     */
+    enum class Access {
+        Shared,    ///< 只读，可与其他共享任务并行
+        Exclusive, ///< 写入，与所有任务互斥
+    };
+
+    /**
+     * @brief 创建执行器
+     * @param pool 实际执行任务的线程池
+     * @return 执行器
+     */
+    static std::shared_ptr<RepoExecutor> Create(ThreadPool &pool = ThreadPool::Shared());
+
+    // 禁止拷贝
+    RepoExecutor(const RepoExecutor &) = delete;
+    RepoExecutor &operator=(const RepoExecutor &) = delete;
+
+    /**
+     * @brief 提交任务，立即返回
+     * @param access 访问方式
+     * @param task 任务函数
+     */
+    void submit(Access access, std::function<void()> task);
+
+    /// 同步调用等待准入的最长时间
+    static constexpr std::chrono::milliseconds SYNC_WAIT{200};
+
+    /**
+     * @brief 在调用线程上执行任务
+     * 准入条件：共享任务只要求没有独占任务正在运行，可以排到已排队的独占任务之前；
+     * 独占任务要求队列为空且执行器空闲。最多等待 wait，仍不能准入时不执行，返回false。任务抛出的异常直接传给调用方
+     * 任务留在调用线程上执行，因此可以在其中调用 JS 回调；在本执行器的任务内调用时直接执行，
+     * 但共享任务内的独占调用无法升级，不执行并返回false
+     *
+     * JS 线程上的同步接口只能用这种方式，且等待时间必须很短：排在前面的任务可能正以阻塞方式向 JS 线程投递数据，
+     * 等待期间它无法继续；线程池线程等待准入则会占住排在前面的任务所需的线程
+     * @param access 访问方式
+     * @param task 任务函数
+     * @param wait 等待准入的最长时间，默认不等待
+     * @return 任务已执行返回true，未能准入时返回false
+     */
+    bool tryRun(Access access, const std::function<void()> &task,
+                std::chrono::milliseconds wait = std::chrono::milliseconds::zero());
+
+    /**
+     * @brief 获取排队中（不含正在执行）的任务数量
+     * @return 任务数量
+     */
+    size_t pending() const;
+
+private:
+    struct Task {
+        Access access;
+        std::function<void()> body;
+    };
+
+    explicit RepoExecutor(ThreadPool &pool) : pool_(pool) {}
+
+    ThreadPool &pool_;                 ///< 线程池
+    mutable std::mutex mutex_;         ///< 保护以下成员
+    std::deque<Task> queue_;           ///< 待执行任务
+    size_t readers_ = 0;               ///< 正在执行的共享任务数量
+    bool writer_ = false;              ///< 是否有独占任务正在执行
+    std::condition_variable finished_; ///< 有任务结束时通知 tryRun 中等待的调用方
+
+    /**
+     * @brief 从队首开始启动所有可以运行的任务，调用时须持有锁
+     * @param ready 输出需要投递到线程池的任务
+     */
+    void schedule(std::vector<Task> &ready);
+
+    /**
+     * @brief 把任务投递到线程池
+     * @param ready 任务列表
+     */
+    void dispatch(std::vector<Task> &ready);
+
+    /**
+     * @brief 任务结束，释放占用并启动后续任务
+     * @param access 访问方式
+     */
+    void finish(Access access);
+};
+
+#endif // HIGIT_REPO_EXECUTOR_H
@@ -1,6 +1,15 @@
 #ifndef HIGIT_REPO_MANAGER_H
 #define HIGIT_REPO_MANAGER_H
 
+#include "compact_tree.h"
+#include "git_runtime.h"
+#include "lru_cache.h"
+#include "path_index.h"
+#include "repo_executor.h"
+#include "repository_pool.h"
+#include "text_search.h"
+#include "word_diff.h"
+#include <atomic>
 #include <functional>
 #include <git2.h>
 #include <string>
@@ -21,6 +30,17 @@ struct CommitInfo {
     std::vector<std::string> parentIds; ///< 父提交ID列表
 };
 
+/**
+ * @brief 仓库预热结果
+ * 启动时批量打开仓库后返回给首页展示
+ */
+struct WarmUpInfo {
+    std::string branch;              ///< 预加载历史的分支
+    size_t branchCount = 0;          ///< 远程跟踪分支数量
+    size_t tagCount = 0;             ///< 标签数量
+    std::vector<CommitInfo> commits; ///< 第一页提交历史
+};
+
 /**
  * @brief 分支信息结构体
  * 存储Git分支的相关信息
@@ -76,6 +96,160 @@ struct FileContent {
     std::string content; ///< 文件内容
 };
 
+/**
+ * @brief 文件变更信息结构体
+ * 存储某次提交相对第一个父提交的单个文件变更
+ */
+struct FileChange {
+    std::string path;    ///< 变更后的文件路径
+    std::string oldPath; ///< 变更前的文件路径（重命名/复制时与path不同）
+    char status;         ///< 变更状态（A新增/D删除/M修改/R重命名/C复制/T类型变化）
+    int similarity;      ///< 重命名/复制的相似度（0-100）
+    size_t additions;    ///< 新增行数
+    size_t deletions;    ///< 删除行数
+    bool isBinary;       ///< 是否为二进制文件
+    bool tooLarge;       ///< 文件超过 MAX_DIFF_BLOB_BYTES，未统计增删行数
+    std::string oldId;   ///< 变更前的blob ID
+    std::string newId;   ///< 变更后的blob ID
+};
+
+/// 参与行级diff的文件大小上限（两侧之和），超过的文件不统计行数、不生成补丁
+constexpr size_t MAX_DIFF_BLOB_BYTES = 16 * 1024 * 1024;
+
+/**
+ * @brief 补丁生成选项
+ */
+struct PatchOptions {
+    uint32_t contextLines = 3;                 ///< 上下文行数
+    size_t maxBytes = 1024 * 1024;             ///< 输出的补丁内容上限，超过后截断
+    size_t chunkBytes = 32 * 1024;             ///< 每次回调输出的内容大小
+    size_t maxBlobBytes = MAX_DIFF_BLOB_BYTES; ///< 参与diff的文件大小上限，超过则不计算补丁
+    bool wordDiff = true;                      ///< 是否计算行内单词级高亮
+};
+
+/**
+ * @brief 补丁行结构体
+ */
+struct PatchLine {
+    char origin;                            ///< 行类型（' '上下文/'+'新增/'-'删除）
+    int oldLineno;                          ///< 旧文件行号，新增行为-1
+    int newLineno;                          ///< 新文件行号，删除行为-1
+    std::string content;                    ///< 行内容（不含换行符）
+    std::vector<HighlightRange> highlights; ///< 行内单词级高亮区间
+};
+
+/**
+ * @brief 补丁块结构体
+ */
+struct PatchHunk {
+    std::string header;           ///< 块头（@@ -a,b +c,d @@ ...）
+    int oldStart;                 ///< 旧文件起始行
+    int oldLines;                 ///< 旧文件行数
+    int newStart;                 ///< 新文件起始行
+    int newLines;                 ///< 新文件行数
+    std::vector<PatchLine> lines; ///< 块内的行
+};
+
+/**
+ * @brief 补丁摘要结构体
+ * 在补丁全部输出后描述整体情况
+ */
+struct PatchSummary {
+    bool exists = false;    ///< 文件在该提交中是否有变更
+    bool isBinary = false;  ///< 是否为二进制文件
+    bool tooLarge = false;  ///< 文件过大，未计算补丁
+    bool truncated = false; ///< 输出达到上限被截断
+    std::string oldPath;    ///< 旧文件路径
+    std::string path;       ///< 新文件路径
+    size_t hunkCount = 0;   ///< 已输出的块数量
+    size_t bytes = 0;       ///< 已输出的内容字节数
+    size_t additions = 0;   ///< 新增行数
+    size_t deletions = 0;   ///< 删除行数
+};
+
+/**
+ * @brief 补丁分块输出回调
+ * @param hunks 本次输出的补丁块
+ * @return 返回false时停止输出
+ */
+using PatchChunkCallback = std::function<bool(const std::vector<PatchHunk> &hunks)>;
+
+/**
+ * @brief 代码搜索选项
+ */
+struct SearchOptions {
+    bool isRegex = false;              ///< 是否为正则表达式
+    bool caseSensitive = true;         ///< 是否区分大小写
+    size_t maxResults = 2000;          ///< 匹配行总数上限，超过后停止搜索
+    size_t maxLinesPerFile = 200;      ///< 单个文件的匹配行数上限
+    size_t maxFileBytes = 1024 * 1024; ///< 参与搜索的文件大小上限
+    size_t batchFiles = 32;            ///< 每次回调输出的文件数量
+};
+
+/**
+ * @brief 单个文件的搜索结果
+ */
+struct FileSearchResult {
+    std::string path;               ///< 文件路径
+    std::string blobId;             ///< 文件的blob ID
+    std::vector<LineMatch> matches; ///< 匹配的行
+};
+
+/**
+ * @brief 搜索摘要结构体
+ */
+struct SearchSummary {
+    size_t filesTotal = 0;    ///< 树中的文件总数
+    size_t filesScanned = 0;  ///< 实际读取并搜索的文件数
+    size_t filesMatched = 0;  ///< 有匹配的文件数
+    size_t matchCount = 0;    ///< 匹配行总数
+    size_t cacheHits = 0;     ///< 命中缓存的文件数
+    size_t skippedBinary = 0; ///< 跳过的二进制文件数
+    size_t skippedLarge = 0;  ///< 跳过的过大文件数
+    bool truncated = false;   ///< 达到 maxResults 或被回调中止
+};
+
+/**
+ * @brief 搜索结果分批输出回调
+ * @param results 本次输出的文件搜索结果
+ * @return 返回false时停止搜索
+ */
+using SearchResultCallback = std::function<bool(const std::vector<FileSearchResult> &results)>;
+
+/**
+ * @brief Blame块结构体
+ * 最终文件中一段连续的、由同一提交最后修改的行
+ */
+struct BlameHunk {
+    uint32_t startLine;   ///< 起始行号（从1开始）
+    uint32_t lineCount;   ///< 行数
+    std::string commitId; ///< 最后修改这些行的提交ID
+    std::string author;   ///< 作者名称
+    std::string email;    ///< 作者邮箱
+    long long timestamp;  ///< 提交时间戳
+    std::string summary;  ///< 简短提交信息
+    std::string path;     ///< 该提交中的文件路径（重命名前的路径）
+    bool boundary;        ///< 是否到达历史边界（根提交或浅克隆的最早提交）
+};
+
+/**
+ * @brief Blame摘要结构体
+ */
+struct BlameSummary {
+    bool cached = false;       ///< 结果是否来自缓存
+    bool cancelled = false;    ///< 是否被取消
+    size_t commitsVisited = 0; ///< 遍历的提交数量
+    size_t lineCount = 0;      ///< 文件总行数
+    size_t hunkCount = 0;      ///< 已输出的块数量
+};
+
+/**
+ * @brief Blame分批输出回调
+ * @param hunks 本次输出的Blame块
+ * @return 返回false时停止
+ */
+using BlameChunkCallback = std::function<bool(const std::vector<BlameHunk> &hunks)>;
+
 /**
  * @brief Git仓库管理类
  * 封装了libgit2库的常用操作，提供简化的接口来管理Git仓库
@@ -83,7 +257,7 @@ struct FileContent {
  * 使用说明：
  * 1. 创建RepoManager实例
  * 2. 使用openRepository()打开现有仓库或createRepository()创建新仓库
- * 3. 使用connectRemote()连接到远程仓库
+ * 3. 使用openLocal()配置远程地址，需要网络的操作（fetch、获取远程分支等）各自建立连接
  * 4. 使用getCommitHistory()获取提交历史等操作
  *
  * 注意：该类不支持拷贝构造和赋值操作
@@ -92,13 +266,13 @@ class RepoManager {
 public:
     /**
      * @brief 构造函数
-     * 初始化libgit2库
+     * 确保进程级的 libgit2 运行时已初始化
      */
     RepoManager();
 
     /**
      * @brief 析构函数
-     * 释放所有资源并关闭libgit2库
+     * 释放所有资源，libgit2 由运行时管理，不在这里关闭
      */
     ~RepoManager();
 
@@ -121,9 +295,25 @@ public:
      */
     bool createRepository(const std::string &path, bool isBare = false);
 
+    /**
+     * @brief 打开本地仓库并配置远程地址，不访问网络
+     * 如果本地路径已存在仓库则打开，否则创建新的裸仓库；离线时也能立即完成
+     * @param url 远程仓库URL
+     * @param localPath 本地仓库路径
+     * @return 成功返回true，失败返回false
+     */
+    bool openLocal(const std::string &url, const std::string &localPath);
+
+    /**
+     * @brief 连接到 origin 远程仓库，已连接时直接返回
+     * 会进行网络握手，只在确实需要保持连接时调用
+     * @return 成功返回true，失败返回false
+     */
+    bool connect();
+
     /**
      * @brief 连接到远程Git仓库
-     * 如果本地路径已存在仓库则打开，否则创建新仓库并添加远程连接
+     * 等同于 openLocal() 后再 connect()
      * @param url 远程仓库URL
      * @param localPath 本地仓库路径
      * @return 成功返回true，失败返回false
@@ -170,34 +360,38 @@ public:
 
     /**
      * @brief 获取远程分支列表
+     * @param branches 输出的分支信息列表，远程没有分支时为空
      * @param remoteName 远程仓库名称，默认为"origin"
-     * @return 分支信息列表
+     * @return 是否成功，失败时错误信息见 getLastError
      */
-    std::vector<BranchInfo> getRemoteBranches(const std::string &remoteName = "origin");
+    bool getRemoteBranches(std::vector<BranchInfo> &branches, const std::string &remoteName = "origin");
 
     /**
      * @brief 获取远程标签列表
+     * @param tags 输出的标签信息列表，远程没有标签时为空
      * @param remoteName 远程仓库名称，默认为"origin"
-     * @return 标签信息列表
+     * @return 是否成功，失败时错误信息见 getLastError
      */
-    std::vector<TagInfo> getRemoteTags(const std::string &remoteName = "origin");
+    bool getRemoteTags(std::vector<TagInfo> &tags, const std::string &remoteName = "origin");
 
     /**
      * @brief 获取提交历史记录
+     * @param commits 输出的提交信息列表
      * @param branch 分支名称或提交ID，默认为"HEAD"
      * @param count 获取的提交数量，默认为50
-     * @return 提交信息列表
+     * @return 是否成功，失败时错误信息见 getLastError
      */
-    std::vector<CommitInfo> getCommitHistory(const std::string &branch = "HEAD", int count = 50);
+    bool getCommitHistory(std::vector<CommitInfo> &commits, const std::string &branch = "HEAD", int count = 50);
 
     /**
      * @brief 获取提交历史记录（分页版本）
-     * @param branch 分支名称或提交ID，默认为"HEAD"
+     * @param commits 输出的提交信息列表，偏移超出历史长度时为空
+     * @param branch 分支名称或提交ID
      * @param count 获取的提交数量
      * @param offset 偏移量（跳过的提交数量）
-     * @return 提交信息列表
+     * @return 是否成功，失败时错误信息见 getLastError
      */
-    std::vector<CommitInfo> getCommitHistory(const std::string &branch, int count, int offset);
+    bool getCommitHistory(std::vector<CommitInfo> &commits, const std::string &branch, int count, int offset);
 
     /**
      * @brief 获取特定提交的详细信息
@@ -206,6 +400,95 @@ public:
      */
     CommitInfo getCommitDetails(const std::string &commitId);
 
+    /**
+     * @brief 获取提交相对第一个父提交的文件变更
+     * 包含重命名/复制检测和逐文件的增删行数，结果按提交ID缓存
+     * @param commitId 提交ID或分支名称
+     * @param changes 输出的文件变更列表
+     * @return 是否成功，失败时错误信息见 getLastError
+     */
+    bool getCommitChanges(const std::string &commitId, std::vector<FileChange> &changes);
+
+    /**
+     * @brief 生成提交中单个文件的统一格式补丁
+     * 补丁块按 chunkBytes 分批通过回调输出，达到 maxBytes 后截断；行内高亮只对实际输出的块计算
+     * @param commitId 提交ID
+     * @param path 文件路径（提交后的路径）
+     * @param options 补丁生成选项
+     * @param onChunk 分块输出回调
+     * @param summary 补丁摘要（输出）
+     * @return 成功返回true，失败返回false
+     */
+    bool getFilePatch(const std::string &commitId, const std::string &path, const PatchOptions &options,
+                      const PatchChunkCallback &onChunk, PatchSummary &summary);
+
+    /**
+     * @brief 在指定分支/提交的文件树中搜索代码
+     * 文件在线程池中并行读取和匹配，结果按 batchFiles 分批通过回调输出；
+     * 同一blob的匹配结果按内容ID缓存，切换分支后未变化的文件不会重复搜索
+     * @param ref 分支名称或提交ID
+     * @param pattern 搜索内容
+     * @param options 搜索选项
+     * @param onResults 分批输出回调，可能在工作线程中调用，但不会并发调用
+     * @param summary 搜索摘要（输出）
+     * @return 成功返回true，失败返回false
+     */
+    bool searchTree(const std::string &ref, const std::string &pattern, const SearchOptions &options,
+                    const SearchResultCallback &onResults, SearchSummary &summary);
+
+    /**
+     * @brief 按文件路径模糊查找文件
+     * 路径索引按树对象ID在首次查询时构建，并持久化到仓库目录下供之后复用
+     * @param ref 分支名称或提交ID
+     * @param query 查询内容
+     * @param limit 最多返回的结果数量
+     * @return 按相关度排序的查找结果
+     */
+    std::vector<PathMatch> findFiles(const std::string &ref, const std::string &query, size_t limit);
+
+    /**
+     * @brief 逐步计算文件的Blame信息
+     * 按提交时间从新到旧遍历历史，每个提交确定下来的行立即通过回调输出，因此较新的修改最先返回；
+     * 合并提交的每个父提交都会比较：与某个父提交相同的行交给该父提交继续追溯，因此合并进来的修改归属于
+     * 分支上的原始提交，只有与所有父提交都不同的行（解决冲突时的改动）才归属于合并提交。
+     * 重命名只沿第一父提交检测。完整结果按(提交ID, 路径)缓存
+     * @param ref 分支名称或提交ID
+     * @param path 文件路径
+     * @param onChunk 分批输出回调
+     * @param summary Blame摘要（输出）
+     * @return 成功（含被取消）返回true，失败返回false
+     */
+    bool blameFile(const std::string &ref, const std::string &path, const BlameChunkCallback &onChunk,
+                   BlameSummary &summary);
+
+    /**
+     * @brief 取消当前仓库所有进行中的Blame
+     * 可在任意线程调用，进行中的 blameFile 会在处理完当前提交后返回
+     */
+    void cancelBlame();
+
+    /**
+     * @brief 预热仓库：读取本地引用并把默认分支的第一页历史加载到缓存
+     * 只读本地数据，不访问网络；默认分支依次取 origin/HEAD、main、master、第一个分支
+     * @param pageSize 第一页的提交数量，与详情页的分页大小一致时后续请求直接命中缓存
+     * @return 预热结果
+     */
+    WarmUpInfo warmUp(int pageSize);
+
+    /**
+     * @brief 按内存压力级别清理结果缓存
+     * 可在任意线程调用；Low 及以上还会释放空闲的只读句柄
+     * @param level 内存压力级别
+     */
+    void trimCaches(GitRuntime::MemoryLevel level);
+
+    /**
+     * @brief 释放主句柄的对象缓存
+     * 重新打开主句柄并丢弃池中的空闲句柄，之后租用的句柄共享新主句柄的对象库；
+     * 会更换主句柄，须以独占方式在执行器上调用
+     */
+    void releaseObjectCache();
+
     /**
      * @brief 获取本地分支列表
      * @return 分支信息列表
@@ -241,6 +524,16 @@ public:
      */
     std::vector<FileTreeNode> getBranchFileTree(const std::string &branch = "HEAD", const std::string &rootPath = "");
 
+    /**
+     * @brief 获取指定分支的紧凑文件树
+     * 结果按树对象ID缓存，同一棵树重复获取不会再次遍历
+     * @param branch 分支名称或提交ID，默认为"HEAD"
+     * @param rootPath 根路径，默认为空（仓库根目录）
+     * @return 紧凑文件树，失败返回nullptr
+     */
+    std::shared_ptr<const CompactFileTree> getCompactFileTree(const std::string &branch = "HEAD",
+                                                              const std::string &rootPath = "");
+
     /**
      * @brief 获取远程仓库URL
      * @param remoteName 远程仓库名称，默认为"origin"
@@ -262,6 +555,7 @@ public:
 
     /**
      * @brief 获取最后的错误信息
+     * 错误信息按线程保存，并行的只读操作互不覆盖，须在执行操作的线程上获取
      * @return 错误信息字符串
      */
     std::string getLastError() const;
@@ -280,14 +574,51 @@ public:
      */
     FileContent readFile(const std::string &branch = "HEAD", const std::string &path = "");
 
+    /**
+     * @brief 获取仓库的执行器
+     * 除 cancelBlame 外的所有操作都应通过它执行：查询类操作以共享方式提交，各自租用句柄并行执行；
+     * fetch、打开仓库等会修改仓库或主句柄的操作以独占方式提交
+     * @return 执行器
+     */
+    const std::shared_ptr<RepoExecutor> &executor() const { return executor_; }
+
 private:
+    /**
+     * @brief 只读操作的作用域
+     * 从句柄池租用一个句柄，作用域内本线程通过 repo() 取到的都是该句柄；嵌套时沿用外层的句柄
+     */
+    class ReadScope {
+    public:
+        explicit ReadScope(const RepoManager &manager);
+        ~ReadScope();
+
+        ReadScope(const ReadScope &) = delete;
+        ReadScope &operator=(const ReadScope &) = delete;
+
+    private:
+        bool owner_ = false;           ///< 是否由本作用域租用句柄
+        RepositoryPool::Lease lease_;  ///< 租用的句柄
+        const RepoManager *previous_;  ///< 外层作用域所属的仓库
+        git_repository *previousRepo_; ///< 外层作用域的句柄
+    };
+
     // 私有成员变量
-    git_repository *repository_; ///< Git仓库对象
+    git_repository *repository_; ///< Git仓库对象（主句柄），只在独占访问时直接使用
     git_remote *remote_;         ///< 远程仓库对象
-    std::string lastError_;      ///< 最后错误信息
     std::string remoteUrl_;      ///< 远程仓库URL
     std::string repoPath_;       ///< 本地仓库路径
 
+    std::shared_ptr<RepoExecutor> executor_ = RepoExecutor::Create(); ///< 调度本仓库的操作
+    mutable RepositoryPool handles_{4};                               ///< 只读句柄池，共享主句柄的对象库
+
+    LruCache<std::string, std::vector<CommitInfo>> historyCache_{16}; ///< 分页历史缓存，键为起点提交ID+数量+偏移
+    LruCache<std::string, std::vector<FileChange>> changesCache_{64}; ///< 提交变更缓存，键为提交ID
+    LruCache<std::string, std::vector<LineMatch>> searchCache_{8192}; ///< 搜索结果缓存，键为匹配器标识+blob ID，另按字节数限制
+    LruCache<std::string, PathIndex> pathIndexCache_{4};              ///< 路径索引缓存，键为树对象ID
+    LruCache<std::string, CompactFileTree> fileTreeCache_{4};         ///< 文件树缓存，键为树对象ID+根路径
+    LruCache<std::string, std::vector<BlameHunk>> blameCache_{32};    ///< Blame结果缓存，键为提交ID+路径
+    std::atomic<uint64_t> blameGeneration_{0};                        ///< 每次取消时递增，进行中的Blame据此判断是否取消
+
     // 辅助方法
     /**
      * @brief 设置错误信息
@@ -324,15 +655,55 @@ private:
     void freeResources();
 
     /**
-     * @brief 递归遍历Git树对象，构建文件树结构
+     * @brief 获取当前线程应使用的仓库句柄
+     * 在 ReadScope 内返回租用的句柄，否则返回主句柄
+     * @return 仓库句柄
+     */
+    git_repository *repo() const;
+
+    /**
+     * @brief 遍历Git树对象，构建紧凑文件树
+     * 使用显式栈迭代遍历，文件大小只读取对象头，不解压文件内容
      * @param tree Git树对象
-     * @param basePath 基础路径
-     * @param parentId 父节点ID
-     * @param nextId 下一个可用的节点ID（引用传递）
-     * @param fileTree 文件树列表（引用传递）
+     * @param fileTree 紧凑文件树（输出）
+     * @return 成功返回true，失败返回false
+     */
+    bool buildCompactTree(git_tree *tree, CompactFileTree &fileTree);
+
+    /**
+     * @brief 统计文件变更的增删行数
+     * 只读取blob原始内容做行级diff，可在工作线程中并行调用；先读对象头判断大小，超过 MAX_DIFF_BLOB_BYTES 的不解压
+     * 工作线程不在 ReadScope 内，不能使用 repo()，所有读取都经过 odb
+     * @param change 文件变更（additions/deletions/isBinary/tooLarge会被填充）
+     * @param odb 对象数据库，由调用方在并行之前取得
+     * @param oldId 变更前的blob ID
+     * @param newId 变更后的blob ID
+     */
+    void countChangedLines(FileChange &change, git_odb *odb, const git_oid &oldId, const git_oid &newId);
+
+    /**
+     * @brief 按提交和路径查找blob对象
+     * @param blob 输出的blob对象，由调用方释放
+     * @param commit 提交对象
+     * @param path 文件路径
+     * @param errorCode 失败时输出的错误码（可选），文件不存在时为GIT_ENOTFOUND
+     * @return 成功返回true，失败返回false（已设置错误信息）
+     */
+    bool lookupBlobByPath(git_blob **blob, git_commit *commit, const std::string &path, int *errorCode = nullptr);
+
+    /**
+     * @brief 获取树对象的路径索引
+     * 依次查找内存缓存、磁盘上的索引文件，都没有时遍历树构建并保存
+     * @param tree 树对象
+     * @return 路径索引，失败返回nullptr
+     */
+    std::shared_ptr<const PathIndex> loadPathIndex(git_tree *tree);
+
+    /**
+     * @brief 为补丁块中成对的删除/新增行计算单词级高亮
+     * @param hunk 补丁块
      */
-    void traverseTree(git_tree *tree, const std::string &basePath, int parentId, int &nextId,
-                      std::vector<FileTreeNode> &fileTree);
+    static void highlightHunk(PatchHunk &hunk);
 
     /**
      * @brief 获取错误分类的描述
@@ -0,0 +1,106 @@
+#ifndef HIGIT_REPOSITORY_POOL_H
+#define HIGIT_REPOSITORY_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <git2.h>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief 只读仓库句柄池
+ * git_repository 不能被多个线程同时使用，池中的句柄各自打开同一仓库，但共享主句柄的对象库（ODB），
+ * 打包文件索引和映射窗口只有一份；只读请求各租用一个句柄即可在多个核心上并行执行
+ *
+ * 句柄在首次需要时创建，数量达到上限后租用方等待归还
+ *
+ * 注意：该类不支持拷贝构造和赋值操作
+ */
+class RepositoryPool {
+public:
+    /**
+     * @brief 租用的句柄，析构时归还
+     */
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease &&other) noexcept;
+        Lease &operator=(Lease &&other) noexcept;
+        ~Lease();
+
+        Lease(const Lease &) = delete;
+        Lease &operator=(const Lease &) = delete;
+
+        git_repository *get() const { return handle_; }
+
+    private:
+        friend class RepositoryPool;
+        Lease(RepositoryPool *pool, git_repository *handle, size_t generation)
+            : pool_(pool), handle_(handle), generation_(generation) {}
+
+        RepositoryPool *pool_ = nullptr;   ///< 所属的池
+        git_repository *handle_ = nullptr; ///< 租用的句柄
+        size_t generation_ = 0;            ///< 租用时主句柄的代数
+    };
+
+    /**
+     * @brief 构造函数
+     * @param maxHandles 句柄数量上限
+     */
+    explicit RepositoryPool(size_t maxHandles);
+
+    /**
+     * @brief 析构函数
+     * 释放所有空闲句柄，调用时不能有未归还的租用
+     */
+    ~RepositoryPool();
+
+    // 禁止拷贝
+    RepositoryPool(const RepositoryPool &) = delete;
+    RepositoryPool &operator=(const RepositoryPool &) = delete;
+
+    /**
+     * @brief 租用一个与主句柄共享对象库的句柄
+     * 主句柄变化（重新打开仓库）后，旧的空闲句柄会被丢弃
+     * @param primary 主句柄
+     * @return 租用的句柄，打开失败时 get() 为空
+     */
+    Lease acquire(git_repository *primary);
+
+    /**
+     * @brief 释放所有空闲句柄
+     * 在释放主句柄之前调用
+     */
+    void clear();
+
+private:
+    size_t maxHandles_;                   ///< 句柄数量上限
+    std::mutex mutex_;                    ///< 保护以下成员
+    std::condition_variable cv_;          ///< 句柄归还通知
+    std::vector<git_repository *> idle_;  ///< 空闲句柄
+    size_t created_ = 0;                  ///< 当前代已创建（含租出）的句柄数量
+    size_t generation_ = 0;               ///< 主句柄代数，每次更换主句柄递增
+    git_repository *primary_ = nullptr;   ///< 当前代的主句柄
+
+    /**
+     * @brief 为主句柄打开一个新句柄并共享其对象库
+     * @param primary 主句柄
+     * @return 新句柄，失败返回空
+     */
+    static git_repository *openHandle(git_repository *primary);
+
+    /**
+     * @brief 归还句柄
+     * @param handle 句柄
+     * @param generation 租用时的代数，与当前代不同时直接释放
+     */
+    void release(git_repository *handle, size_t generation);
+
+    /**
+     * @brief 切换到新的主句柄，调用时须持有锁
+     * @param primary 主句柄
+     */
+    void switchPrimary(git_repository *primary);
+};
+
+#endif // HIGIT_REPOSITORY_POOL_H
@@ -1,7 +1,9 @@
 #ifndef HIGIT_SSH_MANAGER_H
 #define HIGIT_SSH_MANAGER_H
 
+#include "credential_provider.h"
 #include <libssh2.h>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -16,11 +18,27 @@ struct mbedtls_ctr_drbg_context;
 struct SSHKeyInfo {
     std::string publicKey;   ///< 公钥内容
     std::string privateKey;  ///< 私钥内容（加密存储）
-    std::string keyType;     ///< 密钥类型（ssh-rsa, ssh-ed25519等）
+    std::string keyType;     ///< 密钥类型（ssh-rsa, ecdsa-sha2-nistp256等）
     std::string comment;     ///< 密钥注释
     std::string fingerprint; ///< 密钥指纹
 };
 
+/**
+ * @brief SSH密钥算法
+ */
+enum class SSHKeyAlgorithm {
+    ECDSA, ///< ecdsa-sha2-nistp256，默认使用
+    RSA,   ///< ssh-rsa，用于只接受RSA密钥的服务器
+};
+
+/**
+ * @brief SSH密钥文件路径
+ */
+struct SSHKeyPaths {
+    std::string privateKey; ///< 私钥文件路径
+    std::string publicKey;  ///< 公钥文件路径
+};
+
 /**
  * @brief SSH管理类
  * 封装了libssh2库的常用操作，提供SSH密钥管理和认证功能
@@ -44,15 +62,52 @@ public:
     SSHManager &operator=(const SSHManager &) = delete;
 
     /**
-     * @brief 生成新的SSH密钥对
-     * @param keyType 密钥类型（"ssh-rsa", "ssh-ed25519"）
-     * @param bits 密钥位数（仅对RSA有效）
+     * @brief 生成新的RSA密钥对
+     * 素数搜索在共享线程池上并行进行，耗时仍以秒计，应在后台线程调用
+     * @param bits 密钥位数
      * @param comment 密钥注释
      * @param passphrase 保护私钥的密码（可选）
      * @return 成功返回true，失败返回false
      */
     bool generateKeyPair(int bits = 4096, const std::string &comment = "", const std::string &passphrase = "");
 
+    /**
+     * @brief 生成新的ECDSA（nistp256）密钥对
+     * 生成只需毫秒级，签名也比RSA-4096快得多；当前libssh2的mbedTLS后端不支持Ed25519，ECDSA是可用的最快密钥类型
+     * @param comment 密钥注释
+     * @param passphrase 保护私钥的密码（可选）
+     * @return 成功返回true，失败返回false
+     */
+    bool generateECDSAKeyPair(const std::string &comment = "", const std::string &passphrase = "");
+
+    /**
+     * @brief 获取认证使用的密钥文件
+     * 优先使用ECDSA密钥，不存在时沿用早期版本生成的RSA密钥
+     * @param sshDir 密钥目录
+     * @param preferred 返回ECDSA密钥路径（即使文件不存在），用于生成新密钥
+     * @return 密钥文件路径
+     */
+    static SSHKeyPaths KeyPaths(const std::string &sshDir, bool preferred = false);
+
+    /**
+     * @brief 指定算法的密钥文件路径
+     * @param sshDir 密钥目录
+     * @param algorithm 密钥算法
+     * @return 密钥文件路径
+     */
+    static SSHKeyPaths KeyPaths(const std::string &sshDir, SSHKeyAlgorithm algorithm);
+
+    /**
+     * @brief 用已写好的临时文件替换密钥对
+     * 先换公钥再换私钥；私钥替换失败时恢复原公钥（原来没有公钥时删除新公钥），原密钥对保持可用。
+     * 临时文件在失败时保留，由调用方删除
+     * @param staged 已写入新密钥的临时文件
+     * @param target 要替换的密钥文件
+     * @param error 失败原因
+     * @return 成功返回true，失败返回false
+     */
+    static bool ReplaceKeyFiles(const SSHKeyPaths &staged, const SSHKeyPaths &target, std::string &error);
+
     /**
      * @brief 从文件加载SSH密钥对
      * @param privateKeyPath 私钥文件路径
@@ -85,6 +140,12 @@ public:
      */
     std::string getPrivateKey() const;
 
+    /**
+     * @brief 当前密钥内容的快照，供凭据提供者缓存
+     * @return 密钥内容，尚未生成或加载时为空
+     */
+    std::shared_ptr<const SSHCredential> credential() const;
+
     /**
      * @brief 获取密钥指纹
      * @return 密钥指纹字符串
@@ -150,8 +211,9 @@ private:
 
     /**
      * @brief 计算密钥指纹
-     * @param publicKey 公钥数据
-     * @return 指纹字符串
+     * 与 ssh-keygen -l 相同：公钥二进制数据的SHA256，Base64编码且去掉填充
+     * @param publicKey OpenSSH格式的公钥
+     * @return 指纹字符串（SHA256:...）
      */
     std::string calculateFingerprint(const std::string &publicKey);
 
@@ -171,8 +233,23 @@ private:
      */
     bool generateRSAKeyPairWithMbedTLS(int bits, const std::string &passphrase);
 
+    /**
+     * @brief 使用mbedtls生成ECDSA（secp256r1）密钥对
+     * @param passphrase 私钥密码
+     * @return 成功返回true，失败返回false
+     */
+    bool generateECDSAKeyPairWithMbedTLS(const std::string &passphrase);
+
+    /**
+     * @brief 保存生成的PEM私钥并把公钥转换为OpenSSH格式、计算指纹
+     * @param pk 已生成的密钥
+     * @return 成功返回true，失败返回false
+     */
+    bool storeGeneratedKey(mbedtls_pk_context &pk);
+
     /**
      * @brief 将PEM格式的公钥转换为OpenSSH格式
+     * 支持RSA和ECDSA（nistp256）公钥
      * @param pemPublicKey PEM格式的公钥内容
      * @param comment 密钥注释
      * @return OpenSSH格式的公钥字符串
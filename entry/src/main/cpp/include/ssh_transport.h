@@ -0,0 +1,28 @@
+#ifndef HIGIT_SSH_TRANSPORT_H
+#define HIGIT_SSH_TRANSPORT_H
+
+/**
+ * @brief 复用已认证会话的SSH传输
+ * 注册为 libgit2 的 ssh:// 传输（scp 形式的地址同样会走到这里），替换其内置实现。
+ * libgit2 每次 ls-remote、fetch、push 都新建一个SSH会话，要重新完成TCP连接、密钥交换和公钥认证；
+ * 这里在操作结束后把已认证的会话按（用户, 主机, 端口）保留一小段时间，
+ * 下一次操作直接在原会话上打开新的 exec 通道，刷新仓库时只需握手一次
+ *
+ * 主机密钥交给 certificate_check 回调确认，认证使用 credentials 回调返回的SSH密钥；
+ * 空闲会话每次只借给一个操作使用（libssh2 会话不能跨线程并发使用）
+ */
+class SshTransport {
+public:
+    /**
+     * @brief 注册为 libgit2 的SSH传输，须在 git_libgit2_init 之后调用一次
+     * @return 成功返回true，失败返回false（此时仍使用 libgit2 内置的SSH传输）
+     */
+    static bool Register();
+
+    /**
+     * @brief 断开所有空闲会话
+     */
+    static void CloseIdleSessions();
+};
+
+#endif // HIGIT_SSH_TRANSPORT_H
@@ -0,0 +1,81 @@
+#ifndef HIGIT_TEXT_SEARCH_H
+#define HIGIT_TEXT_SEARCH_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 单行匹配结果结构体
+ */
+struct LineMatch {
+    uint32_t line;                                      ///< 行号（从1开始）
+    std::vector<std::pair<uint32_t, uint32_t>> columns; ///< 行内匹配区间（字节偏移，左闭右开），只含预览内的部分
+    std::string text;                                   ///< 行内容预览，超长行在字符边界处截断
+};
+
+/**
+ * @brief 文本匹配器
+ * 字面量模式使用SIMD（NEON/SSE2）首尾字节过滤加逐字节校验，正则模式逐行使用 std::regex
+ *
+ * 注意：编译完成后的匹配器是只读的，可在多个线程中同时使用
+ */
+class TextMatcher {
+public:
+    /**
+     * @brief 编译匹配器
+     * @param pattern 搜索模式
+     * @param isRegex 是否为正则表达式
+     * @param caseSensitive 是否区分大小写
+     * @param error 编译失败时的错误信息（输出）
+     * @return 成功返回匹配器，失败返回nullptr
+     */
+    static std::unique_ptr<TextMatcher> compile(const std::string &pattern, bool isRegex, bool caseSensitive,
+                                                std::string &error);
+
+    /**
+     * @brief 在文本中查找所有匹配
+     * @param text 文本内容
+     * @param maxLines 最多返回的匹配行数
+     * @return 按行聚合的匹配结果
+     */
+    std::vector<LineMatch> findAll(std::string_view text, size_t maxLines) const;
+
+    /**
+     * @brief 获取匹配器的唯一标识，用于缓存键
+     * @return 标识字符串
+     */
+    const std::string &key() const { return key_; }
+
+    /**
+     * @brief 在文本中查找字面量首次出现的位置
+     * @param text 文本内容
+     * @param needle 要查找的字面量
+     * @param caseSensitive 是否区分大小写（不区分时仅处理ASCII字母）
+     * @return 匹配位置，未找到返回 std::string_view::npos
+     */
+    static size_t findLiteral(std::string_view text, std::string_view needle, bool caseSensitive);
+
+private:
+    TextMatcher() = default;
+
+    std::string key_;     ///< 缓存标识
+    std::string literal_; ///< 字面量模式
+    bool isRegex_ = false;
+    bool caseSensitive_ = true;
+    std::regex regex_; ///< 正则模式
+
+    /**
+     * @brief 查找一行内的所有匹配区间
+     * @param line 行内容
+     * @param columns 匹配区间（输出）
+     */
+    void matchLine(std::string_view line, std::vector<std::pair<uint32_t, uint32_t>> &columns) const;
+};
+
+#endif // HIGIT_TEXT_SEARCH_H
@@ -0,0 +1,75 @@
+#ifndef HIGIT_THREAD_POOL_H
+#define HIGIT_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 固定大小的工作线程池
+ * 用于把可拆分的 libgit2 计算（逐文件统计、搜索等）分摊到多个核心上
+ *
+ * 注意：该类不支持拷贝构造和赋值操作
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief 构造函数
+     * @param threadCount 工作线程数量，为0时按CPU核心数决定
+     */
+    explicit ThreadPool(size_t threadCount = 0);
+
+    /**
+     * @brief 析构函数
+     * 等待队列中的任务执行完毕并回收所有线程
+     */
+    ~ThreadPool();
+
+    // 禁止拷贝
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * @brief 获取进程共享的线程池
+     * @return 线程池引用
+     */
+    static ThreadPool &Shared();
+
+    /**
+     * @brief 提交一个任务
+     * @param task 任务函数
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief 并行执行 [0, count) 范围内的任务，返回时全部任务已完成
+     * 调用线程也会参与执行，因此在线程池线程内调用也不会死锁
+     * @param count 任务数量
+     * @param body 任务函数，参数为任务下标
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)> &body);
+
+    /**
+     * @brief 获取工作线程数量
+     * @return 线程数量
+     */
+    size_t size() const { return workers_.size(); }
+
+private:
+    std::vector<std::thread> workers_;        ///< 工作线程
+    std::deque<std::function<void()>> tasks_; ///< 待执行任务队列
+    std::mutex mutex_;                        ///< 保护任务队列
+    std::condition_variable cv_;              ///< 任务到达通知
+    bool stopping_;                           ///< 是否正在停止
+
+    /**
+     * @brief 工作线程主循环
+     */
+    void workerLoop();
+};
+
+#endif // HIGIT_THREAD_POOL_H
@@ -0,0 +1,80 @@
+#ifndef HIGIT_TLS_SESSION_CACHE_H
+#define HIGIT_TLS_SESSION_CACHE_H
+
+#include "lru_cache.h"
+#include <chrono>
+#include <cstddef>
+#include <mbedtls/ssl.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief TLS会话缓存
+ * 按对端（主机:端口）保存最近一次校验通过的会话，下次连接同一主机时恢复会话（session ID 或 session ticket），
+ * 服务器接受时省去一个往返和证书链的非对称运算。会话以序列化形式保存，可在不同线程的连接之间共享；
+ * 超过有效期或超出容量的条目被丢弃
+ */
+class TlsSessionCache {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief 构造函数
+     * @param capacity 最多缓存的对端数量
+     * @param ttl 会话有效期
+     */
+    TlsSessionCache(size_t capacity, Clock::duration ttl);
+
+    // 禁止拷贝
+    TlsSessionCache(const TlsSessionCache &) = delete;
+    TlsSessionCache &operator=(const TlsSessionCache &) = delete;
+
+    /**
+     * @brief 获取进程共享的会话缓存
+     * @return 会话缓存引用
+     */
+    static TlsSessionCache &Shared();
+
+    /**
+     * @brief 把缓存的会话设置到即将握手的连接上
+     * @param peer 对端标识
+     * @param ssl 尚未握手的连接
+     * @return 设置了缓存会话返回true，没有可用会话返回false
+     */
+    bool restore(const std::string &peer, mbedtls_ssl_context *ssl);
+
+    /**
+     * @brief 保存握手完成的连接的会话
+     * @param peer 对端标识
+     * @param ssl 握手完成且证书校验通过的连接
+     */
+    void store(const std::string &peer, const mbedtls_ssl_context *ssl);
+
+    /**
+     * @brief 删除对端的缓存会话，握手失败时调用
+     * @param peer 对端标识
+     */
+    void remove(const std::string &peer);
+
+    /**
+     * @brief 清空缓存
+     */
+    void clear();
+
+    /**
+     * @brief 当前缓存的对端数量
+     * @return 条目数量
+     */
+    size_t size() const;
+
+private:
+    struct Entry {
+        std::vector<unsigned char> session; ///< mbedtls_ssl_session_save 序列化的会话
+        Clock::time_point expiresAt;        ///< 过期时间
+    };
+
+    LruCache<std::string, Entry> entries_; ///< 对端到会话的缓存
+    Clock::duration ttl_;                  ///< 会话有效期
+};
+
+#endif // HIGIT_TLS_SESSION_CACHE_H
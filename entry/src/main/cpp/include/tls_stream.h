@@ -0,0 +1,48 @@
+#ifndef HIGIT_TLS_STREAM_H
+#define HIGIT_TLS_STREAM_H
+
+#include <git2.h>
+#include <git2/sys/stream.h>
+
+/**
+ * @brief 基于mbedTLS的HTTPS传输流
+ * 注册为 libgit2 的TLS流，替换其内置实现：所有连接共用 TrustStore 中已解析的CA证书链，
+ * 不再各自加载证书包；同一主机的后续连接通过 TlsSessionCache 恢复会话。
+ * 关闭时处于空闲状态的连接放回连接池，短时间内到同一对端的新连接直接复用，省去TCP和TLS握手。
+ * 证书校验失败时返回 GIT_ECERTIFICATE，由 certificate_check 回调决定是否继续
+ *
+ * 每个连接使用独立的随机数生成器和TLS配置（mbedTLS 未启用线程支持，这些对象不能跨线程共享）
+ */
+class TlsStream {
+public:
+    /**
+     * @brief 注册为 libgit2 的TLS流，须在 git_libgit2_init 之后调用一次
+     * @return 成功返回true，失败返回false
+     */
+    static bool Register();
+
+    /**
+     * @brief 建立到指定主机的TLS连接
+     * @param out 输出流
+     * @param host 主机名
+     * @param port 端口
+     * @return 0 成功，否则为 libgit2 错误码
+     */
+    static int Init(git_stream **out, const char *host, const char *port);
+
+    /**
+     * @brief 在已有连接（如HTTP代理隧道）上建立TLS
+     * @param out 输出流
+     * @param in 下层流，由调用方负责连接和释放
+     * @param host 主机名，用于SNI和证书校验
+     * @return 0 成功，否则为 libgit2 错误码
+     */
+    static int Wrap(git_stream **out, git_stream *in, const char *host);
+
+    /**
+     * @brief 关闭连接池中所有空闲连接
+     */
+    static void CloseIdleConnections();
+};
+
+#endif // HIGIT_TLS_STREAM_H
@@ -0,0 +1,166 @@
+#ifndef HIGIT_TRACER_H
+#define HIGIT_TRACER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief 进程级的原生耗时追踪
+ * 记录 NAPI 调用、排队等待、libgit2 各阶段和结果转换的耗时，以及 libgit2 自身的 trace 输出，
+ * 写入固定大小的无锁环形缓冲区，写满后覆盖最早的事件；导出为 Chrome trace-event JSON，
+ * 可直接在 chrome://tracing 或 Perfetto 中查看
+ *
+ * 未开启时每个埋点只有一次原子读取；事件名须为字符串字面量或在记录时复制（超长时截断）
+ */
+class Tracer {
+public:
+    static constexpr size_t CAPACITY = 4096; ///< 环形缓冲区容量（事件数）
+    static constexpr size_t MAX_NAME = 95;   ///< 事件名最大字节数
+
+    /**
+     * @brief 获取进程唯一的追踪器
+     * @return 追踪器引用
+     */
+    static Tracer &Shared();
+
+    // 禁止拷贝
+    Tracer(const Tracer &) = delete;
+    Tracer &operator=(const Tracer &) = delete;
+
+    /**
+     * @brief 开启或关闭追踪
+     * 开启时丢弃之前的记录，并把 libgit2 的 trace 输出记录为即时事件
+     * @param enabled 是否开启
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief 是否已开启追踪
+     */
+    bool enabled() const { return enabled_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 记录一个已结束的区间
+     * @param category 分类，须为字符串字面量
+     * @param name 事件名
+     * @param startUs 开始时间（微秒，见 NowMicros）
+     * @param durationUs 持续时间（微秒）
+     */
+    void complete(const char *category, std::string_view name, int64_t startUs, int64_t durationUs);
+
+    /**
+     * @brief 记录一个即时事件
+     * @param category 分类，须为字符串字面量
+     * @param name 事件名
+     */
+    void instant(const char *category, std::string_view name);
+
+    /**
+     * @brief 导出本次开启以来仍在缓冲区中的事件
+     * @return Chrome trace-event JSON
+     */
+    std::string exportJson() const;
+
+    /**
+     * @brief 单调时钟的当前时间
+     * @return 微秒
+     */
+    static int64_t NowMicros();
+
+private:
+    Tracer() = default;
+
+    // 一个事件槽位，sequence 为 2*序号+1 时正在写入，为 2*序号+2 时写入完成
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        const char *category = nullptr;
+        char phase = 0;
+        uint32_t tid = 0;
+        int64_t timestamp = 0;
+        int64_t duration = 0;
+        char name[MAX_NAME + 1] = {0};
+    };
+
+    void record(char phase, const char *category, std::string_view name, int64_t timestamp, int64_t duration);
+
+    mutable std::mutex mutex_;          ///< 串行化开启、关闭和导出
+    std::unique_ptr<Slot[]> slots_;     ///< 首次开启时分配，之后不再释放
+    std::atomic<bool> enabled_{false};  ///< 是否开启
+    std::atomic<uint64_t> next_{0};     ///< 下一个事件的序号
+    std::atomic<uint64_t> first_{0};    ///< 本次开启后第一个事件的序号
+};
+
+/**
+ * @brief 作用域内的耗时区间，析构时记录
+ * 构造时未开启追踪则不记录；category 和 name 须在区间结束前保持有效（通常为字符串字面量）
+ */
+class TraceSpan {
+public:
+    TraceSpan(const char *category, const char *name)
+        : category_(category), name_(name), start_(Tracer::Shared().enabled() ? Tracer::NowMicros() : -1) {}
+
+    ~TraceSpan() {
+        if (start_ >= 0) {
+            Tracer::Shared().complete(category_, name_, start_, Tracer::NowMicros() - start_);
+        }
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    const char *category_;
+    const char *name_;
+    int64_t start_; ///< 开始时间，-1 表示不记录
+};
+
+/**
+ * @brief 首尾相接的多个阶段，进入下一阶段时结束上一阶段，析构时结束最后一个阶段
+ * 用于只能通过回调感知阶段切换的操作（如 fetch 的连接、下载、解析增量和更新引用）
+ */
+class TracePhases {
+public:
+    explicit TracePhases(const char *category) : category_(category) {}
+
+    ~TracePhases() { end(); }
+
+    TracePhases(const TracePhases &) = delete;
+    TracePhases &operator=(const TracePhases &) = delete;
+
+    /**
+     * @brief 进入新阶段，与当前阶段相同时忽略
+     * @param name 阶段名，须为字符串字面量
+     */
+    void enter(const char *name) {
+        if (name_ == name) {
+            return;
+        }
+        end();
+        if (Tracer::Shared().enabled()) {
+            name_ = name;
+            start_ = Tracer::NowMicros();
+        }
+    }
+
+    /**
+     * @brief 结束当前阶段
+     */
+    void end() {
+        if (name_ != nullptr) {
+            Tracer::Shared().complete(category_, name_, start_, Tracer::NowMicros() - start_);
+            name_ = nullptr;
+        }
+    }
+
+private:
+    const char *category_;
+    const char *name_ = nullptr; ///< 当前阶段，为空表示没有进行中的阶段
+    int64_t start_ = 0;
+};
+
+#endif // HIGIT_TRACER_H
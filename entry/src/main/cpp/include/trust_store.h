@@ -0,0 +1,92 @@
+#ifndef HIGIT_TRUST_STORE_H
+#define HIGIT_TRUST_STORE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mbedtls/x509_crt.h>
+#include <mutex>
+#include <string>
+
+/**
+ * @brief 进程共享的CA证书链
+ * 证书包只解析一次，所有TLS连接共用解析结果。首次解析后把各证书的DER编码写入缓存文件，
+ * 之后启动直接从DER加载，省去PEM的Base64解码且不复制证书数据；证书包的大小或修改时间变化时缓存失效
+ *
+ * 加载在线程池上进行，不阻塞初始化；连接在握手前通过 chain() 等待加载完成
+ *
+ * 注意：该类不支持拷贝构造和赋值操作
+ */
+class TrustStore {
+public:
+    using Chain = std::shared_ptr<mbedtls_x509_crt>;
+
+    /**
+     * @brief 获取进程共享的证书链
+     * @return 证书链引用
+     */
+    static TrustStore &Shared();
+
+    // 禁止拷贝
+    TrustStore(const TrustStore &) = delete;
+    TrustStore &operator=(const TrustStore &) = delete;
+
+    /**
+     * @brief 在线程池上加载证书包
+     * @param bundlePath PEM证书包路径
+     * @param cachePath DER缓存文件路径
+     */
+    void loadAsync(const std::string &bundlePath, const std::string &cachePath);
+
+    /**
+     * @brief 加载证书包，替换当前证书链
+     * @param bundlePath PEM证书包路径
+     * @param cachePath DER缓存文件路径，为空时不使用缓存
+     * @return 成功返回true，失败返回false
+     */
+    bool load(const std::string &bundlePath, const std::string &cachePath);
+
+    /**
+     * @brief 当前证书链，正在加载时等待加载结束
+     * 返回的证书链在连接持有期间保持有效，即使之后重新加载
+     * @return 证书链，未加载时为空
+     */
+    Chain chain();
+
+    /**
+     * @brief 当前证书数量
+     * @return 证书数量
+     */
+    size_t size() const;
+
+private:
+    TrustStore() = default;
+
+    /**
+     * @brief 从DER缓存加载
+     * @param cachePath 缓存文件路径
+     * @param bundleSize 证书包大小
+     * @param bundleTime 证书包修改时间
+     * @return 证书链，缓存不存在或已失效时为空
+     */
+    static Chain LoadCache(const std::string &cachePath, size_t bundleSize, int64_t bundleTime);
+
+    /**
+     * @brief 把证书链的DER编码写入缓存文件
+     * @param chain 证书链
+     * @param cachePath 缓存文件路径
+     * @param bundleSize 证书包大小
+     * @param bundleTime 证书包修改时间
+     */
+    static void SaveCache(const mbedtls_x509_crt &chain, const std::string &cachePath, size_t bundleSize,
+                          int64_t bundleTime);
+
+    mutable std::mutex mutex_;   ///< 保护以下成员
+    std::condition_variable cv_; ///< 加载完成通知
+    size_t pending_ = 0;         ///< 进行中的加载数量
+    Chain chain_;                ///< 当前证书链
+    size_t size_ = 0;            ///< 证书数量
+};
+
+#endif // HIGIT_TRUST_STORE_H
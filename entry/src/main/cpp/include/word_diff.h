@@ -0,0 +1,30 @@
+#ifndef HIGIT_WORD_DIFF_H
+#define HIGIT_WORD_DIFF_H
+
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 行内高亮区间，[first, second) 为行内容中的字节偏移；传给 ArkTS 前换算为 UTF-16 码元偏移
+ */
+using HighlightRange = std::pair<uint32_t, uint32_t>;
+
+namespace WordDiff {
+
+/**
+ * @brief 计算一对修改前/修改后行的单词级差异
+ * 按单词、空白和标点切分后做LCS，未匹配的片段即为高亮区间
+ * @param oldLine 修改前的行内容
+ * @param newLine 修改后的行内容
+ * @param oldRanges 修改前行的高亮区间（输出）
+ * @param newRanges 修改后行的高亮区间（输出）
+ * @return 计算成功返回true；行过长或差异过大时返回false，此时不高亮
+ */
+bool diffLines(std::string_view oldLine, std::string_view newLine, std::vector<HighlightRange> &oldRanges,
+               std::vector<HighlightRange> &newRanges);
+
+} // namespace WordDiff
+
+#endif // HIGIT_WORD_DIFF_H
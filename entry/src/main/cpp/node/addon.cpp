@@ -0,0 +1,10 @@
+// Node 插件入口：与 napi_init.cpp 导出同一组接口，供工作站上测量 JS 调用和结果编码的开销
+// 模块由 Node 按文件加载，不需要 napi_module_register，其余绑定代码与设备上完全相同
+
+#include "napi/native_api.h"
+#include "core.h"
+
+NAPI_MODULE_INIT() {
+    Core::GetInstance()->SetEnv(env);
+    return Core::InitApp(env, exports) ? exports : nullptr;
+}
@@ -0,0 +1,334 @@
+// 在 Node 中加载 higit.node，测量从 JS 发起调用到拿到可用结果的完整开销：
+// 参数转换、原生执行、结果封装，以及 JS 侧的 JSON.parse 或列式解码。
+// 同一个接口分别测 JSON 与列式编码、同步与异步调用，以及并发异步调用，用来比较结果编码和异步设计。
+//
+// 用法：
+//   node bench.mjs --addon build/node/higit.node --source /path/to/bare.git
+//   node bench.mjs --addon build/node/higit.node --genrepo build/bench/higit_genrepo --shape linear
+// 其他选项：--filter <子串> --iterations <n> --warmup <n> --page-size <n> --concurrency <n> --json --metrics --keep
+
+import { execFileSync } from 'node:child_process';
+import fs from 'node:fs';
+import { createRequire } from 'node:module';
+import os from 'node:os';
+import path from 'node:path';
+import { TextDecoder } from 'node:util';
+
+const usage = `Usage: node bench.mjs --addon <higit.node> (--source <bare repo> | --genrepo <higit_genrepo> [generator options])
+  --filter <text>       only run cases whose name contains <text>
+  --iterations <n>      measured iterations per case (default 50)
+  --warmup <n>          unmeasured iterations per case (default 5)
+  --page-size <n>       history page size (default 50)
+  --concurrency <n>     in-flight calls for the concurrent cases (default 16)
+  --json                print results as JSON
+  --metrics             print getMetrics() after the run
+  --keep                keep the temporary workdir
+Generator options such as --shape, --commits or --files are passed through to higit_genrepo.`;
+
+function parseArgs(argv) {
+  const options = {
+    addon: '', source: '', genrepo: '', genrepoArgs: [], filter: '',
+    iterations: 50, warmup: 5, pageSize: 50, concurrency: 16, json: false, metrics: false, keep: false,
+  };
+  const numeric = { '--iterations': 'iterations', '--warmup': 'warmup', '--page-size': 'pageSize',
+    '--concurrency': 'concurrency' };
+  const strings = { '--addon': 'addon', '--source': 'source', '--genrepo': 'genrepo', '--filter': 'filter' };
+  const flags = { '--json': 'json', '--metrics': 'metrics', '--keep': 'keep' };
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    if (arg === '--help' || arg === '-h') {
+      console.log(usage);
+      process.exit(0);
+    } else if (arg in flags) {
+      options[flags[arg]] = true;
+    } else if (i + 1 >= argv.length) {
+      throw new Error(`missing value for ${arg}`);
+    } else if (arg in numeric) {
+      options[numeric[arg]] = Number.parseInt(argv[++i], 10);
+    } else if (arg in strings) {
+      options[strings[arg]] = argv[++i];
+    } else if (arg.startsWith('--')) {
+      options.genrepoArgs.push(arg, argv[++i]);
+    } else {
+      throw new Error(`unexpected argument ${arg}`);
+    }
+  }
+  if (!options.addon || (!options.source && !options.genrepo)) {
+    throw new Error('--addon and one of --source/--genrepo are required');
+  }
+  return options;
+}
+
+// 与 cpp/utils/columnar.hpp 和 ets/utils/ColumnarTable.ets 中的格式保持一致
+const MAGIC = 0x42434748; // "HGCB"
+const HEADER_SIZE = 24;
+const COLUMN_DESC_SIZE = 16;
+const decoder = new TextDecoder('utf-8');
+
+// 把整张列式表展开为对象数组，与 JSON.parse 得到的结果对等，比较两种编码的端到端开销
+function decodeColumns(buffer) {
+  const view = new DataView(buffer);
+  const bytes = new Uint8Array(buffer);
+  if (buffer.byteLength < HEADER_SIZE || view.getUint32(0, true) !== MAGIC) {
+    throw new Error('invalid columnar buffer');
+  }
+  const columnCount = view.getUint16(6, true);
+  const rowCount = view.getUint32(8, true);
+  const heapOffset = view.getUint32(12, true);
+  const readHeap = (offset, length) =>
+    length === 0 ? '' : decoder.decode(bytes.subarray(heapOffset + offset, heapOffset + offset + length));
+  const columns = [];
+  for (let i = 0; i < columnCount; i++) {
+    const desc = HEADER_SIZE + COLUMN_DESC_SIZE * i;
+    columns.push({
+      type: view.getUint8(desc),
+      name: readHeap(view.getUint32(desc + 4, true), view.getUint32(desc + 8, true)),
+      offset: view.getUint32(desc + 12, true),
+    });
+  }
+  const rows = new Array(rowCount);
+  for (let row = 0; row < rowCount; row++) {
+    const item = {};
+    for (const column of columns) {
+      switch (column.type) {
+        case 1: item[column.name] = view.getUint32(column.offset + row * 4, true); break;
+        case 2: item[column.name] = view.getInt32(column.offset + row * 4, true); break;
+        case 3: item[column.name] = view.getFloat64(column.offset + row * 8, true); break;
+        case 4: item[column.name] = view.getUint8(column.offset + row) !== 0; break;
+        case 5:
+          item[column.name] = readHeap(view.getUint32(column.offset + row * 8, true),
+            view.getUint32(column.offset + row * 8 + 4, true));
+          break;
+        case 6:
+          item[column.name] = Buffer.from(bytes.buffer, bytes.byteOffset + column.offset + row * 20, 20)
+            .toString('hex');
+          break;
+        default: throw new Error(`unknown column type ${column.type}`);
+      }
+    }
+    rows[row] = item;
+  }
+  return rows;
+}
+
+function check(result, name) {
+  if (!result || result.success !== 1) {
+    throw new Error(`${name}: ${result ? result.message : 'no result'}`);
+  }
+  return result;
+}
+
+function resultBytes(result) {
+  return (typeof result.data === 'string' ? Buffer.byteLength(result.data) : 0) +
+    (result.buffer ? result.buffer.byteLength : 0);
+}
+
+// JSON 结果：调用 + JSON.parse；列式结果：调用 + 展开；列式接口回退到 JSON 时按 JSON 解析
+function consume(result, name) {
+  check(result, name);
+  if (result.buffer) {
+    return decodeColumns(result.buffer);
+  }
+  return typeof result.data === 'string' && result.data.length > 0 ? JSON.parse(result.data) : result.data;
+}
+
+function percentile(sorted, p) {
+  if (sorted.length === 0) {
+    return 0;
+  }
+  return sorted[Math.min(sorted.length - 1, Math.floor((sorted.length - 1) * p))];
+}
+
+async function runCase(benchCase, options) {
+  let bytes = 0;
+  const once = async () => {
+    const started = process.hrtime.bigint();
+    bytes = await benchCase.run();
+    return Number(process.hrtime.bigint() - started) / 1000;
+  };
+  for (let i = 0; i < options.warmup; i++) {
+    await once();
+  }
+  const samples = [];
+  for (let i = 0; i < options.iterations; i++) {
+    samples.push(await once());
+  }
+  samples.sort((a, b) => a - b);
+  const total = samples.reduce((sum, value) => sum + value, 0);
+  return {
+    name: benchCase.name,
+    calls: benchCase.calls ?? 1,
+    iterations: samples.length,
+    meanUs: total / samples.length,
+    p50Us: percentile(samples, 0.5),
+    p99Us: percentile(samples, 0.99),
+    maxUs: samples[samples.length - 1],
+    bytes,
+  };
+}
+
+function prepareSource(options, workdir) {
+  if (options.source) {
+    return path.resolve(options.source);
+  }
+  const source = path.join(workdir, 'source.git');
+  const output = execFileSync(options.genrepo, [source, ...options.genrepoArgs], { encoding: 'utf8' });
+  if (!options.json) {
+    const summary = JSON.parse(output);
+    console.error(`generated ${source} head ${summary.head} in ${summary.seconds.toFixed(1)}s`);
+  }
+  return source;
+}
+
+function buildCases(git, url, branch, files, options) {
+  const size = options.pageSize;
+  let offset = 0;
+  // 每次换一页，绕过历史分页缓存
+  const nextOffset = () => {
+    offset = (offset + size) % (size * 64);
+    return offset;
+  };
+  const sync = (name, call) => ({
+    name,
+    run: () => {
+      const result = call();
+      consume(result, name);
+      return resultBytes(result);
+    },
+  });
+  const async = (name, call) => ({
+    name,
+    run: async () => {
+      const result = await call();
+      consume(result, name);
+      return resultBytes(result);
+    },
+  });
+  const concurrent = (name, call) => ({
+    name,
+    calls: options.concurrency,
+    run: async () => {
+      const results = await Promise.all(Array.from({ length: options.concurrency }, (_, i) => call(i)));
+      let bytes = 0;
+      for (const result of results) {
+        consume(result, name);
+        bytes += resultBytes(result);
+      }
+      return bytes;
+    },
+  });
+
+  const cases = [
+    sync('call/getMetrics', (() => git.getMetrics())),
+
+    sync('history/json', (() => git.history(url, branch, size, 0))),
+    sync('history/columns', (() => git.historyColumns(url, branch, size, 0))),
+    async('history/json-async', () => git.historyAsync(url, branch, size, 0)),
+    async('history/columns-async', () => git.historyColumnsAsync(url, branch, size, 0)),
+    sync('history/json-uncached', (() => git.history(url, branch, size, nextOffset()))),
+    sync('history/columns-uncached', (() => git.historyColumns(url, branch, size, nextOffset()))),
+    concurrent('history/json-async-concurrent', (i) => git.historyAsync(url, branch, size, i * size)),
+    concurrent('history/columns-async-concurrent', (i) => git.historyColumnsAsync(url, branch, size, i * size)),
+
+    sync('fileTree/json', (() => git.getFileTree(url, branch))),
+    sync('fileTree/columns', (() => git.getFileTreeColumns(url, branch))),
+    async('fileTree/json-async', () => git.getFileTreeAsync(url, branch)),
+    async('fileTree/columns-async', () => git.getFileTreeColumnsAsync(url, branch)),
+
+    sync('refs/branches-json', (() => git.getBranches(url))),
+    sync('refs/branches-columns', (() => git.getBranchesColumns(url))),
+    sync('refs/tags-json', (() => git.getTags(url))),
+    sync('refs/tags-columns', (() => git.getTagsColumns(url))),
+    async('refs/tags-json-async', () => git.getTagsAsync(url)),
+    async('refs/tags-columns-async', () => git.getTagsColumnsAsync(url)),
+  ];
+
+  if (files.length > 0) {
+    let next = 0;
+    const nextFile = () => files[next++ % files.length];
+    cases.push(
+      { name: 'readFile/sync', run: () => resultBytes(check(git.readFile(url, branch, nextFile()), 'readFile')) },
+      {
+        name: 'readFile/async',
+        run: async () => resultBytes(check(await git.readFileAsync(url, branch, nextFile()), 'readFile')),
+      },
+      {
+        name: 'readFile/async-concurrent',
+        calls: options.concurrency,
+        run: async () => {
+          const results = await Promise.all(
+            Array.from({ length: options.concurrency }, () => git.readFileAsync(url, branch, nextFile())));
+          return results.reduce((sum, result) => sum + resultBytes(check(result, 'readFile')), 0);
+        },
+      },
+    );
+  }
+  return cases.filter((benchCase) => benchCase.name.includes(options.filter));
+}
+
+function printTable(results) {
+  const header = ['case', 'calls', 'mean(us)', 'p50(us)', 'p99(us)', 'max(us)', 'bytes'];
+  const rows = results.map((r) => [r.name, String(r.calls), r.meanUs.toFixed(1), r.p50Us.toFixed(1),
+    r.p99Us.toFixed(1), r.maxUs.toFixed(1), String(r.bytes)]);
+  const widths = header.map((title, i) => Math.max(title.length, ...rows.map((row) => row[i].length)));
+  const format = (row) => row.map((cell, i) => (i === 0 ? cell.padEnd(widths[i]) : cell.padStart(widths[i])))
+    .join('  ');
+  console.log(format(header));
+  for (const row of rows) {
+    console.log(format(row));
+  }
+}
+
+async function main() {
+  let options;
+  try {
+    options = parseArgs(process.argv.slice(2));
+  } catch (e) {
+    console.error(`${e.message}\n${usage}`);
+    process.exit(2);
+  }
+
+  const git = createRequire(import.meta.url)(path.resolve(options.addon));
+  const workdir = fs.mkdtempSync(path.join(os.tmpdir(), 'higit-node-bench-'));
+  try {
+    const source = prepareSource(options, workdir);
+    const url = `file://${source}`;
+    const branch = 'main';
+    check(git.initSystem(workdir), 'initSystem');
+    check(git.initRepo(workdir, url, 'fixture', 'bench'), 'initRepo');
+    check(await git.fetchAsync(url, branch, () => {}), 'fetch');
+
+    // 从文件树中取最多 64 个普通文件供 readFile 轮流读取
+    const tree = consume(git.getFileTree(url, branch), 'getFileTree');
+    const files = (Array.isArray(tree) ? tree : [])
+      .filter((node) => !node.isDirectory)
+      .slice(0, 64)
+      .map((node) => node.path);
+
+    const results = [];
+    for (const benchCase of buildCases(git, url, branch, files, options)) {
+      results.push(await runCase(benchCase, options));
+    }
+
+    if (options.json) {
+      const report = { node: process.version, source, iterations: options.iterations, results };
+      if (options.metrics) {
+        report.metrics = JSON.parse(git.getMetrics().data);
+      }
+      console.log(JSON.stringify(report, null, 2));
+    } else {
+      printTable(results);
+      if (options.metrics) {
+        console.log(JSON.stringify(JSON.parse(git.getMetrics().data), null, 2));
+      }
+    }
+  } finally {
+    if (options.keep) {
+      console.error(`workdir kept at ${workdir}`);
+    } else {
+      fs.rmSync(workdir, { recursive: true, force: true });
+    }
+  }
+}
+
+await main();
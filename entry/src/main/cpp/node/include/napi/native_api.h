@@ -0,0 +1,17 @@
+#ifndef HIGIT_NODE_NATIVE_API_H
+#define HIGIT_NODE_NATIVE_API_H
+
+// Node 构建下替代 OHOS 的 napi/native_api.h：绑定层只用到标准 N-API，直接取 Node 的头文件
+#include <node_api.h>
+
+#ifndef EXTERN_C_START
+#ifdef __cplusplus
+#define EXTERN_C_START extern "C" {
+#define EXTERN_C_END }
+#else
+#define EXTERN_C_START
+#define EXTERN_C_END
+#endif
+#endif
+
+#endif // HIGIT_NODE_NATIVE_API_H
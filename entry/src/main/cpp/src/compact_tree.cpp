@@ -0,0 +1,94 @@
+#include "compact_tree.h"
+#include <algorithm>
+#include <limits>
+
+void CompactFileTree::reserve(size_t count) {
+    parents_.reserve(count);
+    nameOffsets_.reserve(count);
+    nameLengths_.reserve(count);
+    modes_.reserve(count);
+    sizes_.reserve(count);
+    oids_.reserve(count * OID_SIZE);
+}
+
+uint32_t CompactFileTree::append(uint32_t parent, std::string_view name, uint16_t mode, const unsigned char *oid) {
+    // 文件名去重：index.ts、README.md 之类的名字在大仓库中会重复成千上万次
+    auto [it, inserted] = internTable_.try_emplace(std::string(name), static_cast<uint32_t>(namePool_.size()));
+    if (inserted) {
+        namePool_.append(name);
+    }
+
+    auto index = static_cast<uint32_t>(parents_.size());
+    parents_.push_back(parent);
+    nameOffsets_.push_back(it->second);
+    nameLengths_.push_back(static_cast<uint16_t>(std::min<size_t>(name.size(), std::numeric_limits<uint16_t>::max())));
+    modes_.push_back(mode);
+    sizes_.push_back(0);
+    oids_.insert(oids_.end(), oid, oid + OID_SIZE);
+    return index;
+}
+
+void CompactFileTree::setFileSize(uint32_t index, uint64_t size) {
+    sizes_[index] = static_cast<uint32_t>(std::min<uint64_t>(size, std::numeric_limits<uint32_t>::max()));
+}
+
+void CompactFileTree::finish() {
+    std::unordered_map<std::string, uint32_t>().swap(internTable_);
+    parents_.shrink_to_fit();
+    nameOffsets_.shrink_to_fit();
+    nameLengths_.shrink_to_fit();
+    modes_.shrink_to_fit();
+    sizes_.shrink_to_fit();
+    oids_.shrink_to_fit();
+    namePool_.shrink_to_fit();
+}
+
+std::string_view CompactFileTree::extension(uint32_t index) const {
+    if (isDirectory(index)) {
+        return {};
+    }
+    std::string_view fileName = name(index);
+    size_t dot = fileName.find_last_of('.');
+    if (dot == std::string_view::npos || dot + 1 >= fileName.size()) {
+        return {};
+    }
+    return fileName.substr(dot + 1);
+}
+
+std::string CompactFileTree::path(uint32_t index) const {
+    // 先收集祖先链再按从根到叶的顺序拼接，一次分配
+    std::vector<uint32_t> chain;
+    size_t length = rootPath_.size();
+    for (uint32_t i = index; i != NO_PARENT; i = parents_[i]) {
+        chain.push_back(i);
+        length += nameLengths_[i] + 1;
+    }
+
+    std::string result;
+    result.reserve(length);
+    result.append(rootPath_);
+    for (size_t i = chain.size(); i-- > 0;) {
+        if (!result.empty()) {
+            result.push_back('/');
+        }
+        result.append(name(chain[i]));
+    }
+    return result;
+}
+
+std::string CompactFileTree::oidHex(uint32_t index) const {
+    static constexpr char digits[] = "0123456789abcdef";
+    const unsigned char *bytes = oid(index);
+    std::string hex(OID_SIZE * 2, '0');
+    for (size_t i = 0; i < OID_SIZE; ++i) {
+        hex[i * 2] = digits[bytes[i] >> 4];
+        hex[i * 2 + 1] = digits[bytes[i] & 0x0f];
+    }
+    return hex;
+}
+
+size_t CompactFileTree::memoryUsage() const {
+    return parents_.capacity() * sizeof(uint32_t) + nameOffsets_.capacity() * sizeof(uint32_t) +
+           nameLengths_.capacity() * sizeof(uint16_t) + modes_.capacity() * sizeof(uint16_t) +
+           sizes_.capacity() * sizeof(uint32_t) + oids_.capacity() + namePool_.capacity() + rootPath_.capacity();
+}
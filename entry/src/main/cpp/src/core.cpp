@@ -5,8 +5,11 @@
 // please include "napi/native_api.h".
 
 #include "core.h"
+#include "credential_provider.h"
 #include "global.h"
-#include "hilog/log.h"
+#include "ssh_transport.h"
+#include "thread_pool.h"
+#include "utils/log.hpp"
 #include "utils/utils.hpp"
 #include <repo_manager.h>
 
@@ -33,6 +36,16 @@ bool Core::InitApp(napi_env env, napi_value exports) noexcept {
             .attributes = napi_default,
             .data = nullptr,
         },
+        {
+            .utf8name = "openAll",
+            .name = nullptr,
+            .method = &Core::OpenAll,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
         {
             .utf8name = "getBranches",
             .name = nullptr,
@@ -93,6 +106,16 @@ bool Core::InitApp(napi_env env, napi_value exports) noexcept {
             .attributes = napi_default,
             .data = nullptr,
         },
+        {
+            .utf8name = "getSSHKeyStatus",
+            .name = nullptr,
+            .method = &Core::GetSSHKeyStatus,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
         {
             .utf8name = "deleteRepo",
             .name = nullptr,
@@ -123,101 +146,493 @@ bool Core::InitApp(napi_env env, napi_value exports) noexcept {
             .attributes = napi_default,
             .data = nullptr,
         },
+        {
+            .utf8name = "getCommitChanges",
+            .name = nullptr,
+            .method = &Core::GetCommitChanges,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "getFilePatch",
+            .name = nullptr,
+            .method = &Core::GetFilePatch,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "searchTree",
+            .name = nullptr,
+            .method = &Core::SearchTree,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "findFiles",
+            .name = nullptr,
+            .method = &Core::FindFiles,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "blameFile",
+            .name = nullptr,
+            .method = &Core::BlameFile,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "cancelBlame",
+            .name = nullptr,
+            .method = &Core::CancelBlame,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "trimCaches",
+            .name = nullptr,
+            .method = &Core::TrimCaches,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "setMemoryBudget",
+            .name = nullptr,
+            .method = &Core::SetMemoryBudget,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "setTracing",
+            .name = nullptr,
+            .method = &Core::SetTracing,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "exportTrace",
+            .name = nullptr,
+            .method = &Core::ExportTrace,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "getMetrics",
+            .name = nullptr,
+            .method = &Core::GetMetrics,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "getBranchesColumns",
+            .name = nullptr,
+            .method = &Core::GetBranchesColumns,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "getTagsColumns",
+            .name = nullptr,
+            .method = &Core::GetTagsColumns,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "historyColumns",
+            .name = nullptr,
+            .method = &Core::GetHistoryColumns,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "getFileTreeColumns",
+            .name = nullptr,
+            .method = &Core::GetFileTreeColumns,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "initSystemAsync",
+            .name = nullptr,
+            .method = &Core::InitSystemAsync,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "initRepoAsync",
+            .name = nullptr,
+            .method = &Core::InitRepoAsync,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "getBranchesAsync",
+            .name = nullptr,
+            .method = &Core::GetBranchesAsync,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "getTagsAsync",
+            .name = nullptr,
+            .method = &Core::GetTagsAsync,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "fetchAsync",
+            .name = nullptr,
+            .method = &Core::FetchAsync,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "historyAsync",
+            .name = nullptr,
+            .method = &Core::GetHistoryAsync,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "getSSHKeyAsync",
+            .name = nullptr,
+            .method = &Core::GetSSHKeyAsync,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "generateSSHKeyAsync",
+            .name = nullptr,
+            .method = &Core::GenerateSSHKeyAsync,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "deleteRepoAsync",
+            .name = nullptr,
+            .method = &Core::DeleteRepoAsync,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "getFileTreeAsync",
+            .name = nullptr,
+            .method = &Core::GetFileTreeAsync,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "readFileAsync",
+            .name = nullptr,
+            .method = &Core::ReadFileAsync,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "getCommitChangesAsync",
+            .name = nullptr,
+            .method = &Core::GetCommitChangesAsync,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "findFilesAsync",
+            .name = nullptr,
+            .method = &Core::FindFilesAsync,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "getBranchesColumnsAsync",
+            .name = nullptr,
+            .method = &Core::GetBranchesColumnsAsync,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "getTagsColumnsAsync",
+            .name = nullptr,
+            .method = &Core::GetTagsColumnsAsync,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "historyColumnsAsync",
+            .name = nullptr,
+            .method = &Core::GetHistoryColumnsAsync,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
+        {
+            .utf8name = "getFileTreeColumnsAsync",
+            .name = nullptr,
+            .method = &Core::GetFileTreeColumnsAsync,
+            .getter = nullptr,
+            .setter = nullptr,
+            .value = nullptr,
+            .attributes = napi_default,
+            .data = nullptr,
+        },
     };
 
     return Utils::checkNAPIResult(napi_define_properties(env, exports, std::size(desc), desc), env, "Core::InitApp",
                                   "Can't export methods.");
 }
 
-void Core::StoreRepoManager(const std::string &repoUrl, std::unique_ptr<RepoManager> manager) {
-    repo_registry_.emplace(repoUrl, std::move(manager));
+bool Core::StoreRepoManager(const std::string &repoUrl, std::unique_ptr<RepoManager> manager) {
+    std::unique_lock<std::shared_mutex> lock(registry_mutex_);
+    return repo_registry_.emplace(repoUrl, std::move(manager)).second;
 }
 
-RepoManager *Core::FindRepoManager(const std::string &repoUrl) {
+std::shared_ptr<RepoManager> Core::FindRepoManager(const std::string &repoUrl) {
+    std::shared_lock<std::shared_mutex> lock(registry_mutex_);
     auto it = repo_registry_.find(repoUrl);
     if (it == repo_registry_.end()) {
         return nullptr;
     }
-    return it->second.get();
+    return it->second;
 }
 
-void Core::DeleteRepoManager(const std::string &repoUrl) { repo_registry_.erase(repoUrl); }
+std::shared_ptr<RepoManager> Core::DeleteRepoManager(const std::string &repoUrl) {
+    std::unique_lock<std::shared_mutex> lock(registry_mutex_);
+    auto it = repo_registry_.find(repoUrl);
+    if (it == repo_registry_.end()) {
+        return nullptr;
+    }
+    auto manager = std::move(it->second);
+    repo_registry_.erase(it);
+    return manager;
+}
 
-void Core::InitSSH(std::string const &basePath) {
-    ssh_manager_ = std::make_unique<SSHManager>();
-
-    std::string sshPath = basePath + "/ssh/id_rsa";
-    std::string publicKeyPath = basePath + "/ssh/id_rsa.pub";
-
-    if (std::filesystem::exists(sshPath)) {
-        OH_LOG_INFO(LOG_APP, "SSH key pair already exists at %{public}s", sshPath.c_str());
-        bool loaded = ssh_manager_->loadKeyPair(sshPath, publicKeyPath, "");
-        if (!loaded) {
-            OH_LOG_ERROR(LOG_APP, "Failed to load SSH key pair, error: %{public}s",
-                         ssh_manager_->getLastError().c_str());
-            return;
-        }
-        return;
+std::vector<std::shared_ptr<RepoManager>> Core::ListRepoManagers() {
+    std::shared_lock<std::shared_mutex> lock(registry_mutex_);
+    std::vector<std::shared_ptr<RepoManager>> managers;
+    managers.reserve(repo_registry_.size());
+    for (const auto &entry : repo_registry_) {
+        managers.push_back(entry.second);
     }
+    return managers;
+}
 
-    OH_LOG_INFO(LOG_APP, "Generating SSH key pair at %{public}s", sshPath.c_str());
-    bool success = ssh_manager_->generateKeyPair(4096, "higit", "");
-    if (!success) {
-        OH_LOG_ERROR(LOG_APP, "Failed to generate SSH key pair, error: %{public}s",
-                     ssh_manager_->getLastError().c_str());
+void Core::InitSSH(std::string const &basePath) {
+    std::string const sshDir = basePath + "/ssh";
+
+    // 早期版本生成的 RSA 密钥已经添加到托管平台，存在时继续使用
+    auto const keyPaths = SSHManager::KeyPaths(sshDir);
+
+    if (!std::filesystem::exists(keyPaths.privateKey)) {
+        // 首次启动，在后台生成
+        GenerateSSHKey(SSHKeyAlgorithm::ECDSA);
         return;
     }
 
-    if (!ssh_manager_->validateKeyPair()) {
-        OH_LOG_ERROR(LOG_APP, "Failed to validate SSH key pair, error: %{public}s",
-                     ssh_manager_->getLastError().c_str());
+    OH_LOG_INFO(LOG_APP, "SSH key pair already exists at %{public}s", keyPaths.privateKey.c_str());
+    auto manager = std::make_shared<SSHManager>();
+    bool loaded = manager->loadKeyPair(keyPaths.privateKey, keyPaths.publicKey, "");
+
+    std::lock_guard<std::mutex> lock(ssh_mutex_);
+    if (ssh_state_ == SSHKeyState::Generating) {
+        // 已有生成任务，以新密钥为准
         return;
     }
-
-    bool saved = ssh_manager_->saveKeyPair(basePath + "/ssh/id_rsa", basePath + "/ssh/id_rsa.pub", "");
-    if (!saved) {
-        OH_LOG_ERROR(LOG_APP, "Failed to save SSH key pair, error: %{public}s", ssh_manager_->getLastError().c_str());
+    if (!loaded) {
+        OH_LOG_ERROR(LOG_APP, "Failed to load SSH key pair, error: %{public}s", manager->getLastError().c_str());
+        CredentialProvider::Shared().invalidate();
+        ssh_state_ = SSHKeyState::Failed;
+        ssh_error_ = manager->getLastError();
         return;
     }
-
-    OH_LOG_INFO(LOG_APP, "SSH key pair generated and saved at %{public}s", sshPath.c_str());
+    CredentialProvider::Shared().setSSHKey(manager->credential());
+    ssh_manager_ = std::move(manager);
+    ssh_state_ = SSHKeyState::Ready;
+    ssh_error_.clear();
 }
 
-std::string Core::GetSSHKey() const { return ssh_manager_->getPublicKey(); }
+bool Core::GenerateSSHKey(SSHKeyAlgorithm algorithm) {
+    {
+        std::lock_guard<std::mutex> lock(ssh_mutex_);
+        if (ssh_state_ == SSHKeyState::Generating) {
+            return false;
+        }
+        ssh_state_ = SSHKeyState::Generating;
+        ssh_error_.clear();
+    }
+
+    std::string sshDir = Globals::files_directory + "/ssh";
+    ThreadPool::Shared().submit([this, sshDir, algorithm]() {
+        auto manager = std::make_shared<SSHManager>();
+        std::string error = CreateSSHKey(*manager, sshDir, algorithm);
 
-std::string Core::GenerateSSHKey() const {
-    std::string sshPath = Globals::files_directory + "/ssh/id_rsa";
-    std::string publicKeyPath = Globals::files_directory + "/ssh/id_rsa.pub";
+        std::lock_guard<std::mutex> lock(ssh_mutex_);
+        if (error.empty()) {
+            // 密钥已更换，认证改用新密钥，用旧密钥认证的空闲会话不再复用
+            CredentialProvider::Shared().setSSHKey(manager->credential());
+            SshTransport::CloseIdleSessions();
+            ssh_manager_ = std::move(manager);
+            ssh_state_ = SSHKeyState::Ready;
+        } else {
+            // 生成失败时保留原有密钥
+            ssh_state_ = ssh_manager_ != nullptr ? SSHKeyState::Ready : SSHKeyState::Failed;
+        }
+        ssh_error_ = std::move(error);
+        ssh_cv_.notify_all();
+    });
+    return true;
+}
 
-    // 如果存在则删除
-    if (std::filesystem::exists(sshPath)) {
-        std::filesystem::remove(sshPath);
+SSHKeyStatus Core::GetSSHKeyStatus(bool wait) {
+    std::unique_lock<std::mutex> lock(ssh_mutex_);
+    if (wait) {
+        ssh_cv_.wait(lock, [this]() { return ssh_state_ != SSHKeyState::Generating; });
     }
-    if (std::filesystem::exists(publicKeyPath)) {
-        std::filesystem::remove(publicKeyPath);
+
+    SSHKeyStatus status;
+    status.state = ssh_state_;
+    status.message = ssh_error_;
+    if (ssh_manager_ != nullptr) {
+        status.keyType = ssh_manager_->getKeyType();
+        status.publicKey = ssh_manager_->getPublicKey();
+        status.fingerprint = ssh_manager_->getFingerprint();
     }
+    return status;
+}
+
+std::string Core::CreateSSHKey(SSHManager &manager, std::string const &sshDir, SSHKeyAlgorithm algorithm) {
+    auto const keyPaths = SSHManager::KeyPaths(sshDir, algorithm);
 
     // 生成新的 SSH 密钥
-    OH_LOG_INFO(LOG_APP, "Generating SSH key pair at %{public}s", sshPath.c_str());
-    bool success = ssh_manager_->generateKeyPair(4096, "higit", "");
+    OH_LOG_INFO(LOG_APP, "Generating SSH key pair at %{public}s", keyPaths.privateKey.c_str());
+    bool success = algorithm == SSHKeyAlgorithm::RSA ? manager.generateKeyPair(4096, "higit", "")
+                                                     : manager.generateECDSAKeyPair("higit", "");
     if (!success) {
-        OH_LOG_ERROR(LOG_APP, "Failed to generate SSH key pair, error: %{public}s",
-                     ssh_manager_->getLastError().c_str());
-        return "";
+        OH_LOG_ERROR(LOG_APP, "Failed to generate SSH key pair, error: %{public}s", manager.getLastError().c_str());
+        return manager.getLastError();
     }
 
-    if (!ssh_manager_->validateKeyPair()) {
-        OH_LOG_ERROR(LOG_APP, "Failed to validate SSH key pair, error: %{public}s",
-                     ssh_manager_->getLastError().c_str());
-        return "";
+    if (!manager.validateKeyPair()) {
+        OH_LOG_ERROR(LOG_APP, "Failed to validate SSH key pair, error: %{public}s", manager.getLastError().c_str());
+        return manager.getLastError();
     }
 
-    bool saved = ssh_manager_->saveKeyPair(sshPath, publicKeyPath, "");
+    // 先写入临时文件再替换，保存或替换失败时旧密钥仍然可用
+    SSHKeyPaths const staged{keyPaths.privateKey + ".tmp", keyPaths.publicKey + ".tmp"};
+    std::error_code ec;
+    std::string error;
+    bool saved = manager.saveKeyPair(staged.privateKey, staged.publicKey, "");
     if (!saved) {
-        OH_LOG_ERROR(LOG_APP, "Failed to save SSH key pair, error: %{public}s", ssh_manager_->getLastError().c_str());
-        return "";
+        error = manager.getLastError();
+    }
+    if (!saved || !SSHManager::ReplaceKeyFiles(staged, keyPaths, error)) {
+        OH_LOG_ERROR(LOG_APP, "Failed to save SSH key pair, error: %{public}s", error.c_str());
+        std::filesystem::remove(staged.privateKey, ec);
+        std::filesystem::remove(staged.publicKey, ec);
+        return error;
+    }
+
+    // 新密钥就位后删除另一种算法的旧密钥，之后认证只使用新密钥；私钥先删，避免选中只剩私钥的旧密钥
+    auto const otherPaths =
+        SSHManager::KeyPaths(sshDir, algorithm == SSHKeyAlgorithm::RSA ? SSHKeyAlgorithm::ECDSA : SSHKeyAlgorithm::RSA);
+    for (const auto &path : {otherPaths.privateKey, otherPaths.publicKey}) {
+        if (!std::filesystem::remove(path, ec) && ec) {
+            OH_LOG_WARN(LOG_APP, "Failed to remove old SSH key %{public}s: %{public}s", path.c_str(),
+                        ec.message().c_str());
+        }
     }
 
-    OH_LOG_INFO(LOG_APP, "SSH key pair generated and saved at %{public}s", sshPath.c_str());
-    return ssh_manager_->getPublicKey();
+    OH_LOG_INFO(LOG_APP, "SSH key pair generated and saved at %{public}s, fingerprint: %{public}s",
+                keyPaths.privateKey.c_str(), manager.getFingerprint().c_str());
+    return "";
 }
\ No newline at end of file
@@ -0,0 +1,41 @@
+#include "credential_provider.h"
+#include "global.h"
+#include "ssh_manager.h"
+#include "utils/log.hpp"
+
+CredentialProvider &CredentialProvider::Shared() {
+    static CredentialProvider provider;
+    return provider;
+}
+
+void CredentialProvider::setSSHKey(std::shared_ptr<const SSHCredential> credential) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sshKey_ = std::move(credential);
+}
+
+void CredentialProvider::invalidate() { setSSHKey(nullptr); }
+
+std::shared_ptr<const SSHCredential> CredentialProvider::sshKey() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sshKey_;
+}
+
+int CredentialProvider::createSSHKey(git_credential **out, const char *username) const {
+    auto credential = sshKey();
+    if (credential != nullptr && !memoryUnsupported_.load(std::memory_order_relaxed)) {
+        int result = git_credential_ssh_key_memory_new(out, username, credential->publicKey.c_str(),
+                                                       credential->privateKey.c_str(), nullptr);
+        if (result == 0) {
+            return 0;
+        }
+        // libgit2 编译时未启用内存凭据，之后直接使用密钥文件
+        const git_error *error = git_error_last();
+        OH_LOG_WARN(LOG_APP, "SSH memory credential unavailable, fall back to key files: %{public}s",
+                    error != nullptr ? error->message : "unknown");
+        memoryUnsupported_.store(true, std::memory_order_relaxed);
+    }
+
+    auto const keyPaths = SSHManager::KeyPaths(Globals::files_directory + "/ssh");
+    return git_credential_ssh_key_new(out, username, keyPaths.publicKey.c_str(), keyPaths.privateKey.c_str(),
+                                      nullptr);
+}
@@ -0,0 +1,177 @@
+#include "git_runtime.h"
+#include "ssh_transport.h"
+#include "tls_session_cache.h"
+#include "tls_stream.h"
+#include "trust_store.h"
+#include "utils/log.hpp"
+#include <algorithm>
+#include <git2.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+constexpr size_t MB = 1024 * 1024;
+constexpr size_t MIN_BUDGET = 64 * MB;     // 自动预算下限
+constexpr size_t MAX_BUDGET = 512 * MB;    // 自动预算上限
+constexpr size_t MAX_WINDOW = 128 * MB;    // 单个映射窗口上限
+constexpr int SERVER_TIMEOUT_MS = 30000;   // 网络读写超时
+constexpr int CRITICAL_FILE_LIMIT = 16;    // 内存严重不足时同时打开的打包文件数量上限
+
+// 内存压力越大，预算折减越多
+unsigned BudgetShift(GitRuntime::MemoryLevel level) {
+    switch (level) {
+    case GitRuntime::MemoryLevel::Low:
+        return 1;
+    case GitRuntime::MemoryLevel::Critical:
+        return 2;
+    default:
+        return 0;
+    }
+}
+} // namespace
+
+GitRuntime &GitRuntime::Instance() {
+    // 有意不释放，见类说明
+    static GitRuntime *runtime = new GitRuntime();
+    return *runtime;
+}
+
+GitRuntime::GitRuntime() {
+    int count = git_libgit2_init();
+    OH_LOG_INFO(LOG_APP, "GitRuntime libgit2 initialized, count: %{public}d", count);
+
+    git_libgit2_opts(GIT_OPT_ENABLE_STRICT_HASH_VERIFICATION, 0);
+    git_libgit2_opts(GIT_OPT_SET_SERVER_TIMEOUT, SERVER_TIMEOUT_MS);
+
+    // HTTPS 连接改用共享证书链的 TLS 流
+    tlsRegistered_ = TlsStream::Register();
+    if (!tlsRegistered_) {
+        OH_LOG_WARN(LOG_APP, "Fall back to the built-in TLS stream of libgit2");
+    }
+    // SSH 改用可复用会话的传输
+    if (!SshTransport::Register()) {
+        OH_LOG_WARN(LOG_APP, "Fall back to the built-in SSH transport of libgit2");
+    }
+
+    int features = git_libgit2_features();
+    if (features & GIT_FEATURE_SSH) {
+        OH_LOG_INFO(LOG_APP, "SSH support is enabled");
+    } else {
+        OH_LOG_ERROR(LOG_APP, "SSH support is not enabled");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    applyBudgetLocked();
+}
+
+void GitRuntime::setCertificateDirectory(const std::string &filesDirectory) {
+    std::string certPath = filesDirectory + "/cert.pem";
+    if (access(certPath.c_str(), F_OK) == 0) {
+        // libgit2 内置的 TLS 流未注册成功时仍由它加载证书
+        if (!tlsRegistered_) {
+            git_libgit2_opts(GIT_OPT_SET_SSL_CERT_LOCATIONS, certPath.c_str(), nullptr);
+        }
+        TrustStore::Shared().loadAsync(certPath, filesDirectory + "/cert.der");
+    } else {
+        OH_LOG_WARN(LOG_APP, "cert.pem not found, use default SSL certificate path %{public}s", certPath.c_str());
+    }
+}
+
+void GitRuntime::setMemoryBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    configuredBudget_ = bytes;
+    applyBudgetLocked();
+}
+
+size_t GitRuntime::memoryBudget() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return budget_;
+}
+
+size_t GitRuntime::resultCacheBudget() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return resultBudget_;
+}
+
+void GitRuntime::trimCaches(MemoryLevel level) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    level_ = level;
+    applyBudgetLocked();
+    if (level != MemoryLevel::Moderate) {
+        scheduleRestoreLocked();
+    } else {
+        restoreCv_.notify_all();
+    }
+    if (level >= MemoryLevel::Low) {
+        TlsStream::CloseIdleConnections();
+        SshTransport::CloseIdleSessions();
+    }
+    if (level == MemoryLevel::Critical) {
+        TlsSessionCache::Shared().clear();
+    }
+}
+
+void GitRuntime::scheduleRestoreLocked() {
+    restoreAt_ = std::chrono::steady_clock::now() + PRESSURE_HOLD;
+    if (restoreWaiting_) {
+        restoreCv_.notify_all();
+        return;
+    }
+    restoreWaiting_ = true;
+    // 运行时常驻不释放，线程可以安全地引用它
+    std::thread([this]() { restoreLoop(); }).detach();
+}
+
+void GitRuntime::restoreLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (level_ != MemoryLevel::Moderate) {
+        // 期间收到新的通知时 restoreAt_ 后移，重新等待
+        restoreCv_.wait_until(lock, restoreAt_);
+        if (level_ != MemoryLevel::Moderate && std::chrono::steady_clock::now() >= restoreAt_) {
+            OH_LOG_INFO(LOG_APP, "GitRuntime no memory pressure for %{public}llds, restore full budget",
+                        static_cast<long long>(PRESSURE_HOLD.count()));
+            level_ = MemoryLevel::Moderate;
+            applyBudgetLocked();
+        }
+    }
+    restoreWaiting_ = false;
+}
+
+size_t GitRuntime::PhysicalMemory() {
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (pages <= 0 || pageSize <= 0) {
+        return 0;
+    }
+    return static_cast<size_t>(pages) * static_cast<size_t>(pageSize);
+}
+
+void GitRuntime::applyBudgetLocked() {
+    size_t ram = PhysicalMemory();
+    size_t base = 0;
+    if (configuredBudget_ > 0) {
+        // 配置值不超过物理内存的四分之一
+        base = ram > 0 ? std::min(configuredBudget_, ram / 4) : configuredBudget_;
+    } else {
+        base = ram > 0 ? std::clamp(ram / 16, MIN_BUDGET, MAX_BUDGET) : MIN_BUDGET * 2;
+    }
+    budget_ = base >> BudgetShift(level_);
+
+    // 一半给打包文件的内存映射，四分之一给已解析对象的缓存，其余留给各仓库的结果缓存
+    size_t mappedLimit = budget_ / 2;
+    size_t windowSize = std::clamp(mappedLimit / 2, MB, MAX_WINDOW);
+    size_t cacheSize = budget_ / 4;
+    resultBudget_ = budget_ - mappedLimit - cacheSize;
+    int fileLimit = level_ == MemoryLevel::Critical ? CRITICAL_FILE_LIMIT : 0;
+
+    git_libgit2_opts(GIT_OPT_SET_MWINDOW_SIZE, windowSize);
+    git_libgit2_opts(GIT_OPT_SET_MWINDOW_MAPPED_LIMIT, mappedLimit);
+    git_libgit2_opts(GIT_OPT_SET_MWINDOW_FILE_LIMIT, static_cast<size_t>(fileLimit));
+    git_libgit2_opts(GIT_OPT_SET_CACHE_MAX_SIZE, static_cast<ssize_t>(cacheSize));
+
+    OH_LOG_INFO(LOG_APP,
+                "GitRuntime budget: %{public}zuMB (ram %{public}zuMB, level %{public}d), window %{public}zuMB, "
+                "mapped %{public}zuMB, cache %{public}zuMB, results %{public}zuMB",
+                budget_ / MB, ram / MB, static_cast<int>(level_), windowSize / MB, mappedLimit / MB, cacheSize / MB,
+                resultBudget_ / MB);
+}
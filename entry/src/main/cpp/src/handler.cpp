@@ -1,21 +1,59 @@
+#include "git_runtime.h"
 #include "global.h"
+#include "metrics.h"
+#include "thread_pool.h"
+#include "tracer.h"
+#include "utils/async.hpp"
+#include "utils/columnar.hpp"
+#include "utils/log.hpp"
 #include "utils/messages.hpp"
+#include "utils/utf16.hpp"
 #include "utils/utils.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <core.h>
 #include <filesystem>
-#include <hilog/log.h>
 #include <js_native_api_types.h>
 #include <memory>
+#include <mutex>
 #include <nlohmann/json.hpp>
 #include <node_api_types.h>
-#include <rawfile/raw_file_manager.h>
 #include <repo_manager.h>
 
+using Access = RepoExecutor::Access;
+
 Core Core::instance_{};
 
-napi_value Core::InitSystem(napi_env env, napi_callback_info info) noexcept {
+/**
+ * @brief 工作线程产出的结果消息
+ * 耗时的查询和序列化都在工作线程完成，回到 JS 线程后只做 napi_value 的转换
+ */
+struct ResultPayload {
+    bool success = false;
+    std::string message;
+    std::string data;
+    std::unique_ptr<std::vector<uint8_t>> buffer; ///< 列式结果，非空时以 ArrayBuffer 返回
+};
+
+static ResultPayload Success(const std::string &message, std::string data = "") {
+    return ResultPayload{true, message, std::move(data), nullptr};
+}
+
+static ResultPayload Failure(const std::string &message) { return ResultPayload{false, message, "", nullptr}; }
+
+static napi_value ToResultMessage(napi_env env, ResultPayload &payload) {
+    if (payload.buffer != nullptr) {
+        return Messages::NewBinaryResultMessage(env, payload.success, payload.message,
+                                                Columnar::ToArrayBuffer(env, std::move(payload.buffer)));
+    }
+    return Messages::NewResultMessage(env, payload.success, payload.message, payload.data);
+}
+
+static napi_value InitSystemImpl(napi_env env, napi_callback_info info, bool async) {
     char const *from = "Core::InitSystem-NAPI";
     OH_LOG_INFO(LOG_APP, "================= Core::InitSystem-NAPI =================");
+    TraceSpan span("napi", from);
 
     constexpr size_t expectedParams = 1U;
     constexpr size_t basePathIdx = 0U;
@@ -34,18 +72,32 @@ napi_value Core::InitSystem(napi_env env, napi_callback_info info) noexcept {
     }
 
     Globals::files_directory = basePath.value();
+    GitRuntime::Instance().setCertificateDirectory(basePath.value());
 
     OH_LOG_INFO(LOG_APP, "basePath: %{public}s", basePath.value().c_str());
 
-    // init ssh
-    Core::GetInstance()->InitSSH(basePath.value());
+    return Async::Dispatch(
+        env, from, async,
+        [basePath = basePath.value()]() {
+            // init ssh
+            Core::GetInstance()->InitSSH(basePath);
+            return Success("初始化系统成功");
+        },
+        ToResultMessage);
+}
+
+napi_value Core::InitSystem(napi_env env, napi_callback_info info) noexcept {
+    return InitSystemImpl(env, info, false);
+}
 
-    return Messages::NewResultMessage(env, true, "初始化系统成功");
+napi_value Core::InitSystemAsync(napi_env env, napi_callback_info info) noexcept {
+    return InitSystemImpl(env, info, true);
 }
 
-napi_value Core::InitRepo(napi_env env, napi_callback_info info) noexcept {
+static napi_value InitRepoImpl(napi_env env, napi_callback_info info, bool async) {
     char const *from = "Core::InitRepo-NAPI";
     OH_LOG_INFO(LOG_APP, "================= Core::InitRepo-NAPI =================");
+    TraceSpan span("napi", from);
     constexpr size_t expectedParams = 4U;
     constexpr size_t basePathIdx = 0U;
     constexpr size_t repoURLIdx = 1U;
@@ -88,85 +140,318 @@ napi_value Core::InitRepo(napi_env env, napi_callback_info info) noexcept {
 
     if (Core::GetInstance()->FindRepoManager(repoURL.value()) != nullptr) {
         OH_LOG_INFO(LOG_APP, "RepoManager already exists for url: %{public}s", repoURL.value().c_str());
-        return Messages::NewResultMessage(env, true, "初始化仓库成功");
+        return Async::Settle(env, async, Messages::NewResultMessage(env, true, "初始化仓库成功"));
     }
 
-    // 新建 RepoManager 并按目录是否存在决定 open 或 init
+    struct InitRepoOutcome {
+        ResultPayload payload;
+        std::unique_ptr<RepoManager> manager;
+    };
+
+    return Async::Dispatch(
+        env, from, async,
+        [repoDir, repoURL = repoURL.value()]() {
+            // 新建 RepoManager 并按目录是否存在决定 open 或 init
+            auto manager = std::make_unique<RepoManager>();
+
+            if (std::filesystem::exists(repoDir)) {
+                // 目录存在，视为已创建过仓库：打开
+                OH_LOG_INFO(LOG_APP, "Open existing repo at: %{public}s", repoDir.c_str());
+            } else {
+                // 目录不存在，创建目录并初始化裸仓库
+                if (std::filesystem::create_directories(repoDir)) {
+                    OH_LOG_INFO(LOG_APP, "Create directory success: %{public}s", repoDir.c_str());
+                } else {
+                    OH_LOG_ERROR(LOG_APP, "Create directory failed: %{public}s", repoDir.c_str());
+                    return InitRepoOutcome{Failure("创建目录失败"), nullptr};
+                }
+                OH_LOG_INFO(LOG_APP, "Init new bare repo at: %{public}s", repoDir.c_str());
+            }
+
+            // 只打开本地仓库，不连接远程：离线时也能立即打开，需要网络的操作各自建立连接
+            if (!manager->openLocal(repoURL, repoDir)) {
+                OH_LOG_ERROR(LOG_APP, "Init/open repository failed at: %{public}s, error: %{public}s", repoDir.c_str(),
+                             manager->getLastError().c_str());
+                return InitRepoOutcome{Failure(manager->getLastError()), nullptr};
+            }
+            OH_LOG_INFO(LOG_APP, "Init/open Repo success");
+            return InitRepoOutcome{Success("初始化仓库成功"), std::move(manager)};
+        },
+        [repoURL = repoURL.value()](napi_env env, InitRepoOutcome &outcome) {
+            // 放入 Core 的内存缓存，key 为 repoURL；并发初始化同一仓库时保留先完成的那个
+            if (outcome.manager != nullptr) {
+                if (!Core::GetInstance()->StoreRepoManager(repoURL, std::move(outcome.manager))) {
+                    OH_LOG_INFO(LOG_APP, "RepoManager already exists for url: %{public}s", repoURL.c_str());
+                }
+            }
+            return ToResultMessage(env, outcome.payload);
+        });
+}
+
+napi_value Core::InitRepo(napi_env env, napi_callback_info info) noexcept { return InitRepoImpl(env, info, false); }
+
+napi_value Core::InitRepoAsync(napi_env env, napi_callback_info info) noexcept {
+    return InitRepoImpl(env, info, true);
+}
+
+/**
+ * @brief 打开一个仓库并放入缓存，返回给首页的状态写入 status
+ * 仓库已在缓存中时直接复用；只做文件IO，不经过仓库执行器
+ * @return 仓库管理器，打开失败时返回空，原因写入 status["message"]
+ */
+static std::shared_ptr<RepoManager> OpenRepository(const std::filesystem::path &repoDir, nlohmann::json &status) {
+    TraceSpan span("repo", "OpenRepository");
+    status = {
+        {"provider", repoDir.parent_path().filename().string()},
+        {"name", repoDir.filename().string()},
+        {"ready", false},
+    };
+
     auto manager = std::make_unique<RepoManager>();
+    if (!manager->openRepository(repoDir.string())) {
+        status["message"] = manager->getLastError();
+        return nullptr;
+    }
+    std::string const url = manager->getRemoteUrl("origin");
+    if (url.empty()) {
+        status["message"] = "仓库未配置远程地址";
+        return nullptr;
+    }
+    status["url"] = url;
 
-    bool ok = false;
-    if (std::filesystem::exists(repoDir)) {
-        // 目录存在，视为已创建过仓库：打开
-        OH_LOG_INFO(LOG_APP, "Open existing repo at: %{public}s", repoDir.c_str());
-        ok = manager->openRepository(repoDir);
-        ok = manager->connectRemote(repoURL.value(), repoDir);
-    } else {
-        // 目录不存在，创建目录并初始化裸仓库
-        if (std::filesystem::create_directories(repoDir)) {
-            OH_LOG_INFO(LOG_APP, "Create directory success: %{public}s", repoDir.c_str());
-        } else {
-            OH_LOG_ERROR(LOG_APP, "Create directory failed: %{public}s", repoDir.c_str());
-            return Messages::NewResultMessage(env, false, "创建目录失败");
-        }
-        OH_LOG_INFO(LOG_APP, "Init new bare repo at: %{public}s", repoDir.c_str());
-        ok = manager->connectRemote(repoURL.value(), repoDir);
+    // 并发的 initRepo 先完成时沿用已缓存的仓库
+    std::shared_ptr<RepoManager> repoManager = Core::GetInstance()->FindRepoManager(url);
+    if (repoManager == nullptr) {
+        Core::GetInstance()->StoreRepoManager(url, std::move(manager));
+        repoManager = Core::GetInstance()->FindRepoManager(url);
+    }
+    if (repoManager == nullptr) {
+        status["message"] = "仓库已被移除";
+    }
+    return repoManager;
+}
+
+/**
+ * @brief 预热仓库，把就绪状态写入 status
+ * 须作为共享任务在仓库执行器上调用
+ */
+static void WarmUpRepository(RepoManager &repoManager, int pageSize, nlohmann::json &status) {
+    TraceSpan span("repo", "WarmUpRepository");
+    WarmUpInfo info = repoManager.warmUp(pageSize);
+
+    status["branch"] = info.branch;
+    status["branches"] = info.branchCount;
+    status["tags"] = info.tagCount;
+    status["commits"] = info.commits.size();
+    status["ready"] = true;
+    if (info.commits.empty()) {
+        // 尚未拉取过的仓库也算打开成功，只是没有历史可展示
+        status["message"] = repoManager.getLastError();
+        return;
+    }
+    auto const &latest = info.commits.front();
+    status["time"] = latest.timestamp;
+    status["activity"] = latest.shortMessage;
+}
+
+napi_value Core::OpenAll(napi_env env, napi_callback_info info) noexcept {
+    char const *from = "Core::OpenAll-NAPI";
+    OH_LOG_INFO(LOG_APP, "================= Core::OpenAll-NAPI =================");
+    TraceSpan span("napi", from);
+
+    constexpr size_t expectedParams = 3U;
+    constexpr size_t basePathIdx = 0U;
+    constexpr size_t pageSizeIdx = 1U;
+    constexpr size_t callbackIdx = 2U;
+
+    size_t argc = expectedParams;
+
+    napi_value argv[expectedParams]{};
+
+    bool const result = Utils::extractParameters(env, info, expectedParams, &argc, argv, from);
+    if (!result) {
+        return nullptr;
+    }
+
+    auto const basePath = Utils::extractString(env, argv[basePathIdx], "Can't extract basePath", from);
+    if (!basePath.has_value()) {
+        return nullptr;
+    }
+
+    auto const pageSize = Utils::extractInteger(env, argv[pageSizeIdx], "Can't extract pageSize", from);
+    if (!pageSize.has_value()) {
+        return nullptr;
     }
 
-    if (!ok) {
-        OH_LOG_ERROR(LOG_APP, "Init/open repository failed at: %{public}s, error: %{public}s", repoDir.c_str(),
-                     manager->getLastError().c_str());
-        return Messages::NewResultMessage(env, false, manager->getLastError());
+    auto callback = Async::StreamCallback::Create(env, argv[callbackIdx], from);
+    if (callback == nullptr) {
+        return Messages::NewResultMessage(env, false, "创建回调失败");
     }
-    OH_LOG_INFO(LOG_APP, "Init/open Repo success");
-    // 放入 Core 的内存缓存，key 为 repoURL
-    Core::GetInstance()->StoreRepoManager(repoURL.value(), std::move(manager));
 
-    return Messages::NewResultMessage(env, true, "初始化仓库成功");
+    struct OpenAllTask {
+        size_t total = 0;
+        std::atomic<size_t> ready{0};
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t warming = 0; ///< 已提交、尚未结束的预热任务数
+
+        void finishWarming() {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--warming == 0) {
+                done.notify_all();
+            }
+        }
+    };
+    auto task = std::make_shared<OpenAllTask>();
+
+    return Async::RunPromise(
+        env, from,
+        [task, callback, basePath = basePath.value(), pageSize = pageSize.value() > 0 ? pageSize.value() : 5]() {
+            // 目录结构为 repos/<provider>/<name>
+            std::vector<std::filesystem::path> repoDirs;
+            std::error_code ec;
+            for (const auto &provider : std::filesystem::directory_iterator(basePath + "/repos", ec)) {
+                if (!provider.is_directory(ec)) {
+                    continue;
+                }
+                for (const auto &repo : std::filesystem::directory_iterator(provider.path(), ec)) {
+                    if (repo.is_directory(ec)) {
+                        repoDirs.push_back(repo.path());
+                    }
+                }
+            }
+            task->total = repoDirs.size();
+
+            // 打开仓库以文件IO为主，各仓库互不相关，分摊到工作线程
+            auto post = [callback](const nlohmann::json &status) {
+                callback->Post(status.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace));
+            };
+            std::vector<std::shared_ptr<RepoManager>> managers(repoDirs.size());
+            std::vector<nlohmann::json> statuses(repoDirs.size());
+            ThreadPool::Shared().parallelFor(repoDirs.size(), [&](size_t i) {
+                managers[i] = OpenRepository(repoDirs[i], statuses[i]);
+                if (managers[i] == nullptr) {
+                    post(statuses[i]);
+                }
+            });
+
+            // 预热作为共享任务提交到各仓库的执行器，不能在线程池线程上用 run 等待：
+            // 排在前面的独占任务（fetch、删除、缓存回收）也要靠线程池执行，工作线程全部等待时会死锁
+            for (size_t i = 0; i < managers.size(); ++i) {
+                if (managers[i] == nullptr) {
+                    continue;
+                }
+                {
+                    std::lock_guard<std::mutex> lock(task->mutex);
+                    task->warming++;
+                }
+                auto warmUp = [task, post, pageSize, manager = managers[i],
+                               status = std::move(statuses[i])]() mutable {
+                    // 预热或投递抛出异常时也要计数，否则下面的等待不会结束
+                    struct Finish {
+                        OpenAllTask &task;
+                        ~Finish() { task.finishWarming(); }
+                    } finish{*task};
+                    WarmUpRepository(*manager, pageSize, status);
+                    if (status["ready"].get<bool>()) {
+                        task->ready++;
+                    }
+                    post(status);
+                };
+                try {
+                    managers[i]->executor()->submit(Access::Shared, std::move(warmUp));
+                } catch (const std::exception &e) {
+                    OH_LOG_ERROR(LOG_APP, "OpenAll - submit warm-up failed: %{public}s", e.what());
+                    task->finishWarming();
+                }
+            }
+
+            // 这里是 NAPI 的异步工作线程而不是线程池线程，等待不会占用执行预热任务的线程
+            std::unique_lock<std::mutex> lock(task->mutex);
+            task->done.wait(lock, [&task] { return task->warming == 0; });
+            lock.unlock();
+            callback->Release();
+        },
+        [task](napi_env env) {
+            OH_LOG_INFO(LOG_APP, "OpenAll ready %{public}zu/%{public}zu", task->ready.load(), task->total);
+            nlohmann::json json = {
+                {"total", task->total},
+                {"ready", task->ready.load()},
+            };
+            return Messages::NewResultMessage(env, true, "仓库已就绪", json.dump());
+        });
 }
 
-napi_value Core::GetBranches(napi_env env, napi_callback_info info) noexcept {
+static napi_value GetBranchesImpl(napi_env env, napi_callback_info info, bool async) {
     char const *from = "Core::GetBranches-NAPI";
     OH_LOG_INFO(LOG_APP, "================= Core::GetBranches-NAPI =================");
+    TraceSpan span("napi", from);
 
     auto repoManager = Utils::FindRepoManager(env, info, from);
     if (repoManager == nullptr) {
         OH_LOG_INFO(LOG_APP, "仓库未初始化");
-        return Messages::NewResultMessage(env, false, "仓库未初始化");
+        return Async::Settle(env, async, Messages::NewResultMessage(env, false, "仓库未初始化"));
     }
 
-    auto branches = repoManager->getRemoteBranches();
-    if (branches.empty()) {
-        OH_LOG_ERROR(LOG_APP, "GetBranches failed: %{public}s", repoManager->getLastError().c_str());
-        return Messages::NewResultMessage(env, false, repoManager->getLastError());
-    }
-    nlohmann::json json;
-    for (auto &branch : branches) {
-        json.push_back(branch.name);
-    }
-    OH_LOG_INFO(LOG_APP, "GetBranches success");
-    return Messages::NewResultMessage(env, true, "GetBranches success", json.dump());
+    return Async::Dispatch(
+        env, from, async, repoManager->executor(), Access::Shared,
+        [repoManager]() {
+            std::vector<BranchInfo> branches;
+            if (!repoManager->getRemoteBranches(branches)) {
+                OH_LOG_ERROR(LOG_APP, "GetBranches failed: %{public}s", repoManager->getLastError().c_str());
+                return Failure(repoManager->getLastError());
+            }
+            nlohmann::json json = nlohmann::json::array();
+            for (auto &branch : branches) {
+                json.push_back(branch.name);
+            }
+            OH_LOG_INFO(LOG_APP, "GetBranches success");
+            return Success("GetBranches success", json.dump());
+        },
+        ToResultMessage);
 }
 
-napi_value Core::GetTags(napi_env env, napi_callback_info info) noexcept {
+napi_value Core::GetBranches(napi_env env, napi_callback_info info) noexcept {
+    return GetBranchesImpl(env, info, false);
+}
+
+napi_value Core::GetBranchesAsync(napi_env env, napi_callback_info info) noexcept {
+    return GetBranchesImpl(env, info, true);
+}
+
+static napi_value GetTagsImpl(napi_env env, napi_callback_info info, bool async) {
     char const *from = "Core::GetTags-NAPI";
     OH_LOG_INFO(LOG_APP, "================= Core::GetTags-NAPI =================");
+    TraceSpan span("napi", from);
 
     auto repoManager = Utils::FindRepoManager(env, info, from);
     if (repoManager == nullptr) {
         OH_LOG_ERROR(LOG_APP, "仓库未初始化");
-        return Messages::NewResultMessage(env, false, "仓库未初始化");
+        return Async::Settle(env, async, Messages::NewResultMessage(env, false, "仓库未初始化"));
     }
 
-    auto tags = repoManager->getRemoteTags();
-    if (tags.empty()) {
-        return Messages::NewResultMessage(env, true, "GetTags success", "[]");
-    }
-    nlohmann::json json;
-    for (auto &tag : tags) {
-        json.push_back(tag.name);
-    }
-    OH_LOG_INFO(LOG_APP, "GetTags success");
-    return Messages::NewResultMessage(env, true, "GetTags success", json.dump());
+    return Async::Dispatch(
+        env, from, async, repoManager->executor(), Access::Shared,
+        [repoManager]() {
+            std::vector<TagInfo> tags;
+            if (!repoManager->getRemoteTags(tags)) {
+                OH_LOG_ERROR(LOG_APP, "GetTags failed: %{public}s", repoManager->getLastError().c_str());
+                return Failure(repoManager->getLastError());
+            }
+            nlohmann::json json = nlohmann::json::array();
+            for (auto &tag : tags) {
+                json.push_back(tag.name);
+            }
+            OH_LOG_INFO(LOG_APP, "GetTags success");
+            return Success("GetTags success", json.dump());
+        },
+        ToResultMessage);
+}
+
+napi_value Core::GetTags(napi_env env, napi_callback_info info) noexcept { return GetTagsImpl(env, info, false); }
+
+napi_value Core::GetTagsAsync(napi_env env, napi_callback_info info) noexcept {
+    return GetTagsImpl(env, info, true);
 }
 
 struct FetchCallbackData {
@@ -175,9 +460,26 @@ struct FetchCallbackData {
     std::string message;
 };
 
-napi_value Core::Fetch(napi_env env, napi_callback_info info) noexcept {
+// 在 JS 线程把工作线程投递的进度转换为 callback(process, total, message)
+static void CallFetchCallback(napi_env env, napi_value jsCallback, void *, void *data) {
+    std::unique_ptr<FetchCallbackData> progress(static_cast<FetchCallbackData *>(data));
+    if (env == nullptr || jsCallback == nullptr) {
+        return;
+    }
+    napi_value argv[3];
+    napi_create_int32(env, progress->process, &argv[0]);
+    napi_create_int32(env, progress->total, &argv[1]);
+    napi_create_string_utf8(env, progress->message.c_str(), NAPI_AUTO_LENGTH, &argv[2]);
+    napi_status status = napi_call_function(env, nullptr, jsCallback, 3, argv, nullptr);
+    if (status != napi_ok) {
+        OH_LOG_ERROR(LOG_APP, "Core::CallFetchCallback napi_call_function failed with status: %{public}d", status);
+    }
+}
+
+static napi_value FetchImpl(napi_env env, napi_callback_info info, bool async) {
     char const *from = "Core::Fetch-NAPI";
     OH_LOG_INFO(LOG_APP, "================= Core::Fetch-NAPI =================");
+    TraceSpan span("napi", from);
 
     constexpr size_t expectedParams = 3U;
     constexpr size_t repoURLIdx = 0U;
@@ -206,55 +508,82 @@ napi_value Core::Fetch(napi_env env, napi_callback_info info) noexcept {
     auto const repoManager = Core::GetInstance()->FindRepoManager(repoURL.value());
     if (repoManager == nullptr) {
         OH_LOG_ERROR(LOG_APP, "RepoManager not found for url: %{public}s", repoURL.value().c_str());
-        return Messages::NewResultMessage(env, false, "仓库未初始化");
+        return Async::Settle(env, async, Messages::NewResultMessage(env, false, "仓库未初始化"));
     }
     OH_LOG_INFO(LOG_APP, "Fetching branch: %{public}s", branch.value().c_str());
 
-    napi_value startCallbackData[3];
-    napi_create_int32(env, 0, &startCallbackData[0]);
-    napi_create_int32(env, 0, &startCallbackData[1]);
-    napi_create_string_utf8(env, "start", NAPI_AUTO_LENGTH, &startCallbackData[2]);
-    napi_status startStatus = napi_call_function(env, nullptr, argv[callbackIdx], 3, startCallbackData, nullptr);
-    if (startStatus != napi_ok) {
-        OH_LOG_ERROR(LOG_APP, "Core::callMessageCallback napi_call_threadsafe_function failed with status: %{public}d",
-                     startStatus);
-    }
-
-    auto fetchResult = repoManager->fetch(
-        "origin", {branch.value()}, 0, [env, argv](unsigned int receivedObjects, unsigned int totalObjects) {
-            napi_value data[3];
-            napi_create_int32(env, receivedObjects, &data[0]);
-            napi_create_int32(env, totalObjects, &data[1]);
-            napi_create_string_utf8(env, "processing", NAPI_AUTO_LENGTH, &data[2]);
-            napi_status status = napi_call_function(env, nullptr, argv[callbackIdx], 3, data, nullptr);
-            if (status != napi_ok) {
-                OH_LOG_ERROR(LOG_APP,
-                             "Core::callMessageCallback napi_call_threadsafe_function failed with status: %{public}d",
-                             status);
-            }
-        });
-
-    napi_value endCallbackData[3];
-    napi_create_int32(env, 0, &endCallbackData[0]);
-    napi_create_int32(env, 0, &endCallbackData[1]);
-    napi_create_string_utf8(env, "end", NAPI_AUTO_LENGTH, &endCallbackData[2]);
-    napi_status endStatus = napi_call_function(env, nullptr, argv[callbackIdx], 3, endCallbackData, nullptr);
-    if (endStatus != napi_ok) {
-        OH_LOG_ERROR(LOG_APP, "Core::callMessageCallback napi_call_threadsafe_function failed with status: %{public}d",
-                     endStatus);
+    auto finish = [repoManager](bool fetchResult) {
+        if (!fetchResult) {
+            OH_LOG_ERROR(LOG_APP, "Fetch failed: %{public}s", repoManager->getLastError().c_str());
+            return Failure(repoManager->getLastError());
+        }
+        return Success("拉取分支成功");
+    };
+
+    if (!async) {
+        napi_value callback = argv[callbackIdx];
+        auto report = [env, callback](unsigned int process, unsigned int total, const char *message) {
+            CallFetchCallback(env, callback, nullptr, new FetchCallbackData{process, total, message});
+        };
+        ResultPayload payload;
+        // 进度回调要在 JS 线程上调用，因此独占执行器后在当前线程拉取；仓库正忙时只短暂等待
+        bool const admitted = repoManager->executor()->tryRun(Access::Exclusive, [&]() {
+            report(0, 0, "start");
+            auto fetchResult = repoManager->fetch(
+                "origin", {branch.value()}, 0,
+                [&report](unsigned int receivedObjects, unsigned int totalObjects) {
+                    report(receivedObjects, totalObjects, "processing");
+                });
+            report(0, 0, "end");
+            payload = finish(fetchResult);
+        }, RepoExecutor::SYNC_WAIT);
+        if (!admitted) {
+            return Messages::NewResultMessage(env, false, Async::BUSY_MESSAGE);
+        }
+        return ToResultMessage(env, payload);
     }
 
-    if (!fetchResult) {
-        OH_LOG_ERROR(LOG_APP, "Fetch failed: %{public}s", repoManager->getLastError().c_str());
-        return Messages::NewResultMessage(env, false, repoManager->getLastError());
+    napi_value resourceName = nullptr;
+    napi_create_string_utf8(env, from, NAPI_AUTO_LENGTH, &resourceName);
+    napi_threadsafe_function tsfn = nullptr;
+    napi_status status = napi_create_threadsafe_function(env, argv[callbackIdx], nullptr, resourceName, 16, 1, nullptr,
+                                                         nullptr, nullptr, CallFetchCallback, &tsfn);
+    if (status != napi_ok) {
+        OH_LOG_ERROR(LOG_APP, "Fetch - napi_create_threadsafe_function failed: %{public}d", status);
+        return Async::Settle(env, async, Messages::NewResultMessage(env, false, "创建回调失败"));
     }
 
-    return Messages::NewResultMessage(env, true, "拉取分支成功");
+    return Async::Dispatch(
+        env, from, async, repoManager->executor(), Access::Exclusive,
+        [tsfn, finish, repoManager, branch = branch.value()]() {
+            // start/end 必须送达，传输进度在队列满时直接丢弃，避免拖慢下载
+            auto report = [tsfn](unsigned int process, unsigned int total, const char *message,
+                                 napi_threadsafe_function_call_mode mode) {
+                auto *data = new FetchCallbackData{process, total, message};
+                if (napi_call_threadsafe_function(tsfn, data, mode) != napi_ok) {
+                    delete data;
+                }
+            };
+            report(0, 0, "start", napi_tsfn_blocking);
+            auto fetchResult = repoManager->fetch(
+                "origin", {branch}, 0, [&report](unsigned int receivedObjects, unsigned int totalObjects) {
+                    report(receivedObjects, totalObjects, "processing", napi_tsfn_nonblocking);
+                });
+            report(0, 0, "end", napi_tsfn_blocking);
+            napi_release_threadsafe_function(tsfn, napi_tsfn_release);
+            return finish(fetchResult);
+        },
+        ToResultMessage);
 }
 
-napi_value Core::GetHistory(napi_env env, napi_callback_info info) noexcept {
+napi_value Core::Fetch(napi_env env, napi_callback_info info) noexcept { return FetchImpl(env, info, false); }
+
+napi_value Core::FetchAsync(napi_env env, napi_callback_info info) noexcept { return FetchImpl(env, info, true); }
+
+static napi_value GetHistoryImpl(napi_env env, napi_callback_info info, bool async) {
     char const *from = "Core::GetHistory-NAPI";
     OH_LOG_INFO(LOG_APP, "================= Core::GetHistory-NAPI =================");
+    TraceSpan span("napi", from);
 
     constexpr size_t expectedParams = 4U;
     constexpr size_t repoURLIdx = 0U;
@@ -294,50 +623,143 @@ napi_value Core::GetHistory(napi_env env, napi_callback_info info) noexcept {
     auto const repoManager = Core::GetInstance()->FindRepoManager(repoURL.value());
     if (repoManager == nullptr) {
         OH_LOG_ERROR(LOG_APP, "RepoManager not found for url: %{public}s", repoURL.value().c_str());
-        return Messages::NewResultMessage(env, false, "仓库未初始化");
+        return Async::Settle(env, async, Messages::NewResultMessage(env, false, "仓库未初始化"));
     }
 
-    auto const history = repoManager->getCommitHistory(branch.value(), count.value(), offset.value());
-    if (history.empty()) {
-        return Messages::NewResultMessage(env, true, "获取提交历史成功", "[]");
-    }
-    nlohmann::json json;
-    for (auto &commit : history) {
-        json.push_back({
-            {"id", commit.id},
-            {"shortId", commit.shortId},
-            {"author", commit.author},
-            {"email", commit.email},
-            {"timestamp", commit.timestamp},
-            {"message", commit.message},
-            {"shortMessage", commit.shortMessage},
-        });
+    return Async::Dispatch(
+        env, from, async, repoManager->executor(), Access::Shared,
+        [repoManager, branch = branch.value(), count = count.value(), offset = offset.value()]() {
+            std::vector<CommitInfo> history;
+            if (!repoManager->getCommitHistory(history, branch, count, offset)) {
+                return Failure(repoManager->getLastError());
+            }
+            nlohmann::json json = nlohmann::json::array();
+            for (auto &commit : history) {
+                json.push_back({
+                    {"id", commit.id},
+                    {"shortId", commit.shortId},
+                    {"author", commit.author},
+                    {"email", commit.email},
+                    {"timestamp", commit.timestamp},
+                    {"message", commit.message},
+                    {"shortMessage", commit.shortMessage},
+                });
+            }
+            return Success("获取提交历史成功", json.dump());
+        },
+        ToResultMessage);
+}
+
+napi_value Core::GetHistory(napi_env env, napi_callback_info info) noexcept {
+    return GetHistoryImpl(env, info, false);
+}
+
+napi_value Core::GetHistoryAsync(napi_env env, napi_callback_info info) noexcept {
+    return GetHistoryImpl(env, info, true);
+}
+
+static const char *SSHKeyStateName(SSHKeyState state) {
+    switch (state) {
+    case SSHKeyState::Generating:
+        return "generating";
+    case SSHKeyState::Ready:
+        return "ready";
+    case SSHKeyState::Failed:
+        return "failed";
+    default:
+        return "missing";
     }
-    return Messages::NewResultMessage(env, true, "获取提交历史成功", json.dump());
 }
 
-napi_value Core::GetSSHKey(napi_env env, napi_callback_info info) noexcept {
+static napi_value GetSSHKeyImpl(napi_env env, bool async) {
     char const *from = "Core::GetSSHKey-NAPI";
     OH_LOG_INFO(LOG_APP, "================= Core::GetSSHKey-NAPI =================");
+    TraceSpan span("napi", from);
 
-    auto sshKey = Core::GetInstance()->GetSSHKey();
-    return Messages::NewResultMessage(env, true, "获取 SSH 密钥成功", sshKey);
+    // 异步版本在工作线程等待首次启动时的后台生成结束，同步版本立即返回当前密钥
+    return Async::Dispatch(
+        env, from, async,
+        [async]() { return Success("获取 SSH 密钥成功", Core::GetInstance()->GetSSHKeyStatus(async).publicKey); },
+        ToResultMessage);
 }
 
-napi_value Core::GenerateSSHKey(napi_env env, napi_callback_info info) noexcept {
+napi_value Core::GetSSHKey(napi_env env, napi_callback_info info) noexcept { return GetSSHKeyImpl(env, false); }
+
+napi_value Core::GetSSHKeyAsync(napi_env env, napi_callback_info info) noexcept { return GetSSHKeyImpl(env, true); }
+
+static napi_value GenerateSSHKeyImpl(napi_env env, napi_callback_info info, bool async) {
     char const *from = "Core::GenerateSSHKey-NAPI";
     OH_LOG_INFO(LOG_APP, "================= Core::GenerateSSHKey-NAPI =================");
+    TraceSpan span("napi", from);
+
+    // 可选参数：密钥算法，"rsa" 或 "ecdsa"（默认）
+    constexpr size_t maxParams = 1U;
+    size_t argc = maxParams;
+    napi_value argv[maxParams]{};
+    if (!Utils::checkNAPIResult(napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr), env, from,
+                                "Can't extract arguments")) {
+        return nullptr;
+    }
 
-    auto sshKey = Core::GetInstance()->GenerateSSHKey();
-    if (sshKey.empty()) {
-        return Messages::NewResultMessage(env, false, "生成 SSH 密钥失败");
+    SSHKeyAlgorithm algorithm = SSHKeyAlgorithm::ECDSA;
+    napi_valuetype type = napi_undefined;
+    if (argc >= maxParams && napi_typeof(env, argv[0], &type) == napi_ok && type != napi_undefined) {
+        auto const name = Utils::extractString(env, argv[0], "Can't extract algorithm", from);
+        if (!name.has_value()) {
+            return nullptr;
+        }
+        if (name.value() == "rsa") {
+            algorithm = SSHKeyAlgorithm::RSA;
+        } else if (name.value() != "ecdsa") {
+            return Messages::NewResultMessage(env, false, "不支持的密钥算法: " + name.value(), "");
+        }
     }
-    return Messages::NewResultMessage(env, true, "生成 SSH 密钥成功", sshKey);
+
+    // 生成在线程池上进行，已有生成任务时等待它的结果
+    bool started = Core::GetInstance()->GenerateSSHKey(algorithm);
+    OH_LOG_INFO(LOG_APP, "SSH key generation %{public}s", started ? "started" : "already running");
+
+    return Async::Dispatch(
+        env, from, async,
+        [async]() {
+            if (!async) {
+                return Success("正在后台生成 SSH 密钥");
+            }
+            auto status = Core::GetInstance()->GetSSHKeyStatus(true);
+            if (!status.message.empty() || status.publicKey.empty()) {
+                return Failure("生成 SSH 密钥失败: " + status.message);
+            }
+            return Success("生成 SSH 密钥成功", status.publicKey);
+        },
+        ToResultMessage);
 }
 
-napi_value Core::DeleteRepo(napi_env env, napi_callback_info info) noexcept {
+napi_value Core::GenerateSSHKey(napi_env env, napi_callback_info info) noexcept {
+    return GenerateSSHKeyImpl(env, info, false);
+}
+
+napi_value Core::GenerateSSHKeyAsync(napi_env env, napi_callback_info info) noexcept {
+    return GenerateSSHKeyImpl(env, info, true);
+}
+
+napi_value Core::GetSSHKeyStatus(napi_env env, napi_callback_info info) noexcept {
+    OH_LOG_INFO(LOG_APP, "================= Core::GetSSHKeyStatus-NAPI =================");
+    TraceSpan span("napi", "Core::GetSSHKeyStatus-NAPI");
+
+    auto status = Core::GetInstance()->GetSSHKeyStatus(false);
+    nlohmann::json result = {
+        {"state", SSHKeyStateName(status.state)},
+        {"type", status.keyType},
+        {"fingerprint", status.fingerprint},
+        {"message", status.message},
+    };
+    return Messages::NewResultMessage(env, true, "获取 SSH 密钥状态成功", result.dump());
+}
+
+static napi_value DeleteRepoImpl(napi_env env, napi_callback_info info, bool async) {
     char const *from = "Core::DeleteRepo-NAPI";
     OH_LOG_INFO(LOG_APP, "================= Core::DeleteRepo-NAPI =================");
+    TraceSpan span("napi", from);
 
     constexpr size_t expectedParams = 4U;
     constexpr size_t basePathIdx = 0U;
@@ -379,27 +801,39 @@ napi_value Core::DeleteRepo(napi_env env, napi_callback_info info) noexcept {
 
     auto repoDir = basePath.value() + "/repos/" + provider.value() + "/" + repoName.value();
 
-    if (Core::GetInstance()->FindRepoManager(repoURL.value()) != nullptr) {
-        Core::GetInstance()->DeleteRepoManager(repoURL.value());
-    }
-
-    // 删除目录
-    if (std::filesystem::exists(repoDir)) {
-        if (std::filesystem::remove_all(repoDir)) {
-            OH_LOG_INFO(LOG_APP, "Delete directory success: %{public}s", repoDir.c_str());
-        } else {
-            OH_LOG_ERROR(LOG_APP, "Delete directory failed: %{public}s", repoDir.c_str());
-            return Messages::NewResultMessage(env, false, "删除目录失败");
-        }
-    }
+    // 先从缓存中移除，之后的调用不会再拿到这个仓库；目录在该仓库排队中的操作都结束后再删除
+    auto const removed = Core::GetInstance()->DeleteRepoManager(repoURL.value());
+    auto const executor = removed != nullptr ? removed->executor() : nullptr;
+
+    return Async::Dispatch(
+        env, from, async, executor, Access::Exclusive,
+        [repoDir]() {
+            // 删除目录
+            if (std::filesystem::exists(repoDir)) {
+                if (std::filesystem::remove_all(repoDir)) {
+                    OH_LOG_INFO(LOG_APP, "Delete directory success: %{public}s", repoDir.c_str());
+                } else {
+                    OH_LOG_ERROR(LOG_APP, "Delete directory failed: %{public}s", repoDir.c_str());
+                    return Failure("删除目录失败");
+                }
+            }
+            return Success("删除仓库成功");
+        },
+        ToResultMessage);
+}
 
-    return Messages::NewResultMessage(env, true, "删除仓库成功");
+napi_value Core::DeleteRepo(napi_env env, napi_callback_info info) noexcept {
+    return DeleteRepoImpl(env, info, false);
 }
 
+napi_value Core::DeleteRepoAsync(napi_env env, napi_callback_info info) noexcept {
+    return DeleteRepoImpl(env, info, true);
+}
 
-napi_value Core::GetFileTree(napi_env env, napi_callback_info info) noexcept {
+static napi_value GetFileTreeImpl(napi_env env, napi_callback_info info, bool async) {
     char const *from = "Core::GetFileTree-NAPI";
     OH_LOG_INFO(LOG_APP, "================= Core::GetFileTree-NAPI =================");
+    TraceSpan span("napi", from);
 
     constexpr size_t expectedParams = 2U;
     constexpr size_t repoURLIdx = 0U;
@@ -427,33 +861,49 @@ napi_value Core::GetFileTree(napi_env env, napi_callback_info info) noexcept {
     auto const repoManager = Core::GetInstance()->FindRepoManager(repoURL.value());
     if (repoManager == nullptr) {
         OH_LOG_ERROR(LOG_APP, "RepoManager not found for url: %{public}s", repoURL.value().c_str());
-        return Messages::NewResultMessage(env, false, "仓库未初始化");
+        return Async::Settle(env, async, Messages::NewResultMessage(env, false, "仓库未初始化"));
     }
 
-    auto const fileTree = repoManager->getBranchFileTree(branch.value());
-    if (fileTree.empty()) {
-        return Messages::NewResultMessage(env, true, "获取文件树成功", "[]");
-    }
-    nlohmann::json json;
-    for (auto &file : fileTree) {
-        json.push_back({
-            {"id", file.id},
-            {"parentId", file.parentId},
-            {"name", file.name},
-            {"path", file.path},
-            {"isDirectory", file.isDirectory},
-            {"fileId", file.fileId},
-            {"mode", file.mode},
-            {"size", file.size},
-            {"extension", file.extension},
-        });
-    }
-    return Messages::NewResultMessage(env, true, "获取文件树成功", json.dump());
+    return Async::Dispatch(
+        env, from, async, repoManager->executor(), Access::Shared,
+        [repoManager, branch = branch.value()]() {
+            // 直接从紧凑文件树序列化，路径等字符串只在输出时临时生成
+            auto const fileTree = repoManager->getCompactFileTree(branch);
+            if (fileTree == nullptr || fileTree->size() == 0) {
+                return Success("获取文件树成功", "[]");
+            }
+            nlohmann::json json = nlohmann::json::array();
+            for (uint32_t i = 0; i < fileTree->size(); ++i) {
+                uint32_t parent = fileTree->parent(i);
+                json.push_back({
+                    {"id", i + 1},
+                    {"parentId", parent == CompactFileTree::NO_PARENT ? -1 : static_cast<int64_t>(parent) + 1},
+                    {"name", fileTree->name(i)},
+                    {"path", fileTree->path(i)},
+                    {"isDirectory", fileTree->isDirectory(i)},
+                    {"fileId", fileTree->oidHex(i)},
+                    {"mode", fileTree->mode(i)},
+                    {"size", fileTree->fileSize(i)},
+                    {"extension", fileTree->extension(i)},
+                });
+            }
+            return Success("获取文件树成功", json.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace));
+        },
+        ToResultMessage);
+}
+
+napi_value Core::GetFileTree(napi_env env, napi_callback_info info) noexcept {
+    return GetFileTreeImpl(env, info, false);
+}
+
+napi_value Core::GetFileTreeAsync(napi_env env, napi_callback_info info) noexcept {
+    return GetFileTreeImpl(env, info, true);
 }
 
-napi_value Core::ReadFile(napi_env env, napi_callback_info info) noexcept {
+static napi_value ReadFileImpl(napi_env env, napi_callback_info info, bool async) {
     char const *from = "Core::ReadFile-NAPI";
     OH_LOG_INFO(LOG_APP, "================= Core::ReadFile-NAPI =================");
+    TraceSpan span("napi", from);
 
     constexpr size_t expectedParams = 3U;
     constexpr size_t repoURLIdx = 0U;
@@ -484,18 +934,938 @@ napi_value Core::ReadFile(napi_env env, napi_callback_info info) noexcept {
         return nullptr;
     }
 
+    auto const repoManager = Core::GetInstance()->FindRepoManager(repoURL.value());
+    if (repoManager == nullptr) {
+        OH_LOG_ERROR(LOG_APP, "RepoManager not found for url: %{public}s", repoURL.value().c_str());
+        return Async::Settle(env, async, Messages::NewResultMessage(env, false, "仓库未初始化"));
+    }
+
+    return Async::Dispatch(
+        env, from, async, repoManager->executor(), Access::Shared,
+        [repoManager, branch = branch.value(), path = path.value()]() {
+            auto fileContent = repoManager->readFile(branch, path);
+            if (!fileContent.exists) {
+                return Failure("文件不存在");
+            }
+            if (fileContent.isBinary) {
+                return Failure("无法读取二进制文件");
+            }
+            return Success("读取文件成功", std::move(fileContent.content));
+        },
+        ToResultMessage);
+}
+
+napi_value Core::ReadFile(napi_env env, napi_callback_info info) noexcept { return ReadFileImpl(env, info, false); }
+
+napi_value Core::ReadFileAsync(napi_env env, napi_callback_info info) noexcept {
+    return ReadFileImpl(env, info, true);
+}
+
+static napi_value GetCommitChangesImpl(napi_env env, napi_callback_info info, bool async) {
+    char const *from = "Core::GetCommitChanges-NAPI";
+    OH_LOG_INFO(LOG_APP, "================= Core::GetCommitChanges-NAPI =================");
+    TraceSpan span("napi", from);
+
+    constexpr size_t expectedParams = 2U;
+    constexpr size_t repoURLIdx = 0U;
+    constexpr size_t commitIdIdx = 1U;
+
+    size_t argc = expectedParams;
+
+    napi_value argv[expectedParams]{};
+
+    bool const result = Utils::extractParameters(env, info, expectedParams, &argc, argv, from);
+    if (!result) {
+        return nullptr;
+    }
+
+    auto const repoURL = Utils::extractString(env, argv[repoURLIdx], "Can't extract repoURL", from);
+    if (!repoURL.has_value()) {
+        return nullptr;
+    }
+
+    auto const commitId = Utils::extractString(env, argv[commitIdIdx], "Can't extract commitId", from);
+    if (!commitId.has_value()) {
+        return nullptr;
+    }
+
+    auto const repoManager = Core::GetInstance()->FindRepoManager(repoURL.value());
+    if (repoManager == nullptr) {
+        OH_LOG_ERROR(LOG_APP, "RepoManager not found for url: %{public}s", repoURL.value().c_str());
+        return Async::Settle(env, async, Messages::NewResultMessage(env, false, "仓库未初始化"));
+    }
+
+    return Async::Dispatch(
+        env, from, async, repoManager->executor(), Access::Shared,
+        [repoManager, commitId = commitId.value()]() {
+            std::vector<FileChange> changes;
+            if (!repoManager->getCommitChanges(commitId, changes)) {
+                return Failure(repoManager->getLastError());
+            }
+            nlohmann::json json = nlohmann::json::array();
+            for (auto &change : changes) {
+                json.push_back({
+                    {"path", change.path},
+                    {"oldPath", change.oldPath},
+                    {"status", std::string(1, change.status)},
+                    {"similarity", change.similarity},
+                    {"additions", change.additions},
+                    {"deletions", change.deletions},
+                    {"isBinary", change.isBinary},
+                    {"tooLarge", change.tooLarge},
+                    {"oldId", change.oldId},
+                    {"newId", change.newId},
+                });
+            }
+            return Success("获取提交变更成功", json.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace));
+        },
+        ToResultMessage);
+}
+
+napi_value Core::GetCommitChanges(napi_env env, napi_callback_info info) noexcept {
+    return GetCommitChangesImpl(env, info, false);
+}
+
+napi_value Core::GetCommitChangesAsync(napi_env env, napi_callback_info info) noexcept {
+    return GetCommitChangesImpl(env, info, true);
+}
+
+static nlohmann::json PatchHunksToJson(const std::vector<PatchHunk> &hunks) {
+    nlohmann::json json = nlohmann::json::array();
+    for (auto &hunk : hunks) {
+        nlohmann::json lines = nlohmann::json::array();
+        for (auto &line : hunk.lines) {
+            // 高亮区间是字节偏移，ArkTS 按 UTF-16 码元截取
+            Utf16::OffsetMap offsets(line.content);
+            nlohmann::json highlights = nlohmann::json::array();
+            for (auto &range : offsets.ranges(line.highlights)) {
+                highlights.push_back({range.first, range.second});
+            }
+            lines.push_back({
+                {"origin", std::string(1, line.origin)},
+                {"oldLineno", line.oldLineno},
+                {"newLineno", line.newLineno},
+                {"content", line.content},
+                {"highlights", highlights},
+            });
+        }
+        json.push_back({
+            {"header", hunk.header},
+            {"oldStart", hunk.oldStart},
+            {"oldLines", hunk.oldLines},
+            {"newStart", hunk.newStart},
+            {"newLines", hunk.newLines},
+            {"lines", lines},
+        });
+    }
+    return json;
+}
+
+napi_value Core::GetFilePatch(napi_env env, napi_callback_info info) noexcept {
+    char const *from = "Core::GetFilePatch-NAPI";
+    OH_LOG_INFO(LOG_APP, "================= Core::GetFilePatch-NAPI =================");
+    TraceSpan span("napi", from);
+
+    constexpr size_t expectedParams = 5U;
+    constexpr size_t repoURLIdx = 0U;
+    constexpr size_t commitIdIdx = 1U;
+    constexpr size_t pathIdx = 2U;
+    constexpr size_t optionsIdx = 3U;
+    constexpr size_t callbackIdx = 4U;
+
+    size_t argc = expectedParams;
+
+    napi_value argv[expectedParams]{};
+
+    bool const result = Utils::extractParameters(env, info, expectedParams, &argc, argv, from);
+    if (!result) {
+        return nullptr;
+    }
+
+    auto const repoURL = Utils::extractString(env, argv[repoURLIdx], "Can't extract repoURL", from);
+    if (!repoURL.has_value()) {
+        return nullptr;
+    }
+
+    auto const commitId = Utils::extractString(env, argv[commitIdIdx], "Can't extract commitId", from);
+    if (!commitId.has_value()) {
+        return nullptr;
+    }
+
+    auto const path = Utils::extractString(env, argv[pathIdx], "Can't extract path", from);
+    if (!path.has_value()) {
+        return nullptr;
+    }
+
+    PatchOptions options;
+    if (auto value = Utils::extractOptionalProperty(env, argv[optionsIdx], "contextLines", from)) {
+        auto const contextLines = Utils::extractInteger(env, *value, "Can't extract contextLines", from);
+        if (contextLines.has_value() && contextLines.value() >= 0) {
+            options.contextLines = contextLines.value();
+        }
+    }
+    if (auto value = Utils::extractOptionalProperty(env, argv[optionsIdx], "maxBytes", from)) {
+        auto const maxBytes = Utils::extractInteger(env, *value, "Can't extract maxBytes", from);
+        if (maxBytes.has_value() && maxBytes.value() > 0) {
+            options.maxBytes = maxBytes.value();
+        }
+    }
+    if (auto value = Utils::extractOptionalProperty(env, argv[optionsIdx], "wordDiff", from)) {
+        auto const wordDiff = Utils::extractBoolean(env, *value, "Can't extract wordDiff", from);
+        if (wordDiff.has_value()) {
+            options.wordDiff = wordDiff.value();
+        }
+    }
+
     auto const repoManager = Core::GetInstance()->FindRepoManager(repoURL.value());
     if (repoManager == nullptr) {
         OH_LOG_ERROR(LOG_APP, "RepoManager not found for url: %{public}s", repoURL.value().c_str());
         return Messages::NewResultMessage(env, false, "仓库未初始化");
     }
 
-    auto const fileContent = repoManager->readFile(branch.value(), path.value());
-    if (!fileContent.exists) {
-        return Messages::NewResultMessage(env, false, "文件不存在");
+    auto callback = Async::StreamCallback::Create(env, argv[callbackIdx], from);
+    if (callback == nullptr) {
+        return Messages::NewResultMessage(env, false, "创建回调失败");
     }
-    if (fileContent.isBinary) {
-        return Messages::NewResultMessage(env, false, "无法读取二进制文件");
+
+    struct PatchTask {
+        bool ok = false;
+        PatchSummary summary;
+        std::string error;
+    };
+    auto task = std::make_shared<PatchTask>();
+
+    return Async::RunPromiseOn(
+        env, from, repoManager->executor(), Access::Shared,
+        [task, callback, repoManager, commitId = commitId.value(), path = path.value(), options]() {
+            auto onChunk = [&callback](const std::vector<PatchHunk> &hunks) {
+                // 文件内容不保证是合法UTF-8，序列化时替换非法字节
+                return callback->Post(
+                    PatchHunksToJson(hunks).dump(-1, ' ', false, nlohmann::json::error_handler_t::replace));
+            };
+            task->ok = repoManager->getFilePatch(commitId, path, options, onChunk, task->summary);
+            if (!task->ok) {
+                task->error = repoManager->getLastError();
+            }
+            callback->Release();
+        },
+        [task](napi_env env) {
+            if (!task->ok) {
+                OH_LOG_ERROR(LOG_APP, "GetFilePatch failed: %{public}s", task->error.c_str());
+                return Messages::NewResultMessage(env, false, task->error);
+            }
+            auto const &summary = task->summary;
+            nlohmann::json json = {
+                {"exists", summary.exists},
+                {"isBinary", summary.isBinary},
+                {"tooLarge", summary.tooLarge},
+                {"truncated", summary.truncated},
+                {"oldPath", summary.oldPath},
+                {"path", summary.path},
+                {"hunkCount", summary.hunkCount},
+                {"bytes", summary.bytes},
+                {"additions", summary.additions},
+                {"deletions", summary.deletions},
+            };
+            return Messages::NewResultMessage(env, true, "获取文件补丁成功",
+                                              json.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace));
+        });
+}
+
+static nlohmann::json SearchResultsToJson(const std::vector<FileSearchResult> &results) {
+    nlohmann::json json = nlohmann::json::array();
+    for (auto &result : results) {
+        nlohmann::json matches = nlohmann::json::array();
+        for (auto &match : result.matches) {
+            Utf16::OffsetMap offsets(match.text);
+            nlohmann::json columns = nlohmann::json::array();
+            for (auto &range : offsets.ranges(match.columns)) {
+                columns.push_back({range.first, range.second});
+            }
+            matches.push_back({
+                {"line", match.line},
+                {"text", match.text},
+                {"columns", columns},
+            });
+        }
+        json.push_back({
+            {"path", result.path},
+            {"blobId", result.blobId},
+            {"matches", matches},
+        });
     }
-    return Messages::NewResultMessage(env, true, "读取文件成功", fileContent.content);
-}
\ No newline at end of file
+    return json;
+}
+
+napi_value Core::SearchTree(napi_env env, napi_callback_info info) noexcept {
+    char const *from = "Core::SearchTree-NAPI";
+    OH_LOG_INFO(LOG_APP, "================= Core::SearchTree-NAPI =================");
+    TraceSpan span("napi", from);
+
+    constexpr size_t expectedParams = 5U;
+    constexpr size_t repoURLIdx = 0U;
+    constexpr size_t refIdx = 1U;
+    constexpr size_t patternIdx = 2U;
+    constexpr size_t optionsIdx = 3U;
+    constexpr size_t callbackIdx = 4U;
+
+    size_t argc = expectedParams;
+
+    napi_value argv[expectedParams]{};
+
+    bool const result = Utils::extractParameters(env, info, expectedParams, &argc, argv, from);
+    if (!result) {
+        return nullptr;
+    }
+
+    auto const repoURL = Utils::extractString(env, argv[repoURLIdx], "Can't extract repoURL", from);
+    if (!repoURL.has_value()) {
+        return nullptr;
+    }
+
+    auto const ref = Utils::extractString(env, argv[refIdx], "Can't extract ref", from);
+    if (!ref.has_value()) {
+        return nullptr;
+    }
+
+    auto const pattern = Utils::extractString(env, argv[patternIdx], "Can't extract pattern", from);
+    if (!pattern.has_value()) {
+        return nullptr;
+    }
+
+    SearchOptions options;
+    if (auto value = Utils::extractOptionalProperty(env, argv[optionsIdx], "isRegex", from)) {
+        auto const isRegex = Utils::extractBoolean(env, *value, "Can't extract isRegex", from);
+        if (isRegex.has_value()) {
+            options.isRegex = isRegex.value();
+        }
+    }
+    if (auto value = Utils::extractOptionalProperty(env, argv[optionsIdx], "caseSensitive", from)) {
+        auto const caseSensitive = Utils::extractBoolean(env, *value, "Can't extract caseSensitive", from);
+        if (caseSensitive.has_value()) {
+            options.caseSensitive = caseSensitive.value();
+        }
+    }
+    if (auto value = Utils::extractOptionalProperty(env, argv[optionsIdx], "maxResults", from)) {
+        auto const maxResults = Utils::extractInteger(env, *value, "Can't extract maxResults", from);
+        if (maxResults.has_value() && maxResults.value() > 0) {
+            options.maxResults = maxResults.value();
+        }
+    }
+    if (auto value = Utils::extractOptionalProperty(env, argv[optionsIdx], "maxFileBytes", from)) {
+        auto const maxFileBytes = Utils::extractInteger(env, *value, "Can't extract maxFileBytes", from);
+        if (maxFileBytes.has_value() && maxFileBytes.value() > 0) {
+            options.maxFileBytes = maxFileBytes.value();
+        }
+    }
+
+    auto const repoManager = Core::GetInstance()->FindRepoManager(repoURL.value());
+    if (repoManager == nullptr) {
+        OH_LOG_ERROR(LOG_APP, "RepoManager not found for url: %{public}s", repoURL.value().c_str());
+        return Messages::NewResultMessage(env, false, "仓库未初始化");
+    }
+
+    auto callback = Async::StreamCallback::Create(env, argv[callbackIdx], from);
+    if (callback == nullptr) {
+        return Messages::NewResultMessage(env, false, "创建回调失败");
+    }
+
+    struct SearchTask {
+        bool ok = false;
+        SearchSummary summary;
+        std::string error;
+    };
+    auto task = std::make_shared<SearchTask>();
+
+    return Async::RunPromiseOn(
+        env, from, repoManager->executor(), Access::Shared,
+        [task, callback, repoManager, ref = ref.value(), pattern = pattern.value(), options]() {
+            auto onResults = [&callback](const std::vector<FileSearchResult> &results) {
+                // 文件内容不保证是合法UTF-8，序列化时替换非法字节
+                return callback->Post(
+                    SearchResultsToJson(results).dump(-1, ' ', false, nlohmann::json::error_handler_t::replace));
+            };
+            task->ok = repoManager->searchTree(ref, pattern, options, onResults, task->summary);
+            if (!task->ok) {
+                task->error = repoManager->getLastError();
+            }
+            callback->Release();
+        },
+        [task](napi_env env) {
+            if (!task->ok) {
+                OH_LOG_ERROR(LOG_APP, "SearchTree failed: %{public}s", task->error.c_str());
+                return Messages::NewResultMessage(env, false, task->error);
+            }
+            auto const &summary = task->summary;
+            nlohmann::json json = {
+                {"filesTotal", summary.filesTotal},
+                {"filesScanned", summary.filesScanned},
+                {"filesMatched", summary.filesMatched},
+                {"matchCount", summary.matchCount},
+                {"cacheHits", summary.cacheHits},
+                {"skippedBinary", summary.skippedBinary},
+                {"skippedLarge", summary.skippedLarge},
+                {"truncated", summary.truncated},
+            };
+            return Messages::NewResultMessage(env, true, "搜索完成", json.dump());
+        });
+}
+
+static napi_value FindFilesImpl(napi_env env, napi_callback_info info, bool async) {
+    char const *from = "Core::FindFiles-NAPI";
+    OH_LOG_INFO(LOG_APP, "================= Core::FindFiles-NAPI =================");
+    TraceSpan span("napi", from);
+
+    constexpr size_t expectedParams = 4U;
+    constexpr size_t repoURLIdx = 0U;
+    constexpr size_t refIdx = 1U;
+    constexpr size_t queryIdx = 2U;
+    constexpr size_t limitIdx = 3U;
+
+    size_t argc = expectedParams;
+
+    napi_value argv[expectedParams]{};
+
+    bool const result = Utils::extractParameters(env, info, expectedParams, &argc, argv, from);
+    if (!result) {
+        return nullptr;
+    }
+
+    auto const repoURL = Utils::extractString(env, argv[repoURLIdx], "Can't extract repoURL", from);
+    if (!repoURL.has_value()) {
+        return nullptr;
+    }
+
+    auto const ref = Utils::extractString(env, argv[refIdx], "Can't extract ref", from);
+    if (!ref.has_value()) {
+        return nullptr;
+    }
+
+    auto const query = Utils::extractString(env, argv[queryIdx], "Can't extract query", from);
+    if (!query.has_value()) {
+        return nullptr;
+    }
+
+    auto const limit = Utils::extractInteger(env, argv[limitIdx], "Can't extract limit", from);
+    if (!limit.has_value()) {
+        return nullptr;
+    }
+
+    auto const repoManager = Core::GetInstance()->FindRepoManager(repoURL.value());
+    if (repoManager == nullptr) {
+        OH_LOG_ERROR(LOG_APP, "RepoManager not found for url: %{public}s", repoURL.value().c_str());
+        return Async::Settle(env, async, Messages::NewResultMessage(env, false, "仓库未初始化"));
+    }
+
+    return Async::Dispatch(
+        env, from, async, repoManager->executor(), Access::Shared,
+        [repoManager, ref = ref.value(), query = query.value(), limit = limit.value() > 0 ? limit.value() : 50]() {
+            auto const matches = repoManager->findFiles(ref, query, limit);
+            if (matches.empty()) {
+                return Success("查找文件成功", "[]");
+            }
+            nlohmann::json json;
+            for (auto &match : matches) {
+                // 命中位置是字节下标，多字节字符的各字节换算后落在同一码元上，只保留一个
+                Utf16::OffsetMap offsets(match.path);
+                std::vector<uint32_t> positions;
+                for (auto position : match.positions) {
+                    uint32_t unit = offsets(position);
+                    if (positions.empty() || positions.back() != unit) {
+                        positions.push_back(unit);
+                    }
+                }
+                json.push_back({
+                    {"path", match.path},
+                    {"score", match.score},
+                    {"positions", positions},
+                });
+            }
+            return Success("查找文件成功", json.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace));
+        },
+        ToResultMessage);
+}
+
+napi_value Core::FindFiles(napi_env env, napi_callback_info info) noexcept { return FindFilesImpl(env, info, false); }
+
+napi_value Core::FindFilesAsync(napi_env env, napi_callback_info info) noexcept {
+    return FindFilesImpl(env, info, true);
+}
+
+static nlohmann::json BlameHunksToJson(const std::vector<BlameHunk> &hunks) {
+    nlohmann::json json = nlohmann::json::array();
+    for (auto &hunk : hunks) {
+        json.push_back({
+            {"startLine", hunk.startLine},
+            {"lineCount", hunk.lineCount},
+            {"commitId", hunk.commitId},
+            {"author", hunk.author},
+            {"email", hunk.email},
+            {"timestamp", hunk.timestamp},
+            {"summary", hunk.summary},
+            {"path", hunk.path},
+            {"boundary", hunk.boundary},
+        });
+    }
+    return json;
+}
+
+napi_value Core::BlameFile(napi_env env, napi_callback_info info) noexcept {
+    char const *from = "Core::BlameFile-NAPI";
+    OH_LOG_INFO(LOG_APP, "================= Core::BlameFile-NAPI =================");
+    TraceSpan span("napi", from);
+
+    constexpr size_t expectedParams = 4U;
+    constexpr size_t repoURLIdx = 0U;
+    constexpr size_t refIdx = 1U;
+    constexpr size_t pathIdx = 2U;
+    constexpr size_t callbackIdx = 3U;
+
+    size_t argc = expectedParams;
+
+    napi_value argv[expectedParams]{};
+
+    bool const result = Utils::extractParameters(env, info, expectedParams, &argc, argv, from);
+    if (!result) {
+        return nullptr;
+    }
+
+    auto const repoURL = Utils::extractString(env, argv[repoURLIdx], "Can't extract repoURL", from);
+    if (!repoURL.has_value()) {
+        return nullptr;
+    }
+
+    auto const ref = Utils::extractString(env, argv[refIdx], "Can't extract ref", from);
+    if (!ref.has_value()) {
+        return nullptr;
+    }
+
+    auto const path = Utils::extractString(env, argv[pathIdx], "Can't extract path", from);
+    if (!path.has_value()) {
+        return nullptr;
+    }
+
+    auto const repoManager = Core::GetInstance()->FindRepoManager(repoURL.value());
+    if (repoManager == nullptr) {
+        OH_LOG_ERROR(LOG_APP, "RepoManager not found for url: %{public}s", repoURL.value().c_str());
+        return Messages::NewResultMessage(env, false, "仓库未初始化");
+    }
+
+    auto callback = Async::StreamCallback::Create(env, argv[callbackIdx], from);
+    if (callback == nullptr) {
+        return Messages::NewResultMessage(env, false, "创建回调失败");
+    }
+
+    struct BlameTask {
+        bool ok = false;
+        BlameSummary summary;
+        std::string error;
+    };
+    auto task = std::make_shared<BlameTask>();
+
+    return Async::RunPromiseOn(
+        env, from, repoManager->executor(), Access::Shared,
+        [task, callback, repoManager, ref = ref.value(), path = path.value()]() {
+            auto onChunk = [&callback](const std::vector<BlameHunk> &hunks) {
+                return callback->Post(
+                    BlameHunksToJson(hunks).dump(-1, ' ', false, nlohmann::json::error_handler_t::replace));
+            };
+            task->ok = repoManager->blameFile(ref, path, onChunk, task->summary);
+            if (!task->ok) {
+                task->error = repoManager->getLastError();
+            }
+            callback->Release();
+        },
+        [task](napi_env env) {
+            if (!task->ok) {
+                OH_LOG_ERROR(LOG_APP, "BlameFile failed: %{public}s", task->error.c_str());
+                return Messages::NewResultMessage(env, false, task->error);
+            }
+            auto const &summary = task->summary;
+            nlohmann::json json = {
+                {"cached", summary.cached},
+                {"cancelled", summary.cancelled},
+                {"commitsVisited", summary.commitsVisited},
+                {"lineCount", summary.lineCount},
+                {"hunkCount", summary.hunkCount},
+            };
+            return Messages::NewResultMessage(env, true, summary.cancelled ? "Blame已取消" : "获取Blame成功",
+                                              json.dump());
+        });
+}
+
+napi_value Core::CancelBlame(napi_env env, napi_callback_info info) noexcept {
+    char const *from = "Core::CancelBlame-NAPI";
+    OH_LOG_INFO(LOG_APP, "================= Core::CancelBlame-NAPI =================");
+    TraceSpan span("napi", from);
+
+    constexpr size_t expectedParams = 1U;
+    constexpr size_t repoURLIdx = 0U;
+
+    size_t argc = expectedParams;
+
+    napi_value argv[expectedParams]{};
+
+    bool const result = Utils::extractParameters(env, info, expectedParams, &argc, argv, from);
+    if (!result) {
+        return nullptr;
+    }
+
+    auto const repoURL = Utils::extractString(env, argv[repoURLIdx], "Can't extract repoURL", from);
+    if (!repoURL.has_value()) {
+        return nullptr;
+    }
+
+    auto const repoManager = Core::GetInstance()->FindRepoManager(repoURL.value());
+    if (repoManager == nullptr) {
+        OH_LOG_ERROR(LOG_APP, "RepoManager not found for url: %{public}s", repoURL.value().c_str());
+        return Messages::NewResultMessage(env, false, "仓库未初始化");
+    }
+
+    repoManager->cancelBlame();
+    return Messages::NewResultMessage(env, true, "已取消Blame");
+}
+
+napi_value Core::TrimCaches(napi_env env, napi_callback_info info) noexcept {
+    char const *from = "Core::TrimCaches-NAPI";
+    OH_LOG_INFO(LOG_APP, "================= Core::TrimCaches-NAPI =================");
+    TraceSpan span("napi", from);
+
+    constexpr size_t expectedParams = 1U;
+    constexpr size_t levelIdx = 0U;
+
+    size_t argc = expectedParams;
+
+    napi_value argv[expectedParams]{};
+
+    bool const result = Utils::extractParameters(env, info, expectedParams, &argc, argv, from);
+    if (!result) {
+        return nullptr;
+    }
+
+    auto const level = Utils::extractInteger(env, argv[levelIdx], "Can't extract level", from);
+    if (!level.has_value()) {
+        return nullptr;
+    }
+
+    auto const memoryLevel = static_cast<GitRuntime::MemoryLevel>(
+        std::clamp(level.value(), static_cast<int32_t>(GitRuntime::MemoryLevel::Moderate),
+                   static_cast<int32_t>(GitRuntime::MemoryLevel::Critical)));
+    GitRuntime::Instance().trimCaches(memoryLevel);
+
+    for (const auto &repoManager : Core::GetInstance()->ListRepoManagers()) {
+        repoManager->trimCaches(memoryLevel);
+        if (memoryLevel == GitRuntime::MemoryLevel::Critical) {
+            // 对象缓存属于主句柄，排在进行中的操作之后独占释放
+            repoManager->executor()->submit(Access::Exclusive, [repoManager]() { repoManager->releaseObjectCache(); });
+        }
+    }
+    return Messages::NewResultMessage(env, true, "已清理缓存");
+}
+
+napi_value Core::SetMemoryBudget(napi_env env, napi_callback_info info) noexcept {
+    char const *from = "Core::SetMemoryBudget-NAPI";
+    OH_LOG_INFO(LOG_APP, "================= Core::SetMemoryBudget-NAPI =================");
+    TraceSpan span("napi", from);
+
+    constexpr size_t expectedParams = 1U;
+    constexpr size_t budgetIdx = 0U;
+
+    size_t argc = expectedParams;
+
+    napi_value argv[expectedParams]{};
+
+    bool const result = Utils::extractParameters(env, info, expectedParams, &argc, argv, from);
+    if (!result) {
+        return nullptr;
+    }
+
+    auto const budgetMB = Utils::extractInteger(env, argv[budgetIdx], "Can't extract budget", from);
+    if (!budgetMB.has_value()) {
+        return nullptr;
+    }
+
+    size_t const bytes = static_cast<size_t>(std::max(budgetMB.value(), 0)) * 1024 * 1024;
+    GitRuntime::Instance().setMemoryBudget(bytes);
+    return Messages::NewResultMessage(env, true, "已设置内存预算",
+                                      std::to_string(GitRuntime::Instance().memoryBudget() / (1024 * 1024)));
+}
+
+napi_value Core::SetTracing(napi_env env, napi_callback_info info) noexcept {
+    char const *from = "Core::SetTracing-NAPI";
+    OH_LOG_INFO(LOG_APP, "================= Core::SetTracing-NAPI =================");
+
+    constexpr size_t expectedParams = 1U;
+    constexpr size_t enabledIdx = 0U;
+
+    size_t argc = expectedParams;
+
+    napi_value argv[expectedParams]{};
+
+    bool const result = Utils::extractParameters(env, info, expectedParams, &argc, argv, from);
+    if (!result) {
+        return nullptr;
+    }
+
+    auto const enabled = Utils::extractBoolean(env, argv[enabledIdx], "Can't extract enabled", from);
+    if (!enabled.has_value()) {
+        return nullptr;
+    }
+
+    Tracer::Shared().setEnabled(enabled.value());
+    return Messages::NewResultMessage(env, true, enabled.value() ? "已开启追踪" : "已关闭追踪");
+}
+
+napi_value Core::ExportTrace(napi_env env, napi_callback_info info) noexcept {
+    OH_LOG_INFO(LOG_APP, "================= Core::ExportTrace-NAPI =================");
+
+    return Messages::NewResultMessage(env, true, "导出追踪成功", Tracer::Shared().exportJson());
+}
+
+napi_value Core::GetMetrics(napi_env env, napi_callback_info info) noexcept {
+    OH_LOG_INFO(LOG_APP, "================= Core::GetMetrics-NAPI =================");
+
+    return Messages::NewResultMessage(env, true, "获取指标成功", Metrics::Shared().exportJson());
+}
+
+static napi_value GetBranchesColumnsImpl(napi_env env, napi_callback_info info, bool async) {
+    char const *from = "Core::GetBranchesColumns-NAPI";
+    OH_LOG_INFO(LOG_APP, "================= Core::GetBranchesColumns-NAPI =================");
+    TraceSpan span("napi", from);
+
+    auto repoManager = Utils::FindRepoManager(env, info, from);
+    if (repoManager == nullptr) {
+        return Async::Settle(env, async, Messages::NewResultMessage(env, false, "仓库未初始化"));
+    }
+
+    return Async::Dispatch(
+        env, from, async, repoManager->executor(), Access::Shared,
+        [repoManager]() {
+            std::vector<BranchInfo> branches;
+            if (!repoManager->getRemoteBranches(branches)) {
+                return Failure(repoManager->getLastError());
+            }
+
+            Columnar::TableBuilder table(branches.size());
+            auto const name = table.addColumn("name", Columnar::ColumnType::STRING);
+            auto const id = table.addColumn("id", Columnar::ColumnType::OID);
+            auto const isRemote = table.addColumn("isRemote", Columnar::ColumnType::BOOL);
+            auto const isCurrent = table.addColumn("isCurrent", Columnar::ColumnType::BOOL);
+            for (size_t row = 0; row < branches.size(); ++row) {
+                table.setString(name, row, branches[row].name);
+                table.setOidHex(id, row, branches[row].id);
+                table.setBool(isRemote, row, branches[row].isRemote);
+                table.setBool(isCurrent, row, branches[row].isCurrent);
+            }
+            return ResultPayload{true, "GetBranches success", "", table.finish()};
+        },
+        ToResultMessage);
+}
+
+napi_value Core::GetBranchesColumns(napi_env env, napi_callback_info info) noexcept {
+    return GetBranchesColumnsImpl(env, info, false);
+}
+
+napi_value Core::GetBranchesColumnsAsync(napi_env env, napi_callback_info info) noexcept {
+    return GetBranchesColumnsImpl(env, info, true);
+}
+
+static napi_value GetTagsColumnsImpl(napi_env env, napi_callback_info info, bool async) {
+    char const *from = "Core::GetTagsColumns-NAPI";
+    OH_LOG_INFO(LOG_APP, "================= Core::GetTagsColumns-NAPI =================");
+    TraceSpan span("napi", from);
+
+    auto repoManager = Utils::FindRepoManager(env, info, from);
+    if (repoManager == nullptr) {
+        return Async::Settle(env, async, Messages::NewResultMessage(env, false, "仓库未初始化"));
+    }
+
+    return Async::Dispatch(
+        env, from, async, repoManager->executor(), Access::Shared,
+        [repoManager]() {
+            std::vector<TagInfo> tags;
+            if (!repoManager->getRemoteTags(tags)) {
+                return Failure(repoManager->getLastError());
+            }
+
+            Columnar::TableBuilder table(tags.size());
+            auto const name = table.addColumn("name", Columnar::ColumnType::STRING);
+            auto const id = table.addColumn("id", Columnar::ColumnType::OID);
+            auto const peeledId = table.addColumn("peeledId", Columnar::ColumnType::OID);
+            auto const isAnnotated = table.addColumn("isAnnotated", Columnar::ColumnType::BOOL);
+            for (size_t row = 0; row < tags.size(); ++row) {
+                table.setString(name, row, tags[row].name);
+                table.setOidHex(id, row, tags[row].id);
+                table.setOidHex(peeledId, row, tags[row].peeledId);
+                table.setBool(isAnnotated, row, tags[row].isAnnotated);
+            }
+            return ResultPayload{true, "GetTags success", "", table.finish()};
+        },
+        ToResultMessage);
+}
+
+napi_value Core::GetTagsColumns(napi_env env, napi_callback_info info) noexcept {
+    return GetTagsColumnsImpl(env, info, false);
+}
+
+napi_value Core::GetTagsColumnsAsync(napi_env env, napi_callback_info info) noexcept {
+    return GetTagsColumnsImpl(env, info, true);
+}
+
+static napi_value GetHistoryColumnsImpl(napi_env env, napi_callback_info info, bool async) {
+    char const *from = "Core::GetHistoryColumns-NAPI";
+    OH_LOG_INFO(LOG_APP, "================= Core::GetHistoryColumns-NAPI =================");
+    TraceSpan span("napi", from);
+
+    constexpr size_t expectedParams = 4U;
+    constexpr size_t repoURLIdx = 0U;
+    constexpr size_t branchIdx = 1U;
+    constexpr size_t countIdx = 2U;
+    constexpr size_t offsetIdx = 3U;
+
+    size_t argc = expectedParams;
+
+    napi_value argv[expectedParams]{};
+
+    bool const result = Utils::extractParameters(env, info, expectedParams, &argc, argv, from);
+    if (!result) {
+        return nullptr;
+    }
+
+    auto const repoURL = Utils::extractString(env, argv[repoURLIdx], "Can't extract repoURL", from);
+    if (!repoURL.has_value()) {
+        return nullptr;
+    }
+
+    auto const branch = Utils::extractString(env, argv[branchIdx], "Can't extract branch", from);
+    if (!branch.has_value()) {
+        return nullptr;
+    }
+
+    auto const count = Utils::extractInteger(env, argv[countIdx], "Can't extract count", from);
+    if (!count.has_value()) {
+        return nullptr;
+    }
+
+    auto const offset = Utils::extractInteger(env, argv[offsetIdx], "Can't extract offset", from);
+    if (!offset.has_value()) {
+        return nullptr;
+    }
+
+    auto const repoManager = Core::GetInstance()->FindRepoManager(repoURL.value());
+    if (repoManager == nullptr) {
+        OH_LOG_ERROR(LOG_APP, "RepoManager not found for url: %{public}s", repoURL.value().c_str());
+        return Async::Settle(env, async, Messages::NewResultMessage(env, false, "仓库未初始化"));
+    }
+
+    return Async::Dispatch(
+        env, from, async, repoManager->executor(), Access::Shared,
+        [repoManager, branch = branch.value(), count = count.value(), offset = offset.value()]() {
+            std::vector<CommitInfo> history;
+            if (!repoManager->getCommitHistory(history, branch, count, offset)) {
+                return Failure(repoManager->getLastError());
+            }
+
+            // shortId 是 id 的前7位，由解码端按需截取
+            Columnar::TableBuilder table(history.size());
+            auto const id = table.addColumn("id", Columnar::ColumnType::OID);
+            auto const author = table.addColumn("author", Columnar::ColumnType::STRING);
+            auto const email = table.addColumn("email", Columnar::ColumnType::STRING);
+            auto const timestamp = table.addColumn("timestamp", Columnar::ColumnType::FLOAT64);
+            auto const message = table.addColumn("message", Columnar::ColumnType::STRING);
+            auto const shortMessage = table.addColumn("shortMessage", Columnar::ColumnType::STRING);
+            for (size_t row = 0; row < history.size(); ++row) {
+                auto const &commit = history[row];
+                table.setOidHex(id, row, commit.id);
+                table.setString(author, row, commit.author);
+                table.setString(email, row, commit.email);
+                table.setFloat64(timestamp, row, static_cast<double>(commit.timestamp));
+                table.setString(message, row, commit.message);
+                table.setString(shortMessage, row, commit.shortMessage);
+            }
+            return ResultPayload{true, "获取提交历史成功", "", table.finish()};
+        },
+        ToResultMessage);
+}
+
+napi_value Core::GetHistoryColumns(napi_env env, napi_callback_info info) noexcept {
+    return GetHistoryColumnsImpl(env, info, false);
+}
+
+napi_value Core::GetHistoryColumnsAsync(napi_env env, napi_callback_info info) noexcept {
+    return GetHistoryColumnsImpl(env, info, true);
+}
+
+static napi_value GetFileTreeColumnsImpl(napi_env env, napi_callback_info info, bool async) {
+    char const *from = "Core::GetFileTreeColumns-NAPI";
+    OH_LOG_INFO(LOG_APP, "================= Core::GetFileTreeColumns-NAPI =================");
+    TraceSpan span("napi", from);
+
+    constexpr size_t expectedParams = 2U;
+    constexpr size_t repoURLIdx = 0U;
+    constexpr size_t branchIdx = 1U;
+
+    size_t argc = expectedParams;
+
+    napi_value argv[expectedParams]{};
+
+    bool const result = Utils::extractParameters(env, info, expectedParams, &argc, argv, from);
+    if (!result) {
+        return nullptr;
+    }
+
+    auto const repoURL = Utils::extractString(env, argv[repoURLIdx], "Can't extract repoURL", from);
+    if (!repoURL.has_value()) {
+        return nullptr;
+    }
+
+    auto const branch = Utils::extractString(env, argv[branchIdx], "Can't extract branch", from);
+    if (!branch.has_value()) {
+        return nullptr;
+    }
+
+    auto const repoManager = Core::GetInstance()->FindRepoManager(repoURL.value());
+    if (repoManager == nullptr) {
+        OH_LOG_ERROR(LOG_APP, "RepoManager not found for url: %{public}s", repoURL.value().c_str());
+        return Async::Settle(env, async, Messages::NewResultMessage(env, false, "仓库未初始化"));
+    }
+
+    return Async::Dispatch(
+        env, from, async, repoManager->executor(), Access::Shared,
+        [repoManager, branch = branch.value()]() {
+            auto const fileTree = repoManager->getCompactFileTree(branch);
+            if (fileTree == nullptr) {
+                return Failure(repoManager->getLastError());
+            }
+
+            // 节点ID为行号+1；路径不单独存储，由解码端沿 parentId 拼接
+            size_t rows = fileTree->size();
+            Columnar::TableBuilder table(rows);
+            auto const parentId = table.addColumn("parentId", Columnar::ColumnType::INT32);
+            auto const name = table.addColumn("name", Columnar::ColumnType::STRING);
+            auto const isDirectory = table.addColumn("isDirectory", Columnar::ColumnType::BOOL);
+            auto const fileId = table.addColumn("fileId", Columnar::ColumnType::OID);
+            auto const mode = table.addColumn("mode", Columnar::ColumnType::UINT32);
+            auto const size = table.addColumn("size", Columnar::ColumnType::UINT32);
+            for (uint32_t row = 0; row < rows; ++row) {
+                uint32_t parent = fileTree->parent(row);
+                table.setInt32(parentId, row,
+                               parent == CompactFileTree::NO_PARENT ? -1 : static_cast<int32_t>(parent) + 1);
+                table.setString(name, row, fileTree->name(row));
+                table.setBool(isDirectory, row, fileTree->isDirectory(row));
+                table.setOid(fileId, row, fileTree->oid(row));
+                table.setUint32(mode, row, fileTree->mode(row));
+                table.setUint32(size, row, fileTree->fileSize(row));
+            }
+            return ResultPayload{true, "获取文件树成功", "", table.finish()};
+        },
+        ToResultMessage);
+}
+
+napi_value Core::GetFileTreeColumns(napi_env env, napi_callback_info info) noexcept {
+    return GetFileTreeColumnsImpl(env, info, false);
+}
+
+napi_value Core::GetFileTreeColumnsAsync(napi_env env, napi_callback_info info) noexcept {
+    return GetFileTreeColumnsImpl(env, info, true);
+}
@@ -0,0 +1,145 @@
+#include "metrics.h"
+#include <algorithm>
+#include <bit>
+#include <nlohmann/json.hpp>
+
+namespace {
+constexpr const char *OPERATION_NAMES[] = {"history", "fileTree", "readFile", "commitChanges", "fetch", "lsRemote"};
+constexpr const char *CACHE_NAMES[] = {"history", "changes", "fileTree", "pathIndex", "search", "blame"};
+constexpr const char *COUNTER_NAMES[] = {"marshalledBytes", "marshalledBinaryBytes", "objectsLoaded"};
+constexpr double PERCENTILES[] = {0.5, 0.9, 0.99};
+constexpr const char *PERCENTILE_NAMES[] = {"p50Us", "p90Us", "p99Us"};
+
+// 分片只有所属线程写入，不需要原子读改写
+inline void Increase(std::atomic<uint64_t> &cell, uint64_t value) {
+    cell.store(cell.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+} // namespace
+
+Metrics &Metrics::Shared() {
+    static Metrics metrics;
+    return metrics;
+}
+
+Metrics::Shard &Metrics::localShard() {
+    thread_local Shard *shard = nullptr;
+    if (shard == nullptr) {
+        auto created = std::make_unique<Shard>();
+        shard = created.get();
+        std::lock_guard<std::mutex> lock(mutex_);
+        shards_.push_back(std::move(created));
+    }
+    return *shard;
+}
+
+size_t Metrics::BucketIndex(uint64_t value) {
+    value = std::min<uint64_t>(value, (uint64_t{1} << MAX_EXPONENT) - 1);
+    if (value < SUB_BUCKETS) {
+        return static_cast<size_t>(value);
+    }
+    size_t exponent = static_cast<size_t>(std::bit_width(value)) - 1;
+    size_t shift = exponent - SUB_BUCKET_BITS;
+    return SUB_BUCKETS + shift * SUB_BUCKETS + static_cast<size_t>((value >> shift) & (SUB_BUCKETS - 1));
+}
+
+uint64_t Metrics::BucketValue(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    size_t shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+    uint64_t sub = (index - SUB_BUCKETS) % SUB_BUCKETS;
+    uint64_t low = (SUB_BUCKETS + sub) << shift;
+    // 取档位中点
+    return low + ((uint64_t{1} << shift) >> 1);
+}
+
+void Metrics::recordLatency(Operation operation, uint64_t micros) {
+    Histogram &histogram = localShard().histograms[static_cast<size_t>(operation)];
+    Increase(histogram.buckets[BucketIndex(micros)], 1);
+    Increase(histogram.count, 1);
+    Increase(histogram.sum, micros);
+    if (micros > histogram.max.load(std::memory_order_relaxed)) {
+        histogram.max.store(micros, std::memory_order_relaxed);
+    }
+}
+
+void Metrics::recordCache(Cache cache, bool hit) {
+    Increase(localShard().caches[static_cast<size_t>(cache) * 2 + (hit ? 0 : 1)], 1);
+}
+
+void Metrics::add(Counter counter, uint64_t value) {
+    Increase(localShard().counters[static_cast<size_t>(counter)], value);
+}
+
+std::string Metrics::exportJson() const {
+    constexpr size_t operations = static_cast<size_t>(Operation::Count);
+    constexpr size_t caches = static_cast<size_t>(Cache::Count);
+    constexpr size_t counters = static_cast<size_t>(Counter::Count);
+
+    std::vector<std::array<uint64_t, BUCKETS>> buckets(operations);
+    std::array<uint64_t, operations> count{};
+    std::array<uint64_t, operations> sum{};
+    std::array<uint64_t, operations> max{};
+    std::array<uint64_t, caches * 2> cacheTotals{};
+    std::array<uint64_t, counters> counterTotals{};
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &shard : shards_) {
+            for (size_t op = 0; op < operations; ++op) {
+                const Histogram &histogram = shard->histograms[op];
+                for (size_t i = 0; i < BUCKETS; ++i) {
+                    buckets[op][i] += histogram.buckets[i].load(std::memory_order_relaxed);
+                }
+                count[op] += histogram.count.load(std::memory_order_relaxed);
+                sum[op] += histogram.sum.load(std::memory_order_relaxed);
+                max[op] = std::max(max[op], histogram.max.load(std::memory_order_relaxed));
+            }
+            for (size_t i = 0; i < caches * 2; ++i) {
+                cacheTotals[i] += shard->caches[i].load(std::memory_order_relaxed);
+            }
+            for (size_t i = 0; i < counters; ++i) {
+                counterTotals[i] += shard->counters[i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    nlohmann::json result = {
+        {"operations", nlohmann::json::object()},
+        {"caches", nlohmann::json::object()},
+        {"counters", nlohmann::json::object()},
+    };
+    for (size_t op = 0; op < operations; ++op) {
+        // 汇总期间仍有写入时各桶之和可能与次数略有出入，分位数以桶为准
+        uint64_t total = 0;
+        for (uint64_t value : buckets[op]) {
+            total += value;
+        }
+        nlohmann::json entry = {
+            {"count", count[op]},
+            {"meanUs", count[op] > 0 ? sum[op] / count[op] : 0},
+            {"maxUs", max[op]},
+        };
+        size_t bucket = 0;
+        uint64_t seen = 0;
+        for (size_t p = 0; p < std::size(PERCENTILES); ++p) {
+            uint64_t rank = static_cast<uint64_t>(PERCENTILES[p] * static_cast<double>(total) + 0.5);
+            rank = std::max<uint64_t>(rank, 1);
+            while (bucket < BUCKETS && seen + buckets[op][bucket] < rank) {
+                seen += buckets[op][bucket++];
+            }
+            entry[PERCENTILE_NAMES[p]] = total > 0 && bucket < BUCKETS ? std::min(BucketValue(bucket), max[op]) : 0;
+        }
+        result["operations"][OPERATION_NAMES[op]] = std::move(entry);
+    }
+    for (size_t i = 0; i < caches; ++i) {
+        result["caches"][CACHE_NAMES[i]] = {
+            {"hits", cacheTotals[i * 2]},
+            {"misses", cacheTotals[i * 2 + 1]},
+        };
+    }
+    for (size_t i = 0; i < counters; ++i) {
+        result["counters"][COUNTER_NAMES[i]] = counterTotals[i];
+    }
+    return result.dump();
+}
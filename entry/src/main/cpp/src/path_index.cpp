@@ -0,0 +1,405 @@
+#include "path_index.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace {
+
+constexpr char INDEX_MAGIC[4] = {'H', 'G', 'P', 'I'};
+constexpr uint32_t INDEX_VERSION = 1;
+
+// 评分参数，参考 fzf 的规则：连续命中和单词边界加分，间隔扣分，文件名命中优先
+constexpr int SCORE_MATCH = 16;
+constexpr int BONUS_BOUNDARY = 8;
+constexpr int BONUS_SEPARATOR = 10;
+constexpr int BONUS_CONSECUTIVE = 8;
+constexpr int PENALTY_GAP_START = 3;
+constexpr int PENALTY_GAP_EXTEND = 1;
+constexpr int BONUS_BASENAME = 24;
+constexpr int BONUS_BASENAME_PREFIX = 32;
+constexpr int BONUS_BASENAME_EXACT = 64;
+
+// 模糊匹配回退时最多评分的路径数，避免超大仓库中宽泛的查询逐个评分全部路径
+constexpr size_t MAX_FUZZY_CANDIDATES = 20000;
+
+struct IndexHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t pathCount;
+    uint32_t poolBytes;
+    uint32_t trigramCount;
+    uint32_t postingCount;
+};
+
+inline unsigned char asciiLower(unsigned char c) { return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c; }
+
+inline uint64_t charBit(unsigned char c) {
+    c = asciiLower(c);
+    if (c >= 'a' && c <= 'z') {
+        return 1ULL << (c - 'a');
+    }
+    if (c >= '0' && c <= '9') {
+        return 1ULL << (26 + c - '0');
+    }
+    // 其余字符（含UTF-8字节）散列到剩余的位上，掩码只用于排除，不要求一一对应
+    return 1ULL << (36 + c % 28);
+}
+
+inline uint64_t charMask(std::string_view text) {
+    uint64_t mask = 0;
+    for (char c : text) {
+        mask |= charBit(static_cast<unsigned char>(c));
+    }
+    return mask;
+}
+
+inline uint32_t trigramAt(std::string_view text, size_t i) {
+    return (static_cast<uint32_t>(asciiLower(static_cast<unsigned char>(text[i]))) << 16) |
+           (static_cast<uint32_t>(asciiLower(static_cast<unsigned char>(text[i + 1]))) << 8) |
+           static_cast<uint32_t>(asciiLower(static_cast<unsigned char>(text[i + 2])));
+}
+
+inline bool isUpper(char c) { return c >= 'A' && c <= 'Z'; }
+inline bool isLower(char c) { return c >= 'a' && c <= 'z'; }
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+bool isBoundary(std::string_view text, size_t i) {
+    if (i == 0) {
+        return true;
+    }
+    char prev = text[i - 1];
+    char cur = text[i];
+    if (prev == '/' || prev == '_' || prev == '-' || prev == '.' || prev == ' ') {
+        return true;
+    }
+    return (isLower(prev) && isUpper(cur)) || (!isDigit(prev) && isDigit(cur));
+}
+
+/**
+ * 在 text 中做子序列匹配并评分，不匹配时返回空；分散的匹配得分可以为负
+ * 先正向贪心找到最早的结束位置，再反向收缩出最短窗口，只在窗口内计算得分
+ */
+std::optional<int> scoreSubsequence(std::string_view text, size_t base, std::string_view query,
+                                   std::vector<uint32_t> &positions) {
+    size_t qi = 0;
+    size_t end = std::string_view::npos;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (asciiLower(static_cast<unsigned char>(text[i])) == static_cast<unsigned char>(query[qi]) &&
+            ++qi == query.size()) {
+            end = i;
+            break;
+        }
+    }
+    if (end == std::string_view::npos) {
+        return std::nullopt;
+    }
+
+    size_t start = end;
+    qi = query.size();
+    for (size_t i = end + 1; i-- > 0;) {
+        if (asciiLower(static_cast<unsigned char>(text[i])) == static_cast<unsigned char>(query[qi - 1]) &&
+            --qi == 0) {
+            start = i;
+            break;
+        }
+    }
+
+    positions.clear();
+    int score = 0;
+    bool inGap = false;
+    qi = 0;
+    for (size_t i = start; i <= end && qi < query.size(); ++i) {
+        if (asciiLower(static_cast<unsigned char>(text[i])) != static_cast<unsigned char>(query[qi])) {
+            score -= inGap ? PENALTY_GAP_EXTEND : PENALTY_GAP_START;
+            inGap = true;
+            continue;
+        }
+        score += SCORE_MATCH;
+        if (isBoundary(text, i)) {
+            score += (i > 0 && text[i - 1] == '/') ? BONUS_SEPARATOR : BONUS_BOUNDARY;
+        }
+        if (!positions.empty() && positions.back() == base + i - 1) {
+            score += BONUS_CONSECUTIVE;
+        }
+        positions.push_back(static_cast<uint32_t>(base + i));
+        inGap = false;
+        ++qi;
+    }
+    return score;
+}
+
+bool startsWithIgnoreCase(std::string_view text, std::string_view lowerPrefix) {
+    if (text.size() < lowerPrefix.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < lowerPrefix.size(); ++i) {
+        if (asciiLower(static_cast<unsigned char>(text[i])) != static_cast<unsigned char>(lowerPrefix[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 路径的匹配得分，不匹配时返回空
+std::optional<int> scorePath(std::string_view path, std::string_view query, std::vector<uint32_t> &positions) {
+    size_t slash = path.rfind('/');
+    size_t base = slash == std::string_view::npos ? 0 : slash + 1;
+    std::string_view basename = path.substr(base);
+
+    std::optional<int> score = scoreSubsequence(basename, base, query, positions);
+    if (score) {
+        *score += BONUS_BASENAME;
+        if (startsWithIgnoreCase(basename, query)) {
+            std::string_view stem = basename.substr(0, basename.rfind('.'));
+            *score += (stem.size() == query.size() || basename.size() == query.size()) ? BONUS_BASENAME_EXACT
+                                                                                       : BONUS_BASENAME_PREFIX;
+        }
+    } else {
+        score = scoreSubsequence(path, 0, query, positions);
+        if (!score) {
+            return std::nullopt;
+        }
+    }
+    // 同等匹配时较短（层级较浅）的路径优先
+    return *score - static_cast<int>(path.size() / 8);
+}
+
+template <typename T> void writeArray(std::ofstream &out, const std::vector<T> &data) {
+    out.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size() * sizeof(T)));
+}
+
+template <typename T> bool readArray(const std::string &buffer, size_t &offset, std::vector<T> &data, size_t count) {
+    size_t bytes = count * sizeof(T);
+    if (buffer.size() - offset < bytes) {
+        return false;
+    }
+    data.resize(count);
+    std::memcpy(data.data(), buffer.data() + offset, bytes);
+    offset += bytes;
+    return true;
+}
+
+} // namespace
+
+void PathIndex::build(const std::vector<std::string> &paths) {
+    pool_.clear();
+    pathOffsets_.assign(1, 0);
+    charMasks_.clear();
+    charMasks_.reserve(paths.size());
+
+    std::unordered_map<uint32_t, std::vector<uint32_t>> postings;
+    std::vector<uint32_t> pathTrigrams;
+    for (uint32_t id = 0; id < paths.size(); ++id) {
+        std::string_view path = paths[id];
+        pool_.append(path);
+        pathOffsets_.push_back(static_cast<uint32_t>(pool_.size()));
+        charMasks_.push_back(charMask(path));
+
+        pathTrigrams.clear();
+        for (size_t i = 0; i + 3 <= path.size(); ++i) {
+            pathTrigrams.push_back(trigramAt(path, i));
+        }
+        std::sort(pathTrigrams.begin(), pathTrigrams.end());
+        pathTrigrams.erase(std::unique(pathTrigrams.begin(), pathTrigrams.end()), pathTrigrams.end());
+        // 路径编号递增处理，每个倒排表天然有序
+        for (uint32_t trigram : pathTrigrams) {
+            postings[trigram].push_back(id);
+        }
+    }
+
+    trigrams_.clear();
+    trigrams_.reserve(postings.size());
+    for (auto &entry : postings) {
+        trigrams_.push_back(entry.first);
+    }
+    std::sort(trigrams_.begin(), trigrams_.end());
+
+    postingOffsets_.assign(1, 0);
+    postingOffsets_.reserve(trigrams_.size() + 1);
+    postings_.clear();
+    for (uint32_t trigram : trigrams_) {
+        auto &list = postings[trigram];
+        postings_.insert(postings_.end(), list.begin(), list.end());
+        postingOffsets_.push_back(static_cast<uint32_t>(postings_.size()));
+    }
+}
+
+bool PathIndex::load(const std::string &file) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    std::string buffer((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    IndexHeader header{};
+    if (buffer.size() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, buffer.data(), sizeof(header));
+    if (std::memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 || header.version != INDEX_VERSION) {
+        return false;
+    }
+
+    size_t offset = sizeof(header);
+    if (buffer.size() - offset < header.poolBytes) {
+        return false;
+    }
+    std::string pool = buffer.substr(offset, header.poolBytes);
+    offset += header.poolBytes;
+
+    std::vector<uint32_t> pathOffsets;
+    std::vector<uint64_t> charMasks;
+    std::vector<uint32_t> trigrams;
+    std::vector<uint32_t> postingOffsets;
+    std::vector<uint32_t> postings;
+    if (!readArray(buffer, offset, pathOffsets, header.pathCount + 1ULL) ||
+        !readArray(buffer, offset, charMasks, header.pathCount) ||
+        !readArray(buffer, offset, trigrams, header.trigramCount) ||
+        !readArray(buffer, offset, postingOffsets, header.trigramCount + 1ULL) ||
+        !readArray(buffer, offset, postings, header.postingCount) || offset != buffer.size()) {
+        return false;
+    }
+    if (pathOffsets.back() != pool.size() || postingOffsets.back() != postings.size() ||
+        !std::is_sorted(pathOffsets.begin(), pathOffsets.end()) ||
+        !std::is_sorted(postingOffsets.begin(), postingOffsets.end()) ||
+        std::any_of(postings.begin(), postings.end(), [&](uint32_t id) { return id >= header.pathCount; })) {
+        return false;
+    }
+
+    pool_ = std::move(pool);
+    pathOffsets_ = std::move(pathOffsets);
+    charMasks_ = std::move(charMasks);
+    trigrams_ = std::move(trigrams);
+    postingOffsets_ = std::move(postingOffsets);
+    postings_ = std::move(postings);
+    return true;
+}
+
+bool PathIndex::save(const std::string &file) const {
+    // 临时文件名按进程和序号区分，多个线程同时为同一个树构建索引时互不覆盖
+    static std::atomic<uint64_t> sequence{0};
+    std::string tmpFile = file + "." + std::to_string(getpid()) + "." + std::to_string(sequence++) + ".tmp";
+    {
+        std::ofstream out(tmpFile, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        IndexHeader header{};
+        std::memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+        header.version = INDEX_VERSION;
+        header.pathCount = static_cast<uint32_t>(size());
+        header.poolBytes = static_cast<uint32_t>(pool_.size());
+        header.trigramCount = static_cast<uint32_t>(trigrams_.size());
+        header.postingCount = static_cast<uint32_t>(postings_.size());
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(pool_.data(), static_cast<std::streamsize>(pool_.size()));
+        writeArray(out, pathOffsets_);
+        writeArray(out, charMasks_);
+        writeArray(out, trigrams_);
+        writeArray(out, postingOffsets_);
+        writeArray(out, postings_);
+        if (!out.good()) {
+            std::remove(tmpFile.c_str());
+            return false;
+        }
+    }
+    return std::rename(tmpFile.c_str(), file.c_str()) == 0;
+}
+
+std::vector<uint32_t> PathIndex::intersectTrigrams(std::string_view query) const {
+    std::vector<std::pair<const uint32_t *, const uint32_t *>> lists;
+    for (size_t i = 0; i + 3 <= query.size(); ++i) {
+        uint32_t trigram = trigramAt(query, i);
+        auto it = std::lower_bound(trigrams_.begin(), trigrams_.end(), trigram);
+        if (it == trigrams_.end() || *it != trigram) {
+            return {};
+        }
+        size_t index = it - trigrams_.begin();
+        lists.emplace_back(postings_.data() + postingOffsets_[index], postings_.data() + postingOffsets_[index + 1]);
+    }
+    if (lists.empty()) {
+        return {};
+    }
+
+    // 从最短的倒排表开始求交集
+    std::sort(lists.begin(), lists.end(),
+              [](const auto &a, const auto &b) { return (a.second - a.first) < (b.second - b.first); });
+    std::vector<uint32_t> result(lists[0].first, lists[0].second);
+    std::vector<uint32_t> next;
+    for (size_t i = 1; i < lists.size() && !result.empty(); ++i) {
+        next.clear();
+        std::set_intersection(result.begin(), result.end(), lists[i].first, lists[i].second, std::back_inserter(next));
+        result.swap(next);
+    }
+    return result;
+}
+
+std::vector<PathMatch> PathIndex::find(const std::string &query, size_t limit) const {
+    std::string lowered;
+    for (char c : query) {
+        if (c != ' ') {
+            lowered.push_back(static_cast<char>(asciiLower(static_cast<unsigned char>(c))));
+        }
+    }
+    if (lowered.empty() || limit == 0 || size() == 0) {
+        return {};
+    }
+
+    uint64_t queryMask = charMask(lowered);
+    std::vector<std::pair<int, uint32_t>> scored;
+    std::vector<uint32_t> positions;
+    auto consider = [&](uint32_t id) {
+        if (auto score = scorePath(pathAt(id), lowered, positions)) {
+            scored.emplace_back(*score, id);
+        }
+    };
+
+    // 连续子串命中的路径通常就足够了，只有结果不足时才对其余路径做模糊匹配
+    std::vector<uint32_t> contiguous;
+    if (lowered.size() >= 3) {
+        contiguous = intersectTrigrams(lowered);
+        for (uint32_t id : contiguous) {
+            consider(id);
+        }
+    }
+    if (scored.size() < limit) {
+        // 掩码过滤代价很低，评分的路径数有上限，超出后不再补充结果
+        size_t budget = MAX_FUZZY_CANDIDATES;
+        auto next = contiguous.begin();
+        for (uint32_t id = 0; id < size() && budget > 0; ++id) {
+            if (next != contiguous.end() && *next == id) {
+                ++next;
+                continue;
+            }
+            if ((charMasks_[id] & queryMask) != queryMask) {
+                continue;
+            }
+            --budget;
+            consider(id);
+        }
+    }
+
+    size_t count = std::min(limit, scored.size());
+    std::partial_sort(scored.begin(), scored.begin() + count, scored.end(), [this](const auto &a, const auto &b) {
+        if (a.first != b.first) {
+            return a.first > b.first;
+        }
+        return pathAt(a.second) < pathAt(b.second);
+    });
+
+    std::vector<PathMatch> matches;
+    matches.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string_view path = pathAt(scored[i].second);
+        PathMatch match{std::string(path), scored[i].first, {}};
+        scorePath(path, lowered, match.positions);
+        matches.push_back(std::move(match));
+    }
+    return matches;
+}
@@ -0,0 +1,128 @@
+#include "repo_executor.h"
+#include "utils/log.hpp"
+
+namespace {
+struct CurrentTask {
+    const RepoExecutor *executor = nullptr;
+    RepoExecutor::Access access = RepoExecutor::Access::Shared;
+};
+thread_local CurrentTask currentTask; ///< 当前线程正在执行的任务
+
+// 在作用域内把当前线程标记为正在执行某执行器的任务
+class TaskMark {
+public:
+    TaskMark(const RepoExecutor *executor, RepoExecutor::Access access) : previous_(currentTask) {
+        currentTask = {executor, access};
+    }
+    ~TaskMark() { currentTask = previous_; }
+
+private:
+    CurrentTask previous_;
+};
+} // namespace
+
+std::shared_ptr<RepoExecutor> RepoExecutor::Create(ThreadPool &pool) {
+    return std::shared_ptr<RepoExecutor>(new RepoExecutor(pool));
+}
+
+void RepoExecutor::submit(Access access, std::function<void()> task) {
+    std::vector<Task> ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(Task{access, std::move(task)});
+        schedule(ready);
+    }
+    dispatch(ready);
+}
+
+bool RepoExecutor::tryRun(Access access, const std::function<void()> &task, std::chrono::milliseconds wait) {
+    if (currentTask.executor == this) {
+        if (currentTask.access == Access::Shared && access == Access::Exclusive) {
+            // 共享任务无法升级为独占：直接执行会失去互斥，等待则会与外层任务互相等待
+            OH_LOG_ERROR(LOG_APP, "RepoExecutor exclusive task nested in a shared task, rejected");
+            return false;
+        }
+        task();
+        return true;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        // 同步调用来自 JS 线程，同一时刻最多一个，共享调用插到排队的独占任务之前最多让它多等一次调用，不会饿死；
+        // 独占调用不插队，避免越过先提交的写入
+        auto admissible = [this, access] {
+            return access == Access::Shared ? !writer_ : queue_.empty() && !writer_ && readers_ == 0;
+        };
+        if (!finished_.wait_for(lock, wait, admissible)) {
+            return false;
+        }
+        if (access == Access::Exclusive) {
+            writer_ = true;
+        } else {
+            ++readers_;
+        }
+    }
+
+    struct Finish {
+        RepoExecutor *executor;
+        Access access;
+        ~Finish() { executor->finish(access); }
+    } finish{this, access};
+    TaskMark mark(this, access);
+    task();
+    return true;
+}
+
+size_t RepoExecutor::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+void RepoExecutor::schedule(std::vector<Task> &ready) {
+    while (!queue_.empty() && !writer_) {
+        auto &head = queue_.front();
+        if (head.access == Access::Exclusive) {
+            if (readers_ > 0) {
+                break;
+            }
+            writer_ = true;
+        } else {
+            ++readers_;
+        }
+        ready.push_back(std::move(head));
+        queue_.pop_front();
+    }
+}
+
+void RepoExecutor::dispatch(std::vector<Task> &ready) {
+    for (auto &task : ready) {
+        pool_.submit([self = shared_from_this(), access = task.access, body = std::move(task.body)]() mutable {
+            {
+                TaskMark mark(self.get(), access);
+                try {
+                    body();
+                } catch (...) {
+                    OH_LOG_WARN(LOG_APP, "RepoExecutor task threw an exception, ignoring");
+                }
+                // 任务可能持有仓库等资源，在调度后续任务前释放
+                body = nullptr;
+            }
+            self->finish(access);
+        });
+    }
+}
+
+void RepoExecutor::finish(Access access) {
+    std::vector<Task> ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (access == Access::Exclusive) {
+            writer_ = false;
+        } else {
+            --readers_;
+        }
+        schedule(ready);
+    }
+    finished_.notify_all();
+    dispatch(ready);
+}
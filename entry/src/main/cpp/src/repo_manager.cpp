@@ -1,11 +1,21 @@
 #include "repo_manager.h"
+#include "credential_provider.h"
 #include "git2/common.h"
+#include "git_runtime.h"
 #include "global.h"
+#include "metrics.h"
+#include "thread_pool.h"
+#include "tracer.h"
+#include "utils/log.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstring>
 #include <ctime>
+#include <filesystem>
 #include <git2.h>
-#include <hilog/log.h>
 #include <iostream>
+#include <mutex>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -33,12 +43,8 @@ static int certificate_check_cb(git_cert *cert, int valid, const char *host, voi
 static int credentials_cb(git_credential **out, const char *url, const char *username_from_url,
                           unsigned int allowed_types, void *payload) {
     if (allowed_types & GIT_CREDENTIAL_SSH_KEY) {
-        std::string public_key = Globals::files_directory + "/ssh/id_rsa.pub";
-        std::string private_key = Globals::files_directory + "/ssh/id_rsa";
-
         OH_LOG_INFO(LOG_APP, "SSH authentication requested for URL: %{public}s", url);
-        int result =
-            git_credential_ssh_key_new(out, username_from_url, public_key.c_str(), private_key.c_str(), nullptr);
+        int result = CredentialProvider::Shared().createSSHKey(out, username_from_url);
 
         if (result == 0) {
             OH_LOG_INFO(LOG_APP, "SSH credential created successfully");
@@ -56,37 +62,69 @@ static int credentials_cb(git_credential **out, const char *url, const char *use
     return GIT_EUSER;
 }
 
+namespace {
+// 同一个 RepoManager 的只读请求会在多个线程上并行执行，当前句柄和错误信息都按线程保存
+struct CurrentHandle {
+    const RepoManager *owner = nullptr; ///< 租用句柄的管理器
+    git_repository *repo = nullptr;     ///< 租用的句柄
+};
+struct ThreadError {
+    const RepoManager *owner = nullptr; ///< 设置错误的管理器
+    std::string message;                ///< 错误信息
+};
+thread_local CurrentHandle currentHandle;
+thread_local ThreadError lastError;
+
+// 打开的仓库数量，结果缓存预算按此均分
+std::atomic<size_t> openManagers{0};
+
+// 每个仓库的搜索缓存可用的字节数：结果缓存预算的一半，其余留给按条目数限制的其他缓存
+size_t SearchCacheBudget() {
+    size_t managers = std::max<size_t>(openManagers.load(std::memory_order_relaxed), 1);
+    return GitRuntime::Instance().resultCacheBudget() / managers / 2;
+}
 
-RepoManager::RepoManager() : repository_(nullptr), remote_(nullptr) {
-    OH_LOG_INFO(LOG_APP, "RepoManager::RepoManager");
-    // 初始化libgit2库
-    git_libgit2_init();
-
-    git_libgit2_opts(GIT_OPT_ENABLE_STRICT_HASH_VERIFICATION, 0);
-    git_libgit2_opts(GIT_OPT_SET_MWINDOW_SIZE, 128 * 1024 * 1024);        // 128MB
-    git_libgit2_opts(GIT_OPT_SET_MWINDOW_MAPPED_LIMIT, 64 * 1024 * 1024); // 64M
-    int timeout_ms = 30 * 1000;                                           // 60 seconds
-    int error = git_libgit2_opts(GIT_OPT_SET_SERVER_TIMEOUT, timeout_ms);
-
-    int features = git_libgit2_features();
-    if (features & GIT_FEATURE_SSH) {
-        OH_LOG_INFO(LOG_APP, "SSH support is enabled");
-    } else {
-        OH_LOG_ERROR(LOG_APP, "SSH support is not enabled");
+// 估算一条搜索缓存占用的字节数
+size_t SearchResultBytes(const std::string &key, const std::vector<LineMatch> &matches) {
+    size_t bytes = key.capacity() + sizeof(matches) + matches.capacity() * sizeof(LineMatch);
+    for (const auto &match : matches) {
+        bytes += match.text.capacity() + match.columns.capacity() * sizeof(match.columns[0]);
     }
+    return bytes;
+}
+} // namespace
 
-    std::string certPath = Globals::files_directory + "/cert.pem";
-    if (access(certPath.c_str(), F_OK) == 0) {
-        git_libgit2_opts(GIT_OPT_SET_SSL_CERT_LOCATIONS, certPath.c_str(), nullptr);
-    } else {
-        OH_LOG_WARN(LOG_APP, "cert.pem not found, use default SSL certificate path %{public}s", certPath.c_str());
+RepoManager::ReadScope::ReadScope(const RepoManager &manager)
+    : previous_(currentHandle.owner), previousRepo_(currentHandle.repo) {
+    if (currentHandle.owner == &manager) {
+        return;
     }
+    // 租用失败时 repo() 返回空，调用方按仓库未打开处理
+    lease_ = manager.handles_.acquire(manager.repository_);
+    owner_ = true;
+    currentHandle = {&manager, lease_.get()};
+}
+
+RepoManager::ReadScope::~ReadScope() {
+    if (owner_) {
+        currentHandle = {previous_, previousRepo_};
+    }
+}
+
+git_repository *RepoManager::repo() const {
+    return currentHandle.owner == this ? currentHandle.repo : repository_;
+}
+
+RepoManager::RepoManager() : repository_(nullptr), remote_(nullptr) {
+    OH_LOG_INFO(LOG_APP, "RepoManager::RepoManager");
+    openManagers++;
+    // libgit2 由进程级运行时统一初始化和配置
+    GitRuntime::Instance();
 }
 
 RepoManager::~RepoManager() {
     freeResources();
-    // 关闭libgit2库
-    git_libgit2_shutdown();
+    openManagers--;
 }
 
 void RepoManager::freeResources() {
@@ -96,12 +134,14 @@ void RepoManager::freeResources() {
     }
 
     if (repository_) {
+        // 池中句柄共享主句柄的对象库，先于主句柄释放
+        handles_.clear();
         git_repository_free(repository_);
         repository_ = nullptr;
     }
 }
 
-void RepoManager::setError(const std::string &error) { lastError_ = error; }
+void RepoManager::setError(const std::string &error) { lastError = {this, error}; }
 
 bool RepoManager::checkError(int error, const std::string &operation) {
     if (error < 0) {
@@ -375,6 +415,7 @@ std::string RepoManager::getErrorSolution(git_error_t error_class, int error_cod
 }
 
 bool RepoManager::openRepository(const std::string &path) {
+    TraceSpan span("git", "git_repository_open");
     // 释放之前的资源
     freeResources();
 
@@ -387,9 +428,9 @@ bool RepoManager::openRepository(const std::string &path) {
 
     // 打开仓库
     if (!checkError(git_repository_open(&repository_, path.c_str()), "Open repository")) {
-        setError(lastError_.c_str());
+        setError(getLastError().c_str());
         OH_LOG_ERROR(LOG_APP, "Open repository failed: %{public}s, error: %{public}s", path.c_str(),
-                     lastError_.c_str());
+                     getLastError().c_str());
         return false;
     }
 
@@ -419,64 +460,73 @@ bool RepoManager::createRepository(const std::string &path, bool isBare) {
     return true;
 }
 
-bool RepoManager::connectRemote(const std::string &url, const std::string &localPath) {
+bool RepoManager::openLocal(const std::string &url, const std::string &localPath) {
+    TraceSpan span("git", "RepoManager::openLocal");
     // 释放之前的资源
     freeResources();
 
     remoteUrl_ = url;
 
-    // 检查本地路径是否存在仓库
-    if (git_repository_open(&repository_, localPath.c_str()) == 0) {
+    // 检查本地路径是否存在仓库，路径已确定，不向上搜索
+    if (git_repository_open_ext(&repository_, localPath.c_str(), GIT_REPOSITORY_OPEN_NO_SEARCH, nullptr) == 0) {
         // 成功打开现有仓库
         repoPath_ = localPath;
     } else {
         // 创建新的裸仓库
         if (!createRepository(localPath, true)) {
             OH_LOG_ERROR(LOG_APP, "Create repository failed: %{public}s, error: %{public}s", localPath.c_str(),
-                         lastError_.c_str());
+                         getLastError().c_str());
             return false;
         }
     }
 
-    // 添加或更新远程仓库连接
-    if (!addRemote("origin", url)) {
-        // 注意：这里不调用freeResources()，因为我们可能想保留已打开的仓库
-        // 只清理remote_成员变量
-        if (remote_) {
-            git_remote_free(remote_);
-            remote_ = nullptr;
-        }
-        OH_LOG_ERROR(LOG_APP, "Add remote failed: %{public}s, error: %{public}s", url.c_str(), lastError_.c_str());
+    // 远程地址未变化时不改写配置文件
+    git_remote *remote = nullptr;
+    bool upToDate = false;
+    if (git_remote_lookup(&remote, repository_, "origin") == 0) {
+        const char *current = git_remote_url(remote);
+        upToDate = current != nullptr && url == current;
+        git_remote_free(remote);
+    }
+    if (!upToDate && !addRemote("origin", url)) {
+        OH_LOG_ERROR(LOG_APP, "Add remote failed: %{public}s, error: %{public}s", url.c_str(), getLastError().c_str());
+        return false;
+    }
+    return true;
+}
+
+bool RepoManager::connect() {
+    if (isConnected()) {
+        return true;
+    }
+    if (!repository_) {
+        setError("仓库未初始化");
         return false;
     }
 
+    if (remote_) {
+        git_remote_free(remote_);
+        remote_ = nullptr;
+    }
+
     // 获取远程仓库对象
     if (!checkError(git_remote_lookup(&remote_, repository_, "origin"), "Lookup remote")) {
-        // 注意：这里不调用freeResources()，因为我们可能想保留已打开的仓库
-        // 只清理remote_成员变量
-        if (remote_) {
-            git_remote_free(remote_);
-            remote_ = nullptr;
-        }
-        OH_LOG_ERROR(LOG_APP, "Lookup remote failed: %{public}s, error: %{public}s", "origin", lastError_.c_str());
+        OH_LOG_ERROR(LOG_APP, "Lookup remote failed: %{public}s, error: %{public}s", "origin", getLastError().c_str());
         return false;
     }
 
     // 连接远程仓库
+    TraceSpan span("git", "git_remote_connect");
     git_remote_callbacks callbacks = GIT_REMOTE_CALLBACKS_INIT;
     callbacks.credentials = credentials_cb;
     callbacks.certificate_check = certificate_check_cb;
     if (!checkError(git_remote_connect(remote_, GIT_DIRECTION_FETCH, &callbacks, nullptr, nullptr),
                     "Connect to remote repository")) {
-        // 注意：这里不调用freeResources()，因为我们可能想保留已打开的仓库
-        // 只清理remote_成员变量
-        if (remote_) {
-            git_remote_free(remote_);
-            remote_ = nullptr;
-        }
-        setError(lastError_.c_str());
+        // 只清理remote_成员变量，保留已打开的仓库
+        git_remote_free(remote_);
+        remote_ = nullptr;
         OH_LOG_ERROR(LOG_APP, "Connect to remote repository failed: %{public}s, error: %{public}s", "origin",
-                     lastError_.c_str());
+                     getLastError().c_str());
         return false;
     }
 
@@ -484,6 +534,10 @@ bool RepoManager::connectRemote(const std::string &url, const std::string &local
     return true;
 }
 
+bool RepoManager::connectRemote(const std::string &url, const std::string &localPath) {
+    return openLocal(url, localPath) && connect();
+}
+
 bool RepoManager::shallowClone(const std::string &url, const std::string &localPath, int depth) {
     // 释放之前的资源
     freeResources();
@@ -497,7 +551,7 @@ bool RepoManager::shallowClone(const std::string &url, const std::string &localP
     // 执行克隆操作
     if (!checkError(git_clone(&repository_, url.c_str(), localPath.c_str(), &clone_opts), "Shallow clone repository")) {
         OH_LOG_ERROR(LOG_APP, "Shallow clone repository failed: %{public}s, error: %{public}s", url.c_str(),
-                     lastError_.c_str());
+                     getLastError().c_str());
         return false;
     }
 
@@ -527,17 +581,17 @@ bool RepoManager::cloneRepository(const std::string &url, const std::string &loc
 }
 
 bool RepoManager::addRemote(const std::string &name, const std::string &url) {
-    if (!repository_) {
+    if (!repo()) {
         setError("No repository opened");
         return false;
     }
 
     git_remote *remote = nullptr;
-    int error = git_remote_create(&remote, repository_, name.c_str(), url.c_str());
+    int error = git_remote_create(&remote, repo(), name.c_str(), url.c_str());
 
     if (error == GIT_EEXISTS) {
         // 远程仓库已存在，更新URL
-        if (!checkError(git_remote_set_url(repository_, name.c_str(), url.c_str()), "Update remote URL")) {
+        if (!checkError(git_remote_set_url(repo(), name.c_str(), url.c_str()), "Update remote URL")) {
             return false;
         }
         return true;
@@ -551,7 +605,8 @@ bool RepoManager::addRemote(const std::string &name, const std::string &url) {
 
 bool RepoManager::fetch(const std::string &remoteName, const std::vector<std::string> &branchRefs, int depth,
                         FetchProgressCallback progressCallback) {
-    if (!repository_) {
+    MetricsTimer timer(Metrics::Operation::Fetch);
+    if (!repo()) {
         setError("仓库未初始化");
         return false;
     }
@@ -560,9 +615,9 @@ bool RepoManager::fetch(const std::string &remoteName, const std::vector<std::st
                 remoteName.c_str(), branchRefs.size(), depth);
 
     git_remote *remote = nullptr;
-    if (!checkError(git_remote_lookup(&remote, repository_, remoteName.c_str()), "Lookup remote")) {
+    if (!checkError(git_remote_lookup(&remote, repo(), remoteName.c_str()), "Lookup remote")) {
         OH_LOG_ERROR(LOG_APP, "Lookup remote failed: %{public}s, error: %{public}s", remoteName.c_str(),
-                     lastError_.c_str());
+                     getLastError().c_str());
         return false;
     }
 
@@ -603,24 +658,30 @@ bool RepoManager::fetch(const std::string &remoteName, const std::vector<std::st
         OH_LOG_INFO(LOG_APP, "No specific branches specified, will fetch with depth limit");
     }
 
-    // 添加回调以监控进度和错误
-    git_remote_callbacks callbacks = GIT_REMOTE_CALLBACKS_INIT;
-
-    // 如果提供了进度回调函数，则设置进度回调
+    // 添加回调以监控进度和错误，回调通过 payload 取得进度回调和追踪阶段
+    struct FetchState {
+        FetchProgressCallback *progress = nullptr;
+        TracePhases phases{"fetch"};
+    };
+    FetchState state;
     if (progressCallback) {
-        // 使用成员变量来存储进度回调函数，避免lambda捕获问题
-        static FetchProgressCallback *current_callback = nullptr;
-        current_callback = &progressCallback;
-
-        callbacks.transfer_progress = [](const git_indexer_progress *stats, void *payload) -> int {
-            // 调用当前设置的进度回调函数
-            if (current_callback && *current_callback) {
-                try {
-                    (*current_callback)(stats->received_objects, stats->total_objects);
-                } catch (...) {
-                    // 忽略回调函数中的异常，避免影响fetch操作
-                    OH_LOG_WARN(LOG_APP, "Progress callback threw an exception, ignoring");
-                }
+        state.progress = &progressCallback;
+    }
+
+    git_remote_callbacks callbacks = GIT_REMOTE_CALLBACKS_INIT;
+    callbacks.payload = &state;
+    callbacks.transfer_progress = [](const git_indexer_progress *stats, void *payload) -> int {
+        auto *state = static_cast<FetchState *>(payload);
+        // 对象全部收到后剩下的是增量解析
+        bool resolving = stats->received_objects == stats->total_objects && stats->total_deltas > 0;
+        state->phases.enter(resolving ? "resolve deltas" : "download");
+
+        if (state->progress != nullptr && *state->progress) {
+            try {
+                (*state->progress)(stats->received_objects, stats->total_objects);
+            } catch (...) {
+                // 忽略回调函数中的异常，避免影响fetch操作
+                OH_LOG_WARN(LOG_APP, "Progress callback threw an exception, ignoring");
             }
 
             // 保持原有的日志输出
@@ -628,16 +689,22 @@ bool RepoManager::fetch(const std::string &remoteName, const std::vector<std::st
                 OH_LOG_INFO(LOG_APP, "Indexing progress: %{public}d/%{public}d", stats->indexed_objects,
                             stats->total_objects);
             }
+        }
 
-            return 0; // 继续
-        };
-    }
+        return 0; // 继续
+    };
+    callbacks.update_refs = [](const char *, const git_oid *, const git_oid *, git_refspec *, void *payload) -> int {
+        static_cast<FetchState *>(payload)->phases.enter("update tips");
+        return 0;
+    };
 
     callbacks.credentials = credentials_cb;
     callbacks.certificate_check = certificate_check_cb;
 
     fetch_opts.callbacks = callbacks;
 
+    // 收到第一个进度之前是连接和协商
+    state.phases.enter("connect");
     int result;
     if (!branchRefs.empty()) {
         OH_LOG_INFO(LOG_APP, "Fetching with %{public}zu refspecs:", refspecs.count);
@@ -648,6 +715,7 @@ bool RepoManager::fetch(const std::string &remoteName, const std::vector<std::st
     } else {
         result = git_remote_fetch(remote, nullptr, &fetch_opts, "fetching with limits");
     }
+    state.phases.end();
 
     bool success = checkError(result, "Fetch from remote");
 
@@ -668,30 +736,37 @@ bool RepoManager::fetch(const std::string &remoteName, const std::vector<std::st
     return success;
 }
 
-std::vector<BranchInfo> RepoManager::getRemoteBranches(const std::string &remoteName) {
-    std::vector<BranchInfo> branches;
+bool RepoManager::getRemoteBranches(std::vector<BranchInfo> &branches, const std::string &remoteName) {
+    MetricsTimer timer(Metrics::Operation::LsRemote);
+    ReadScope scope(*this);
+    branches.clear();
 
-    if (!repository_) {
+    if (!repo()) {
         setError("仓库未初始化");
-        return branches;
+        return false;
     }
 
     // 获取远程仓库对象
     git_remote *remote = nullptr;
-    if (!checkError(git_remote_lookup(&remote, repository_, remoteName.c_str()), "Lookup remote")) {
-        return branches;
+    if (!checkError(git_remote_lookup(&remote, repo(), remoteName.c_str()), "Lookup remote")) {
+        return false;
     }
 
     // 连接远程仓库以获取最新的引用
+    TracePhases phases("git");
+    phases.enter("git_remote_connect");
     git_remote_callbacks callbacks = GIT_REMOTE_CALLBACKS_INIT;
     callbacks.credentials = credentials_cb;
     callbacks.certificate_check = certificate_check_cb;
+    bool listed = false;
     if (git_remote_connect(remote, GIT_DIRECTION_FETCH, &callbacks, nullptr, nullptr) == 0) {
         // 获取远程引用
+        phases.enter("git_remote_ls");
         const git_remote_head **remote_heads;
         size_t heads_len;
 
-        if (checkError(git_remote_ls(&remote_heads, &heads_len, remote), "List remote references")) {
+        listed = checkError(git_remote_ls(&remote_heads, &heads_len, remote), "List remote references");
+        if (listed) {
             for (size_t i = 0; i < heads_len; ++i) {
                 const git_remote_head *head = remote_heads[i];
 
@@ -710,36 +785,43 @@ std::vector<BranchInfo> RepoManager::getRemoteBranches(const std::string &remote
     }
 
     git_remote_free(remote);
-    if (branches.empty()) {
-        setError("获取远程分支失败，请检查：1) 远程仓库是否可访问 2) 远程分支是否存在 3) 网络连接是否稳定");
+    if (!listed) {
+        setError("获取远程分支失败，请检查：1) 远程仓库是否可访问 2) 网络连接是否稳定");
     }
-    return branches;
+    return listed;
 }
 
-std::vector<TagInfo> RepoManager::getRemoteTags(const std::string &remoteName) {
-    std::vector<TagInfo> tags;
+bool RepoManager::getRemoteTags(std::vector<TagInfo> &tags, const std::string &remoteName) {
+    MetricsTimer timer(Metrics::Operation::LsRemote);
+    ReadScope scope(*this);
+    tags.clear();
 
-    if (!repository_) {
+    if (!repo()) {
         setError("仓库未初始化");
-        return tags;
+        return false;
     }
 
     // 获取远程仓库对象
     git_remote *remote = nullptr;
-    if (!checkError(git_remote_lookup(&remote, repository_, remoteName.c_str()), "Lookup remote")) {
-        return tags;
+    if (!checkError(git_remote_lookup(&remote, repo(), remoteName.c_str()), "Lookup remote")) {
+        return false;
     }
 
     // 连接远程仓库以获取最新的引用
+    TracePhases phases("git");
+    phases.enter("git_remote_connect");
     git_remote_callbacks callbacks = GIT_REMOTE_CALLBACKS_INIT;
     callbacks.credentials = credentials_cb;
     callbacks.certificate_check = certificate_check_cb;
+    bool listed = false;
     if (git_remote_connect(remote, GIT_DIRECTION_FETCH, &callbacks, nullptr, nullptr) == 0) {
         // 获取远程引用
+        phases.enter("git_remote_ls");
         const git_remote_head **remote_heads;
         size_t heads_len;
 
-        if (checkError(git_remote_ls(&remote_heads, &heads_len, remote), "List remote references")) {
+        listed = checkError(git_remote_ls(&remote_heads, &heads_len, remote), "List remote references");
+        if (listed) {
             for (size_t i = 0; i < heads_len; ++i) {
                 const git_remote_head *head = remote_heads[i];
                 // 只处理标签引用(以refs/tags/开头)
@@ -765,10 +847,10 @@ std::vector<TagInfo> RepoManager::getRemoteTags(const std::string &remoteName) {
     }
 
     git_remote_free(remote);
-    if (tags.empty()) {
-        setError("获取远程标签失败，请检查：1) 远程仓库是否可访问 2) 远程标签是否存在 3) 网络连接是否稳定");
+    if (!listed) {
+        setError("获取远程标签失败，请检查：1) 远程仓库是否可访问 2) 网络连接是否稳定");
     }
-    return tags;
+    return listed;
 }
 
 CommitInfo RepoManager::convertToCommitInfo(git_commit *commit) {
@@ -818,30 +900,32 @@ CommitInfo RepoManager::convertToCommitInfo(git_commit *commit) {
     return info;
 }
 
-std::vector<CommitInfo> RepoManager::getCommitHistory(const std::string &branch, int count) {
-    std::vector<CommitInfo> commits;
+bool RepoManager::getCommitHistory(std::vector<CommitInfo> &commits, const std::string &branch, int count) {
+    ReadScope scope(*this);
+    commits.clear();
 
-    if (!repository_) {
+    if (!repo()) {
         setError("No repository opened");
-        return commits;
+        return false;
     }
 
     // 解析分支或提交ID
     git_oid oid;
     if (!resolveReference(oid, branch)) {
-        return commits;
+        return false;
     }
 
     // 创建提交遍历器
+    TraceSpan span("git", "git_revwalk");
     git_revwalk *walk;
-    if (!checkError(git_revwalk_new(&walk, repository_), "Create revision walker")) {
-        return commits;
+    if (!checkError(git_revwalk_new(&walk, repo()), "Create revision walker")) {
+        return false;
     }
 
     // 添加起始提交
     if (!checkError(git_revwalk_push(walk, &oid), "Push commit to walker")) {
         git_revwalk_free(walk);
-        return commits;
+        return false;
     }
 
     // 设置排序方式（时间倒序）
@@ -852,7 +936,8 @@ std::vector<CommitInfo> RepoManager::getCommitHistory(const std::string &branch,
     int commit_count = 0;
     while (git_revwalk_next(&commit_oid, walk) == 0 && commit_count < count) {
         git_commit *commit;
-        if (git_commit_lookup(&commit, repository_, &commit_oid) == 0) {
+        if (git_commit_lookup(&commit, repo(), &commit_oid) == 0) {
+            Metrics::Shared().add(Metrics::Counter::ObjectsLoaded);
             commits.push_back(convertToCommitInfo(commit));
             git_commit_free(commit);
             commit_count++;
@@ -860,34 +945,48 @@ std::vector<CommitInfo> RepoManager::getCommitHistory(const std::string &branch,
     }
 
     git_revwalk_free(walk);
-    return commits;
+    return true;
 }
 
-std::vector<CommitInfo> RepoManager::getCommitHistory(const std::string &branch, int count, int offset) {
-    std::vector<CommitInfo> commits;
+bool RepoManager::getCommitHistory(std::vector<CommitInfo> &commits, const std::string &branch, int count,
+                                   int offset) {
+    MetricsTimer timer(Metrics::Operation::History);
+    ReadScope scope(*this);
+    commits.clear();
 
-    if (!repository_) {
+    if (!repo()) {
         setError("仓库未初始化");
-        return commits;
+        return false;
     }
 
     // 解析分支或提交ID
     git_oid oid;
     if (!resolveReference(oid, branch)) {
         setError("获取提交历史失败，请检查：1) 分支是否存在 2) 提交ID是否正确 3) 网络连接是否稳定");
-        return commits;
+        return false;
+    }
+
+    // 以起点提交为键，fetch 移动分支后自然失效
+    std::string cacheKey = std::string(git_oid_tostr_s(&oid)) + ":" + std::to_string(count) + ":" +
+                           std::to_string(offset);
+    auto cached = historyCache_.get(cacheKey);
+    Metrics::Shared().recordCache(Metrics::Cache::History, static_cast<bool>(cached));
+    if (cached) {
+        commits = *cached;
+        return true;
     }
 
     // 创建提交遍历器
+    TraceSpan span("git", "git_revwalk");
     git_revwalk *walk;
-    if (!checkError(git_revwalk_new(&walk, repository_), "Create revision walker")) {
-        return commits;
+    if (!checkError(git_revwalk_new(&walk, repo()), "Create revision walker")) {
+        return false;
     }
 
     // 添加起始提交
     if (!checkError(git_revwalk_push(walk, &oid), "Push commit to walker")) {
         git_revwalk_free(walk);
-        return commits;
+        return false;
     }
 
     // 设置排序方式（时间倒序）
@@ -904,7 +1003,8 @@ std::vector<CommitInfo> RepoManager::getCommitHistory(const std::string &branch,
     int commit_count = 0;
     while (git_revwalk_next(&commit_oid, walk) == 0 && commit_count < count) {
         git_commit *commit;
-        if (git_commit_lookup(&commit, repository_, &commit_oid) == 0) {
+        if (git_commit_lookup(&commit, repo(), &commit_oid) == 0) {
+            Metrics::Shared().add(Metrics::Counter::ObjectsLoaded);
             commits.push_back(convertToCommitInfo(commit));
             git_commit_free(commit);
             commit_count++;
@@ -912,16 +1012,15 @@ std::vector<CommitInfo> RepoManager::getCommitHistory(const std::string &branch,
     }
 
     git_revwalk_free(walk);
-    if (commits.empty()) {
-        setError("获取提交历史失败，请检查：1) 分支是否存在 2) 提交ID是否正确 3) 网络连接是否稳定");
-    }
-    return commits;
+    historyCache_.put(cacheKey, commits);
+    return true;
 }
 
 CommitInfo RepoManager::getCommitDetails(const std::string &commitId) {
+    ReadScope scope(*this);
     CommitInfo info;
 
-    if (!repository_) {
+    if (!repo()) {
         setError("No repository opened");
         return info;
     }
@@ -934,7 +1033,7 @@ CommitInfo RepoManager::getCommitDetails(const std::string &commitId) {
 
     // 查找提交
     git_commit *commit;
-    if (!checkError(git_commit_lookup(&commit, repository_, &oid), "Lookup commit")) {
+    if (!checkError(git_commit_lookup(&commit, repo(), &oid), "Lookup commit")) {
         return info;
     }
 
@@ -944,203 +1043,1348 @@ CommitInfo RepoManager::getCommitDetails(const std::string &commitId) {
     return info;
 }
 
-std::vector<BranchInfo> RepoManager::getLocalBranches() {
-    std::vector<BranchInfo> branches;
-
-    if (!repository_) {
-        setError("No repository opened");
-        return branches;
-    }
-
-    // 获取所有引用
-    git_branch_iterator *iter;
-    if (!checkError(git_branch_iterator_new(&iter, repository_, GIT_BRANCH_LOCAL), "Create branch iterator")) {
-        return branches;
-    }
-
-    git_reference *ref;
-    git_branch_t branch_type;
-    while (git_branch_next(&ref, &branch_type, iter) == 0) {
-        BranchInfo branch;
-
-        // 获取分支名称
-        const char *name;
-        if (git_branch_name(&name, ref) == 0) {
-            branch.name = name;
-        }
-
-        // 获取分支指向的提交ID
-        const git_oid *target_oid = git_reference_target(ref);
-        if (target_oid) {
-            branch.id = git_oid_tostr_s(target_oid);
-        }
-
-        branch.isRemote = false;
-
-        // 检查是否为当前分支
-        git_reference *head_ref;
-        if (git_repository_head(&head_ref, repository_) == 0) {
-            branch.isCurrent = git_reference_cmp(ref, head_ref) == 0;
-            git_reference_free(head_ref);
-        } else {
-            branch.isCurrent = false;
-        }
-
-        branches.push_back(branch);
-        git_reference_free(ref);
-    }
-
-    git_branch_iterator_free(iter);
-    return branches;
-}
+bool RepoManager::getCommitChanges(const std::string &commitId, std::vector<FileChange> &changes) {
+    MetricsTimer timer(Metrics::Operation::CommitChanges);
+    ReadScope scope(*this);
+    changes.clear();
 
-bool RepoManager::checkoutBranch(const std::string &branchName) {
-    if (!repository_) {
-        setError("No repository opened");
+    if (!repo()) {
+        setError("仓库未初始化");
         return false;
     }
 
-    // 查找分支引用
-    git_reference *ref;
-    std::string ref_name = "refs/heads/" + branchName;
-    if (!checkError(git_reference_lookup(&ref, repository_, ref_name.c_str()), "Lookup branch reference")) {
+    // 解析提交ID
+    git_oid oid;
+    if (!resolveReference(oid, commitId)) {
+        setError("获取提交变更失败，请检查：1) 提交ID是否正确 2) 提交是否已拉取到本地");
         return false;
     }
 
-    // 获取分支指向的提交
-    git_object *target;
-    if (!checkError(git_reference_peel(&target, ref, GIT_OBJECT_COMMIT), "Peel reference to commit")) {
-        git_reference_free(ref);
-        return false;
+    // 提交是不可变的，按提交ID缓存结果
+    std::string cacheKey = git_oid_tostr_s(&oid);
+    auto cached = changesCache_.get(cacheKey);
+    Metrics::Shared().recordCache(Metrics::Cache::Changes, static_cast<bool>(cached));
+    if (cached) {
+        OH_LOG_DEBUG(LOG_APP, "Commit changes cache hit: %{public}s", cacheKey.c_str());
+        changes = *cached;
+        return true;
     }
 
-    // 执行检出操作
-    git_checkout_options checkout_opts = GIT_CHECKOUT_OPTIONS_INIT;
-    checkout_opts.checkout_strategy = GIT_CHECKOUT_SAFE;
-
-    if (!checkError(git_checkout_tree(repository_, target, &checkout_opts), "Checkout tree")) {
-        git_object_free(target);
-        git_reference_free(ref);
+    TraceSpan span("git", "RepoManager::getCommitChanges");
+    git_commit *commit = nullptr;
+    if (!checkError(git_commit_lookup(&commit, repo(), &oid), "Lookup commit")) {
         return false;
     }
 
-    // 设置HEAD引用
-    if (!checkError(git_repository_set_head(repository_, ref_name.c_str()), "Set HEAD reference")) {
-        git_object_free(target);
-        git_reference_free(ref);
+    git_tree *tree = nullptr;
+    if (!checkError(git_commit_tree(&tree, commit), "Get commit tree")) {
+        git_commit_free(commit);
         return false;
     }
 
-    git_object_free(target);
-    git_reference_free(ref);
-    return true;
-}
-
-bool RepoManager::createBranch(const std::string &branchName, const std::string &commitId) {
-    if (!repository_) {
-        setError("No repository opened");
-        return false;
+    // 与第一个父提交比较，根提交与空树比较；浅克隆时父提交可能不在本地
+    git_tree *parentTree = nullptr;
+    if (git_commit_parentcount(commit) > 0) {
+        git_commit *parent = nullptr;
+        if (git_commit_parent(&parent, commit, 0) == 0) {
+            if (git_commit_tree(&parentTree, parent) != 0) {
+                parentTree = nullptr;
+            }
+            git_commit_free(parent);
+        } else {
+            OH_LOG_WARN(LOG_APP, "Parent of %{public}s not available locally, diffing against empty tree",
+                        cacheKey.c_str());
+        }
     }
 
-    // 解析提交ID
-    git_oid oid;
-    if (!checkError(git_oid_fromstr(&oid, commitId.c_str()), "Parse commit ID")) {
+    git_diff_options diffOpts = GIT_DIFF_OPTIONS_INIT;
+    git_diff *diff = nullptr;
+    if (!checkError(git_diff_tree_to_tree(&diff, repo(), parentTree, tree, &diffOpts), "Diff commit trees")) {
+        git_tree_free(parentTree);
+        git_tree_free(tree);
+        git_commit_free(commit);
         return false;
     }
 
-    // 创建分支
-    git_commit *commit;
-    if (!checkError(git_commit_lookup(&commit, repository_, &oid), "Lookup commit")) {
+    // 重命名与复制检测
+    git_diff_find_options findOpts = GIT_DIFF_FIND_OPTIONS_INIT;
+    findOpts.flags = GIT_DIFF_FIND_RENAMES | GIT_DIFF_FIND_COPIES;
+    if (!checkError(git_diff_find_similar(diff, &findOpts), "Find renames and copies")) {
+        git_diff_free(diff);
+        git_tree_free(parentTree);
+        git_tree_free(tree);
+        git_commit_free(commit);
         return false;
     }
 
-    git_reference *ref;
-    std::string ref_name = "refs/heads/" + branchName;
-    bool result = checkError(git_branch_create(&ref, repository_, branchName.c_str(), commit, 0), "Create branch");
+    size_t deltaCount = git_diff_num_deltas(diff);
+    changes.reserve(deltaCount);
+    std::vector<std::pair<git_oid, git_oid>> blobIds;
+    blobIds.reserve(deltaCount);
+    for (size_t i = 0; i < deltaCount; ++i) {
+        const git_diff_delta *delta = git_diff_get_delta(diff, i);
+
+        FileChange change;
+        change.path = delta->new_file.path ? delta->new_file.path : "";
+        change.oldPath = delta->old_file.path ? delta->old_file.path : "";
+        change.status = git_diff_status_char(delta->status);
+        change.similarity = delta->similarity;
+        change.additions = 0;
+        change.deletions = 0;
+        change.isBinary = (delta->flags & GIT_DIFF_FLAG_BINARY) != 0;
+        change.tooLarge = false;
+        change.oldId = git_oid_is_zero(&delta->old_file.id) ? "" : git_oid_tostr_s(&delta->old_file.id);
+        change.newId = git_oid_is_zero(&delta->new_file.id) ? "" : git_oid_tostr_s(&delta->new_file.id);
+
+        // 子模块没有可统计的内容
+        if (delta->old_file.mode == GIT_FILEMODE_COMMIT || delta->new_file.mode == GIT_FILEMODE_COMMIT) {
+            change.isBinary = true;
+        }
 
-    if (ref) {
-        git_reference_free(ref);
+        changes.push_back(std::move(change));
+        blobIds.emplace_back(delta->old_file.id, delta->new_file.id);
     }
-    git_commit_free(commit);
 
-    return result;
-}
+    git_diff_free(diff);
+    git_tree_free(parentTree);
+    git_tree_free(tree);
+    git_commit_free(commit);
 
-bool RepoManager::isConnected() const { return remote_ != nullptr && git_remote_connected(remote_); }
+    // 逐文件的行级diff相互独立，分摊到工作线程
+    git_odb *odb = nullptr;
+    if (checkError(git_repository_odb(&odb, repo()), "Get object database")) {
+        ThreadPool::Shared().parallelFor(changes.size(), [this, odb, &changes, &blobIds](size_t i) {
+            if (!changes[i].isBinary) {
+                countChangedLines(changes[i], odb, blobIds[i].first, blobIds[i].second);
+            }
+        });
+        git_odb_free(odb);
+    }
 
-bool RepoManager::isOpen() const { return repository_ != nullptr; }
+    OH_LOG_INFO(LOG_APP, "Commit %{public}s changed %{public}zu files", cacheKey.c_str(), changes.size());
+    changesCache_.put(cacheKey, changes);
+    return true;
+}
 
-std::string RepoManager::getLastError() const { return lastError_; }
+void RepoManager::countChangedLines(FileChange &change, git_odb *odb, const git_oid &oldId, const git_oid &newId) {
+    // 先读对象头判断大小，生成文件等超大文件不解压也不做diff
+    size_t totalSize = 0;
+    for (const git_oid *id : {&oldId, &newId}) {
+        size_t size = 0;
+        git_object_t type = GIT_OBJECT_INVALID;
+        if (!git_oid_is_zero(id) && git_odb_read_header(&size, &type, odb, id) == 0) {
+            totalSize += size;
+        }
+    }
+    if (totalSize > MAX_DIFF_BLOB_BYTES) {
+        OH_LOG_INFO(LOG_APP, "Skip line stats for large file %{public}s: %{public}zu bytes", change.path.c_str(),
+                    totalSize);
+        change.tooLarge = true;
+        return;
+    }
 
-std::string RepoManager::getCurrentBranch() const {
-    if (!repository_) {
-        return "";
+    // 工作线程上没有租用的仓库句柄，直接从调用方传入的对象库读取，不经过主句柄
+    git_odb_object *oldObject = nullptr;
+    git_odb_object *newObject = nullptr;
+    if (!git_oid_is_zero(&oldId) && git_odb_read(&oldObject, odb, &oldId) != 0) {
+        OH_LOG_WARN(LOG_APP, "Read blob failed: %{public}s", change.oldPath.c_str());
+        return;
+    }
+    if (!git_oid_is_zero(&newId) && git_odb_read(&newObject, odb, &newId) != 0) {
+        OH_LOG_WARN(LOG_APP, "Read blob failed: %{public}s", change.path.c_str());
+        git_odb_object_free(oldObject);
+        return;
     }
 
-    git_reference *head;
-    if (git_repository_head(&head, repository_) != 0) {
-        return "";
+    const char *oldData = oldObject ? static_cast<const char *>(git_odb_object_data(oldObject)) : nullptr;
+    size_t oldSize = oldObject ? git_odb_object_size(oldObject) : 0;
+    const char *newData = newObject ? static_cast<const char *>(git_odb_object_data(newObject)) : nullptr;
+    size_t newSize = newObject ? git_odb_object_size(newObject) : 0;
+    if ((oldData && git_blob_data_is_binary(oldData, oldSize) == 1) ||
+        (newData && git_blob_data_is_binary(newData, newSize) == 1)) {
+        change.isBinary = true;
+        git_odb_object_free(oldObject);
+        git_odb_object_free(newObject);
+        return;
     }
 
-    const char *branchName;
-    if (git_branch_name(&branchName, head) != 0) {
-        git_reference_free(head);
-        return "";
+    // 直接对原始内容做diff，不经过仓库属性/驱动查找
+    git_diff_options opts = GIT_DIFF_OPTIONS_INIT;
+    opts.context_lines = 0;
+    git_patch *patch = nullptr;
+    int error = git_patch_from_buffers(&patch, oldData, oldSize, change.oldPath.c_str(), newData, newSize,
+                                       change.path.c_str(), &opts);
+    if (error == 0) {
+        git_patch_line_stats(nullptr, &change.additions, &change.deletions, patch);
+        git_patch_free(patch);
+    } else {
+        OH_LOG_WARN(LOG_APP, "Create patch failed for %{public}s: %{public}d", change.path.c_str(), error);
     }
 
-    std::string result = branchName;
-    git_reference_free(head);
-    return result;
+    git_odb_object_free(oldObject);
+    git_odb_object_free(newObject);
 }
 
-std::string RepoManager::getRemoteUrl(const std::string &remoteName) const {
-    if (!repository_) {
-        return "";
-    }
+bool RepoManager::getFilePatch(const std::string &commitId, const std::string &path, const PatchOptions &options,
+                               const PatchChunkCallback &onChunk, PatchSummary &summary) {
+    ReadScope scope(*this);
+    summary = PatchSummary();
+    summary.path = path;
 
-    git_remote *remote = nullptr;
-    if (git_remote_lookup(&remote, repository_, remoteName.c_str()) != 0) {
-        return "";
+    if (!repo()) {
+        setError("仓库未初始化");
+        return false;
     }
 
-    const char *url = git_remote_url(remote);
-    std::string result = url ? url : "";
-
-    git_remote_free(remote);
-    return result;
-}
-
-bool RepoManager::resolveReference(git_oid &oid, const std::string &ref) {
-    if (!repository_) {
-        setError("No repository opened");
+    if (path.empty()) {
+        setError("文件路径不能为空");
         return false;
     }
 
-    // 首先尝试作为分支名查找
-    if (git_reference_name_to_id(&oid, repository_, ("refs/heads/" + ref).c_str()) == 0) {
-        OH_LOG_DEBUG(LOG_APP, "Resolved as local branch: refs/heads/%{public}s", ref.c_str());
+    // 借助已缓存的提交变更定位文件，处理重命名/复制时的旧路径
+    std::vector<FileChange> changes;
+    if (!getCommitChanges(commitId, changes)) {
+        return false;
+    }
+    auto change = std::find_if(changes.begin(), changes.end(),
+                               [&path](const FileChange &item) { return item.path == path; });
+    if (change == changes.end()) {
+        OH_LOG_INFO(LOG_APP, "File %{public}s not changed in %{public}s", path.c_str(), commitId.c_str());
         return true;
     }
-
-    // 尝试作为远程分支名查找
-    if (git_reference_name_to_id(&oid, repository_, ("refs/remotes/origin/" + ref).c_str()) == 0) {
-        OH_LOG_DEBUG(LOG_APP, "Resolved as remote branch: refs/remotes/origin/%{public}s", ref.c_str());
+    summary.exists = true;
+    summary.oldPath = change->oldPath;
+    if (change->isBinary) {
+        summary.isBinary = true;
         return true;
     }
 
-    // 尝试作为完整的远程分支引用查找
-    if (git_reference_name_to_id(&oid, repository_, ref.c_str()) == 0) {
-        OH_LOG_DEBUG(LOG_APP, "Resolved as full reference: %{public}s", ref.c_str());
+    // 先按变更记录中的blob ID读对象头判断大小，生成文件等超大文件不解压也不做diff，避免长时间占用CPU和内存
+    git_odb *odb = nullptr;
+    if (!checkError(git_repository_odb(&odb, repo()), "Get object database")) {
+        return false;
+    }
+    size_t headerSize = 0;
+    for (const std::string *id : {&change->oldId, &change->newId}) {
+        git_oid blobId;
+        size_t size = 0;
+        git_object_t type = GIT_OBJECT_INVALID;
+        if (!id->empty() && git_oid_fromstr(&blobId, id->c_str()) == 0 &&
+            git_odb_read_header(&size, &type, odb, &blobId) == 0) {
+            headerSize += size;
+        }
+    }
+    git_odb_free(odb);
+    if (headerSize > options.maxBlobBytes) {
+        OH_LOG_WARN(LOG_APP, "Skip patch for large file %{public}s: %{public}zu bytes", path.c_str(), headerSize);
+        summary.tooLarge = true;
+        summary.additions = change->additions;
+        summary.deletions = change->deletions;
         return true;
     }
 
-    // 如果还不是远程分支名，尝试直接解析为提交ID
-    if (git_oid_fromstr(&oid, ref.c_str()) == 0) {
-        OH_LOG_DEBUG(LOG_APP, "Resolved as commit ID: %{public}s", ref.c_str());
-        return true;
+    git_oid oid;
+    if (!resolveReference(oid, commitId)) {
+        setError("获取文件补丁失败，请检查：1) 提交ID是否正确 2) 提交是否已拉取到本地");
+        return false;
     }
 
-    // 所有尝试都失败了
+    git_commit *commit = nullptr;
+    if (!checkError(git_commit_lookup(&commit, repo(), &oid), "Lookup commit")) {
+        return false;
+    }
+
+    // 与 readFile 相同的方式查找两侧的blob，新增/删除的文件只有一侧
+    git_blob *oldBlob = nullptr;
+    git_blob *newBlob = nullptr;
+    if (change->status != 'A' && git_commit_parentcount(commit) > 0) {
+        git_commit *parent = nullptr;
+        if (git_commit_parent(&parent, commit, 0) == 0) {
+            if (!lookupBlobByPath(&oldBlob, parent, change->oldPath)) {
+                oldBlob = nullptr;
+            }
+            git_commit_free(parent);
+        }
+    }
+    if (change->status != 'D' && !lookupBlobByPath(&newBlob, commit, path)) {
+        git_blob_free(oldBlob);
+        git_commit_free(commit);
+        return false;
+    }
+    git_commit_free(commit);
+
+    size_t oldSize = oldBlob ? static_cast<size_t>(git_blob_rawsize(oldBlob)) : 0;
+    size_t newSize = newBlob ? static_cast<size_t>(git_blob_rawsize(newBlob)) : 0;
+
+    git_diff_options diffOpts = GIT_DIFF_OPTIONS_INIT;
+    diffOpts.context_lines = options.contextLines;
+    git_patch *patch = nullptr;
+    int error = git_patch_from_buffers(&patch, oldBlob ? git_blob_rawcontent(oldBlob) : nullptr, oldSize,
+                                       summary.oldPath.c_str(), newBlob ? git_blob_rawcontent(newBlob) : nullptr,
+                                       newSize, path.c_str(), &diffOpts);
+    if (!checkError(error, "Create patch")) {
+        git_blob_free(oldBlob);
+        git_blob_free(newBlob);
+        return false;
+    }
+    git_patch_line_stats(nullptr, &summary.additions, &summary.deletions, patch);
+
+    std::vector<PatchHunk> pending;
+    size_t pendingBytes = 0;
+    bool stopped = false;
+    auto flush = [&]() {
+        if (pending.empty()) {
+            return;
+        }
+        if (!onChunk(pending)) {
+            stopped = true;
+        }
+        pending.clear();
+        pendingBytes = 0;
+    };
+
+    size_t hunkCount = git_patch_num_hunks(patch);
+    for (size_t h = 0; h < hunkCount && !stopped && !summary.truncated; ++h) {
+        const git_diff_hunk *diffHunk = nullptr;
+        size_t lineCount = 0;
+        if (git_patch_get_hunk(&diffHunk, &lineCount, patch, h) != 0) {
+            break;
+        }
+
+        PatchHunk hunk;
+        hunk.header.assign(diffHunk->header, diffHunk->header_len);
+        while (!hunk.header.empty() && hunk.header.back() == '\n') {
+            hunk.header.pop_back();
+        }
+        hunk.oldStart = diffHunk->old_start;
+        hunk.oldLines = diffHunk->old_lines;
+        hunk.newStart = diffHunk->new_start;
+        hunk.newLines = diffHunk->new_lines;
+        size_t hunkBytes = hunk.header.size();
+
+        for (size_t l = 0; l < lineCount; ++l) {
+            const git_diff_line *diffLine = nullptr;
+            if (git_patch_get_line_in_hunk(&diffLine, patch, h, l) != 0) {
+                break;
+            }
+            // 跳过 "\ No newline at end of file" 标记行
+            if (diffLine->origin != GIT_DIFF_LINE_CONTEXT && diffLine->origin != GIT_DIFF_LINE_ADDITION &&
+                diffLine->origin != GIT_DIFF_LINE_DELETION) {
+                continue;
+            }
+            if (summary.bytes + pendingBytes + hunkBytes + diffLine->content_len > options.maxBytes) {
+                summary.truncated = true;
+                break;
+            }
+
+            PatchLine line;
+            line.origin = diffLine->origin;
+            line.oldLineno = diffLine->old_lineno;
+            line.newLineno = diffLine->new_lineno;
+            line.content.assign(diffLine->content, diffLine->content_len);
+            while (!line.content.empty() && (line.content.back() == '\n' || line.content.back() == '\r')) {
+                line.content.pop_back();
+            }
+            hunkBytes += diffLine->content_len;
+            hunk.lines.push_back(std::move(line));
+        }
+
+        if (hunk.lines.empty()) {
+            break;
+        }
+
+        // 高亮只为实际输出的块计算
+        if (options.wordDiff) {
+            highlightHunk(hunk);
+        }
+        pending.push_back(std::move(hunk));
+        pendingBytes += hunkBytes;
+        summary.hunkCount++;
+        if (pendingBytes >= options.chunkBytes) {
+            summary.bytes += pendingBytes;
+            flush();
+        }
+    }
+    summary.bytes += pendingBytes;
+    if (!stopped) {
+        flush();
+    }
+
+    git_patch_free(patch);
+    git_blob_free(oldBlob);
+    git_blob_free(newBlob);
+
+    OH_LOG_INFO(LOG_APP, "Patch for %{public}s: %{public}zu hunks, %{public}zu bytes, truncated: %{public}d",
+                path.c_str(), summary.hunkCount, summary.bytes, summary.truncated);
+    return true;
+}
+
+void RepoManager::highlightHunk(PatchHunk &hunk) {
+    auto &lines = hunk.lines;
+    size_t i = 0;
+    while (i < lines.size()) {
+        if (lines[i].origin != GIT_DIFF_LINE_DELETION) {
+            ++i;
+            continue;
+        }
+
+        // 一段连续删除行紧跟一段连续新增行，按顺序两两配对
+        size_t delStart = i;
+        while (i < lines.size() && lines[i].origin == GIT_DIFF_LINE_DELETION) {
+            ++i;
+        }
+        size_t addStart = i;
+        while (i < lines.size() && lines[i].origin == GIT_DIFF_LINE_ADDITION) {
+            ++i;
+        }
+        size_t pairs = std::min(addStart - delStart, i - addStart);
+        for (size_t p = 0; p < pairs; ++p) {
+            WordDiff::diffLines(lines[delStart + p].content, lines[addStart + p].content,
+                                lines[delStart + p].highlights, lines[addStart + p].highlights);
+        }
+    }
+}
+
+bool RepoManager::searchTree(const std::string &ref, const std::string &pattern, const SearchOptions &options,
+                             const SearchResultCallback &onResults, SearchSummary &summary) {
+    ReadScope scope(*this);
+    summary = SearchSummary();
+
+    if (!repo()) {
+        setError("仓库未初始化");
+        return false;
+    }
+
+    std::string compileError;
+    auto matcher = TextMatcher::compile(pattern, options.isRegex, options.caseSensitive, compileError);
+    if (!matcher) {
+        setError(compileError);
+        return false;
+    }
+
+    git_oid oid;
+    if (!resolveReference(oid, ref)) {
+        setError("搜索失败，请检查：1) 分支是否存在 2) 提交ID是否正确");
+        return false;
+    }
+
+    git_commit *commit = nullptr;
+    if (!checkError(git_commit_lookup(&commit, repo(), &oid), "Lookup commit")) {
+        return false;
+    }
+
+    git_tree *tree = nullptr;
+    if (!checkError(git_commit_tree(&tree, commit), "Get commit tree")) {
+        git_commit_free(commit);
+        return false;
+    }
+
+    // 先在当前线程收集所有文件的路径和blob ID，树对象的遍历很快，真正耗时的是解压blob
+    struct BlobEntry {
+        std::string path;
+        git_oid id;
+    };
+    std::vector<BlobEntry> blobs;
+    auto collect = [](const char *root, const git_tree_entry *entry, void *payload) -> int {
+        // 符号链接和子模块没有可搜索的内容
+        if (git_tree_entry_type(entry) == GIT_OBJECT_BLOB && git_tree_entry_filemode(entry) != GIT_FILEMODE_LINK) {
+            auto *blobs = static_cast<std::vector<BlobEntry> *>(payload);
+            blobs->push_back({std::string(root) + git_tree_entry_name(entry), *git_tree_entry_id(entry)});
+        }
+        return 0;
+    };
+    int error = git_tree_walk(tree, GIT_TREEWALK_PRE, collect, &blobs);
+    git_tree_free(tree);
+    git_commit_free(commit);
+    if (!checkError(error, "Walk tree")) {
+        return false;
+    }
+    summary.filesTotal = blobs.size();
+
+    git_odb *odb = nullptr;
+    if (!checkError(git_repository_odb(&odb, repo()), "Get object database")) {
+        return false;
+    }
+
+    // 匹配结果只取决于blob内容和匹配器，与所在分支和路径无关
+    std::string keyPrefix = matcher->key() + '\n' + std::to_string(options.maxLinesPerFile) + '\n';
+    // 预算随内存压力和打开的仓库数量变化，每次搜索前按当前值收紧
+    searchCache_.setMaxCost(SearchCacheBudget());
+    size_t batchFiles = std::max<size_t>(options.batchFiles, 1);
+
+    std::mutex resultMutex;
+    std::vector<FileSearchResult> pending;
+    bool emitting = false; // 由 resultMutex 保护，有线程正在调用回调
+    std::atomic<bool> stopped{false};
+    std::atomic<size_t> filesScanned{0};
+    std::atomic<size_t> cacheHits{0};
+    std::atomic<size_t> skippedBinary{0};
+    std::atomic<size_t> skippedLarge{0};
+
+    // 回调可能阻塞在JS线程上，在锁外调用；同一时刻只有一个线程负责输出，其他线程只追加结果，保证批次有序且不并发
+    auto emit = [&](FileSearchResult result) {
+        std::unique_lock<std::mutex> lock(resultMutex);
+        if (stopped.load()) {
+            return;
+        }
+        size_t remaining = options.maxResults - summary.matchCount;
+        if (result.matches.size() >= remaining) {
+            result.matches.resize(remaining);
+            summary.truncated = true;
+            stopped.store(true);
+        }
+        summary.matchCount += result.matches.size();
+        summary.filesMatched++;
+        pending.push_back(std::move(result));
+        if (emitting) {
+            return;
+        }
+        emitting = true;
+        while (!pending.empty() && (pending.size() >= batchFiles || stopped.load())) {
+            std::vector<FileSearchResult> batch;
+            batch.swap(pending);
+            lock.unlock();
+            bool accepted = onResults(batch);
+            lock.lock();
+            if (!accepted) {
+                summary.truncated = true;
+                stopped.store(true);
+                pending.clear();
+            }
+        }
+        emitting = false;
+    };
+
+    ThreadPool::Shared().parallelFor(blobs.size(), [&](size_t i) {
+        if (stopped.load(std::memory_order_relaxed)) {
+            return;
+        }
+        const BlobEntry &blob = blobs[i];
+        std::string blobId = git_oid_tostr_s(&blob.id);
+        std::string cacheKey = keyPrefix + blobId;
+
+        auto matches = searchCache_.get(cacheKey);
+        Metrics::Shared().recordCache(Metrics::Cache::Search, static_cast<bool>(matches));
+        if (matches) {
+            cacheHits++;
+        } else {
+            // 先读对象头判断大小，避免解压大文件
+            size_t size = 0;
+            git_object_t type = GIT_OBJECT_INVALID;
+            if (git_odb_read_header(&size, &type, odb, &blob.id) != 0) {
+                OH_LOG_WARN(LOG_APP, "Read blob header failed: %{public}s", blob.path.c_str());
+                return;
+            }
+            if (size > options.maxFileBytes) {
+                skippedLarge++;
+                return;
+            }
+
+            git_odb_object *object = nullptr;
+            if (git_odb_read(&object, odb, &blob.id) != 0) {
+                OH_LOG_WARN(LOG_APP, "Read blob failed: %{public}s", blob.path.c_str());
+                return;
+            }
+            std::string_view content(static_cast<const char *>(git_odb_object_data(object)),
+                                     git_odb_object_size(object));
+            filesScanned++;
+
+            // 与 git_blob_is_binary 相同的判定：前8000字节内出现NUL即视为二进制
+            std::vector<LineMatch> found;
+            bool isBinary = !content.empty() &&
+                            std::memchr(content.data(), '\0', std::min<size_t>(content.size(), 8000)) != nullptr;
+            if (isBinary) {
+                skippedBinary++;
+            } else {
+                found = matcher->findAll(content, options.maxLinesPerFile);
+            }
+            git_odb_object_free(object);
+            size_t bytes = SearchResultBytes(cacheKey, found);
+            matches = searchCache_.put(cacheKey, std::move(found), bytes);
+        }
+
+        if (!matches->empty()) {
+            emit({blob.path, std::move(blobId), *matches});
+        }
+    });
+
+    git_odb_free(odb);
+
+    if (!pending.empty() && !stopped.load()) {
+        onResults(pending);
+    }
+
+    summary.filesScanned = filesScanned.load();
+    summary.cacheHits = cacheHits.load();
+    summary.skippedBinary = skippedBinary.load();
+    summary.skippedLarge = skippedLarge.load();
+    OH_LOG_INFO(LOG_APP,
+                "Search '%{public}s' in %{public}s: %{public}zu/%{public}zu files scanned, %{public}zu matches, "
+                "%{public}zu cache hits",
+                pattern.c_str(), ref.c_str(), summary.filesScanned, summary.filesTotal, summary.matchCount,
+                summary.cacheHits);
+    return true;
+}
+
+std::vector<PathMatch> RepoManager::findFiles(const std::string &ref, const std::string &query, size_t limit) {
+    ReadScope scope(*this);
+    if (!repo()) {
+        setError("仓库未初始化");
+        return {};
+    }
+
+    git_oid oid;
+    if (!resolveReference(oid, ref)) {
+        setError("查找文件失败，请检查：1) 分支是否存在 2) 提交ID是否正确");
+        return {};
+    }
+
+    git_commit *commit = nullptr;
+    if (!checkError(git_commit_lookup(&commit, repo(), &oid), "Lookup commit")) {
+        return {};
+    }
+
+    git_tree *tree = nullptr;
+    if (!checkError(git_commit_tree(&tree, commit), "Get commit tree")) {
+        git_commit_free(commit);
+        return {};
+    }
+
+    auto index = loadPathIndex(tree);
+    git_tree_free(tree);
+    git_commit_free(commit);
+    if (!index) {
+        return {};
+    }
+    return index->find(query, limit);
+}
+
+std::shared_ptr<const PathIndex> RepoManager::loadPathIndex(git_tree *tree) {
+    // 相同的树对象路径集合必然相同，不同提交可以共用索引
+    std::string treeId = git_oid_tostr_s(git_tree_id(tree));
+    std::filesystem::path indexDir = std::filesystem::path(git_repository_path(repo())) / "higit" / "path-index";
+    std::string indexFile = (indexDir / (treeId + ".idx")).string();
+    // 索引文件的修改时间记录最近一次使用，清理时据此保留最近使用的索引
+    std::error_code ec;
+    auto touch = [&]() {
+        std::filesystem::last_write_time(indexFile, std::filesystem::file_time_type::clock::now(), ec);
+    };
+
+    auto cached = pathIndexCache_.get(treeId);
+    Metrics::Shared().recordCache(Metrics::Cache::PathIndex, static_cast<bool>(cached));
+    if (cached) {
+        touch();
+        return cached;
+    }
+
+    PathIndex index;
+    if (index.load(indexFile)) {
+        touch();
+        OH_LOG_INFO(LOG_APP, "Path index loaded: %{public}s (%{public}zu paths)", treeId.c_str(), index.size());
+        return pathIndexCache_.put(treeId, std::move(index));
+    }
+
+    std::vector<std::string> paths;
+    auto collect = [](const char *root, const git_tree_entry *entry, void *payload) -> int {
+        if (git_tree_entry_type(entry) == GIT_OBJECT_BLOB) {
+            static_cast<std::vector<std::string> *>(payload)->push_back(std::string(root) +
+                                                                        git_tree_entry_name(entry));
+        }
+        return 0;
+    };
+    if (!checkError(git_tree_walk(tree, GIT_TREEWALK_PRE, collect, &paths), "Walk tree")) {
+        return nullptr;
+    }
+    index.build(paths);
+    OH_LOG_INFO(LOG_APP, "Path index built: %{public}s (%{public}zu paths)", treeId.c_str(), index.size());
+
+    // 索引文件只是缓存，写入失败不影响本次查询
+    std::filesystem::create_directories(indexDir, ec);
+    if (ec || !index.save(indexFile)) {
+        OH_LOG_WARN(LOG_APP, "Save path index failed: %{public}s", indexFile.c_str());
+    } else {
+        // 只保留最近使用的若干个树的索引
+        constexpr size_t maxIndexFiles = 8;
+        std::vector<std::filesystem::directory_entry> files;
+        for (auto &entry : std::filesystem::directory_iterator(indexDir, ec)) {
+            if (entry.path().extension() == ".idx") {
+                files.push_back(entry);
+            }
+        }
+        if (files.size() > maxIndexFiles) {
+            std::sort(files.begin(), files.end(), [](const auto &a, const auto &b) {
+                std::error_code ignored;
+                return a.last_write_time(ignored) > b.last_write_time(ignored);
+            });
+            for (size_t i = maxIndexFiles; i < files.size(); ++i) {
+                std::filesystem::remove(files[i].path(), ec);
+            }
+        }
+    }
+    return pathIndexCache_.put(treeId, std::move(index));
+}
+
+/**
+ * @brief Blame中尚未确定归属的一段行
+ * 最终文件的 [finalStart, finalStart+count) 对应当前遍历到的版本的 [currentStart, currentStart+count)
+ */
+struct BlameRange {
+    uint32_t finalStart;
+    uint32_t currentStart;
+    uint32_t count;
+};
+
+/**
+ * @brief 根据父版本到当前版本的diff拆分未确定的行
+ * 落在新增行内的部分放入 attributed（仍为当前版本的行号），其余部分换算成父版本中的行号留在 ranges 中继续向前追溯
+ * ranges 须按 currentStart 排序
+ */
+static void splitBlameRanges(git_patch *patch, std::vector<BlameRange> &ranges, std::vector<BlameRange> &attributed) {
+    struct Hunk {
+        uint32_t newStart; // 从0开始；纯删除块为删除位置之后的第一行
+        uint32_t newCount;
+        int64_t delta; // newCount - oldCount
+    };
+    std::vector<Hunk> hunks;
+    size_t hunkCount = git_patch_num_hunks(patch);
+    hunks.reserve(hunkCount);
+    for (size_t i = 0; i < hunkCount; ++i) {
+        const git_diff_hunk *hunk = nullptr;
+        if (git_patch_get_hunk(&hunk, nullptr, patch, i) != 0) {
+            continue;
+        }
+        uint32_t newStart = hunk->new_lines > 0 ? hunk->new_start - 1 : hunk->new_start;
+        hunks.push_back({newStart, static_cast<uint32_t>(hunk->new_lines),
+                         static_cast<int64_t>(hunk->new_lines) - static_cast<int64_t>(hunk->old_lines)});
+    }
+
+    std::vector<BlameRange> remaining;
+    size_t hi = 0;
+    int64_t delta = 0; // hunks[0, hi) 的行数变化之和
+    uint32_t lastPos = 0;
+    for (const BlameRange &range : ranges) {
+        // ranges 按 currentStart 排序；合并分支两侧汇合来的行可能重叠，重叠时从头重新定位
+        if (range.currentStart < lastPos) {
+            hi = 0;
+            delta = 0;
+        }
+        uint32_t pos = range.currentStart;
+        lastPos = range.currentStart + range.count;
+        uint32_t end = range.currentStart + range.count;
+        while (pos < end) {
+            while (hi < hunks.size() && hunks[hi].newStart + hunks[hi].newCount <= pos) {
+                delta += hunks[hi].delta;
+                ++hi;
+            }
+            uint32_t finalPos = range.finalStart + (pos - range.currentStart);
+            if (hi < hunks.size() && pos >= hunks[hi].newStart) {
+                uint32_t segEnd = std::min(end, hunks[hi].newStart + hunks[hi].newCount);
+                attributed.push_back({finalPos, pos, segEnd - pos});
+                pos = segEnd;
+            } else {
+                uint32_t segEnd = hi < hunks.size() ? std::min(end, hunks[hi].newStart) : end;
+                remaining.push_back({finalPos, static_cast<uint32_t>(pos - delta), segEnd - pos});
+                pos = segEnd;
+            }
+        }
+    }
+    ranges.swap(remaining);
+}
+
+/**
+ * @brief 查找提交中指定路径的blob ID，不存在时不设置错误信息
+ */
+static bool findBlobIdByPath(git_commit *commit, const std::string &path, git_oid &blobId) {
+    git_tree *tree = nullptr;
+    if (git_commit_tree(&tree, commit) != 0) {
+        return false;
+    }
+    git_tree_entry *entry = nullptr;
+    bool found = git_tree_entry_bypath(&entry, tree, path.c_str()) == 0;
+    if (found) {
+        found = git_tree_entry_type(entry) == GIT_OBJECT_BLOB;
+        git_oid_cpy(&blobId, git_tree_entry_id(entry));
+        git_tree_entry_free(entry);
+    }
+    git_tree_free(tree);
+    return found;
+}
+
+bool RepoManager::blameFile(const std::string &ref, const std::string &path, const BlameChunkCallback &onChunk,
+                            BlameSummary &summary) {
+    ReadScope scope(*this);
+    summary = BlameSummary();
+    uint64_t generation = blameGeneration_.load();
+
+    if (!repo()) {
+        setError("仓库未初始化");
+        return false;
+    }
+
+    git_oid oid;
+    if (!resolveReference(oid, ref)) {
+        setError("获取Blame失败，请检查：1) 分支是否存在 2) 提交ID是否正确");
+        return false;
+    }
+
+    git_commit *current = nullptr;
+    if (!checkError(git_commit_lookup(&current, repo(), &oid), "Lookup commit")) {
+        return false;
+    }
+
+    git_blob *currentBlob = nullptr;
+    if (!lookupBlobByPath(&currentBlob, current, path)) {
+        git_commit_free(current);
+        return false;
+    }
+    if (git_blob_is_binary(currentBlob)) {
+        setError("二进制文件不支持Blame: " + path);
+        git_blob_free(currentBlob);
+        git_commit_free(current);
+        return false;
+    }
+
+    auto size = static_cast<size_t>(git_blob_rawsize(currentBlob));
+    auto *content = static_cast<const char *>(git_blob_rawcontent(currentBlob));
+    summary.lineCount = std::count(content, content + size, '\n');
+    if (size > 0 && content[size - 1] != '\n') {
+        summary.lineCount++;
+    }
+
+    // 提交不可变，同一提交同一路径的Blame结果不会变化
+    std::string cacheKey = std::string(git_oid_tostr_s(&oid)) + ":" + path;
+    auto cached = blameCache_.get(cacheKey);
+    Metrics::Shared().recordCache(Metrics::Cache::Blame, static_cast<bool>(cached));
+    if (cached) {
+        git_blob_free(currentBlob);
+        git_commit_free(current);
+        summary.cached = true;
+        summary.hunkCount = cached->size();
+        if (!cached->empty()) {
+            onChunk(*cached);
+        }
+        return true;
+    }
+
+    std::vector<BlameHunk> result;
+    std::vector<BlameHunk> pending;
+    auto lastFlush = std::chrono::steady_clock::now();
+    bool stopped = false;
+    auto flush = [&](bool force) {
+        auto now = std::chrono::steady_clock::now();
+        // 首批结果尽快返回，之后按数量或时间合并输出，避免回调过于频繁
+        if (pending.empty() || (!force && pending.size() < 64 && now - lastFlush < std::chrono::milliseconds(100))) {
+            return;
+        }
+        if (!onChunk(pending)) {
+            stopped = true;
+        }
+        pending.clear();
+        lastFlush = now;
+    };
+
+    auto attribute = [&](git_commit *commit, const std::string &commitPath, std::vector<BlameRange> &ranges,
+                         bool boundary) {
+        if (ranges.empty()) {
+            return;
+        }
+        std::sort(ranges.begin(), ranges.end(),
+                  [](const BlameRange &a, const BlameRange &b) { return a.finalStart < b.finalStart; });
+        CommitInfo info = convertToCommitInfo(commit);
+        bool first = true;
+        for (const BlameRange &range : ranges) {
+            // 合并最终文件中相邻的行
+            if (!first && result.back().startLine + result.back().lineCount == range.finalStart + 1) {
+                result.back().lineCount += range.count;
+                pending.back().lineCount += range.count;
+                continue;
+            }
+            BlameHunk hunk;
+            hunk.startLine = range.finalStart + 1;
+            hunk.lineCount = range.count;
+            hunk.commitId = info.id;
+            hunk.author = info.author;
+            hunk.email = info.email;
+            hunk.timestamp = info.timestamp;
+            hunk.summary = info.shortMessage;
+            hunk.path = commitPath;
+            hunk.boundary = boundary;
+            result.push_back(hunk);
+            pending.push_back(std::move(hunk));
+            first = false;
+        }
+        ranges.clear();
+        // 第一批结果立即输出
+        flush(result.size() == pending.size());
+    };
+
+    // 待追溯的版本：某个提交中某个路径的文件，以及其中尚未确定归属的行
+    struct BlameOrigin {
+        git_commit *commit;
+        std::string path;
+        git_blob *blob;
+        std::vector<BlameRange> ranges;
+    };
+    std::vector<BlameOrigin> origins;
+    // 同一提交同一路径的行合并追溯，否则接收行的版本取得 commit 和 blob 的所有权
+    auto enqueue = [&origins](git_commit *commit, const std::string &commitPath, git_blob *blob,
+                              std::vector<BlameRange> &&ranges) {
+        for (auto &origin : origins) {
+            if (origin.path == commitPath && git_oid_equal(git_commit_id(origin.commit), git_commit_id(commit))) {
+                origin.ranges.insert(origin.ranges.end(), ranges.begin(), ranges.end());
+                git_blob_free(blob);
+                git_commit_free(commit);
+                return;
+            }
+        }
+        origins.push_back({commit, commitPath, blob, std::move(ranges)});
+    };
+
+    if (summary.lineCount > 0) {
+        enqueue(current, path, currentBlob, {{0, 0, static_cast<uint32_t>(summary.lineCount)}});
+    } else {
+        git_blob_free(currentBlob);
+        git_commit_free(current);
+    }
+
+    std::vector<BlameRange> attributed;
+    while (!origins.empty() && !stopped) {
+        if (blameGeneration_.load() != generation) {
+            summary.cancelled = true;
+            break;
+        }
+        summary.commitsVisited++;
+
+        // 先处理提交时间最新的版本，合并分支两侧汇合到同一祖先的行在那里一起追溯
+        auto newest = std::max_element(origins.begin(), origins.end(), [](const BlameOrigin &a, const BlameOrigin &b) {
+            return git_commit_time(a.commit) < git_commit_time(b.commit);
+        });
+        BlameOrigin origin = std::move(*newest);
+        origins.erase(newest);
+        std::sort(origin.ranges.begin(), origin.ranges.end(),
+                  [](const BlameRange &a, const BlameRange &b) { return a.currentStart < b.currentStart; });
+
+        // 没有父提交（根提交，或浅克隆时父提交不在本地），剩余的行都归属于当前提交
+        unsigned int parentCount = git_commit_parentcount(origin.commit);
+        std::vector<git_commit *> parents;
+        for (unsigned int i = 0; i < parentCount; ++i) {
+            git_commit *parent = nullptr;
+            if (git_commit_parent(&parent, origin.commit, i) == 0) {
+                parents.push_back(parent);
+            } else if (i == 0) {
+                break;
+            }
+        }
+        if (parents.empty()) {
+            attribute(origin.commit, origin.path, origin.ranges, true);
+            git_blob_free(origin.blob);
+            git_commit_free(origin.commit);
+            continue;
+        }
+
+        // 各父提交中的路径，路径在第一父提交中不存在时借助变更列表的重命名检测找到原路径
+        std::vector<std::string> parentPaths(parents.size(), origin.path);
+        std::vector<git_oid> parentBlobIds(parents.size());
+        std::vector<bool> found(parents.size(), false);
+        for (size_t i = 0; i < parents.size(); ++i) {
+            found[i] = findBlobIdByPath(parents[i], parentPaths[i], parentBlobIds[i]);
+        }
+        std::vector<FileChange> changes;
+        if (!found[0] && getCommitChanges(git_oid_tostr_s(git_commit_id(origin.commit)), changes)) {
+            for (auto &change : changes) {
+                if (change.path == origin.path && (change.status == 'R' || change.status == 'C')) {
+                    parentPaths[0] = change.oldPath;
+                    found[0] = findBlobIdByPath(parents[0], parentPaths[0], parentBlobIds[0]);
+                    break;
+                }
+            }
+        }
+
+        // 与某个父提交内容相同时，所有行都来自该父提交（合并时未改动的一侧），直接跳过当前提交
+        size_t same = parents.size();
+        for (size_t i = 0; i < parents.size() && same == parents.size(); ++i) {
+            if (found[i] && git_oid_equal(&parentBlobIds[i], git_blob_id(origin.blob))) {
+                same = i;
+            }
+        }
+        if (same < parents.size()) {
+            for (size_t i = 0; i < parents.size(); ++i) {
+                if (i != same) {
+                    git_commit_free(parents[i]);
+                }
+            }
+            enqueue(parents[same], parentPaths[same], origin.blob, std::move(origin.ranges));
+            git_commit_free(origin.commit);
+            continue;
+        }
+
+        // 依次与各父提交比较：未改动的行交给该父提交继续追溯，其余的行再与下一个父提交比较，
+        // 与所有父提交都不同的行才归属于当前提交
+        for (size_t i = 0; i < parents.size(); ++i) {
+            git_blob *parentBlob = nullptr;
+            if (origin.ranges.empty() || !found[i] || git_blob_lookup(&parentBlob, repo(), &parentBlobIds[i]) != 0 ||
+                git_blob_is_binary(parentBlob)) {
+                git_blob_free(parentBlob);
+                git_commit_free(parents[i]);
+                continue;
+            }
+
+            git_diff_options opts = GIT_DIFF_OPTIONS_INIT;
+            opts.context_lines = 0;
+            git_patch *patch = nullptr;
+            int error = git_patch_from_buffers(
+                &patch, git_blob_rawcontent(parentBlob), static_cast<size_t>(git_blob_rawsize(parentBlob)),
+                parentPaths[i].c_str(), git_blob_rawcontent(origin.blob),
+                static_cast<size_t>(git_blob_rawsize(origin.blob)), origin.path.c_str(), &opts);
+            if (error != 0) {
+                OH_LOG_WARN(LOG_APP, "Blame diff failed for %{public}s: %{public}d", origin.path.c_str(), error);
+                git_blob_free(parentBlob);
+                git_commit_free(parents[i]);
+                continue;
+            }
+
+            attributed.clear();
+            splitBlameRanges(patch, origin.ranges, attributed);
+            git_patch_free(patch);
+            if (origin.ranges.empty()) {
+                git_blob_free(parentBlob);
+                git_commit_free(parents[i]);
+            } else {
+                enqueue(parents[i], parentPaths[i], parentBlob, std::move(origin.ranges));
+            }
+            origin.ranges.swap(attributed);
+        }
+        attribute(origin.commit, origin.path, origin.ranges, false);
+        git_blob_free(origin.blob);
+        git_commit_free(origin.commit);
+    }
+
+    for (auto &origin : origins) {
+        git_blob_free(origin.blob);
+        git_commit_free(origin.commit);
+    }
+
+    if (!stopped) {
+        flush(true);
+    }
+    summary.hunkCount = result.size();
+    OH_LOG_INFO(LOG_APP, "Blame %{public}s: %{public}zu hunks, %{public}zu commits visited%{public}s", path.c_str(),
+                summary.hunkCount, summary.commitsVisited, summary.cancelled ? " (cancelled)" : "");
+
+    // 只缓存完整的结果
+    if (!summary.cancelled && !stopped) {
+        blameCache_.put(cacheKey, std::move(result));
+    }
+    return true;
+}
+
+void RepoManager::cancelBlame() { blameGeneration_.fetch_add(1); }
+
+WarmUpInfo RepoManager::warmUp(int pageSize) {
+    ReadScope scope(*this);
+    WarmUpInfo info;
+
+    if (!repo()) {
+        setError("仓库未初始化");
+        return info;
+    }
+
+    // 遍历引用的同时把 packed-refs 读入引用库缓存
+    TracePhases phases("git");
+    phases.enter("git_reference_iterator");
+    static const std::string remotePrefix = "refs/remotes/origin/";
+    std::vector<std::string> branches;
+    git_reference_iterator *iter = nullptr;
+    if (git_reference_iterator_glob_new(&iter, repo(), (remotePrefix + "*").c_str()) == 0) {
+        const char *name = nullptr;
+        while (git_reference_next_name(&name, iter) == 0) {
+            std::string branch = name + remotePrefix.size();
+            if (branch != "HEAD") {
+                branches.push_back(std::move(branch));
+            }
+        }
+        git_reference_iterator_free(iter);
+    }
+    if (git_reference_iterator_glob_new(&iter, repo(), "refs/tags/*") == 0) {
+        const char *name = nullptr;
+        while (git_reference_next_name(&name, iter) == 0) {
+            info.tagCount++;
+        }
+        git_reference_iterator_free(iter);
+    }
+    info.branchCount = branches.size();
+    if (branches.empty()) {
+        setError("仓库尚未拉取任何分支");
+        return info;
+    }
+
+    git_reference *head = nullptr;
+    if (git_reference_lookup(&head, repo(), (remotePrefix + "HEAD").c_str()) == 0) {
+        const char *target = git_reference_symbolic_target(head);
+        if (target != nullptr && strncmp(target, remotePrefix.c_str(), remotePrefix.size()) == 0) {
+            info.branch = target + remotePrefix.size();
+        }
+        git_reference_free(head);
+    }
+    if (info.branch.empty()) {
+        std::sort(branches.begin(), branches.end());
+        for (const char *candidate : {"main", "master"}) {
+            if (std::binary_search(branches.begin(), branches.end(), candidate)) {
+                info.branch = candidate;
+                break;
+            }
+        }
+    }
+    if (info.branch.empty()) {
+        info.branch = branches.front();
+    }
+
+    phases.end();
+    getCommitHistory(info.commits, info.branch, pageSize, 0);
+    return info;
+}
+
+void RepoManager::trimCaches(GitRuntime::MemoryLevel level) {
+    // 搜索和Blame结果占用最大，重新计算的代价也可以接受
+    searchCache_.clear();
+    blameCache_.clear();
+    if (level == GitRuntime::MemoryLevel::Moderate) {
+        return;
+    }
+
+    changesCache_.clear();
+    historyCache_.clear();
+    fileTreeCache_.clear();
+    pathIndexCache_.clear();
+    // 租出的句柄归还时因代数变化直接释放
+    handles_.clear();
+}
+
+void RepoManager::releaseObjectCache() {
+    if (!repository_) {
+        return;
+    }
+    // 不用 git_repository__cleanup：它连同对象库、引用库、配置和 grafts 一起丢弃，主句柄之后重建的对象库
+    // 不再与池中句柄共享。对象缓存只能随句柄释放，因此重新打开主句柄，池中句柄随代数变化一并重建
+    std::string path = git_repository_path(repository_);
+    git_repository *reopened = nullptr;
+    if (git_repository_open_ext(&reopened, path.c_str(), GIT_REPOSITORY_OPEN_NO_SEARCH, nullptr) != 0) {
+        const git_error *e = git_error_last();
+        OH_LOG_WARN(LOG_APP, "Reopen repository %{public}s failed: %{public}s", path.c_str(),
+                    e ? e->message : "unknown");
+        return;
+    }
+    // 远程对象引用旧句柄，下次连接时重建
+    if (remote_) {
+        git_remote_free(remote_);
+        remote_ = nullptr;
+    }
+    // 先打开新句柄再释放旧句柄，两者地址不同，池能识别出主句柄已更换
+    handles_.clear();
+    git_repository_free(repository_);
+    repository_ = reopened;
+}
+
+std::vector<BranchInfo> RepoManager::getLocalBranches() {
+    ReadScope scope(*this);
+    std::vector<BranchInfo> branches;
+
+    if (!repo()) {
+        setError("No repository opened");
+        return branches;
+    }
+
+    // 获取所有引用
+    git_branch_iterator *iter;
+    if (!checkError(git_branch_iterator_new(&iter, repo(), GIT_BRANCH_LOCAL), "Create branch iterator")) {
+        return branches;
+    }
+
+    git_reference *ref;
+    git_branch_t branch_type;
+    while (git_branch_next(&ref, &branch_type, iter) == 0) {
+        BranchInfo branch;
+
+        // 获取分支名称
+        const char *name;
+        if (git_branch_name(&name, ref) == 0) {
+            branch.name = name;
+        }
+
+        // 获取分支指向的提交ID
+        const git_oid *target_oid = git_reference_target(ref);
+        if (target_oid) {
+            branch.id = git_oid_tostr_s(target_oid);
+        }
+
+        branch.isRemote = false;
+
+        // 检查是否为当前分支
+        git_reference *head_ref;
+        if (git_repository_head(&head_ref, repo()) == 0) {
+            branch.isCurrent = git_reference_cmp(ref, head_ref) == 0;
+            git_reference_free(head_ref);
+        } else {
+            branch.isCurrent = false;
+        }
+
+        branches.push_back(branch);
+        git_reference_free(ref);
+    }
+
+    git_branch_iterator_free(iter);
+    return branches;
+}
+
+bool RepoManager::checkoutBranch(const std::string &branchName) {
+    if (!repo()) {
+        setError("No repository opened");
+        return false;
+    }
+
+    // 查找分支引用
+    git_reference *ref;
+    std::string ref_name = "refs/heads/" + branchName;
+    if (!checkError(git_reference_lookup(&ref, repo(), ref_name.c_str()), "Lookup branch reference")) {
+        return false;
+    }
+
+    // 获取分支指向的提交
+    git_object *target;
+    if (!checkError(git_reference_peel(&target, ref, GIT_OBJECT_COMMIT), "Peel reference to commit")) {
+        git_reference_free(ref);
+        return false;
+    }
+
+    // 执行检出操作
+    git_checkout_options checkout_opts = GIT_CHECKOUT_OPTIONS_INIT;
+    checkout_opts.checkout_strategy = GIT_CHECKOUT_SAFE;
+
+    if (!checkError(git_checkout_tree(repo(), target, &checkout_opts), "Checkout tree")) {
+        git_object_free(target);
+        git_reference_free(ref);
+        return false;
+    }
+
+    // 设置HEAD引用
+    if (!checkError(git_repository_set_head(repo(), ref_name.c_str()), "Set HEAD reference")) {
+        git_object_free(target);
+        git_reference_free(ref);
+        return false;
+    }
+
+    git_object_free(target);
+    git_reference_free(ref);
+    return true;
+}
+
+bool RepoManager::createBranch(const std::string &branchName, const std::string &commitId) {
+    if (!repo()) {
+        setError("No repository opened");
+        return false;
+    }
+
+    // 解析提交ID
+    git_oid oid;
+    if (!checkError(git_oid_fromstr(&oid, commitId.c_str()), "Parse commit ID")) {
+        return false;
+    }
+
+    // 创建分支
+    git_commit *commit;
+    if (!checkError(git_commit_lookup(&commit, repo(), &oid), "Lookup commit")) {
+        return false;
+    }
+
+    git_reference *ref;
+    std::string ref_name = "refs/heads/" + branchName;
+    bool result = checkError(git_branch_create(&ref, repo(), branchName.c_str(), commit, 0), "Create branch");
+
+    if (ref) {
+        git_reference_free(ref);
+    }
+    git_commit_free(commit);
+
+    return result;
+}
+
+bool RepoManager::isConnected() const { return remote_ != nullptr && git_remote_connected(remote_); }
+
+bool RepoManager::isOpen() const { return repository_ != nullptr; }
+
+std::string RepoManager::getLastError() const { return lastError.owner == this ? lastError.message : std::string(); }
+
+std::string RepoManager::getCurrentBranch() const {
+    ReadScope scope(*this);
+    if (!repo()) {
+        return "";
+    }
+
+    git_reference *head;
+    if (git_repository_head(&head, repo()) != 0) {
+        return "";
+    }
+
+    const char *branchName;
+    if (git_branch_name(&branchName, head) != 0) {
+        git_reference_free(head);
+        return "";
+    }
+
+    std::string result = branchName;
+    git_reference_free(head);
+    return result;
+}
+
+std::string RepoManager::getRemoteUrl(const std::string &remoteName) const {
+    ReadScope scope(*this);
+    if (!repo()) {
+        return "";
+    }
+
+    git_remote *remote = nullptr;
+    if (git_remote_lookup(&remote, repo(), remoteName.c_str()) != 0) {
+        return "";
+    }
+
+    const char *url = git_remote_url(remote);
+    std::string result = url ? url : "";
+
+    git_remote_free(remote);
+    return result;
+}
+
+bool RepoManager::resolveReference(git_oid &oid, const std::string &ref) {
+    if (!repo()) {
+        setError("No repository opened");
+        return false;
+    }
+
+    // 首先尝试作为分支名查找
+    if (git_reference_name_to_id(&oid, repo(), ("refs/heads/" + ref).c_str()) == 0) {
+        OH_LOG_DEBUG(LOG_APP, "Resolved as local branch: refs/heads/%{public}s", ref.c_str());
+        return true;
+    }
+
+    // 尝试作为远程分支名查找
+    if (git_reference_name_to_id(&oid, repo(), ("refs/remotes/origin/" + ref).c_str()) == 0) {
+        OH_LOG_DEBUG(LOG_APP, "Resolved as remote branch: refs/remotes/origin/%{public}s", ref.c_str());
+        return true;
+    }
+
+    // 尝试作为完整的远程分支引用查找
+    if (git_reference_name_to_id(&oid, repo(), ref.c_str()) == 0) {
+        OH_LOG_DEBUG(LOG_APP, "Resolved as full reference: %{public}s", ref.c_str());
+        return true;
+    }
+
+    // 如果还不是远程分支名，尝试直接解析为提交ID
+    if (git_oid_fromstr(&oid, ref.c_str()) == 0) {
+        OH_LOG_DEBUG(LOG_APP, "Resolved as commit ID: %{public}s", ref.c_str());
+        return true;
+    }
+
+    // 所有尝试都失败了
     setError("Cannot resolve reference: " + ref);
     return false;
 }
@@ -1150,116 +2394,175 @@ std::string RepoManager::getRepositoryPath() const { return repoPath_; }
 std::vector<FileTreeNode> RepoManager::getBranchFileTree(const std::string &branch, const std::string &rootPath) {
     std::vector<FileTreeNode> fileTree;
 
-    if (!repository_) {
-        setError("仓库未初始化");
+    auto compactTree = getCompactFileTree(branch, rootPath);
+    if (!compactTree) {
         return fileTree;
     }
 
+    fileTree.reserve(compactTree->size());
+    for (uint32_t i = 0; i < compactTree->size(); ++i) {
+        FileTreeNode node;
+        node.id = static_cast<int>(i) + 1;
+        uint32_t parent = compactTree->parent(i);
+        node.parentId = parent == CompactFileTree::NO_PARENT ? -1 : static_cast<int>(parent) + 1;
+        node.name = compactTree->name(i);
+        node.path = compactTree->path(i);
+        node.isDirectory = compactTree->isDirectory(i);
+        node.fileId = compactTree->oidHex(i);
+        node.mode = compactTree->mode(i);
+        node.size = compactTree->fileSize(i);
+        node.extension = compactTree->extension(i);
+        fileTree.push_back(std::move(node));
+    }
+    return fileTree;
+}
+
+std::shared_ptr<const CompactFileTree> RepoManager::getCompactFileTree(const std::string &branch,
+                                                                       const std::string &rootPath) {
+    MetricsTimer timer(Metrics::Operation::FileTree);
+    ReadScope scope(*this);
+    if (!repo()) {
+        setError("仓库未初始化");
+        return nullptr;
+    }
+
     // 解析分支或提交ID
     git_oid oid;
     if (!resolveReference(oid, branch)) {
         setError("获取文件树失败，请检查：1) 分支是否存在 2) 提交ID是否正确 3) 网络连接是否稳定");
-        return fileTree;
+        return nullptr;
     }
 
     // 查找提交对象
+    TraceSpan span("git", "git_tree_walk");
     git_commit *commit = nullptr;
-    if (!checkError(git_commit_lookup(&commit, repository_, &oid), "Lookup commit")) {
-        return fileTree;
+    if (!checkError(git_commit_lookup(&commit, repo(), &oid), "Lookup commit")) {
+        return nullptr;
     }
 
     // 获取提交的树对象
     git_tree *tree = nullptr;
-    if (!checkError(git_commit_tree(&tree, commit), "Get commit tree")) {
-        git_commit_free(commit);
-        return fileTree;
+    int error = git_commit_tree(&tree, commit);
+    git_commit_free(commit);
+    if (!checkError(error, "Get commit tree")) {
+        return nullptr;
     }
 
     // 如果指定了根路径，导航到该目录
-    git_tree *target_tree = tree;
     if (!rootPath.empty()) {
         git_tree_entry *entry = nullptr;
-        if (checkError(git_tree_entry_bypath(&entry, tree, rootPath.c_str()), "Find root path in tree")) {
-            if (git_tree_entry_type(entry) == GIT_OBJECT_TREE) {
-                git_tree *subtree = nullptr;
-                if (checkError(git_tree_lookup(&subtree, repository_, git_tree_entry_id(entry)), "Lookup subtree")) {
-                    git_tree_free(tree);
-                    target_tree = subtree;
-                }
-            }
-            git_tree_entry_free(entry);
+        error = git_tree_entry_bypath(&entry, tree, rootPath.c_str());
+        if (!checkError(error, "Find root path in tree")) {
+            git_tree_free(tree);
+            return nullptr;
+        }
+        git_tree *subtree = nullptr;
+        if (git_tree_entry_type(entry) != GIT_OBJECT_TREE) {
+            setError("路径指向的不是目录: " + rootPath);
+        } else if (checkError(git_tree_lookup(&subtree, repo(), git_tree_entry_id(entry)), "Lookup subtree")) {
+            git_tree_free(tree);
+            tree = subtree;
+        }
+        git_tree_entry_free(entry);
+        if (subtree == nullptr) {
+            git_tree_free(tree);
+            return nullptr;
         }
     }
 
-    // 递归遍历文件树
-    int nextId = 1;
-    traverseTree(target_tree, rootPath, -1, nextId, fileTree);
+    // 同一棵树的内容不会变化，不同分支/提交指向同一棵树时共用结果
+    std::string cacheKey = std::string(git_oid_tostr_s(git_tree_id(tree))) + ":" + rootPath;
+    auto cached = fileTreeCache_.get(cacheKey);
+    Metrics::Shared().recordCache(Metrics::Cache::FileTree, static_cast<bool>(cached));
+    if (cached) {
+        git_tree_free(tree);
+        return cached;
+    }
 
-    // 清理资源
-    git_tree_free(target_tree);
-    git_commit_free(commit);
+    CompactFileTree fileTree;
+    fileTree.setRootPath(rootPath);
+    bool ok = buildCompactTree(tree, fileTree);
+    git_tree_free(tree);
+    if (!ok) {
+        return nullptr;
+    }
 
-    return fileTree;
+    OH_LOG_INFO(LOG_APP, "File tree %{public}s: %{public}zu nodes, %{public}zu bytes", cacheKey.c_str(),
+                fileTree.size(), fileTree.memoryUsage());
+    return fileTreeCache_.put(cacheKey, std::move(fileTree));
 }
 
-void RepoManager::traverseTree(git_tree *tree, const std::string &basePath, int parentId, int &nextId,
-                               std::vector<FileTreeNode> &fileTree) {
-    if (!tree)
-        return;
-
-    size_t entry_count = git_tree_entrycount(tree);
-    for (size_t i = 0; i < entry_count; ++i) {
-        const git_tree_entry *entry = git_tree_entry_byindex(tree, i);
-        if (!entry)
-            continue;
-
-        FileTreeNode node;
-        node.id = nextId++;
-        node.parentId = parentId;
-        node.name = git_tree_entry_name(entry);
-        node.path = basePath.empty() ? node.name : basePath + "/" + node.name;
-        node.isDirectory = (git_tree_entry_type(entry) == GIT_OBJECT_TREE);
-        node.fileId = git_oid_tostr_s(git_tree_entry_id(entry));
-        node.mode = git_tree_entry_filemode(entry);
-        node.size = 0;
-
-        // 获取文件扩展名
-        if (!node.isDirectory) {
-            size_t dot_pos = node.name.find_last_of('.');
-            if (dot_pos != std::string::npos && dot_pos < node.name.length() - 1) {
-                node.extension = node.name.substr(dot_pos + 1);
-            }
-
-            // 获取文件大小（如果是blob对象）
-            if (git_tree_entry_type(entry) == GIT_OBJECT_BLOB) {
-                git_blob *blob = nullptr;
-                if (git_blob_lookup(&blob, repository_, git_tree_entry_id(entry)) == 0) {
-                    node.size = git_blob_rawsize(blob);
-                    git_blob_free(blob);
-                }
+bool RepoManager::buildCompactTree(git_tree *tree, CompactFileTree &fileTree) {
+    struct Frame {
+        git_tree *tree;
+        uint32_t parent;
+        size_t next;
+    };
+
+    // 先序遍历：目录节点之后紧跟其子节点，与原先递归版本的顺序一致
+    std::vector<Frame> stack;
+    stack.push_back({tree, CompactFileTree::NO_PARENT, 0});
+    std::vector<uint32_t> blobs;
+    while (!stack.empty()) {
+        Frame &frame = stack.back();
+        if (frame.next >= git_tree_entrycount(frame.tree)) {
+            // 根树由调用方释放
+            if (stack.size() > 1) {
+                git_tree_free(frame.tree);
             }
+            stack.pop_back();
+            continue;
         }
 
-        fileTree.push_back(node);
+        const git_tree_entry *entry = git_tree_entry_byindex(frame.tree, frame.next++);
+        if (!entry) {
+            continue;
+        }
+        auto index = fileTree.append(frame.parent, git_tree_entry_name(entry),
+                                     static_cast<uint16_t>(git_tree_entry_filemode(entry)),
+                                     git_tree_entry_id(entry)->id);
 
-        // 如果是目录，递归遍历
-        if (node.isDirectory) {
+        git_object_t type = git_tree_entry_type(entry);
+        if (type == GIT_OBJECT_TREE) {
             git_tree *subtree = nullptr;
-            if (git_tree_lookup(&subtree, repository_, git_tree_entry_id(entry)) == 0) {
-                traverseTree(subtree, node.path, node.id, nextId, fileTree);
-                git_tree_free(subtree);
+            if (git_tree_lookup(&subtree, repo(), git_tree_entry_id(entry)) == 0) {
+                Metrics::Shared().add(Metrics::Counter::ObjectsLoaded);
+                stack.push_back({subtree, index, 0});
             }
+        } else if (type == GIT_OBJECT_BLOB) {
+            blobs.push_back(index);
         }
     }
+
+    // 文件大小只需读取对象头，分摊到工作线程
+    git_odb *odb = nullptr;
+    if (!checkError(git_repository_odb(&odb, repo()), "Get object database")) {
+        return false;
+    }
+    ThreadPool::Shared().parallelFor(blobs.size(), [&fileTree, &blobs, odb](size_t i) {
+        git_oid oid;
+        git_oid_fromraw(&oid, fileTree.oid(blobs[i]));
+        size_t size = 0;
+        git_object_t type = GIT_OBJECT_INVALID;
+        if (git_odb_read_header(&size, &type, odb, &oid) == 0) {
+            fileTree.setFileSize(blobs[i], size);
+        }
+    });
+    git_odb_free(odb);
+
+    fileTree.finish();
+    return true;
 }
 
 FileContent RepoManager::readFile(const std::string &branch, const std::string &path) {
+    MetricsTimer timer(Metrics::Operation::ReadFile);
+    ReadScope scope(*this);
     FileContent result;
     result.exists = false;
     result.isBinary = false;
     result.content = "";
 
-    if (!repository_) {
+    if (!repo()) {
         setError("仓库未打开");
         return result;
     }
@@ -1278,45 +2581,13 @@ FileContent RepoManager::readFile(const std::string &branch, const std::string &
 
     // 查找提交对象
     git_commit *commit = nullptr;
-    if (!checkError(git_commit_lookup(&commit, repository_, &oid), "Lookup commit")) {
-        return result;
-    }
-
-    // 获取提交的树对象
-    git_tree *tree = nullptr;
-    if (!checkError(git_commit_tree(&tree, commit), "Get commit tree")) {
-        git_commit_free(commit);
-        return result;
-    }
-
-    // 查找文件对应的树条目
-    git_tree_entry *entry = nullptr;
-    int error = git_tree_entry_bypath(&entry, tree, path.c_str());
-    if (error != 0) {
-        if (error == GIT_ENOTFOUND) {
-            setError("文件未找到: " + path);
-        } else {
-            checkError(error, "Find file in tree");
-        }
-        git_tree_free(tree);
-        git_commit_free(commit);
-        return result;
-    }
-
-    // 检查条目类型，确保是文件而不是目录
-    if (git_tree_entry_type(entry) != GIT_OBJECT_BLOB) {
-        setError("路径指向的不是文件: " + path);
-        git_tree_entry_free(entry);
-        git_tree_free(tree);
-        git_commit_free(commit);
+    if (!checkError(git_commit_lookup(&commit, repo(), &oid), "Lookup commit")) {
         return result;
     }
 
-    // 获取blob对象
+    // 查找文件对应的blob对象
     git_blob *blob = nullptr;
-    if (!checkError(git_blob_lookup(&blob, repository_, git_tree_entry_id(entry)), "Lookup blob")) {
-        git_tree_entry_free(entry);
-        git_tree_free(tree);
+    if (!lookupBlobByPath(&blob, commit, path)) {
         git_commit_free(commit);
         return result;
     }
@@ -1325,6 +2596,7 @@ FileContent RepoManager::readFile(const std::string &branch, const std::string &
     result.exists = true;
 
     // 获取文件内容
+    Metrics::Shared().add(Metrics::Counter::ObjectsLoaded);
     const void *rawdata = git_blob_rawcontent(blob);
     size_t size = git_blob_rawsize(blob);
 
@@ -1348,9 +2620,57 @@ FileContent RepoManager::readFile(const std::string &branch, const std::string &
 
     // 清理资源
     git_blob_free(blob);
-    git_tree_entry_free(entry);
-    git_tree_free(tree);
     git_commit_free(commit);
 
     return result;
+}
+
+bool RepoManager::lookupBlobByPath(git_blob **blob, git_commit *commit, const std::string &path, int *errorCode) {
+    // 获取提交的树对象
+    git_tree *tree = nullptr;
+    int error = git_commit_tree(&tree, commit);
+    if (!checkError(error, "Get commit tree")) {
+        if (errorCode) {
+            *errorCode = error;
+        }
+        return false;
+    }
+
+    // 查找文件对应的树条目
+    git_tree_entry *entry = nullptr;
+    error = git_tree_entry_bypath(&entry, tree, path.c_str());
+    if (error != 0) {
+        if (error == GIT_ENOTFOUND) {
+            setError("文件未找到: " + path);
+        } else {
+            checkError(error, "Find file in tree");
+        }
+        if (errorCode) {
+            *errorCode = error;
+        }
+        git_tree_free(tree);
+        return false;
+    }
+
+    // 检查条目类型，确保是文件而不是目录
+    if (git_tree_entry_type(entry) != GIT_OBJECT_BLOB) {
+        setError("路径指向的不是文件: " + path);
+        if (errorCode) {
+            *errorCode = GIT_EINVALID;
+        }
+        git_tree_entry_free(entry);
+        git_tree_free(tree);
+        return false;
+    }
+
+    // 获取blob对象
+    error = git_blob_lookup(blob, repo(), git_tree_entry_id(entry));
+    if (errorCode) {
+        *errorCode = error;
+    }
+    bool found = checkError(error, "Lookup blob");
+
+    git_tree_entry_free(entry);
+    git_tree_free(tree);
+    return found;
 }
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "repository_pool.h"
+#include "tracer.h"
+#include "utils/log.hpp"
+#include <git2/sys/repository.h>
+
+RepositoryPool::Lease::Lease(Lease &&other) noexcept
+    : pool_(other.pool_), handle_(other.handle_), generation_(other.generation_) {
+    other.pool_ = nullptr;
+    other.handle_ = nullptr;
+}
+
+RepositoryPool::Lease &RepositoryPool::Lease::operator=(Lease &&other) noexcept {
+    if (this != &other) {
+        if (pool_ != nullptr && handle_ != nullptr) {
+            pool_->release(handle_, generation_);
+        }
+        pool_ = other.pool_;
+        handle_ = other.handle_;
+        generation_ = other.generation_;
+        other.pool_ = nullptr;
+        other.handle_ = nullptr;
+    }
+    return *this;
+}
+
+RepositoryPool::Lease::~Lease() {
+    if (pool_ != nullptr && handle_ != nullptr) {
+        pool_->release(handle_, generation_);
+    }
+}
+
+RepositoryPool::RepositoryPool(size_t maxHandles) : maxHandles_(maxHandles > 0 ? maxHandles : 1) {}
+
+RepositoryPool::~RepositoryPool() { clear(); }
+
+RepositoryPool::Lease RepositoryPool::acquire(git_repository *primary) {
+    if (primary == nullptr) {
+        return Lease();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (primary != primary_) {
+        switchPrimary(primary);
+    }
+    cv_.wait(lock, [this] { return !idle_.empty() || created_ < maxHandles_; });
+
+    size_t generation = generation_;
+    if (!idle_.empty()) {
+        git_repository *handle = idle_.back();
+        idle_.pop_back();
+        return Lease(this, handle, generation);
+    }
+
+    // 打开仓库涉及文件IO，不持有锁
+    ++created_;
+    lock.unlock();
+    git_repository *handle = openHandle(primary);
+    if (handle == nullptr) {
+        lock.lock();
+        if (generation == generation_) {
+            --created_;
+        }
+        cv_.notify_one();
+        return Lease();
+    }
+    return Lease(this, handle, generation);
+}
+
+void RepositoryPool::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    switchPrimary(nullptr);
+}
+
+git_repository *RepositoryPool::openHandle(git_repository *primary) {
+    TraceSpan span("git", "git_repository_open_ext");
+    git_repository *handle = nullptr;
+    if (git_repository_open_ext(&handle, git_repository_path(primary), GIT_REPOSITORY_OPEN_NO_SEARCH, nullptr) != 0) {
+        const git_error *e = git_error_last();
+        OH_LOG_ERROR(LOG_APP, "RepositoryPool open handle failed: %{public}s", e != nullptr ? e->message : "");
+        return nullptr;
+    }
+
+    git_odb *odb = nullptr;
+    if (git_repository_odb(&odb, primary) == 0) {
+        git_repository_set_odb(handle, odb);
+        git_odb_free(odb);
+    }
+    return handle;
+}
+
+void RepositoryPool::release(git_repository *handle, size_t generation) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (generation == generation_) {
+            idle_.push_back(handle);
+            cv_.notify_one();
+            return;
+        }
+    }
+    git_repository_free(handle);
+}
+
+void RepositoryPool::switchPrimary(git_repository *primary) {
+    for (auto *handle : idle_) {
+        git_repository_free(handle);
+    }
+    idle_.clear();
+    created_ = 0;
+    ++generation_;
+    primary_ = primary;
+    cv_.notify_all();
+}
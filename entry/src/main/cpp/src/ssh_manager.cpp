@@ -1,10 +1,15 @@
 #include "ssh_manager.h"
 #include "global.h"
+#include "thread_pool.h"
+#include "utils/log.hpp"
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <filesystem>
 #include <fstream>
-#include <hilog/log.h>
 #include <iomanip>
 #include <memory>
+#include <mutex>
 #include <random>
 #include <sstream>
 #include <sys/stat.h>
@@ -12,6 +17,7 @@
 
 // mbedtls 头文件
 #include <mbedtls/base64.h>
+#include <mbedtls/bignum.h>
 #include <mbedtls/ctr_drbg.h>
 #include <mbedtls/ecp.h>
 #include <mbedtls/entropy.h>
@@ -19,6 +25,210 @@
 #include <mbedtls/rsa.h>
 #include <mbedtls/sha256.h>
 
+namespace {
+constexpr int RSA_EXPONENT = 65537;
+constexpr size_t MAX_PRIME_WORKERS = 4; // 只需要两个素数，更多线程收益有限
+
+// Miller-Rabin 轮数，与 mbedtls_mpi_gen_prime 的低错误率（2^-128）取值一致
+int PrimeRounds(size_t bits) {
+    if (bits >= 1450) {
+        return 4;
+    }
+    if (bits >= 1150) {
+        return 5;
+    }
+    if (bits >= 1000) {
+        return 6;
+    }
+    if (bits >= 850) {
+        return 7;
+    }
+    if (bits >= 750) {
+        return 8;
+    }
+    if (bits >= 500) {
+        return 13;
+    }
+    if (bits >= 250) {
+        return 28;
+    }
+    return bits >= 150 ? 40 : 51;
+}
+
+/**
+ * @brief 在线程池上并行搜索RSA的两个素因子
+ * 每个线程使用独立的熵源和DRBG，从随机起点逐个检测奇数候选；先找到的两个合格素数作为 P、Q，
+ * 其余线程在下一个候选前停止。约束与 mbedtls_rsa_gen_key 相同：gcd(E, p-1) = 1，|P-Q| 足够大
+ * @param primeBits 每个素数的位数（密钥位数的一半）
+ * @param P 输出素数
+ * @param Q 输出素数
+ * @return 成功返回0，否则返回mbedtls错误码
+ */
+int SearchRSAPrimes(size_t primeBits, mbedtls_mpi &P, mbedtls_mpi &Q) {
+    std::mutex mutex;
+    std::atomic<bool> done{false};
+    int found = 0;
+    int error = 0;
+
+    size_t workers = std::min(ThreadPool::Shared().size() + 1, MAX_PRIME_WORKERS);
+    ThreadPool::Shared().parallelFor(workers, [&](size_t index) {
+        mbedtls_entropy_context entropy;
+        mbedtls_ctr_drbg_context drbg;
+        mbedtls_mpi X, H, G, E;
+        mbedtls_entropy_init(&entropy);
+        mbedtls_ctr_drbg_init(&drbg);
+        mbedtls_mpi_init(&X);
+        mbedtls_mpi_init(&H);
+        mbedtls_mpi_init(&G);
+        mbedtls_mpi_init(&E);
+
+        std::string pers = "higit_ssh_keygen_" + std::to_string(index);
+        int ret = mbedtls_ctr_drbg_seed(&drbg, mbedtls_entropy_func, &entropy,
+                                        reinterpret_cast<const unsigned char *>(pers.data()), pers.size());
+        if (ret == 0) {
+            ret = mbedtls_mpi_lset(&E, RSA_EXPONENT);
+        }
+
+        bool restart = true;
+        while (ret == 0 && !done.load(std::memory_order_relaxed)) {
+            if (restart) {
+                // 随机起点，最高两位置1保证 P*Q 恰好为密钥位数，最低位置1保证为奇数
+                ret = mbedtls_mpi_fill_random(&X, (primeBits + 7) / 8, mbedtls_ctr_drbg_random, &drbg);
+                if (ret == 0 && primeBits % 8 != 0) {
+                    ret = mbedtls_mpi_shift_r(&X, 8 - primeBits % 8);
+                }
+                if (ret == 0) {
+                    ret = mbedtls_mpi_set_bit(&X, primeBits - 1, 1);
+                }
+                if (ret == 0) {
+                    ret = mbedtls_mpi_set_bit(&X, primeBits - 2, 1);
+                }
+                if (ret == 0) {
+                    ret = mbedtls_mpi_set_bit(&X, 0, 1);
+                }
+                restart = false;
+            } else {
+                ret = mbedtls_mpi_add_int(&X, &X, 2);
+                if (ret == 0 && mbedtls_mpi_bitlen(&X) > primeBits) {
+                    restart = true;
+                    continue;
+                }
+            }
+            if (ret != 0) {
+                break;
+            }
+
+            ret = mbedtls_mpi_is_prime_ext(&X, PrimeRounds(primeBits), mbedtls_ctr_drbg_random, &drbg);
+            if (ret == MBEDTLS_ERR_MPI_NOT_ACCEPTABLE) {
+                ret = 0;
+                continue;
+            }
+            if (ret != 0) {
+                break;
+            }
+
+            // E 与 p-1 互素，否则无法求私钥指数
+            ret = mbedtls_mpi_sub_int(&H, &X, 1);
+            if (ret == 0) {
+                ret = mbedtls_mpi_gcd(&G, &E, &H);
+            }
+            if (ret != 0) {
+                break;
+            }
+            if (mbedtls_mpi_cmp_int(&G, 1) != 0) {
+                restart = true;
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (done.load(std::memory_order_relaxed)) {
+                break;
+            }
+            if (found == 0) {
+                ret = mbedtls_mpi_copy(&P, &X);
+                found = ret == 0 ? 1 : 0;
+                restart = true;
+                continue;
+            }
+            // 两个素数过于接近时可被费马分解
+            ret = mbedtls_mpi_sub_abs(&H, &P, &X);
+            if (ret == 0 && mbedtls_mpi_bitlen(&H) <= primeBits - 99) {
+                restart = true;
+                continue;
+            }
+            if (ret == 0) {
+                ret = mbedtls_mpi_copy(&Q, &X);
+            }
+            if (ret == 0) {
+                found = 2;
+                done.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        if (ret != 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (error == 0) {
+                error = ret;
+            }
+            done.store(true, std::memory_order_relaxed);
+        }
+
+        mbedtls_mpi_free(&X);
+        mbedtls_mpi_free(&H);
+        mbedtls_mpi_free(&G);
+        mbedtls_mpi_free(&E);
+        mbedtls_ctr_drbg_free(&drbg);
+        mbedtls_entropy_free(&entropy);
+    });
+
+    if (error != 0) {
+        return error;
+    }
+    return found == 2 ? 0 : MBEDTLS_ERR_RSA_KEY_GEN_FAILED;
+}
+
+/**
+ * @brief 由素因子组装RSA私钥
+ * @param rsa 已初始化的RSA上下文
+ * @param bits 密钥位数
+ * @param P 素数
+ * @param Q 素数
+ * @return 成功返回0，否则返回mbedtls错误码
+ */
+int ImportRSAKey(mbedtls_rsa_context *rsa, int bits, const mbedtls_mpi &P, const mbedtls_mpi &Q) {
+    mbedtls_mpi N, E, D;
+    mbedtls_mpi_init(&N);
+    mbedtls_mpi_init(&E);
+    mbedtls_mpi_init(&D);
+
+    int ret = mbedtls_mpi_mul_mpi(&N, &P, &Q);
+    if (ret == 0) {
+        ret = mbedtls_mpi_lset(&E, RSA_EXPONENT);
+    }
+    if (ret == 0) {
+        ret = mbedtls_rsa_import(rsa, &N, &P, &Q, nullptr, &E);
+    }
+    if (ret == 0) {
+        ret = mbedtls_rsa_complete(rsa);
+    }
+    // 与 mbedtls_rsa_gen_key 相同，拒绝过小的私钥指数
+    if (ret == 0) {
+        ret = mbedtls_rsa_export(rsa, nullptr, nullptr, nullptr, &D, nullptr);
+    }
+    if (ret == 0 && mbedtls_mpi_bitlen(&D) <= static_cast<size_t>(bits / 2)) {
+        ret = MBEDTLS_ERR_RSA_KEY_GEN_FAILED;
+    }
+    if (ret == 0) {
+        ret = mbedtls_rsa_check_privkey(rsa);
+    }
+
+    mbedtls_mpi_free(&N);
+    mbedtls_mpi_free(&E);
+    mbedtls_mpi_free(&D);
+    return ret;
+}
+} // namespace
+
 SSHManager::SSHManager() : session_(nullptr) {
     OH_LOG_INFO(LOG_APP, "SSHManager::SSHManager");
 
@@ -84,9 +294,123 @@ bool SSHManager::generateKeyPair(int bits, const std::string &comment, const std
     return generateRSAKeyPairWithMbedTLS(bits, passphrase);
 }
 
+bool SSHManager::generateECDSAKeyPair(const std::string &comment, const std::string &passphrase) {
+    OH_LOG_INFO(LOG_APP, "Generating SSH key pair: ecdsa-sha2-nistp256");
+
+    keyInfo_.keyType = "ecdsa-sha2-nistp256";
+    keyInfo_.comment = comment.empty() ? "higit@openharmony" : comment;
+    return generateECDSAKeyPairWithMbedTLS(passphrase);
+}
+
+SSHKeyPaths SSHManager::KeyPaths(const std::string &sshDir, bool preferred) {
+    SSHKeyPaths ecdsa{sshDir + "/id_ecdsa", sshDir + "/id_ecdsa.pub"};
+    if (preferred || access(ecdsa.privateKey.c_str(), F_OK) == 0) {
+        return ecdsa;
+    }
+    SSHKeyPaths rsa{sshDir + "/id_rsa", sshDir + "/id_rsa.pub"};
+    if (access(rsa.privateKey.c_str(), F_OK) == 0) {
+        return rsa;
+    }
+    return ecdsa;
+}
+
+SSHKeyPaths SSHManager::KeyPaths(const std::string &sshDir, SSHKeyAlgorithm algorithm) {
+    if (algorithm == SSHKeyAlgorithm::RSA) {
+        return {sshDir + "/id_rsa", sshDir + "/id_rsa.pub"};
+    }
+    return {sshDir + "/id_ecdsa", sshDir + "/id_ecdsa.pub"};
+}
+
+bool SSHManager::ReplaceKeyFiles(const SSHKeyPaths &staged, const SSHKeyPaths &target, std::string &error) {
+    std::error_code ec;
+    // 原公钥先硬链接一份备份，私钥替换失败时用它恢复
+    std::string const backup = target.publicKey + ".bak";
+    std::filesystem::remove(backup, ec);
+    bool const hadPublicKey = std::filesystem::exists(target.publicKey, ec);
+    if (hadPublicKey) {
+        std::filesystem::create_hard_link(target.publicKey, backup, ec);
+        if (ec) {
+            std::filesystem::copy_file(target.publicKey, backup, ec);
+        }
+        if (ec) {
+            error = "Failed to back up SSH public key: " + ec.message();
+            return false;
+        }
+    }
+
+    // 先换公钥再换私钥：私钥存在与否决定认证时选用哪种算法
+    std::filesystem::rename(staged.publicKey, target.publicKey, ec);
+    if (ec) {
+        error = "Failed to replace SSH public key: " + ec.message();
+        std::filesystem::remove(backup, ec);
+        return false;
+    }
+    std::filesystem::rename(staged.privateKey, target.privateKey, ec);
+    if (ec) {
+        error = "Failed to replace SSH private key: " + ec.message();
+        if (hadPublicKey) {
+            std::filesystem::rename(backup, target.publicKey, ec);
+        } else {
+            std::filesystem::remove(target.publicKey, ec);
+        }
+        if (ec) {
+            OH_LOG_ERROR(LOG_APP, "Failed to restore SSH public key %{public}s: %{public}s", target.publicKey.c_str(),
+                         ec.message().c_str());
+        }
+        return false;
+    }
+    std::filesystem::remove(backup, ec);
+    return true;
+}
+
 bool SSHManager::generateRSAKeyPairWithMbedTLS(int bits, const std::string &passphrase) {
     OH_LOG_INFO(LOG_APP, "Generating RSA key pair with %{public}d bits using mbedtls", bits);
 
+    if (bits < MBEDTLS_RSA_GEN_KEY_MIN_BITS || bits % 2 != 0) {
+        setError("Invalid RSA key size: " + std::to_string(bits));
+        return false;
+    }
+
+    // 初始化 mbedtls 结构
+    mbedtls_pk_context pk;
+    mbedtls_mpi P, Q;
+
+    mbedtls_pk_init(&pk);
+    mbedtls_mpi_init(&P);
+    mbedtls_mpi_init(&Q);
+
+    // 生成 RSA 密钥对，素数搜索分摊到多个线程
+    int ret = mbedtls_pk_setup(&pk, mbedtls_pk_info_from_type(MBEDTLS_PK_RSA));
+    if (ret == 0) {
+        ret = SearchRSAPrimes(static_cast<size_t>(bits / 2), P, Q);
+    }
+    if (ret == 0) {
+        ret = ImportRSAKey(mbedtls_pk_rsa(pk), bits, P, Q);
+    }
+    if (ret != 0) {
+        setError("Failed to generate RSA key pair: " + std::to_string(ret));
+        mbedtls_pk_free(&pk);
+        mbedtls_mpi_free(&P);
+        mbedtls_mpi_free(&Q);
+        return false;
+    }
+
+    bool stored = storeGeneratedKey(pk);
+    if (stored) {
+        OH_LOG_INFO(LOG_APP, "RSA key pair generated successfully using mbedtls");
+    }
+
+    // 清理资源
+    mbedtls_pk_free(&pk);
+    mbedtls_mpi_free(&P);
+    mbedtls_mpi_free(&Q);
+
+    return stored;
+}
+
+bool SSHManager::generateECDSAKeyPairWithMbedTLS(const std::string &passphrase) {
+    OH_LOG_INFO(LOG_APP, "Generating ECDSA key pair on secp256r1 using mbedtls");
+
     // 初始化 mbedtls 结构
     mbedtls_pk_context pk;
     mbedtls_entropy_context entropy;
@@ -100,42 +424,40 @@ bool SSHManager::generateRSAKeyPairWithMbedTLS(int bits, const std::string &pass
     const char *pers = "higit_ssh_keygen";
     int ret =
         mbedtls_ctr_drbg_seed(&ctr_drbg, mbedtls_entropy_func, &entropy, (const unsigned char *)pers, strlen(pers));
-    if (ret != 0) {
-        setError("Failed to seed random number generator: " + std::to_string(ret));
-        mbedtls_pk_free(&pk);
-        mbedtls_entropy_free(&entropy);
-        mbedtls_ctr_drbg_free(&ctr_drbg);
-        return false;
+    if (ret == 0) {
+        ret = mbedtls_pk_setup(&pk, mbedtls_pk_info_from_type(MBEDTLS_PK_ECKEY));
+    }
+    if (ret == 0) {
+        ret = mbedtls_ecp_gen_key(MBEDTLS_ECP_DP_SECP256R1, mbedtls_pk_ec(pk), mbedtls_ctr_drbg_random, &ctr_drbg);
     }
-
-    // 生成 RSA 密钥对
-    ret = mbedtls_pk_setup(&pk, mbedtls_pk_info_from_type(MBEDTLS_PK_RSA));
     if (ret != 0) {
-        setError("Failed to setup RSA key: " + std::to_string(ret));
+        setError("Failed to generate ECDSA key pair: " + std::to_string(ret));
         mbedtls_pk_free(&pk);
         mbedtls_entropy_free(&entropy);
         mbedtls_ctr_drbg_free(&ctr_drbg);
         return false;
     }
 
-    ret = mbedtls_rsa_gen_key(mbedtls_pk_rsa(pk), mbedtls_ctr_drbg_random, &ctr_drbg, bits, 65537);
-    if (ret != 0) {
-        setError("Failed to generate RSA key pair: " + std::to_string(ret));
-        mbedtls_pk_free(&pk);
-        mbedtls_entropy_free(&entropy);
-        mbedtls_ctr_drbg_free(&ctr_drbg);
-        return false;
+    bool stored = storeGeneratedKey(pk);
+    if (stored) {
+        OH_LOG_INFO(LOG_APP, "ECDSA key pair generated successfully using mbedtls");
     }
 
+    // 清理资源
+    mbedtls_pk_free(&pk);
+    mbedtls_entropy_free(&entropy);
+    mbedtls_ctr_drbg_free(&ctr_drbg);
+
+    return stored;
+}
+
+bool SSHManager::storeGeneratedKey(mbedtls_pk_context &pk) {
     // 将私钥转换为 PEM 格式
     unsigned char private_key_buffer[8192];
 
-    ret = mbedtls_pk_write_key_pem(&pk, private_key_buffer, sizeof(private_key_buffer));
+    int ret = mbedtls_pk_write_key_pem(&pk, private_key_buffer, sizeof(private_key_buffer));
     if (ret != 0) {
         setError("Failed to write private key to PEM: " + std::to_string(ret));
-        mbedtls_pk_free(&pk);
-        mbedtls_entropy_free(&entropy);
-        mbedtls_ctr_drbg_free(&ctr_drbg);
         return false;
     }
 
@@ -145,9 +467,6 @@ bool SSHManager::generateRSAKeyPairWithMbedTLS(int bits, const std::string &pass
     ret = mbedtls_pk_write_pubkey_pem(&pk, public_key_buffer, sizeof(public_key_buffer));
     if (ret != 0) {
         setError("Failed to write public key to PEM: " + std::to_string(ret));
-        mbedtls_pk_free(&pk);
-        mbedtls_entropy_free(&entropy);
-        mbedtls_ctr_drbg_free(&ctr_drbg);
         return false;
     }
 
@@ -157,17 +476,12 @@ bool SSHManager::generateRSAKeyPairWithMbedTLS(int bits, const std::string &pass
 
     // 转换为 OpenSSH 格式
     keyInfo_.publicKey = convertToOpenSSHFormat(rawPublicKey, keyInfo_.comment);
+    if (keyInfo_.publicKey.empty()) {
+        return false;
+    }
 
     // 计算指纹
     keyInfo_.fingerprint = calculateFingerprint(keyInfo_.publicKey);
-
-    OH_LOG_INFO(LOG_APP, "RSA key pair generated successfully using mbedtls");
-
-    // 清理资源
-    mbedtls_pk_free(&pk);
-    mbedtls_entropy_free(&entropy);
-    mbedtls_ctr_drbg_free(&ctr_drbg);
-
     return true;
 }
 
@@ -184,6 +498,40 @@ std::string SSHManager::convertToOpenSSHFormat(const std::string &pemPublicKey,
         return "";
     }
 
+    // ECDSA 公钥：string "ecdsa-sha2-nistp256" + string "nistp256" + string 未压缩的公钥点
+    if (mbedtls_pk_get_type(&pk) == MBEDTLS_PK_ECKEY) {
+        const mbedtls_ecp_keypair *ec = mbedtls_pk_ec(pk);
+        unsigned char point[MBEDTLS_ECP_MAX_PT_LEN];
+        size_t point_len = 0;
+        if (mbedtls_ecp_keypair_get_group_id(ec) != MBEDTLS_ECP_DP_SECP256R1 ||
+            mbedtls_ecp_write_public_key(ec, MBEDTLS_ECP_PF_UNCOMPRESSED, &point_len, point, sizeof(point)) != 0) {
+            mbedtls_pk_free(&pk);
+            setError("Unsupported ECDSA public key");
+            return "";
+        }
+        mbedtls_pk_free(&pk);
+
+        std::vector<unsigned char> ssh_key_data;
+        auto append_string = [&ssh_key_data](const unsigned char *data, size_t len) {
+            for (int shift = 24; shift >= 0; shift -= 8) {
+                ssh_key_data.push_back(static_cast<unsigned char>(len >> shift));
+            }
+            ssh_key_data.insert(ssh_key_data.end(), data, data + len);
+        };
+        const std::string key_type = "ecdsa-sha2-nistp256";
+        const std::string curve = "nistp256";
+        append_string(reinterpret_cast<const unsigned char *>(key_type.data()), key_type.size());
+        append_string(reinterpret_cast<const unsigned char *>(curve.data()), curve.size());
+        append_string(point, point_len);
+
+        std::string base64_key = base64Encode(ssh_key_data);
+        if (base64_key.empty()) {
+            setError("Failed to encode public key to base64");
+            return "";
+        }
+        return key_type + " " + base64_key + " " + comment;
+    }
+
     // 检查是否是 RSA 密钥
     if (mbedtls_pk_get_type(&pk) != MBEDTLS_PK_RSA) {
         mbedtls_pk_free(&pk);
@@ -364,7 +712,10 @@ bool SSHManager::loadKeyPair(const std::string &privateKeyPath, const std::strin
         }
 
         // 设置密钥类型
-        if (keyInfo_.privateKey.find("RSA") != std::string::npos ||
+        if (keyInfo_.privateKey.find("EC PRIVATE KEY") != std::string::npos ||
+            keyInfo_.publicKey.find("ecdsa-sha2-nistp256") != std::string::npos) {
+            keyInfo_.keyType = "ecdsa-sha2-nistp256";
+        } else if (keyInfo_.privateKey.find("RSA") != std::string::npos ||
             keyInfo_.publicKey.find("ssh-rsa") != std::string::npos) {
             keyInfo_.keyType = "ssh-rsa";
         } else if (keyInfo_.privateKey.find("OPENSSH") != std::string::npos ||
@@ -500,6 +851,13 @@ std::string SSHManager::getPublicKey() const { return keyInfo_.publicKey; }
 
 std::string SSHManager::getPrivateKey() const { return keyInfo_.privateKey; }
 
+std::shared_ptr<const SSHCredential> SSHManager::credential() const {
+    if (keyInfo_.privateKey.empty() || keyInfo_.publicKey.empty()) {
+        return nullptr;
+    }
+    return std::make_shared<const SSHCredential>(SSHCredential{keyInfo_.publicKey, keyInfo_.privateKey});
+}
+
 std::string SSHManager::getFingerprint() const { return keyInfo_.fingerprint; }
 
 std::string SSHManager::getKeyType() const { return keyInfo_.keyType; }
@@ -537,7 +895,9 @@ bool SSHManager::changePassphrase(const std::string &oldPassphrase, const std::s
     std::string oldKeyType = keyInfo_.keyType;
     std::string oldComment = keyInfo_.comment;
 
-    if (!generateKeyPair(4096, oldComment, newPassphrase)) {
+    bool regenerated = oldKeyType == "ssh-rsa" ? generateKeyPair(4096, oldComment, newPassphrase)
+                                               : generateECDSAKeyPair(oldComment, newPassphrase);
+    if (!regenerated) {
         setError("Failed to regenerate key pair with new passphrase");
         return false;
     }
@@ -583,15 +943,10 @@ std::string SSHManager::calculateFingerprint(const std::string &publicKey) {
     mbedtls_sha256_finish(&sha256_ctx, hash);
     mbedtls_sha256_free(&sha256_ctx);
 
-    // 转换为十六进制字符串
-    std::stringstream ss;
-    ss << "SHA256:";
-    for (int i = 0; i < 32; i++) {
-        ss << std::hex << std::setfill('0') << std::setw(2) << static_cast<int>(hash[i]);
-        if (i < 31) {
-            ss << ":";
-        }
+    // 与 OpenSSH 一致：Base64 编码并去掉末尾的填充
+    std::string encoded = base64Encode(std::vector<unsigned char>(hash, hash + sizeof(hash)));
+    while (!encoded.empty() && encoded.back() == '=') {
+        encoded.pop_back();
     }
-
-    return ss.str();
+    return "SHA256:" + encoded;
 }
\ No newline at end of file
@@ -0,0 +1,556 @@
+#include "ssh_transport.h"
+#include "utils/log.hpp"
+#include "utils/socket.hpp"
+#include <chrono>
+#include <cstring>
+#include <git2.h>
+#include <git2/sys/credential.h>
+#include <git2/sys/errors.h>
+#include <git2/sys/transport.h>
+#include <iterator>
+#include <libssh2.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+constexpr int DEFAULT_TIMEOUT_MS = 30000;               // 读写超时，与 GIT_OPT_SET_SERVER_TIMEOUT 一致
+constexpr int DEFAULT_CONNECT_TIMEOUT_MS = 15000;       // 建立连接超时
+constexpr int CLOSE_TIMEOUT_MS = 1000;                  // 关闭通道时等待远端命令退出的超时
+constexpr size_t MAX_IDLE = 8;                          // 空闲会话总数
+constexpr auto IDLE_TIMEOUT = std::chrono::seconds(30); // 空闲超时，足够覆盖一次刷新中的连续操作
+constexpr const char *DEFAULT_PORT = "22";
+constexpr const char *PREFIXES[] = {"ssh://", "ssh+git://", "git+ssh://"};
+
+using Clock = std::chrono::steady_clock;
+
+void SetSshError(const std::string &message) { git_error_set_str(GIT_ERROR_SSH, message.c_str()); }
+
+void SetSessionError(LIBSSH2_SESSION *session, const std::string &message) {
+    char *text = nullptr;
+    libssh2_session_last_error(session, &text, nullptr, 0);
+    SetSshError(text != nullptr && *text != '\0' ? message + ": " + text : message);
+}
+
+// 解析后的SSH地址
+struct SshUrl {
+    std::string user;
+    std::string host;
+    std::string port = DEFAULT_PORT;
+    std::string path;
+};
+
+// 拆分 [user@]host[:port]，IPv6 地址带方括号
+bool ParseAuthority(const std::string &authority, SshUrl &out, bool allowPort) {
+    std::string hostPort = authority;
+    size_t at = authority.rfind('@');
+    if (at != std::string::npos) {
+        out.user = authority.substr(0, at);
+        hostPort = authority.substr(at + 1);
+    }
+    std::string portPart;
+    if (!hostPort.empty() && hostPort.front() == '[') {
+        size_t end = hostPort.find(']');
+        if (end == std::string::npos) {
+            return false;
+        }
+        out.host = hostPort.substr(1, end - 1);
+        portPart = hostPort.substr(end + 1);
+    } else {
+        size_t colon = hostPort.find(':');
+        out.host = hostPort.substr(0, colon);
+        portPart = colon == std::string::npos ? "" : hostPort.substr(colon);
+    }
+    if (!portPart.empty()) {
+        if (!allowPort || portPart.front() != ':' || portPart.size() == 1) {
+            return false;
+        }
+        out.port = portPart.substr(1);
+    }
+    return !out.host.empty();
+}
+
+// 支持 ssh://[user@]host[:port]/path 和 scp 形式的 [user@]host:path
+bool ParseUrl(const std::string &url, SshUrl &out) {
+    for (const char *prefix : PREFIXES) {
+        size_t length = std::strlen(prefix);
+        if (url.compare(0, length, prefix) != 0) {
+            continue;
+        }
+        size_t slash = url.find('/', length);
+        if (slash == std::string::npos || slash + 1 == url.size()) {
+            return false;
+        }
+        out.path = url.substr(slash);
+        // ssh://host/~user/repo 表示相对用户目录的路径
+        if (out.path.compare(0, 2, "/~") == 0) {
+            out.path.erase(0, 1);
+        }
+        return ParseAuthority(url.substr(length, slash - length), out, true);
+    }
+
+    if (url.empty()) {
+        return false;
+    }
+    size_t colon = url.find(':', url.front() == '[' ? url.find(']') : 0);
+    if (colon == std::string::npos || colon + 1 == url.size()) {
+        return false;
+    }
+    std::string authority = url.substr(0, colon);
+    if (authority.find('/') != std::string::npos) {
+        return false;
+    }
+    out.path = url.substr(colon + 1);
+    return ParseAuthority(authority, out, false);
+}
+
+// 远端命令，路径按 shell 单引号转义
+std::string BuildCommand(git_smart_service_t action, const std::string &path) {
+    bool upload = action == GIT_SERVICE_UPLOADPACK_LS || action == GIT_SERVICE_UPLOADPACK;
+    std::string command = upload ? "git-upload-pack '" : "git-receive-pack '";
+    for (char c : path) {
+        if (c == '\'') {
+            command += "'\\''";
+        } else {
+            command += c;
+        }
+    }
+    command += '\'';
+    return command;
+}
+
+// 已认证的SSH会话，可在操作结束后放回会话池
+struct SshSession {
+    int fd = -1;                            ///< 套接字
+    LIBSSH2_SESSION *session = nullptr;     ///< libssh2 会话
+    std::string key;                        ///< 会话池的键（用户@主机:端口）
+    Clock::time_point idleSince;            ///< 放回会话池的时间
+
+    SshSession() = default;
+    SshSession(const SshSession &) = delete;
+    SshSession &operator=(const SshSession &) = delete;
+
+    ~SshSession() {
+        if (session != nullptr) {
+            libssh2_session_disconnect(session, "closing");
+            libssh2_session_free(session);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+};
+
+/**
+ * @brief 空闲的SSH会话池
+ * 会话取出后由一个操作独占，操作结束且通道正常关闭时放回
+ */
+class SessionPool {
+public:
+    static SessionPool &Shared() {
+        static SessionPool pool;
+        return pool;
+    }
+
+    // 取出一个仍然可用的空闲会话
+    std::unique_ptr<SshSession> take(const std::string &key) {
+        std::vector<std::unique_ptr<SshSession>> expired;
+        std::unique_ptr<SshSession> result;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto now = Clock::now();
+            for (auto it = idle_.begin(); it != idle_.end();) {
+                if (now - (*it)->idleSince >= IDLE_TIMEOUT || Socket::Readable((*it)->fd)) {
+                    // 超时或对端已发来数据（通常是断开连接）的不再使用
+                    expired.push_back(std::move(*it));
+                    it = idle_.erase(it);
+                } else if (result == nullptr && (*it)->key == key) {
+                    result = std::move(*it);
+                    it = idle_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+        // 在锁外断开会话
+        expired.clear();
+        return result;
+    }
+
+    // 放回空闲会话，超出数量上限时断开最久未用的会话
+    void put(std::unique_ptr<SshSession> session) {
+        std::unique_ptr<SshSession> evicted;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            session->idleSince = Clock::now();
+            idle_.insert(idle_.begin(), std::move(session));
+            if (idle_.size() > MAX_IDLE) {
+                evicted = std::move(idle_.back());
+                idle_.pop_back();
+            }
+        }
+    }
+
+    // 断开所有空闲会话
+    void clear() {
+        std::vector<std::unique_ptr<SshSession>> idle;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            idle.swap(idle_);
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<SshSession>> idle_; ///< 空闲会话，新的在前
+};
+
+// 向调用方确认主机密钥；设备上没有 known_hosts，与内置实现一样以未校验的状态交给回调
+int CheckHostKey(git_transport *owner, SshSession &session, const std::string &host) {
+    git_cert_hostkey cert{};
+    cert.parent.cert_type = GIT_CERT_HOSTKEY_LIBSSH2;
+    unsigned type = 0;
+
+    size_t keyLength = 0;
+    int keyType = LIBSSH2_HOSTKEY_TYPE_UNKNOWN;
+    const char *key = libssh2_session_hostkey(session.session, &keyLength, &keyType);
+    if (key != nullptr) {
+        cert.hostkey = key;
+        cert.hostkey_len = keyLength;
+        cert.raw_type = static_cast<git_cert_ssh_raw_type_t>(keyType);
+        type |= GIT_CERT_SSH_RAW;
+    }
+    if (const char *hash = libssh2_hostkey_hash(session.session, LIBSSH2_HOSTKEY_HASH_SHA256)) {
+        std::memcpy(cert.hash_sha256, hash, sizeof(cert.hash_sha256));
+        type |= GIT_CERT_SSH_SHA256;
+    }
+    if (const char *hash = libssh2_hostkey_hash(session.session, LIBSSH2_HOSTKEY_HASH_SHA1)) {
+        std::memcpy(cert.hash_sha1, hash, sizeof(cert.hash_sha1));
+        type |= GIT_CERT_SSH_SHA1;
+    }
+    if (const char *hash = libssh2_hostkey_hash(session.session, LIBSSH2_HOSTKEY_HASH_MD5)) {
+        std::memcpy(cert.hash_md5, hash, sizeof(cert.hash_md5));
+        type |= GIT_CERT_SSH_MD5;
+    }
+    if (type == 0) {
+        SetSshError("unable to get the host key");
+        return -1;
+    }
+    cert.type = static_cast<git_cert_ssh_t>(type);
+
+    int ret = git_transport_smart_certificate_check(owner, &cert.parent, 0, host.c_str());
+    if (ret == GIT_PASSTHROUGH) {
+        SetSshError("unknown host key for " + host);
+        return GIT_ECERTIFICATE;
+    }
+    return ret;
+}
+
+// 地址中没有用户名时向调用方索取
+int RequestUsername(git_transport *owner, std::string &user) {
+    git_credential *cred = nullptr;
+    int ret = git_transport_smart_credentials(&cred, owner, nullptr, GIT_CREDENTIAL_USERNAME);
+    if (ret == GIT_PASSTHROUGH) {
+        SetSshError("no username specified in the SSH url");
+        return GIT_EAUTH;
+    }
+    if (ret < 0) {
+        return ret;
+    }
+    if (cred->credtype == GIT_CREDENTIAL_USERNAME) {
+        user = reinterpret_cast<git_credential_username *>(cred)->username;
+    }
+    git_credential_free(cred);
+    if (user.empty()) {
+        SetSshError("no username specified in the SSH url");
+        return GIT_EAUTH;
+    }
+    return 0;
+}
+
+// 使用 credentials 回调返回的密钥进行公钥认证
+int Authenticate(git_transport *owner, SshSession &session, const std::string &user) {
+    git_credential *cred = nullptr;
+    int ret = git_transport_smart_credentials(&cred, owner, user.c_str(),
+                                              GIT_CREDENTIAL_SSH_KEY | GIT_CREDENTIAL_SSH_MEMORY);
+    if (ret == GIT_PASSTHROUGH) {
+        SetSshError("no SSH credentials provided");
+        return GIT_EAUTH;
+    }
+    if (ret < 0) {
+        return ret;
+    }
+    if (cred->credtype != GIT_CREDENTIAL_SSH_KEY && cred->credtype != GIT_CREDENTIAL_SSH_MEMORY) {
+        git_credential_free(cred);
+        SetSshError("unsupported SSH credential type");
+        return GIT_EAUTH;
+    }
+
+    auto *key = reinterpret_cast<git_credential_ssh_key *>(cred);
+    const char *username = key->username != nullptr && *key->username != '\0' ? key->username : user.c_str();
+    unsigned int usernameLength = static_cast<unsigned int>(std::strlen(username));
+    if (cred->credtype == GIT_CREDENTIAL_SSH_MEMORY) {
+        ret = libssh2_userauth_publickey_frommemory(
+            session.session, username, usernameLength, key->publickey,
+            key->publickey != nullptr ? std::strlen(key->publickey) : 0, key->privatekey,
+            std::strlen(key->privatekey), key->passphrase);
+    } else {
+        ret = libssh2_userauth_publickey_fromfile_ex(session.session, username, usernameLength, key->publickey,
+                                                     key->privatekey, key->passphrase);
+    }
+    git_credential_free(cred);
+
+    if (ret != 0) {
+        SetSessionError(session.session, "SSH authentication failed for " + user);
+        return GIT_EAUTH;
+    }
+    return 0;
+}
+
+// 建立新会话：TCP连接、密钥交换、主机密钥确认、公钥认证
+int Connect(std::unique_ptr<SshSession> &out, git_transport *owner, const SshUrl &target, const std::string &key) {
+    auto session = std::make_unique<SshSession>();
+    session->key = key;
+
+    std::string error;
+    session->fd = Socket::Connect(target.host, target.port, DEFAULT_CONNECT_TIMEOUT_MS, DEFAULT_TIMEOUT_MS, error);
+    if (session->fd < 0) {
+        git_error_set_str(GIT_ERROR_NET, error.c_str());
+        return -1;
+    }
+
+    session->session = libssh2_session_init();
+    if (session->session == nullptr) {
+        SetSshError("failed to initialize SSH session");
+        return -1;
+    }
+    libssh2_session_set_blocking(session->session, 1);
+    libssh2_session_set_timeout(session->session, DEFAULT_TIMEOUT_MS);
+
+    int ret = libssh2_session_handshake(session->session, session->fd);
+    if (ret != 0) {
+        SetSessionError(session->session, "SSH handshake failed");
+        return -1;
+    }
+    if ((ret = CheckHostKey(owner, *session, target.host)) < 0) {
+        return ret;
+    }
+    if ((ret = Authenticate(owner, *session, target.user)) < 0) {
+        return ret;
+    }
+
+    OH_LOG_INFO(LOG_APP, "SSH session established: %{public}s", key.c_str());
+    out = std::move(session);
+    return 0;
+}
+
+// 在会话上执行远端命令
+LIBSSH2_CHANNEL *OpenChannel(SshSession &session, const std::string &command) {
+    LIBSSH2_CHANNEL *channel = libssh2_channel_open_session(session.session);
+    if (channel == nullptr) {
+        SetSessionError(session.session, "failed to open SSH channel");
+        return nullptr;
+    }
+    if (libssh2_channel_exec(channel, command.c_str()) != 0) {
+        SetSessionError(session.session, "failed to start SSH command");
+        libssh2_channel_free(channel);
+        return nullptr;
+    }
+    return channel;
+}
+
+struct SshSubtransport;
+
+// 交给 libgit2 的流，对应一个 exec 通道
+struct SshStream {
+    git_smart_subtransport_stream parent;
+    SshSubtransport *owner = nullptr;     ///< 所属子传输
+    std::unique_ptr<SshSession> session;  ///< 独占的会话
+    LIBSSH2_CHANNEL *channel = nullptr;   ///< 远端命令的通道
+    bool broken = false;                  ///< 读写是否出错
+};
+
+struct SshSubtransport {
+    git_smart_subtransport parent;
+    git_transport *owner = nullptr;  ///< 所属的 smart 传输，用于调用回调
+    SshStream *current = nullptr;    ///< 当前流，由 libgit2 释放
+};
+
+/**
+ * @brief 关闭通道，会话仍然可用时放回会话池
+ * 远端命令在收到结束包后退出，这里只短暂等待；等待超时或读写出过错的会话直接断开
+ */
+void ReleaseStream(SshStream &stream) {
+    if (stream.channel != nullptr) {
+        bool clean = !stream.broken;
+        if (clean) {
+            libssh2_session_set_timeout(stream.session->session, CLOSE_TIMEOUT_MS);
+            clean = libssh2_channel_send_eof(stream.channel) == 0 && libssh2_channel_wait_eof(stream.channel) == 0 &&
+                    libssh2_channel_close(stream.channel) == 0 && libssh2_channel_wait_closed(stream.channel) == 0;
+            libssh2_session_set_timeout(stream.session->session, DEFAULT_TIMEOUT_MS);
+        }
+        libssh2_channel_free(stream.channel);
+        stream.channel = nullptr;
+        stream.broken = !clean;
+    }
+    if (stream.session != nullptr && !stream.broken) {
+        SessionPool::Shared().put(std::move(stream.session));
+    }
+    stream.session.reset();
+}
+
+int StreamRead(git_smart_subtransport_stream *stream, char *buffer, size_t size, size_t *bytesRead) {
+    auto *st = reinterpret_cast<SshStream *>(stream);
+    *bytesRead = 0;
+    ssize_t ret = libssh2_channel_read(st->channel, buffer, size);
+    if (ret < 0) {
+        st->broken = true;
+        SetSessionError(st->session->session, "SSH could not read data");
+        return -1;
+    }
+    // 远端命令直接退出时，原因（如仓库不存在）在 stderr 中
+    if (ret == 0) {
+        char message[256];
+        ssize_t length = libssh2_channel_read_stderr(st->channel, message, sizeof(message) - 1);
+        if (length > 0) {
+            message[length] = '\0';
+            SetSshError(message);
+            return -1;
+        }
+    }
+    *bytesRead = static_cast<size_t>(ret);
+    return 0;
+}
+
+int StreamWrite(git_smart_subtransport_stream *stream, const char *buffer, size_t len) {
+    auto *st = reinterpret_cast<SshStream *>(stream);
+    size_t offset = 0;
+    while (offset < len) {
+        ssize_t ret = libssh2_channel_write(st->channel, buffer + offset, len - offset);
+        if (ret < 0) {
+            st->broken = true;
+            SetSessionError(st->session->session, "SSH could not write data");
+            return -1;
+        }
+        offset += static_cast<size_t>(ret);
+    }
+    return 0;
+}
+
+void StreamFree(git_smart_subtransport_stream *stream) {
+    auto *st = reinterpret_cast<SshStream *>(stream);
+    if (st->owner->current == st) {
+        st->owner->current = nullptr;
+    }
+    ReleaseStream(*st);
+    delete st;
+}
+
+int SubtransportAction(git_smart_subtransport_stream **out, git_smart_subtransport *subtransport, const char *url,
+                       git_smart_service_t action) {
+    auto *t = reinterpret_cast<SshSubtransport *>(subtransport);
+    // ls 之后的 fetch 或 push 沿用同一个通道
+    if ((action == GIT_SERVICE_UPLOADPACK || action == GIT_SERVICE_RECEIVEPACK) && t->current != nullptr) {
+        *out = &t->current->parent;
+        return 0;
+    }
+
+    SshUrl target;
+    if (!ParseUrl(url, target)) {
+        SetSshError(std::string("malformed SSH url: ") + url);
+        return -1;
+    }
+    int ret = 0;
+    if (target.user.empty() && (ret = RequestUsername(t->owner, target.user)) < 0) {
+        return ret;
+    }
+    std::string key = target.user + "@" + target.host + ":" + target.port;
+    std::string command = BuildCommand(action, target.path);
+
+    auto stream = std::make_unique<SshStream>();
+    stream->parent.subtransport = subtransport;
+    stream->parent.read = StreamRead;
+    stream->parent.write = StreamWrite;
+    stream->parent.free = StreamFree;
+    stream->owner = t;
+
+    stream->session = SessionPool::Shared().take(key);
+    if (stream->session != nullptr) {
+        stream->channel = OpenChannel(*stream->session, command);
+        if (stream->channel != nullptr) {
+            OH_LOG_DEBUG(LOG_APP, "Reuse idle SSH session: %{public}s", key.c_str());
+        } else {
+            // 服务器已关闭的会话丢弃后重新连接
+            stream->session.reset();
+            git_error_clear();
+        }
+    }
+    if (stream->channel == nullptr) {
+        if ((ret = Connect(stream->session, t->owner, target, key)) < 0) {
+            return ret;
+        }
+        stream->channel = OpenChannel(*stream->session, command);
+        if (stream->channel == nullptr) {
+            return -1;
+        }
+    }
+
+    t->current = stream.release();
+    *out = &t->current->parent;
+    return 0;
+}
+
+int SubtransportClose(git_smart_subtransport *subtransport) {
+    // 流由 libgit2 在关闭子传输之前释放
+    (void)subtransport;
+    return 0;
+}
+
+void SubtransportFree(git_smart_subtransport *subtransport) {
+    delete reinterpret_cast<SshSubtransport *>(subtransport);
+}
+
+int NewSubtransport(git_smart_subtransport **out, git_transport *owner, void *param) {
+    (void)param;
+    auto *t = new SshSubtransport();
+    t->parent.action = SubtransportAction;
+    t->parent.close = SubtransportClose;
+    t->parent.free = SubtransportFree;
+    t->owner = owner;
+    *out = &t->parent;
+    return 0;
+}
+
+int NewTransport(git_transport **out, git_remote *owner, void *param) {
+    (void)param;
+    // 与内置SSH一样使用持久连接（rpc = 0）
+    static git_smart_subtransport_definition definition = {NewSubtransport, 0, nullptr};
+    return git_transport_smart(out, owner, &definition);
+}
+} // namespace
+
+bool SshTransport::Register() {
+    int ret = libssh2_init(0);
+    if (ret != 0) {
+        OH_LOG_ERROR(LOG_APP, "Failed to initialize libssh2: %{public}d", ret);
+        return false;
+    }
+
+    // scp 形式的地址由 libgit2 按 ssh:// 查找传输
+    for (size_t i = 0; i < std::size(PREFIXES); ++i) {
+        if (git_transport_register(PREFIXES[i], NewTransport, nullptr) != 0) {
+            const git_error *error = git_error_last();
+            OH_LOG_ERROR(LOG_APP, "Failed to register SSH transport for %{public}s: %{public}s", PREFIXES[i],
+                         error != nullptr ? error->message : "");
+            while (i > 0) {
+                git_transport_unregister(PREFIXES[--i]);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+void SshTransport::CloseIdleSessions() { SessionPool::Shared().clear(); }
@@ -0,0 +1,238 @@
+#include "text_search.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__aarch64__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define HIGIT_SEARCH_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define HIGIT_SEARCH_SSE2 1
+#endif
+
+namespace {
+
+// 预览中保留的行内容上限，超长行（压缩后的js等）只截取开头
+constexpr size_t MAX_PREVIEW_BYTES = 512;
+// 正则模式下跳过超长行，std::regex 在长输入上递归过深
+constexpr size_t MAX_REGEX_LINE_BYTES = 8 * 1024;
+
+inline unsigned char asciiLower(unsigned char c) { return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c; }
+
+inline unsigned char asciiUpper(unsigned char c) { return (c >= 'a' && c <= 'z') ? c - ('a' - 'A') : c; }
+
+inline bool equalsAt(const char *text, std::string_view needle, bool caseSensitive) {
+    if (caseSensitive) {
+        return std::memcmp(text, needle.data(), needle.size()) == 0;
+    }
+    for (size_t i = 0; i < needle.size(); ++i) {
+        if (asciiLower(static_cast<unsigned char>(text[i])) != asciiLower(static_cast<unsigned char>(needle[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline int countTrailingZeros(uint64_t value) { return __builtin_ctzll(value); }
+
+} // namespace
+
+std::unique_ptr<TextMatcher> TextMatcher::compile(const std::string &pattern, bool isRegex, bool caseSensitive,
+                                                  std::string &error) {
+    if (pattern.empty()) {
+        error = "搜索内容不能为空";
+        return nullptr;
+    }
+
+    std::unique_ptr<TextMatcher> matcher(new TextMatcher());
+    matcher->isRegex_ = isRegex;
+    matcher->caseSensitive_ = caseSensitive;
+    matcher->key_ = std::string(isRegex ? "re" : "lit") + (caseSensitive ? ":c:" : ":i:") + pattern;
+
+    if (isRegex) {
+        auto flags = std::regex::ECMAScript | std::regex::optimize;
+        if (!caseSensitive) {
+            flags |= std::regex::icase;
+        }
+        try {
+            matcher->regex_.assign(pattern, flags);
+        } catch (const std::regex_error &e) {
+            error = std::string("正则表达式无效: ") + e.what();
+            return nullptr;
+        }
+    } else {
+        matcher->literal_ = pattern;
+    }
+    return matcher;
+}
+
+size_t TextMatcher::findLiteral(std::string_view text, std::string_view needle, bool caseSensitive) {
+    size_t n = text.size();
+    size_t k = needle.size();
+    if (k == 0) {
+        return 0;
+    }
+    if (k > n) {
+        return std::string_view::npos;
+    }
+    const char *data = text.data();
+    if (k == 1 && caseSensitive) {
+        const void *hit = std::memchr(data, needle[0], n);
+        return hit ? static_cast<const char *>(hit) - data : std::string_view::npos;
+    }
+
+    // 同时比较候选位置的首字节和尾字节，两者都命中才逐字节校验
+    auto first = static_cast<unsigned char>(needle[0]);
+    auto last = static_cast<unsigned char>(needle[k - 1]);
+    unsigned char firstLo = caseSensitive ? first : asciiLower(first);
+    unsigned char firstHi = caseSensitive ? first : asciiUpper(first);
+    unsigned char lastLo = caseSensitive ? last : asciiLower(last);
+    unsigned char lastHi = caseSensitive ? last : asciiUpper(last);
+
+    size_t lastStart = n - k;
+    size_t i = 0;
+#if defined(HIGIT_SEARCH_NEON)
+    const uint8x16_t vFirstLo = vdupq_n_u8(firstLo);
+    const uint8x16_t vFirstHi = vdupq_n_u8(firstHi);
+    const uint8x16_t vLastLo = vdupq_n_u8(lastLo);
+    const uint8x16_t vLastHi = vdupq_n_u8(lastHi);
+    for (; i + 16 <= lastStart + 1; i += 16) {
+        uint8x16_t blockFirst = vld1q_u8(reinterpret_cast<const uint8_t *>(data + i));
+        uint8x16_t blockLast = vld1q_u8(reinterpret_cast<const uint8_t *>(data + i + k - 1));
+        uint8x16_t eqFirst = vorrq_u8(vceqq_u8(blockFirst, vFirstLo), vceqq_u8(blockFirst, vFirstHi));
+        uint8x16_t eqLast = vorrq_u8(vceqq_u8(blockLast, vLastLo), vceqq_u8(blockLast, vLastHi));
+        uint8x16_t eq = vandq_u8(eqFirst, eqLast);
+        // 每个字节压缩为4位，得到64位掩码
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+        while (mask != 0) {
+            size_t offset = static_cast<size_t>(countTrailingZeros(mask)) >> 2;
+            if (equalsAt(data + i + offset, needle, caseSensitive)) {
+                return i + offset;
+            }
+            mask &= ~(0xFull << (offset * 4));
+        }
+    }
+#elif defined(HIGIT_SEARCH_SSE2)
+    const __m128i vFirstLo = _mm_set1_epi8(static_cast<char>(firstLo));
+    const __m128i vFirstHi = _mm_set1_epi8(static_cast<char>(firstHi));
+    const __m128i vLastLo = _mm_set1_epi8(static_cast<char>(lastLo));
+    const __m128i vLastHi = _mm_set1_epi8(static_cast<char>(lastHi));
+    for (; i + 16 <= lastStart + 1; i += 16) {
+        __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + k - 1));
+        __m128i eqFirst = _mm_or_si128(_mm_cmpeq_epi8(blockFirst, vFirstLo), _mm_cmpeq_epi8(blockFirst, vFirstHi));
+        __m128i eqLast = _mm_or_si128(_mm_cmpeq_epi8(blockLast, vLastLo), _mm_cmpeq_epi8(blockLast, vLastHi));
+        auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(eqFirst, eqLast)));
+        while (mask != 0) {
+            size_t offset = static_cast<size_t>(countTrailingZeros(mask));
+            if (equalsAt(data + i + offset, needle, caseSensitive)) {
+                return i + offset;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+    // 剩余不足一个向量宽度的部分（或不支持SIMD的平台）逐字节比较
+    for (; i <= lastStart; ++i) {
+        auto c = static_cast<unsigned char>(data[i]);
+        if ((c == firstLo || c == firstHi) && equalsAt(data + i, needle, caseSensitive)) {
+            return i;
+        }
+    }
+    return std::string_view::npos;
+}
+
+void TextMatcher::matchLine(std::string_view line, std::vector<std::pair<uint32_t, uint32_t>> &columns) const {
+    if (isRegex_) {
+        if (line.size() > MAX_REGEX_LINE_BYTES) {
+            return;
+        }
+        auto begin = std::cregex_iterator(line.data(), line.data() + line.size(), regex_);
+        for (auto it = begin; it != std::cregex_iterator(); ++it) {
+            // 空匹配（如 ^、a*）没有可高亮的内容
+            if (it->length(0) == 0) {
+                continue;
+            }
+            auto start = static_cast<uint32_t>(it->position(0));
+            columns.emplace_back(start, start + static_cast<uint32_t>(it->length(0)));
+        }
+        return;
+    }
+
+    size_t pos = 0;
+    while (pos < line.size()) {
+        size_t hit = findLiteral(line.substr(pos), literal_, caseSensitive_);
+        if (hit == std::string_view::npos) {
+            break;
+        }
+        auto start = static_cast<uint32_t>(pos + hit);
+        columns.emplace_back(start, start + static_cast<uint32_t>(literal_.size()));
+        pos += hit + literal_.size();
+    }
+}
+
+std::vector<LineMatch> TextMatcher::findAll(std::string_view text, size_t maxLines) const {
+    std::vector<LineMatch> matches;
+    uint32_t lineNumber = 1;
+    size_t countedUpTo = 0; // [0, countedUpTo) 内的换行已计入 lineNumber
+    size_t pos = 0;
+
+    auto addLine = [&](size_t lineStart) {
+        const char *newline = static_cast<const char *>(std::memchr(text.data() + lineStart, '\n', text.size() - lineStart));
+        size_t lineEnd = newline ? newline - text.data() : text.size();
+        std::string_view line = text.substr(lineStart, lineEnd - lineStart);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+
+        LineMatch match;
+        matchLine(line, match.columns);
+        if (!match.columns.empty()) {
+            lineNumber += static_cast<uint32_t>(
+                std::count(text.data() + countedUpTo, text.data() + lineStart, '\n'));
+            countedUpTo = lineStart;
+            match.line = lineNumber;
+            // 预览在字符边界处截断，超出预览的匹配区间无法在界面上显示，截掉
+            size_t previewSize = std::min(line.size(), MAX_PREVIEW_BYTES);
+            while (previewSize < line.size() && previewSize > 0 &&
+                   (static_cast<unsigned char>(line[previewSize]) & 0xC0) == 0x80) {
+                --previewSize;
+            }
+            match.text.assign(line.substr(0, previewSize));
+            auto bound = static_cast<uint32_t>(previewSize);
+            match.columns.erase(std::remove_if(match.columns.begin(), match.columns.end(),
+                                               [bound](const auto &range) { return range.first >= bound; }),
+                                match.columns.end());
+            for (auto &range : match.columns) {
+                range.second = std::min(range.second, bound);
+            }
+            matches.push_back(std::move(match));
+        }
+        return lineEnd + 1;
+    };
+
+    if (isRegex_) {
+        // 正则无法整体预过滤，逐行匹配
+        while (pos < text.size() && matches.size() < maxLines) {
+            pos = addLine(pos);
+        }
+        return matches;
+    }
+
+    // 字面量先在整段文本上用SIMD定位，只处理命中的行
+    while (pos < text.size() && matches.size() < maxLines) {
+        size_t hit = findLiteral(text.substr(pos), literal_, caseSensitive_);
+        if (hit == std::string_view::npos) {
+            break;
+        }
+        size_t hitPos = pos + hit;
+        size_t lineStart = hitPos;
+        while (lineStart > pos && text[lineStart - 1] != '\n') {
+            --lineStart;
+        }
+        // 命中跨越换行（模式本身含换行）时不会被逐行校验接受，跳过本行即可
+        size_t next = addLine(lineStart);
+        pos = std::max(next, hitPos + 1);
+    }
+    return matches;
+}
@@ -0,0 +1,113 @@
+#include "thread_pool.h"
+#include "utils/log.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+ThreadPool::ThreadPool(size_t threadCount) : stopping_(false) {
+    if (threadCount == 0) {
+        // 移动端大小核混合，超过8个线程收益很小
+        threadCount = std::clamp<size_t>(std::thread::hardware_concurrency(), 2, 8);
+    }
+
+    workers_.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers_.emplace_back([this] { workerLoop(); });
+    }
+    OH_LOG_INFO(LOG_APP, "ThreadPool started with %{public}zu threads", threadCount);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto &worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+ThreadPool &ThreadPool::Shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (stopping_ && tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+
+        try {
+            task();
+        } catch (...) {
+            OH_LOG_WARN(LOG_APP, "ThreadPool task threw an exception, ignoring");
+        }
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)> &body) {
+    if (count == 0) {
+        return;
+    }
+    if (count == 1) {
+        body(0);
+        return;
+    }
+
+    // 共享状态由 shared_ptr 持有，晚到的辅助任务在调用方返回后也能安全退出
+    struct State {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        size_t count = 0;
+        const std::function<void(size_t)> *body = nullptr;
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+    auto state = std::make_shared<State>();
+    state->count = count;
+    state->body = &body;
+
+    auto drain = [](State &s) {
+        size_t index;
+        while ((index = s.next.fetch_add(1)) < s.count) {
+            try {
+                (*s.body)(index);
+            } catch (...) {
+                OH_LOG_WARN(LOG_APP, "ThreadPool parallelFor body threw an exception, ignoring");
+            }
+            if (s.done.fetch_add(1) + 1 == s.count) {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                s.cv.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = std::min(count - 1, workers_.size());
+    for (size_t i = 0; i < helpers; ++i) {
+        submit([state, drain] { drain(*state); });
+    }
+
+    drain(*state);
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cv.wait(lock, [&state] { return state->done.load() == state->count; });
+}
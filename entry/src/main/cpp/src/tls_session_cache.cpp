@@ -0,0 +1,70 @@
+#include "tls_session_cache.h"
+#include "utils/log.hpp"
+
+namespace {
+constexpr size_t SESSION_CAPACITY = 32;               // 托管平台数量有限，32 个对端足够
+constexpr auto SESSION_TTL = std::chrono::minutes(5); // 常见服务器的会话保留时间下限
+} // namespace
+
+TlsSessionCache::TlsSessionCache(size_t capacity, Clock::duration ttl) : entries_(capacity), ttl_(ttl) {}
+
+TlsSessionCache &TlsSessionCache::Shared() {
+    static TlsSessionCache cache(SESSION_CAPACITY, SESSION_TTL);
+    return cache;
+}
+
+bool TlsSessionCache::restore(const std::string &peer, mbedtls_ssl_context *ssl) {
+    auto entry = entries_.get(peer);
+    if (entry == nullptr) {
+        return false;
+    }
+    if (Clock::now() >= entry->expiresAt) {
+        entries_.erase(peer);
+        return false;
+    }
+
+    mbedtls_ssl_session session;
+    mbedtls_ssl_session_init(&session);
+    int ret = mbedtls_ssl_session_load(&session, entry->session.data(), entry->session.size());
+    if (ret == 0) {
+        ret = mbedtls_ssl_set_session(ssl, &session);
+    }
+    mbedtls_ssl_session_free(&session);
+
+    if (ret != 0) {
+        OH_LOG_WARN(LOG_APP, "Failed to restore TLS session for %{public}s: %{public}d", peer.c_str(), ret);
+        entries_.erase(peer);
+        return false;
+    }
+    return true;
+}
+
+void TlsSessionCache::store(const std::string &peer, const mbedtls_ssl_context *ssl) {
+    mbedtls_ssl_session session;
+    mbedtls_ssl_session_init(&session);
+
+    Entry entry;
+    int ret = mbedtls_ssl_get_session(ssl, &session);
+    if (ret == 0) {
+        size_t length = 0;
+        ret = mbedtls_ssl_session_save(&session, nullptr, 0, &length);
+        if (ret == MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL) {
+            entry.session.resize(length);
+            ret = mbedtls_ssl_session_save(&session, entry.session.data(), entry.session.size(), &length);
+        }
+    }
+    mbedtls_ssl_session_free(&session);
+
+    if (ret != 0) {
+        OH_LOG_WARN(LOG_APP, "Failed to save TLS session for %{public}s: %{public}d", peer.c_str(), ret);
+        return;
+    }
+    entry.expiresAt = Clock::now() + ttl_;
+    entries_.put(peer, std::move(entry));
+}
+
+void TlsSessionCache::remove(const std::string &peer) { entries_.erase(peer); }
+
+void TlsSessionCache::clear() { entries_.clear(); }
+
+size_t TlsSessionCache::size() const { return entries_.size(); }
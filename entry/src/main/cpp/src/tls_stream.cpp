@@ -0,0 +1,534 @@
+#include "tls_stream.h"
+#include "tls_session_cache.h"
+#include "trust_store.h"
+#include "utils/log.hpp"
+#include "utils/socket.hpp"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <git2/sys/errors.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/error.h>
+#include <mbedtls/net_sockets.h>
+#include <mbedtls/ssl.h>
+#include <memory>
+#include <mutex>
+#include <psa/crypto.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+constexpr int DEFAULT_TIMEOUT_MS = 30000;               // 读写超时，与 GIT_OPT_SET_SERVER_TIMEOUT 一致
+constexpr int DEFAULT_CONNECT_TIMEOUT_MS = 15000;       // 建立连接超时
+constexpr int DRAIN_TIMEOUT_MS = 50;                    // 关闭时等待在途数据的时间
+constexpr size_t MAX_IDLE_PER_PEER = 4;                 // 每个对端保留的空闲连接数量
+constexpr size_t MAX_IDLE = 16;                         // 空闲连接总数
+constexpr auto IDLE_TIMEOUT = std::chrono::seconds(15); // 空闲超时，短于常见服务器的 keep-alive 超时
+
+using Clock = std::chrono::steady_clock;
+
+void SetNetError(const std::string &message) { git_error_set_str(GIT_ERROR_NET, message.c_str()); }
+
+void SetTlsError(const std::string &message, int ret) {
+    char buffer[128] = {0};
+    mbedtls_strerror(ret, buffer, sizeof(buffer));
+    git_error_set_str(GIT_ERROR_SSL, (message + ": " + buffer).c_str());
+}
+
+// 普通TCP连接
+struct SocketStream {
+    git_stream parent;
+    std::string host;
+    std::string port;
+    int fd = -1;
+};
+
+int SocketConnect(git_stream *stream) {
+    auto *st = reinterpret_cast<SocketStream *>(stream);
+    int connectTimeout = st->parent.connect_timeout > 0 ? st->parent.connect_timeout : DEFAULT_CONNECT_TIMEOUT_MS;
+    int timeout = st->parent.timeout > 0 ? st->parent.timeout : DEFAULT_TIMEOUT_MS;
+    std::string error;
+    st->fd = Socket::Connect(st->host, st->port, connectTimeout, timeout, error);
+    if (st->fd < 0) {
+        SetNetError(error);
+        return -1;
+    }
+    return 0;
+}
+
+ssize_t SocketRead(git_stream *stream, void *data, size_t len) {
+    auto *st = reinterpret_cast<SocketStream *>(stream);
+    ssize_t ret;
+    do {
+        ret = recv(st->fd, data, len, 0);
+    } while (ret < 0 && errno == EINTR);
+    if (ret < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            git_error_set_str(GIT_ERROR_NET, "read timed out");
+            return GIT_TIMEOUT;
+        }
+        SetNetError(std::string("error receiving data from socket: ") + std::strerror(errno));
+        return -1;
+    }
+    return ret;
+}
+
+ssize_t SocketWrite(git_stream *stream, const char *data, size_t len, int flags) {
+    auto *st = reinterpret_cast<SocketStream *>(stream);
+    ssize_t ret;
+    do {
+        ret = send(st->fd, data, len, MSG_NOSIGNAL);
+    } while (ret < 0 && errno == EINTR);
+    if (ret < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            git_error_set_str(GIT_ERROR_NET, "write timed out");
+            return GIT_TIMEOUT;
+        }
+        SetNetError(std::string("error sending data to socket: ") + std::strerror(errno));
+        return -1;
+    }
+    return ret;
+}
+
+int SocketClose(git_stream *stream) {
+    auto *st = reinterpret_cast<SocketStream *>(stream);
+    if (st->fd >= 0) {
+        ::close(st->fd);
+        st->fd = -1;
+    }
+    return 0;
+}
+
+void SocketFree(git_stream *stream) {
+    auto *st = reinterpret_cast<SocketStream *>(stream);
+    SocketClose(stream);
+    delete st;
+}
+
+git_stream *NewSocketStream(const char *host, const char *port) {
+    auto *st = new SocketStream();
+    st->parent.version = GIT_STREAM_VERSION;
+    st->parent.connect = SocketConnect;
+    st->parent.read = SocketRead;
+    st->parent.write = SocketWrite;
+    st->parent.close = SocketClose;
+    st->parent.free = SocketFree;
+    st->host = host;
+    st->port = port;
+    return &st->parent;
+}
+
+// 已建立的TLS连接，可在 git_stream 释放后放回连接池
+struct TlsSession {
+    git_stream *io = nullptr;         ///< 下层流
+    bool ownsIo = false;              ///< 是否负责连接和释放下层流（经代理时为false）
+    bool connected = false;           ///< 握手是否完成
+    bool verified = false;            ///< 证书是否校验通过
+    bool broken = false;              ///< 读写是否出错
+    std::string host;                 ///< 主机名
+    std::string peer;                 ///< 连接池和会话缓存的键（主机:端口）
+    TrustStore::Chain chain;          ///< 连接期间持有的证书链
+    Clock::time_point idleSince;      ///< 放回连接池的时间
+    mbedtls_entropy_context entropy;
+    mbedtls_ctr_drbg_context drbg;
+    mbedtls_ssl_config conf;
+    mbedtls_ssl_context ssl;
+
+    TlsSession(git_stream *stream, bool owns, const char *hostName, std::string peerName)
+        : io(stream), ownsIo(owns), host(hostName), peer(std::move(peerName)) {
+        mbedtls_entropy_init(&entropy);
+        mbedtls_ctr_drbg_init(&drbg);
+        mbedtls_ssl_config_init(&conf);
+        mbedtls_ssl_init(&ssl);
+    }
+
+    ~TlsSession() {
+        close();
+        if (ownsIo) {
+            io->free(io);
+        }
+        mbedtls_ssl_free(&ssl);
+        mbedtls_ssl_config_free(&conf);
+        mbedtls_ctr_drbg_free(&drbg);
+        mbedtls_entropy_free(&entropy);
+    }
+
+    TlsSession(const TlsSession &) = delete;
+    TlsSession &operator=(const TlsSession &) = delete;
+
+    int close() {
+        if (connected) {
+            mbedtls_ssl_close_notify(&ssl);
+            connected = false;
+        }
+        return ownsIo ? io->close(io) : 0;
+    }
+
+    int socket() const { return ownsIo ? reinterpret_cast<SocketStream *>(io)->fd : -1; }
+};
+
+// 交给 libgit2 的流，连接本身在 session 中
+struct TlsConnection {
+    git_stream parent;
+    std::unique_ptr<TlsSession> session;
+    git_cert_x509 certificate; ///< 对端证书，数据指向 session 内部
+};
+
+/**
+ * @brief 空闲的HTTPS连接池
+ * libgit2 在每个 git_remote 断开时关闭连接，同一托管平台的下一次操作又要重新建立TCP和TLS。
+ * 连接关闭时若处于空闲状态（上一个响应已读完），放回池中，之后到同一对端的连接直接复用
+ */
+class IdlePool {
+public:
+    static IdlePool &Shared() {
+        static IdlePool pool;
+        return pool;
+    }
+
+    // 取出一个仍然可用的空闲连接
+    std::unique_ptr<TlsSession> take(const std::string &peer) {
+        std::vector<std::unique_ptr<TlsSession>> expired;
+        std::unique_ptr<TlsSession> result;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto now = Clock::now();
+            auto it = idle_.find(peer);
+            while (it != idle_.end() && !it->second.empty() && result == nullptr) {
+                auto session = std::move(it->second.back());
+                it->second.pop_back();
+                --count_;
+                // 超时或对端已发来数据（通常是关闭连接）的不再使用
+                if (now - session->idleSince < IDLE_TIMEOUT && !Socket::Readable(session->socket())) {
+                    result = std::move(session);
+                } else {
+                    expired.push_back(std::move(session));
+                }
+            }
+            if (it != idle_.end() && it->second.empty()) {
+                idle_.erase(it);
+            }
+        }
+        // 在锁外关闭连接
+        expired.clear();
+        return result;
+    }
+
+    // 放回空闲连接，超出数量上限时关闭最久未用的连接
+    void put(std::unique_ptr<TlsSession> session) {
+        std::vector<std::unique_ptr<TlsSession>> evicted;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            session->idleSince = Clock::now();
+            auto &sessions = idle_[session->peer];
+            sessions.insert(sessions.begin(), std::move(session));
+            ++count_;
+            if (sessions.size() > MAX_IDLE_PER_PEER) {
+                evicted.push_back(std::move(sessions.back()));
+                sessions.pop_back();
+                --count_;
+            }
+            if (count_ > MAX_IDLE) {
+                evictOldestLocked(evicted);
+            }
+        }
+        evicted.clear();
+    }
+
+    // 关闭所有空闲连接
+    void clear() {
+        std::unordered_map<std::string, std::vector<std::unique_ptr<TlsSession>>> idle;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            idle.swap(idle_);
+            count_ = 0;
+        }
+    }
+
+private:
+    void evictOldestLocked(std::vector<std::unique_ptr<TlsSession>> &evicted) {
+        auto oldest = idle_.end();
+        for (auto it = idle_.begin(); it != idle_.end(); ++it) {
+            if (!it->second.empty() &&
+                (oldest == idle_.end() || it->second.back()->idleSince < oldest->second.back()->idleSince)) {
+                oldest = it;
+            }
+        }
+        if (oldest == idle_.end()) {
+            return;
+        }
+        evicted.push_back(std::move(oldest->second.back()));
+        oldest->second.pop_back();
+        --count_;
+        if (oldest->second.empty()) {
+            idle_.erase(oldest);
+        }
+    }
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::vector<std::unique_ptr<TlsSession>>> idle_; ///< 对端到空闲连接，新的在前
+    size_t count_ = 0;                                                             ///< 空闲连接总数
+};
+
+/**
+ * @brief 判断连接在关闭时是否空闲，可以复用
+ * git_stream 接口不会告知 HTTP 层是否读完了响应，这里也不解析 HTTP：只有 TLS 层没有未处理的数据，
+ * 且短暂等待后套接字上仍没有数据到达时，才认为上一个响应已被完全读取。
+ * 响应还有剩余（例如未读的 chunked 结束块）时关闭连接，避免残留数据混入下一个请求
+ */
+bool IsIdle(TlsSession &session) {
+    if (mbedtls_ssl_check_pending(&session.ssl) != 0) {
+        return false;
+    }
+    return !Socket::Readable(session.socket(), DRAIN_TIMEOUT_MS);
+}
+
+int BioSend(void *ctx, const unsigned char *buf, size_t len) {
+    auto *io = static_cast<git_stream *>(ctx);
+    ssize_t ret = io->write(io, reinterpret_cast<const char *>(buf), len, 0);
+    return ret < 0 ? MBEDTLS_ERR_NET_SEND_FAILED : static_cast<int>(ret);
+}
+
+int BioRecv(void *ctx, unsigned char *buf, size_t len) {
+    auto *io = static_cast<git_stream *>(ctx);
+    ssize_t ret = io->read(io, buf, len);
+    return ret < 0 ? MBEDTLS_ERR_NET_RECV_FAILED : static_cast<int>(ret);
+}
+
+int Handshake(TlsConnection *st) {
+    TlsSession &session = *st->session;
+
+    if (session.ownsIo) {
+        session.io->timeout = st->parent.timeout;
+        session.io->connect_timeout = st->parent.connect_timeout;
+        if (session.io->connect(session.io) < 0) {
+            return -1;
+        }
+    }
+
+    // 证书链可能仍在后台加载，此处等待
+    session.chain = TrustStore::Shared().chain();
+    if (session.chain == nullptr) {
+        OH_LOG_WARN(LOG_APP, "Trust store is empty, certificate of %{public}s cannot be verified",
+                    session.host.c_str());
+    }
+
+    const char *pers = "higit_tls";
+    int ret = mbedtls_ctr_drbg_seed(&session.drbg, mbedtls_entropy_func, &session.entropy,
+                                    reinterpret_cast<const unsigned char *>(pers), strlen(pers));
+    if (ret == 0) {
+        ret = mbedtls_ssl_config_defaults(&session.conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                          MBEDTLS_SSL_PRESET_DEFAULT);
+    }
+    if (ret != 0) {
+        SetTlsError("failed to initialize TLS", ret);
+        return -1;
+    }
+
+    // 校验结果在握手后检查，交给 certificate_check 回调决定是否继续
+    mbedtls_ssl_conf_authmode(&session.conf, MBEDTLS_SSL_VERIFY_OPTIONAL);
+    mbedtls_ssl_conf_ca_chain(&session.conf, session.chain.get(), nullptr);
+    mbedtls_ssl_conf_rng(&session.conf, mbedtls_ctr_drbg_random, &session.drbg);
+    mbedtls_ssl_conf_min_tls_version(&session.conf, MBEDTLS_SSL_VERSION_TLS1_2);
+#ifndef MBEDTLS_THREADING_C
+    // TLS 1.3 的密钥交换经过 PSA 的全局密钥槽，未启用 MBEDTLS_THREADING_C 时不加锁，
+    // 多个仓库同时拉取时的并发握手会相互破坏；TLS 1.2 走不依赖全局状态的旧接口。启用线程支持后自动协商 TLS 1.3
+    mbedtls_ssl_conf_max_tls_version(&session.conf, MBEDTLS_SSL_VERSION_TLS1_2);
+#endif
+    mbedtls_ssl_conf_session_tickets(&session.conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+
+    ret = mbedtls_ssl_setup(&session.ssl, &session.conf);
+    if (ret == 0) {
+        ret = mbedtls_ssl_set_hostname(&session.ssl, session.host.c_str());
+    }
+    if (ret != 0) {
+        SetTlsError("failed to set up TLS session", ret);
+        return -1;
+    }
+    mbedtls_ssl_set_bio(&session.ssl, session.io, BioSend, BioRecv, nullptr);
+
+    // 服务器不接受缓存的会话时自动进行完整握手
+    bool resuming = TlsSessionCache::Shared().restore(session.peer, &session.ssl);
+
+    do {
+        ret = mbedtls_ssl_handshake(&session.ssl);
+    } while (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+
+    if (ret != 0 && ret != MBEDTLS_ERR_X509_CERT_VERIFY_FAILED) {
+        if (resuming) {
+            TlsSessionCache::Shared().remove(session.peer);
+        }
+        SetTlsError("TLS handshake with " + session.host + " failed", ret);
+        return -1;
+    }
+    session.connected = true;
+
+    uint32_t flags = mbedtls_ssl_get_verify_result(&session.ssl);
+    if (ret != 0 || flags != 0) {
+        // 未通过校验的会话不缓存，下次连接仍完整校验证书
+        TlsSessionCache::Shared().remove(session.peer);
+        char info[256] = {0};
+        mbedtls_x509_crt_verify_info(info, sizeof(info), "", flags);
+        git_error_set_str(GIT_ERROR_SSL, ("the SSL certificate is invalid: " + std::string(info)).c_str());
+        return GIT_ECERTIFICATE;
+    }
+
+    session.verified = true;
+    TlsSessionCache::Shared().store(session.peer, &session.ssl);
+    return 0;
+}
+
+int TlsConnect(git_stream *stream) {
+    auto *st = reinterpret_cast<TlsConnection *>(stream);
+    // 从连接池取出的连接已经完成握手和校验
+    if (st->session->connected) {
+        return 0;
+    }
+    return Handshake(st);
+}
+
+int TlsCertificate(git_cert **out, git_stream *stream) {
+    auto *st = reinterpret_cast<TlsConnection *>(stream);
+    const mbedtls_x509_crt *peer =
+        st->session != nullptr ? mbedtls_ssl_get_peer_cert(&st->session->ssl) : nullptr;
+    if (peer == nullptr || peer->raw.len == 0) {
+        git_error_set_str(GIT_ERROR_SSL, "the server did not provide a certificate");
+        return -1;
+    }
+    st->certificate.parent.cert_type = GIT_CERT_X509;
+    st->certificate.data = peer->raw.p;
+    st->certificate.len = peer->raw.len;
+    *out = &st->certificate.parent;
+    return 0;
+}
+
+int TlsSetProxy(git_stream *stream, const git_proxy_options *proxy) {
+    git_error_set_str(GIT_ERROR_NET, "TLS stream does not support proxies directly");
+    return -1;
+}
+
+ssize_t TlsRead(git_stream *stream, void *data, size_t len) {
+    auto *st = reinterpret_cast<TlsConnection *>(stream);
+    if (st->session == nullptr) {
+        git_error_set_str(GIT_ERROR_NET, "TLS stream is closed");
+        return -1;
+    }
+    int ret;
+    do {
+        ret = mbedtls_ssl_read(&st->session->ssl, static_cast<unsigned char *>(data), len);
+    } while (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+
+    if (ret == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY || ret == 0) {
+        st->session->broken = true;
+        return 0;
+    }
+    if (ret < 0) {
+        st->session->broken = true;
+        SetTlsError("error reading from TLS stream", ret);
+        return -1;
+    }
+    return ret;
+}
+
+ssize_t TlsWrite(git_stream *stream, const char *data, size_t len, int flags) {
+    auto *st = reinterpret_cast<TlsConnection *>(stream);
+    if (st->session == nullptr) {
+        git_error_set_str(GIT_ERROR_NET, "TLS stream is closed");
+        return -1;
+    }
+    int ret;
+    do {
+        ret = mbedtls_ssl_write(&st->session->ssl, reinterpret_cast<const unsigned char *>(data), len);
+    } while (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+
+    if (ret < 0) {
+        st->session->broken = true;
+        SetTlsError("error writing to TLS stream", ret);
+        return -1;
+    }
+    return ret;
+}
+
+int TlsClose(git_stream *stream) {
+    auto *st = reinterpret_cast<TlsConnection *>(stream);
+    if (st->session == nullptr) {
+        return 0;
+    }
+    auto session = std::move(st->session);
+    // 只复用直连、校验通过且上一个响应已读完的连接
+    if (session->connected && session->verified && !session->broken && session->ownsIo && IsIdle(*session)) {
+        IdlePool::Shared().put(std::move(session));
+        return 0;
+    }
+    return session->close();
+}
+
+void TlsFree(git_stream *stream) {
+    auto *st = reinterpret_cast<TlsConnection *>(stream);
+    delete st;
+}
+
+git_stream *NewTlsConnection(std::unique_ptr<TlsSession> session) {
+    auto *st = new TlsConnection();
+    st->parent.version = GIT_STREAM_VERSION;
+    st->parent.encrypted = 1;
+    st->parent.proxy_support = 0;
+    st->parent.connect = TlsConnect;
+    st->parent.certificate = TlsCertificate;
+    st->parent.set_proxy = TlsSetProxy;
+    st->parent.read = TlsRead;
+    st->parent.write = TlsWrite;
+    st->parent.close = TlsClose;
+    st->parent.free = TlsFree;
+    st->session = std::move(session);
+    return &st->parent;
+}
+} // namespace
+
+bool TlsStream::Register() {
+    // 启用 TLS 1.3 编译选项的 mbedTLS 要求在任何TLS调用前初始化 PSA
+    psa_status_t status = psa_crypto_init();
+    if (status != PSA_SUCCESS) {
+        OH_LOG_ERROR(LOG_APP, "Failed to initialize PSA crypto: %{public}d", static_cast<int>(status));
+        return false;
+    }
+
+#ifndef MBEDTLS_THREADING_C
+    OH_LOG_INFO(LOG_APP, "mbedTLS built without MBEDTLS_THREADING_C, HTTPS limited to TLS 1.2");
+#endif
+
+    git_stream_registration registration{};
+    registration.version = GIT_STREAM_VERSION;
+    registration.init = TlsStream::Init;
+    registration.wrap = TlsStream::Wrap;
+    if (git_stream_register(GIT_STREAM_TLS, &registration) != 0) {
+        const git_error *error = git_error_last();
+        OH_LOG_ERROR(LOG_APP, "Failed to register TLS stream: %{public}s", error != nullptr ? error->message : "");
+        return false;
+    }
+    return true;
+}
+
+int TlsStream::Init(git_stream **out, const char *host, const char *port) {
+    std::string peer = std::string(host) + ":" + port;
+    auto session = IdlePool::Shared().take(peer);
+    if (session != nullptr) {
+        OH_LOG_DEBUG(LOG_APP, "Reuse idle TLS connection to %{public}s", peer.c_str());
+    } else {
+        session = std::make_unique<TlsSession>(NewSocketStream(host, port), true, host, std::move(peer));
+    }
+    *out = NewTlsConnection(std::move(session));
+    return 0;
+}
+
+int TlsStream::Wrap(git_stream **out, git_stream *in, const char *host) {
+    // 经代理建立的隧道没有端口信息，按主机区分会话，且不放回连接池
+    *out = NewTlsConnection(std::make_unique<TlsSession>(in, false, host, std::string(host) + ":proxy"));
+    return 0;
+}
+
+void TlsStream::CloseIdleConnections() { IdlePool::Shared().clear(); }
@@ -0,0 +1,139 @@
+#include "tracer.h"
+#include "utils/log.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <git2.h>
+#include <nlohmann/json.hpp>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+// libgit2 的 trace 输出（HTTP 请求、协议协商等）记为即时事件
+void OnLibgit2Trace(git_trace_level_t level, const char *message) {
+    (void)level;
+    if (message != nullptr) {
+        Tracer::Shared().instant("libgit2", message);
+    }
+}
+
+uint32_t CurrentThreadId() {
+    static thread_local uint32_t tid = static_cast<uint32_t>(syscall(SYS_gettid));
+    return tid;
+}
+} // namespace
+
+Tracer &Tracer::Shared() {
+    static Tracer tracer;
+    return tracer;
+}
+
+void Tracer::setEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (enabled == this->enabled()) {
+        return;
+    }
+    if (!enabled) {
+        git_trace_set(GIT_TRACE_NONE, nullptr);
+        enabled_.store(false, std::memory_order_release);
+        return;
+    }
+
+    if (slots_ == nullptr) {
+        slots_ = std::make_unique<Slot[]>(CAPACITY);
+    }
+    first_.store(next_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    enabled_.store(true, std::memory_order_release);
+    // libgit2 未启用 GIT_TRACE 编译选项时只记录原生埋点
+    if (git_trace_set(GIT_TRACE_TRACE, OnLibgit2Trace) != 0) {
+        OH_LOG_WARN(LOG_APP, "libgit2 tracing is not available");
+    }
+}
+
+void Tracer::complete(const char *category, std::string_view name, int64_t startUs, int64_t durationUs) {
+    record('X', category, name, startUs, durationUs);
+}
+
+void Tracer::instant(const char *category, std::string_view name) { record('i', category, name, NowMicros(), 0); }
+
+void Tracer::record(char phase, const char *category, std::string_view name, int64_t timestamp, int64_t duration) {
+    // 区间可能在关闭之后才结束，此时不再记录
+    if (!enabled()) {
+        return;
+    }
+    uint64_t index = next_.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = slots_[index % CAPACITY];
+    // 缓冲区绕过一圈时可能有另一个线程正在写同一槽位，此时丢弃本事件
+    uint64_t current = slot.sequence.load(std::memory_order_relaxed);
+    if ((current & 1) != 0 ||
+        !slot.sequence.compare_exchange_strong(current, 2 * index + 1, std::memory_order_acquire,
+                                               std::memory_order_relaxed)) {
+        return;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    size_t length = std::min(name.size(), MAX_NAME);
+    std::memcpy(slot.name, name.data(), length);
+    slot.name[length] = '\0';
+    slot.category = category;
+    slot.phase = phase;
+    slot.tid = CurrentThreadId();
+    slot.timestamp = timestamp;
+    slot.duration = duration;
+
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+std::string Tracer::exportJson() const {
+    nlohmann::json events = nlohmann::json::array();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (slots_ != nullptr) {
+        uint64_t end = next_.load(std::memory_order_acquire);
+        uint64_t begin = std::max(first_.load(std::memory_order_relaxed), end > CAPACITY ? end - CAPACITY : 0);
+        int pid = static_cast<int>(getpid());
+        for (uint64_t index = begin; index < end; ++index) {
+            const Slot &slot = slots_[index % CAPACITY];
+            uint64_t expected = 2 * index + 2;
+            if (slot.sequence.load(std::memory_order_acquire) != expected) {
+                continue;
+            }
+            char name[MAX_NAME + 1];
+            std::memcpy(name, slot.name, sizeof(name));
+            name[MAX_NAME] = '\0';
+            const char *category = slot.category;
+            char phase = slot.phase;
+            uint32_t tid = slot.tid;
+            int64_t timestamp = slot.timestamp;
+            int64_t duration = slot.duration;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            // 读取期间被新事件覆盖的槽位丢弃
+            if (slot.sequence.load(std::memory_order_relaxed) != expected) {
+                continue;
+            }
+
+            nlohmann::json event = {
+                {"name", name}, {"cat", category}, {"ph", std::string(1, phase)},
+                {"ts", timestamp}, {"pid", pid}, {"tid", tid},
+            };
+            if (phase == 'X') {
+                event["dur"] = duration;
+            } else {
+                event["s"] = "t";
+            }
+            events.push_back(std::move(event));
+        }
+    }
+
+    nlohmann::json trace = {
+        {"traceEvents", std::move(events)},
+        {"displayTimeUnit", "ms"},
+    };
+    // 截断的事件名可能不是完整的 UTF-8
+    return trace.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+}
+
+int64_t Tracer::NowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
@@ -0,0 +1,194 @@
+#include "trust_store.h"
+#include "thread_pool.h"
+#include "utils/log.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+#include <vector>
+
+namespace {
+constexpr char CACHE_MAGIC[4] = {'H', 'G', 'C', 'A'};
+constexpr uint32_t CACHE_VERSION = 1;
+
+// 缓存文件头，证书包的大小和修改时间用于判断缓存是否失效
+struct CacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t bundleSize;
+    int64_t bundleTime;
+    uint32_t count;
+};
+
+// buffer 不为空时证书链直接引用其中的DER数据，随证书链一起释放
+TrustStore::Chain NewChain(std::shared_ptr<std::vector<unsigned char>> buffer = nullptr) {
+    auto *crt = new mbedtls_x509_crt;
+    mbedtls_x509_crt_init(crt);
+    return TrustStore::Chain(crt, [buffer = std::move(buffer)](mbedtls_x509_crt *p) {
+        mbedtls_x509_crt_free(p);
+        delete p;
+    });
+}
+
+size_t CountCertificates(const mbedtls_x509_crt *crt) {
+    size_t count = 0;
+    for (; crt != nullptr && crt->raw.len > 0; crt = crt->next) {
+        ++count;
+    }
+    return count;
+}
+} // namespace
+
+TrustStore &TrustStore::Shared() {
+    static TrustStore store;
+    return store;
+}
+
+void TrustStore::loadAsync(const std::string &bundlePath, const std::string &cachePath) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++pending_;
+    }
+    ThreadPool::Shared().submit([this, bundlePath, cachePath]() {
+        load(bundlePath, cachePath);
+        std::lock_guard<std::mutex> lock(mutex_);
+        --pending_;
+        cv_.notify_all();
+    });
+}
+
+bool TrustStore::load(const std::string &bundlePath, const std::string &cachePath) {
+    auto start = std::chrono::steady_clock::now();
+
+    struct stat st {};
+    if (stat(bundlePath.c_str(), &st) != 0) {
+        OH_LOG_WARN(LOG_APP, "CA bundle not found: %{public}s", bundlePath.c_str());
+        return false;
+    }
+    auto bundleSize = static_cast<size_t>(st.st_size);
+    auto bundleTime = static_cast<int64_t>(st.st_mtime);
+
+    bool fromCache = false;
+    Chain chain = cachePath.empty() ? nullptr : LoadCache(cachePath, bundleSize, bundleTime);
+    if (chain != nullptr) {
+        fromCache = true;
+    } else {
+        chain = NewChain();
+        // 返回值大于0表示部分证书无法解析，其余证书仍然可用
+        int ret = mbedtls_x509_crt_parse_file(chain.get(), bundlePath.c_str());
+        if (ret < 0 || CountCertificates(chain.get()) == 0) {
+            OH_LOG_ERROR(LOG_APP, "Failed to parse CA bundle %{public}s: %{public}d", bundlePath.c_str(), ret);
+            return false;
+        }
+        if (ret > 0) {
+            OH_LOG_WARN(LOG_APP, "%{public}d certificates in CA bundle could not be parsed", ret);
+        }
+        if (!cachePath.empty()) {
+            SaveCache(*chain, cachePath, bundleSize, bundleTime);
+        }
+    }
+
+    size_t count = CountCertificates(chain.get());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        chain_ = std::move(chain);
+        size_ = count;
+    }
+
+    auto elapsed =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    OH_LOG_INFO(LOG_APP, "Trust store loaded %{public}zu certificates from %{public}s in %{public}lldms", count,
+                fromCache ? "DER cache" : "PEM bundle", static_cast<long long>(elapsed));
+    return true;
+}
+
+TrustStore::Chain TrustStore::chain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return pending_ == 0; });
+    return chain_;
+}
+
+size_t TrustStore::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_;
+}
+
+TrustStore::Chain TrustStore::LoadCache(const std::string &cachePath, size_t bundleSize, int64_t bundleTime) {
+    std::ifstream file(cachePath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+    auto fileSize = static_cast<size_t>(file.tellg());
+    if (fileSize < sizeof(CacheHeader)) {
+        return nullptr;
+    }
+    auto buffer = std::make_shared<std::vector<unsigned char>>(fileSize);
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char *>(buffer->data()), static_cast<std::streamsize>(fileSize))) {
+        return nullptr;
+    }
+
+    CacheHeader header{};
+    std::memcpy(&header, buffer->data(), sizeof(header));
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION ||
+        header.bundleSize != bundleSize || header.bundleTime != bundleTime || header.count == 0) {
+        return nullptr;
+    }
+
+    Chain chain = NewChain(buffer);
+    size_t offset = sizeof(header);
+    for (uint32_t i = 0; i < header.count; ++i) {
+        uint32_t length = 0;
+        if (offset + sizeof(length) > fileSize) {
+            return nullptr;
+        }
+        std::memcpy(&length, buffer->data() + offset, sizeof(length));
+        offset += sizeof(length);
+        if (length == 0 || offset + length > fileSize) {
+            return nullptr;
+        }
+        if (mbedtls_x509_crt_parse_der_nocopy(chain.get(), buffer->data() + offset, length) != 0) {
+            // 缓存损坏，重新解析证书包
+            OH_LOG_WARN(LOG_APP, "Trust store cache is corrupted: %{public}s", cachePath.c_str());
+            return nullptr;
+        }
+        offset += length;
+    }
+    return chain;
+}
+
+void TrustStore::SaveCache(const mbedtls_x509_crt &chain, const std::string &cachePath, size_t bundleSize,
+                           int64_t bundleTime) {
+    // 先写临时文件再改名，避免其他进程读到写了一半的缓存
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            OH_LOG_WARN(LOG_APP, "Failed to create trust store cache: %{public}s", tempPath.c_str());
+            return;
+        }
+
+        CacheHeader header{};
+        std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        header.version = CACHE_VERSION;
+        header.bundleSize = bundleSize;
+        header.bundleTime = bundleTime;
+        header.count = static_cast<uint32_t>(CountCertificates(&chain));
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+        for (const mbedtls_x509_crt *crt = &chain; crt != nullptr && crt->raw.len > 0; crt = crt->next) {
+            auto length = static_cast<uint32_t>(crt->raw.len);
+            file.write(reinterpret_cast<const char *>(&length), sizeof(length));
+            file.write(reinterpret_cast<const char *>(crt->raw.p), length);
+        }
+        if (!file) {
+            OH_LOG_WARN(LOG_APP, "Failed to write trust store cache: %{public}s", tempPath.c_str());
+            std::remove(tempPath.c_str());
+            return;
+        }
+    }
+    if (std::rename(tempPath.c_str(), cachePath.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+    }
+}
@@ -0,0 +1,113 @@
+#include "word_diff.h"
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+// 超过该规模的LCS表不再计算，避免单行过长时耗时和内存失控
+constexpr size_t MAX_LCS_CELLS = 128 * 1024;
+
+struct Token {
+    uint32_t begin;
+    uint32_t end;
+};
+
+bool isWordByte(unsigned char c) { return c == '_' || c >= 0x80 || std::isalnum(c); }
+
+bool isSpaceByte(unsigned char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+std::vector<Token> tokenize(std::string_view line) {
+    std::vector<Token> tokens;
+    size_t i = 0;
+    while (i < line.size()) {
+        size_t start = i;
+        auto c = static_cast<unsigned char>(line[i]);
+        if (isWordByte(c)) {
+            while (i < line.size() && isWordByte(static_cast<unsigned char>(line[i]))) {
+                ++i;
+            }
+        } else if (isSpaceByte(c)) {
+            while (i < line.size() && isSpaceByte(static_cast<unsigned char>(line[i]))) {
+                ++i;
+            }
+        } else {
+            ++i;
+        }
+        tokens.push_back({static_cast<uint32_t>(start), static_cast<uint32_t>(i)});
+    }
+    return tokens;
+}
+
+void appendRange(std::vector<HighlightRange> &ranges, const Token &token) {
+    if (!ranges.empty() && ranges.back().second == token.begin) {
+        ranges.back().second = token.end;
+    } else {
+        ranges.emplace_back(token.begin, token.end);
+    }
+}
+
+} // namespace
+
+namespace WordDiff {
+
+bool diffLines(std::string_view oldLine, std::string_view newLine, std::vector<HighlightRange> &oldRanges,
+               std::vector<HighlightRange> &newRanges) {
+    oldRanges.clear();
+    newRanges.clear();
+
+    auto oldTokens = tokenize(oldLine);
+    auto newTokens = tokenize(newLine);
+    size_t n = oldTokens.size();
+    size_t m = newTokens.size();
+    if (n == 0 || m == 0 || (n + 1) * (m + 1) > MAX_LCS_CELLS) {
+        return false;
+    }
+
+    auto equals = [&](size_t i, size_t j) {
+        return oldLine.substr(oldTokens[i].begin, oldTokens[i].end - oldTokens[i].begin) ==
+               newLine.substr(newTokens[j].begin, newTokens[j].end - newTokens[j].begin);
+    };
+
+    // lcs[i][j] 为 old[i..] 与 new[j..] 的最长公共子序列长度
+    std::vector<uint16_t> lcs((n + 1) * (m + 1), 0);
+    auto at = [m](size_t i, size_t j) { return i * (m + 1) + j; };
+    for (size_t i = n; i-- > 0;) {
+        for (size_t j = m; j-- > 0;) {
+            lcs[at(i, j)] = equals(i, j) ? lcs[at(i + 1, j + 1)] + 1
+                                         : std::max(lcs[at(i + 1, j)], lcs[at(i, j + 1)]);
+        }
+    }
+
+    size_t i = 0;
+    size_t j = 0;
+    size_t commonWords = 0;
+    while (i < n && j < m) {
+        if (equals(i, j)) {
+            if (!isSpaceByte(static_cast<unsigned char>(oldLine[oldTokens[i].begin]))) {
+                ++commonWords;
+            }
+            ++i;
+            ++j;
+        } else if (lcs[at(i + 1, j)] >= lcs[at(i, j + 1)]) {
+            appendRange(oldRanges, oldTokens[i++]);
+        } else {
+            appendRange(newRanges, newTokens[j++]);
+        }
+    }
+    while (i < n) {
+        appendRange(oldRanges, oldTokens[i++]);
+    }
+    while (j < m) {
+        appendRange(newRanges, newTokens[j++]);
+    }
+
+    // 两行几乎没有共同内容时整行都是差异，行内高亮没有意义
+    if (commonWords == 0) {
+        oldRanges.clear();
+        newRanges.clear();
+        return false;
+    }
+    return true;
+}
+
+} // namespace WordDiff
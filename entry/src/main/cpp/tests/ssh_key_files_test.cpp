@@ -0,0 +1,97 @@
+// higit_ssh_key_files_test：SSHManager::ReplaceKeyFiles 替换密钥文件
+// 把目标私钥路径换成非空目录即可让第二次重命名失败，检查原公钥被恢复
+
+#include "ssh_manager.h"
+#include "test_support.h"
+#include "utils/log.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+void WriteFile(const std::string &path, const std::string &content) { std::ofstream(path) << content; }
+
+std::string ReadFile(const std::string &path) {
+    std::ifstream file(path);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+// 每个用例一个空目录，结束时删除
+struct KeyDir {
+    std::string path;
+    SSHKeyPaths target;
+    SSHKeyPaths staged;
+
+    KeyDir() {
+        char pattern[] = "/tmp/higit-keys-XXXXXX";
+        path = mkdtemp(pattern);
+        target = {path + "/id_ecdsa", path + "/id_ecdsa.pub"};
+        staged = {target.privateKey + ".tmp", target.publicKey + ".tmp"};
+        WriteFile(staged.privateKey, "new private");
+        WriteFile(staged.publicKey, "new public");
+    }
+
+    ~KeyDir() {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+    }
+};
+
+void TestReplacesKeyPair() {
+    KeyDir dir;
+    WriteFile(dir.target.privateKey, "old private");
+    WriteFile(dir.target.publicKey, "old public");
+
+    std::string error;
+    REQUIRE(SSHManager::ReplaceKeyFiles(dir.staged, dir.target, error));
+    CHECK(error.empty());
+    CHECK(ReadFile(dir.target.privateKey) == "new private");
+    CHECK(ReadFile(dir.target.publicKey) == "new public");
+    CHECK(!std::filesystem::exists(dir.staged.privateKey));
+    CHECK(!std::filesystem::exists(dir.staged.publicKey));
+    CHECK(!std::filesystem::exists(dir.target.publicKey + ".bak"));
+}
+
+void TestRestoresPublicKeyWhenPrivateRenameFails() {
+    KeyDir dir;
+    // 目标是非空目录时 rename 失败，原“私钥”保持不变
+    std::filesystem::create_directory(dir.target.privateKey);
+    WriteFile(dir.target.privateKey + "/keep", "old private");
+    WriteFile(dir.target.publicKey, "old public");
+
+    std::string error;
+    CHECK(!SSHManager::ReplaceKeyFiles(dir.staged, dir.target, error));
+    CHECK(!error.empty());
+    CHECK(ReadFile(dir.target.publicKey) == "old public");
+    CHECK(ReadFile(dir.target.privateKey + "/keep") == "old private");
+    CHECK(!std::filesystem::exists(dir.target.publicKey + ".bak"));
+    // 临时文件由调用方清理
+    CHECK(ReadFile(dir.staged.privateKey) == "new private");
+}
+
+void TestRemovesNewPublicKeyWithoutOldOne() {
+    KeyDir dir;
+    std::filesystem::create_directory(dir.target.privateKey);
+    WriteFile(dir.target.privateKey + "/keep", "");
+
+    std::string error;
+    CHECK(!SSHManager::ReplaceKeyFiles(dir.staged, dir.target, error));
+    CHECK(!std::filesystem::exists(dir.target.publicKey));
+}
+
+} // namespace
+
+int main() {
+    Log::SetMinLevel(Log::Warn);
+    return Test::Run({
+        {"key pair is replaced", TestReplacesKeyPair},
+        {"old public key is restored when the private key rename fails", TestRestoresPublicKeyWhenPrivateRenameFails},
+        {"new public key is removed when there was no old one", TestRemovesNewPublicKeyWithoutOldOne},
+    });
+}
@@ -0,0 +1,369 @@
+// higit_ssh_test：SshTransport 的会话复用
+// 在回环地址上起一个临时的 sshd（自带主机密钥和 authorized_keys），远端是 SyntheticRepo 生成的裸仓库；
+// sshd 日志中 "Accepted publickey" 的行数即完成认证的会话数。没有 sshd 或 git-upload-pack 时跳过
+// （以 -DHIGIT_TEST_REQUIRE_SSHD=ON 配置时跳过即失败）
+
+#include "git_runtime.h"
+#include "ssh_manager.h"
+#include "ssh_transport.h"
+#include "synthetic_repo.h"
+#include "test_support.h"
+#include "utils/log.hpp"
+#include <arpa/inet.h>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <git2.h>
+#include <map>
+#include <memory>
+#include <netinet/in.h>
+#include <pwd.h>
+#include <sstream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr const char *SSHD_CANDIDATES[] = {"/usr/sbin/sshd", "/usr/bin/sshd", "/usr/local/sbin/sshd"};
+
+std::string FindSshd() {
+    if (const char *sshd = std::getenv("HIGIT_TEST_SSHD")) {
+        return sshd;
+    }
+    for (const char *path : SSHD_CANDIDATES) {
+        if (access(path, X_OK) == 0) {
+            return path;
+        }
+    }
+    return "";
+}
+
+// 取一个当前空闲的回环端口
+std::string FreePort() {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(addr);
+    std::string port;
+    if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0 &&
+        getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &length) == 0) {
+        port = std::to_string(ntohs(addr.sin_port));
+    }
+    close(fd);
+    return port;
+}
+
+bool CanConnect(const std::string &port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(static_cast<uint16_t>(std::stoi(port)));
+    bool connected = connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0;
+    close(fd);
+    return connected;
+}
+
+// 进程的所有后代，按 /proc/<pid>/stat 中的父进程号查找
+std::vector<pid_t> Descendants(pid_t root) {
+    std::multimap<pid_t, pid_t> children;
+    std::error_code ec;
+    for (auto &entry : std::filesystem::directory_iterator("/proc", ec)) {
+        std::ifstream stat(entry.path() / "stat");
+        std::string line;
+        if (!std::getline(stat, line)) {
+            continue;
+        }
+        // 第二个字段是带括号的进程名，其后依次为状态和父进程号
+        size_t end = line.rfind(')');
+        if (end == std::string::npos) {
+            continue;
+        }
+        std::istringstream fields(line.substr(end + 2));
+        char state = 0;
+        pid_t parent = 0;
+        fields >> state >> parent;
+        children.emplace(parent, static_cast<pid_t>(std::atoi(entry.path().filename().c_str())));
+    }
+    std::vector<pid_t> result;
+    std::vector<pid_t> pending{root};
+    while (!pending.empty()) {
+        pid_t pid = pending.back();
+        pending.pop_back();
+        auto range = children.equal_range(pid);
+        for (auto it = range.first; it != range.second; ++it) {
+            result.push_back(it->second);
+            pending.push_back(it->second);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief 临时的 sshd，只接受测试密钥的公钥认证
+ */
+class SshServer {
+public:
+    SshServer(std::string sshd, std::filesystem::path dir) : sshd_(std::move(sshd)), dir_(std::move(dir)) {}
+
+    ~SshServer() { stop(); }
+
+    bool start(const std::string &authorizedKey) {
+        if (std::system(("ssh-keygen -q -t ed25519 -N '' -f '" + (dir_ / "host_key").string() + "'").c_str()) != 0) {
+            return false;
+        }
+        std::ofstream(dir_ / "authorized_keys") << authorizedKey << "\n";
+        chmod((dir_ / "authorized_keys").c_str(), S_IRUSR | S_IWUSR);
+        // 以 root 运行时需要特权分离目录
+        mkdir("/run/sshd", S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH);
+
+        port_ = FreePort();
+        std::ofstream config(dir_ / "sshd_config");
+        config << "ListenAddress 127.0.0.1:" << port_ << "\n"
+               << "HostKey " << (dir_ / "host_key").string() << "\n"
+               << "PidFile " << (dir_ / "sshd.pid").string() << "\n"
+               << "AuthorizedKeysFile " << (dir_ / "authorized_keys").string() << "\n"
+               << "StrictModes no\n"
+               << "UsePAM no\n"
+               << "PasswordAuthentication no\n"
+               << "KbdInteractiveAuthentication no\n"
+               << "LogLevel VERBOSE\n";
+        config.close();
+
+        std::string configPath = (dir_ / "sshd_config").string();
+        std::string logPath = (dir_ / "sshd.log").string();
+        pid_ = fork();
+        if (pid_ == 0) {
+            execl(sshd_.c_str(), sshd_.c_str(), "-D", "-f", configPath.c_str(), "-E", logPath.c_str(), nullptr);
+            _exit(127);
+        }
+        for (int i = 0; i < 100 && pid_ > 0; ++i) {
+            if (CanConnect(port_)) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        return false;
+    }
+
+    void stop() {
+        if (pid_ > 0) {
+            killSessions();
+            kill(pid_, SIGTERM);
+            waitpid(pid_, nullptr, 0);
+            pid_ = -1;
+        }
+    }
+
+    // 强制断开所有已建立的连接，监听进程保留
+    void killSessions() {
+        for (pid_t pid : Descendants(pid_)) {
+            kill(pid, SIGKILL);
+        }
+    }
+
+    // 日志中完成公钥认证的次数
+    int authentications() const {
+        std::ifstream log(dir_ / "sshd.log");
+        int count = 0;
+        std::string line;
+        while (std::getline(log, line)) {
+            if (line.find("Accepted publickey") != std::string::npos) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    const std::string &port() const { return port_; }
+
+private:
+    std::string sshd_;          ///< sshd 路径
+    std::filesystem::path dir_; ///< 配置、密钥和日志所在目录
+    std::string port_;          ///< 监听端口
+    pid_t pid_ = -1;            ///< 监听进程
+};
+
+struct Fixture {
+    std::filesystem::path dir;         ///< 临时目录
+    std::string url;                   ///< 远端地址
+    std::string privateKey;            ///< 客户端私钥路径
+    std::string publicKey;             ///< 客户端公钥路径
+    std::unique_ptr<SshServer> server; ///< 临时的 sshd
+    std::string skipReason;            ///< 非空时跳过
+    std::string error;                 ///< 准备失败的原因
+
+    Fixture() {
+        std::string sshd = FindSshd();
+        if (sshd.empty()) {
+            skipReason = "sshd not found, set HIGIT_TEST_SSHD";
+            return;
+        }
+        if (std::system("command -v git-upload-pack >/dev/null 2>&1") != 0) {
+            skipReason = "git-upload-pack not found";
+            return;
+        }
+        char pattern[] = "/tmp/higit_ssh_test.XXXXXX";
+        if (mkdtemp(pattern) == nullptr) {
+            error = "mkdtemp failed";
+            return;
+        }
+        dir = pattern;
+
+        SyntheticRepoOptions options;
+        options.commits = 20;
+        options.files = 50;
+        options.branches = 2;
+        options.tags = 2;
+        if (!SyntheticRepo::Generate((dir / "remote.git").string(), options, error)) {
+            return;
+        }
+
+        // 客户端密钥与应用中生成的格式相同
+        SSHManager manager;
+        privateKey = (dir / "id_ecdsa").string();
+        publicKey = (dir / "id_ecdsa.pub").string();
+        if (!manager.generateECDSAKeyPair("higit-test", "") || !manager.saveKeyPair(privateKey, publicKey, "")) {
+            error = "generate client key: " + manager.getLastError();
+            return;
+        }
+
+        server = std::make_unique<SshServer>(sshd, dir);
+        if (!server->start(manager.getPublicKey())) {
+            error = "sshd did not start, see " + (dir / "sshd.log").string();
+            return;
+        }
+        passwd *user = getpwuid(getuid());
+        url = std::string("ssh://") + user->pw_name + "@127.0.0.1:" + server->port() + (dir / "remote.git").string();
+    }
+
+    ~Fixture() {
+        server.reset();
+        std::error_code ec;
+        if (!dir.empty()) {
+            std::filesystem::remove_all(dir, ec);
+        }
+    }
+
+    git_remote_callbacks callbacks() {
+        git_remote_callbacks callbacks = GIT_REMOTE_CALLBACKS_INIT;
+        callbacks.credentials = [](git_credential **out, const char *, const char *username, unsigned int,
+                                   void *payload) -> int {
+            auto *fixture = static_cast<Fixture *>(payload);
+            return git_credential_ssh_key_new(out, username, fixture->publicKey.c_str(),
+                                              fixture->privateKey.c_str(), "");
+        };
+        // 临时主机密钥，直接信任
+        callbacks.certificate_check = [](git_cert *, int, const char *, void *) -> int { return 0; };
+        callbacks.payload = this;
+        return callbacks;
+    }
+
+    // 相当于 git ls-remote，返回引用数量，失败返回-1
+    int lsRemote() {
+        git_remote *remote = nullptr;
+        if (git_remote_create_detached(&remote, url.c_str()) != 0) {
+            return -1;
+        }
+        git_remote_callbacks cb = callbacks();
+        int count = -1;
+        if (git_remote_connect(remote, GIT_DIRECTION_FETCH, &cb, nullptr, nullptr) == 0) {
+            const git_remote_head **heads = nullptr;
+            size_t size = 0;
+            if (git_remote_ls(&heads, &size, remote) == 0) {
+                count = static_cast<int>(size);
+            }
+            git_remote_disconnect(remote);
+        }
+        git_remote_free(remote);
+        return count;
+    }
+
+    // 抓取到新的本地仓库
+    bool fetch(const std::string &name) {
+        git_repository *repo = nullptr;
+        if (git_repository_init(&repo, (dir / name).string().c_str(), 1) != 0) {
+            return false;
+        }
+        git_remote *remote = nullptr;
+        bool ok = git_remote_create(&remote, repo, "origin", url.c_str()) == 0;
+        if (ok) {
+            git_fetch_options options = GIT_FETCH_OPTIONS_INIT;
+            options.callbacks = callbacks();
+            ok = git_remote_fetch(remote, nullptr, &options, nullptr) == 0;
+        }
+        git_oid id;
+        ok = ok && git_reference_name_to_id(&id, repo, "refs/remotes/origin/main") == 0;
+        git_remote_free(remote);
+        git_repository_free(repo);
+        return ok;
+    }
+};
+
+std::string LastGitError() {
+    const git_error *error = git_error_last();
+    return error != nullptr && error->message != nullptr ? error->message : "";
+}
+
+void TestReusesSessionAcrossOperations(Fixture &fixture) {
+    int before = fixture.server->authentications();
+    int refs = fixture.lsRemote();
+    if (refs <= 0) {
+        fprintf(stderr, "ls-remote: %s\n", LastGitError().c_str());
+    }
+    CHECK(refs > 0);
+    bool fetched = fixture.fetch("first.git");
+    if (!fetched) {
+        fprintf(stderr, "fetch: %s\n", LastGitError().c_str());
+    }
+    CHECK(fetched);
+    // ls-remote 之后的 fetch 沿用已认证的会话
+    CHECK_EQ(fixture.server->authentications() - before, 1);
+}
+
+void TestDropsDeadPooledSession(Fixture &fixture) {
+    SshTransport::CloseIdleSessions();
+    int before = fixture.server->authentications();
+    REQUIRE(fixture.lsRemote() > 0);
+
+    // 服务器断开池中的会话，下一次操作应丢弃它并重新认证，而不是失败
+    fixture.server->killSessions();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    bool fetched = fixture.fetch("second.git");
+    if (!fetched) {
+        fprintf(stderr, "fetch: %s\n", LastGitError().c_str());
+    }
+    CHECK(fetched);
+    CHECK_EQ(fixture.server->authentications() - before, 2);
+}
+
+} // namespace
+
+int main() {
+    // 初始化 libgit2，注册SSH传输
+    GitRuntime::Instance();
+    Log::SetMinLevel(Log::Warn);
+
+    Fixture fixture;
+    if (!fixture.skipReason.empty()) {
+        printf("[SKIP] %s\n", fixture.skipReason.c_str());
+        return Test::SKIPPED;
+    }
+    if (!fixture.error.empty()) {
+        fprintf(stderr, "setup failed: %s\n", fixture.error.c_str());
+        return 1;
+    }
+    return Test::Run({
+        {"SSH session is reused from ls-remote to fetch", [&]() { TestReusesSessionAcrossOperations(fixture); }},
+        {"SSH pool drops a session closed by the server", [&]() { TestDropsDeadPooledSession(fixture); }},
+    });
+}
@@ -0,0 +1,77 @@
+#ifndef HIGIT_TEST_SUPPORT_H
+#define HIGIT_TEST_SUPPORT_H
+
+// 工作站上的集成测试共用的断言和用例执行，不依赖测试框架。
+// CHECK 失败时记录并继续，REQUIRE 失败时结束当前用例；进程退出码由 Run 返回
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Test {
+
+/// 缺少外部依赖（如 sshd）时的退出码，与 CMake 的 SKIP_RETURN_CODE 对应
+constexpr int SKIPPED = 77;
+
+/**
+ * @brief 一个测试用例
+ */
+struct Case {
+    const char *name;          ///< 用例名
+    std::function<void()> run; ///< 用例内容
+};
+
+inline int &Failures() {
+    static int failures = 0;
+    return failures;
+}
+
+inline void Fail(const char *file, int line, const std::string &message) {
+    fprintf(stderr, "%s:%d: %s\n", file, line, message.c_str());
+    Failures()++;
+}
+
+/**
+ * @brief 依次执行用例并输出结果
+ * @param cases 用例列表
+ * @return 全部通过返回0，否则返回1
+ */
+inline int Run(const std::vector<Case> &cases) {
+    for (const auto &testCase : cases) {
+        int before = Failures();
+        testCase.run();
+        printf("[%s] %s\n", Failures() == before ? "PASS" : "FAIL", testCase.name);
+    }
+    return Failures() == 0 ? 0 : 1;
+}
+
+} // namespace Test
+
+#define CHECK(condition)                                                                                               \
+    do {                                                                                                               \
+        if (!(condition)) {                                                                                            \
+            Test::Fail(__FILE__, __LINE__, "CHECK failed: " #condition);                                               \
+        }                                                                                                              \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                                                                     \
+    do {                                                                                                               \
+        auto actualValue = (actual);                                                                                   \
+        auto expectedValue = (expected);                                                                               \
+        if (!(actualValue == expectedValue)) {                                                                         \
+            Test::Fail(__FILE__, __LINE__,                                                                             \
+                       "CHECK_EQ failed: " #actual " == " #expected " (" + std::to_string(actualValue) +               \
+                           " vs " + std::to_string(expectedValue) + ")");                                              \
+        }                                                                                                              \
+    } while (0)
+
+#define REQUIRE(condition)                                                                                             \
+    do {                                                                                                               \
+        if (!(condition)) {                                                                                            \
+            Test::Fail(__FILE__, __LINE__, "REQUIRE failed: " #condition);                                             \
+            return;                                                                                                    \
+        }                                                                                                              \
+    } while (0)
+
+#endif // HIGIT_TEST_SUPPORT_H
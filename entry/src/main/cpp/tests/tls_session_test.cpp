@@ -0,0 +1,321 @@
+// higit_tls_test：TlsStream 的会话恢复
+// 在本进程内用 mbedTLS 起一个只支持 session ID 缓存的 TLS 1.2 服务器，证书由测试时生成的CA签发；
+// 服务器会话缓存的命中次数即客户端恢复会话的次数
+
+#include "git_runtime.h"
+#include "test_support.h"
+#include "tls_session_cache.h"
+#include "tls_stream.h"
+#include "trust_store.h"
+#include "utils/log.hpp"
+#include <arpa/inet.h>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/ecp.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/net_sockets.h>
+#include <mbedtls/pk.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/ssl_cache.h>
+#include <mbedtls/x509_crt.h>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+
+namespace {
+
+constexpr const char *HOST = "localhost";
+
+// 每个线程各自使用的随机数生成器（mbedTLS 未启用线程支持）
+struct Random {
+    mbedtls_entropy_context entropy;
+    mbedtls_ctr_drbg_context drbg;
+
+    Random() {
+        mbedtls_entropy_init(&entropy);
+        mbedtls_ctr_drbg_init(&drbg);
+        const char *pers = "higit_tls_test";
+        mbedtls_ctr_drbg_seed(&drbg, mbedtls_entropy_func, &entropy, reinterpret_cast<const unsigned char *>(pers),
+                              std::strlen(pers));
+    }
+
+    ~Random() {
+        mbedtls_ctr_drbg_free(&drbg);
+        mbedtls_entropy_free(&entropy);
+    }
+};
+
+// 证书及其私钥
+struct Identity {
+    std::string subject; ///< 主体名
+    std::string pem;     ///< 证书的PEM编码
+    mbedtls_pk_context key;
+    mbedtls_x509_crt cert;
+
+    Identity() {
+        mbedtls_pk_init(&key);
+        mbedtls_x509_crt_init(&cert);
+    }
+
+    ~Identity() {
+        mbedtls_x509_crt_free(&cert);
+        mbedtls_pk_free(&key);
+    }
+};
+
+// 签发证书，issuer 为空时生成自签名的CA
+bool Issue(Identity &out, const std::string &subject, Identity *issuer, Random &random) {
+    out.subject = subject;
+    if (mbedtls_pk_setup(&out.key, mbedtls_pk_info_from_type(MBEDTLS_PK_ECKEY)) != 0 ||
+        mbedtls_ecp_gen_key(MBEDTLS_ECP_DP_SECP256R1, mbedtls_pk_ec(out.key), mbedtls_ctr_drbg_random,
+                            &random.drbg) != 0) {
+        return false;
+    }
+
+    mbedtls_x509write_cert writer;
+    mbedtls_x509write_crt_init(&writer);
+    mbedtls_x509write_crt_set_version(&writer, MBEDTLS_X509_CRT_VERSION_3);
+    mbedtls_x509write_crt_set_md_alg(&writer, MBEDTLS_MD_SHA256);
+    mbedtls_x509write_crt_set_subject_key(&writer, &out.key);
+    mbedtls_x509write_crt_set_issuer_key(&writer, issuer != nullptr ? &issuer->key : &out.key);
+    unsigned char serial[] = {static_cast<unsigned char>(issuer != nullptr ? 2 : 1)};
+    unsigned char pem[4096] = {0};
+    int ret = mbedtls_x509write_crt_set_subject_name(&writer, subject.c_str());
+    if (ret == 0) {
+        ret = mbedtls_x509write_crt_set_issuer_name(&writer, (issuer != nullptr ? issuer : &out)->subject.c_str());
+    }
+    if (ret == 0) {
+        ret = mbedtls_x509write_crt_set_serial_raw(&writer, serial, sizeof(serial));
+    }
+    if (ret == 0) {
+        ret = mbedtls_x509write_crt_set_validity(&writer, "20200101000000", "20991231235959");
+    }
+    if (ret == 0) {
+        ret = mbedtls_x509write_crt_set_basic_constraints(&writer, issuer == nullptr, -1);
+    }
+    if (ret == 0) {
+        ret = mbedtls_x509write_crt_pem(&writer, pem, sizeof(pem), mbedtls_ctr_drbg_random, &random.drbg);
+    }
+    mbedtls_x509write_crt_free(&writer);
+    if (ret != 0) {
+        return false;
+    }
+    out.pem = reinterpret_cast<const char *>(pem);
+    return mbedtls_x509_crt_parse(&out.cert, pem, out.pem.size() + 1) == 0;
+}
+
+/**
+ * @brief 逐个处理连接的TLS服务器
+ * 握手后读到客户端关闭为止，再接受下一个连接；只开启 session ID 缓存，不签发 session ticket
+ */
+class TlsServer {
+public:
+    explicit TlsServer(Identity &identity) {
+        mbedtls_net_init(&listen_);
+        mbedtls_ssl_config_init(&conf_);
+        mbedtls_ssl_cache_init(&cache_);
+        mbedtls_ssl_config_defaults(&conf_, MBEDTLS_SSL_IS_SERVER, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                    MBEDTLS_SSL_PRESET_DEFAULT);
+        mbedtls_ssl_conf_rng(&conf_, mbedtls_ctr_drbg_random, &random_.drbg);
+        mbedtls_ssl_conf_own_cert(&conf_, &identity.cert, &identity.key);
+        mbedtls_ssl_conf_min_tls_version(&conf_, MBEDTLS_SSL_VERSION_TLS1_2);
+        mbedtls_ssl_conf_max_tls_version(&conf_, MBEDTLS_SSL_VERSION_TLS1_2);
+        mbedtls_ssl_conf_session_cache(&conf_, this, CacheGet, CacheSet);
+    }
+
+    ~TlsServer() {
+        stop();
+        mbedtls_ssl_cache_free(&cache_);
+        mbedtls_ssl_config_free(&conf_);
+        mbedtls_net_free(&listen_);
+    }
+
+    bool start() {
+        if (mbedtls_net_bind(&listen_, "127.0.0.1", "0", MBEDTLS_NET_PROTO_TCP) != 0) {
+            return false;
+        }
+        sockaddr_in addr{};
+        socklen_t length = sizeof(addr);
+        if (getsockname(listen_.fd, reinterpret_cast<sockaddr *>(&addr), &length) != 0) {
+            return false;
+        }
+        port_ = std::to_string(ntohs(addr.sin_port));
+        thread_ = std::thread([this]() { serve(); });
+        return true;
+    }
+
+    void stop() {
+        if (thread_.joinable()) {
+            // 让阻塞在 accept 上的服务线程返回
+            shutdown(listen_.fd, SHUT_RDWR);
+            thread_.join();
+        }
+    }
+
+    // 丢弃服务器缓存的会话，之后客户端提供的会话都会被拒绝；只在两次连接之间调用
+    void forgetSessions() {
+        mbedtls_ssl_cache_free(&cache_);
+        mbedtls_ssl_cache_init(&cache_);
+    }
+
+    const std::string &port() const { return port_; }
+
+    int resumed() const { return resumed_.load(); }
+
+private:
+    static int CacheGet(void *data, const unsigned char *id, size_t length, mbedtls_ssl_session *session) {
+        auto *server = static_cast<TlsServer *>(data);
+        int ret = mbedtls_ssl_cache_get(&server->cache_, id, length, session);
+        if (ret == 0) {
+            server->resumed_++;
+        }
+        return ret;
+    }
+
+    static int CacheSet(void *data, const unsigned char *id, size_t length, const mbedtls_ssl_session *session) {
+        return mbedtls_ssl_cache_set(&static_cast<TlsServer *>(data)->cache_, id, length, session);
+    }
+
+    void serve() {
+        while (true) {
+            mbedtls_net_context client;
+            mbedtls_net_init(&client);
+            if (mbedtls_net_accept(&listen_, &client, nullptr, 0, nullptr) != 0) {
+                mbedtls_net_free(&client);
+                return;
+            }
+            mbedtls_ssl_context ssl;
+            mbedtls_ssl_init(&ssl);
+            int ret = mbedtls_ssl_setup(&ssl, &conf_);
+            if (ret == 0) {
+                mbedtls_ssl_set_bio(&ssl, &client, mbedtls_net_send, mbedtls_net_recv, nullptr);
+                do {
+                    ret = mbedtls_ssl_handshake(&ssl);
+                } while (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+            }
+            if (ret == 0) {
+                unsigned char buffer[256];
+                while (mbedtls_ssl_read(&ssl, buffer, sizeof(buffer)) > 0) {
+                }
+                mbedtls_ssl_close_notify(&ssl);
+            }
+            mbedtls_ssl_free(&ssl);
+            mbedtls_net_free(&client);
+        }
+    }
+
+    Random random_;                   ///< 只在服务线程中使用
+    mbedtls_net_context listen_;      ///< 监听套接字
+    mbedtls_ssl_config conf_;         ///< 服务器配置
+    mbedtls_ssl_cache_context cache_; ///< 服务器的会话缓存
+    std::string port_;                ///< 监听端口
+    std::thread thread_;              ///< 服务线程
+    std::atomic<int> resumed_{0};     ///< 恢复会话的次数
+};
+
+// 以 PEM 文件替换进程共享的证书链
+bool Trust(const Identity &ca, const std::filesystem::path &dir) {
+    std::filesystem::path bundle = dir / "cert.pem";
+    std::ofstream(bundle, std::ios::trunc) << ca.pem;
+    return TrustStore::Shared().load(bundle.string(), "");
+}
+
+// 完成一次握手后关闭连接，返回 connect 的结果
+int ConnectOnce(const std::string &port) {
+    git_stream *stream = nullptr;
+    int ret = TlsStream::Init(&stream, HOST, port.c_str());
+    if (ret == 0) {
+        ret = stream->connect(stream);
+        stream->close(stream);
+        stream->free(stream);
+    }
+    // 空闲连接会被下一次连接直接复用，关闭后下一次连接才会重新握手
+    TlsStream::CloseIdleConnections();
+    return ret;
+}
+
+struct Fixture {
+    std::filesystem::path dir; ///< 临时目录
+    Random random;
+    Identity ca;      ///< 签发服务器证书的CA
+    Identity otherCa; ///< 与服务器无关的CA
+    Identity server;  ///< 服务器证书，主体为 localhost
+    bool ready = false;
+
+    Fixture() {
+        char pattern[] = "/tmp/higit_tls_test.XXXXXX";
+        if (mkdtemp(pattern) == nullptr) {
+            return;
+        }
+        dir = pattern;
+        ready = Issue(ca, "CN=HiGit Test CA", nullptr, random) &&
+                Issue(otherCa, "CN=HiGit Other CA", nullptr, random) &&
+                Issue(server, "CN=localhost", &ca, random);
+    }
+
+    ~Fixture() {
+        std::error_code ec;
+        std::filesystem::remove_all(dir, ec);
+    }
+};
+
+void TestResumesVerifiedSession(Fixture &fixture) {
+    REQUIRE(fixture.ready);
+    REQUIRE(Trust(fixture.ca, fixture.dir));
+    TlsServer server(fixture.server);
+    REQUIRE(server.start());
+    size_t cached = TlsSessionCache::Shared().size();
+
+    CHECK_EQ(ConnectOnce(server.port()), 0);
+    CHECK_EQ(server.resumed(), 0);
+    CHECK_EQ(TlsSessionCache::Shared().size(), cached + 1);
+
+    // 第二次连接恢复第一次的会话
+    CHECK_EQ(ConnectOnce(server.port()), 0);
+    CHECK_EQ(server.resumed(), 1);
+    CHECK_EQ(TlsSessionCache::Shared().size(), cached + 1);
+}
+
+void TestRejectsUnverifiedSession(Fixture &fixture) {
+    REQUIRE(fixture.ready);
+    TlsServer server(fixture.server);
+    REQUIRE(server.start());
+    size_t cached = TlsSessionCache::Shared().size();
+
+    // 证书不受信任：连接失败，会话不缓存，下一次连接不提供会话
+    REQUIRE(Trust(fixture.otherCa, fixture.dir));
+    CHECK_EQ(ConnectOnce(server.port()), static_cast<int>(GIT_ECERTIFICATE));
+    CHECK_EQ(TlsSessionCache::Shared().size(), cached);
+    CHECK_EQ(ConnectOnce(server.port()), static_cast<int>(GIT_ECERTIFICATE));
+    CHECK_EQ(server.resumed(), 0);
+
+    // 已缓存的会话在一次未通过校验的完整握手后被丢弃
+    REQUIRE(Trust(fixture.ca, fixture.dir));
+    CHECK_EQ(ConnectOnce(server.port()), 0);
+    CHECK_EQ(TlsSessionCache::Shared().size(), cached + 1);
+    server.forgetSessions();
+    REQUIRE(Trust(fixture.otherCa, fixture.dir));
+    CHECK_EQ(ConnectOnce(server.port()), static_cast<int>(GIT_ECERTIFICATE));
+    CHECK_EQ(server.resumed(), 0);
+    CHECK_EQ(TlsSessionCache::Shared().size(), cached);
+}
+
+} // namespace
+
+int main() {
+    // 初始化 libgit2 和 PSA，注册 TLS 流
+    GitRuntime::Instance();
+    Log::SetMinLevel(Log::Warn);
+
+    Fixture fixture;
+    return Test::Run({
+        {"TLS session is resumed on the next connection", [&]() { TestResumesVerifiedSession(fixture); }},
+        {"TLS session is not cached when verification fails", [&]() { TestRejectsUnverifiedSession(fixture); }},
+    });
+}
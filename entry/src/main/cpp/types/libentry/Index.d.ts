@@ -3,6 +3,10 @@ export const initSystem: (path: string) => { success: number, message: string, d
 export const initRepo: (path: string, url: string, repo: string,
   provider: string) => { success: number, message: string, data: string };
 
+// 并行打开 basePath/repos 下的所有仓库并预加载第一页历史，每个仓库就绪时回调一次（JSON）
+export const openAll: (basePath: string, pageSize: number,
+  callback: (status: string) => void) => Promise<{ success: number, message: string, data: string }>;
+
 export const getBranches: (url: string) => { success: number, message: string, data: string };
 
 export const getTags: (url: string) => { success: number, message: string, data: string };
@@ -15,11 +19,111 @@ export const history: (url: string, branch: string, count: number,
 
 export const getSSHKey: () => { success: number, message: string, data: string };
 
-export const generateSSHKey: () => { success: number, message: string, data: string };
+// 在后台生成新的 SSH 密钥并立即返回，algorithm 为 "ecdsa"（默认）或 "rsa"；进度通过 getSSHKeyStatus 查询
+export const generateSSHKey: (algorithm?: string) => { success: number, message: string, data: string };
+
+// data 为 JSON：{ state: "missing" | "generating" | "ready" | "failed", type, fingerprint, message }
+export const getSSHKeyStatus: () => { success: number, message: string, data: string };
 
 export const deleteRepo: (path: string, url: string, repo: string,
   provider: string) => { success: number, message: string, data: string }
 
 export const getFileTree: (url: string, branch: string) => { success: number, message: string, data: string };
 
-export const readFile: (url: string, branch: string, path: string) => { success: number, message: string, data: string };
\ No newline at end of file
+export const readFile: (url: string, branch: string, path: string) => { success: number, message: string, data: string };
+
+export const getCommitChanges: (url: string, commitId: string) => { success: number, message: string, data: string };
+
+export const getFilePatch: (url: string, commitId: string, path: string,
+  options: { contextLines?: number, maxBytes?: number, wordDiff?: boolean },
+  callback: (chunk: string) => void) => Promise<{ success: number, message: string, data: string }>;
+
+export const searchTree: (url: string, ref: string, pattern: string,
+  options: { isRegex?: boolean, caseSensitive?: boolean, maxResults?: number, maxFileBytes?: number },
+  callback: (chunk: string) => void) => Promise<{ success: number, message: string, data: string }>;
+
+export const findFiles: (url: string, ref: string, query: string,
+  limit: number) => { success: number, message: string, data: string };
+
+// 分批回调 Blame 块（JSON 数组），较新的修改先返回；合并提交的所有父提交都会追溯，
+// 合并进来的行归属于分支上的原始提交，重命名只沿第一父提交检测
+export const blameFile: (url: string, ref: string, path: string,
+  callback: (chunk: string) => void) => Promise<{ success: number, message: string, data: string }>;
+
+export const cancelBlame: (url: string) => { success: number, message: string, data: string };
+
+// level 取值与 AbilityConstant.MemoryLevel 一致
+export const trimCaches: (level: number) => { success: number, message: string, data: string };
+
+// budgetMB 为 0 时按设备内存自动推算，data 为生效的预算（MB）
+export const setMemoryBudget: (budgetMB: number) => { success: number, message: string, data: string };
+
+// 开启时丢弃之前的记录；开启后记录 NAPI 调用、排队、libgit2 各阶段和结果转换的耗时
+export const setTracing: (enabled: boolean) => { success: number, message: string, data: string };
+
+// data 为 Chrome trace-event JSON，可在 chrome://tracing 或 Perfetto 中打开
+export const exportTrace: () => { success: number, message: string, data: string };
+
+// data 为 JSON：operations 中各操作的 count/meanUs/p50Us/p90Us/p99Us/maxUs，caches 中各缓存的 hits/misses，
+// counters 中传给 JS 的字节数（marshalledBytes/marshalledBinaryBytes）和读取的对象数（objectsLoaded）
+export const getMetrics: () => { success: number, message: string, data: string };
+
+export const getBranchesColumns: (url: string) => { success: number, message: string, data: string, buffer?: ArrayBuffer };
+
+export const getTagsColumns: (url: string) => { success: number, message: string, data: string, buffer?: ArrayBuffer };
+
+export const historyColumns: (url: string, branch: string, count: number,
+  offset: number) => { success: number, message: string, data: string, buffer?: ArrayBuffer };
+
+export const getFileTreeColumns: (url: string,
+  branch: string) => { success: number, message: string, data: string, buffer?: ArrayBuffer };
+
+// 以下为返回 Promise 的异步版本，参数与同步版本相同，原生操作在工作线程执行
+// 同步版本不会等待同一仓库上的其他操作：有操作排队或冲突（如正在拉取）时直接返回 success 为 0 的结果，
+// 需要排队执行时使用异步版本
+
+export const initSystemAsync: (path: string) => Promise<{ success: number, message: string, data: string }>;
+
+export const initRepoAsync: (path: string, url: string, repo: string,
+  provider: string) => Promise<{ success: number, message: string, data: string }>;
+
+export const getBranchesAsync: (url: string) => Promise<{ success: number, message: string, data: string }>;
+
+export const getTagsAsync: (url: string) => Promise<{ success: number, message: string, data: string }>;
+
+export const fetchAsync: (url: string, branch: string, callback: (process: number, total: number,
+  message: string) => void) => Promise<{ success: number, message: string, data: string }>;
+
+export const historyAsync: (url: string, branch: string, count: number,
+  offset: number) => Promise<{ success: number, message: string, data: string }>;
+
+export const getSSHKeyAsync: () => Promise<{ success: number, message: string, data: string }>;
+
+export const generateSSHKeyAsync: (algorithm?: string) => Promise<{ success: number, message: string, data: string }>;
+
+export const deleteRepoAsync: (path: string, url: string, repo: string,
+  provider: string) => Promise<{ success: number, message: string, data: string }>;
+
+export const getFileTreeAsync: (url: string,
+  branch: string) => Promise<{ success: number, message: string, data: string }>;
+
+export const readFileAsync: (url: string, branch: string,
+  path: string) => Promise<{ success: number, message: string, data: string }>;
+
+export const getCommitChangesAsync: (url: string,
+  commitId: string) => Promise<{ success: number, message: string, data: string }>;
+
+export const findFilesAsync: (url: string, ref: string, query: string,
+  limit: number) => Promise<{ success: number, message: string, data: string }>;
+
+export const getBranchesColumnsAsync: (url: string) => Promise<{ success: number, message: string, data: string,
+  buffer?: ArrayBuffer }>;
+
+export const getTagsColumnsAsync: (url: string) => Promise<{ success: number, message: string, data: string,
+  buffer?: ArrayBuffer }>;
+
+export const historyColumnsAsync: (url: string, branch: string, count: number,
+  offset: number) => Promise<{ success: number, message: string, data: string, buffer?: ArrayBuffer }>;
+
+export const getFileTreeColumnsAsync: (url: string,
+  branch: string) => Promise<{ success: number, message: string, data: string, buffer?: ArrayBuffer }>;
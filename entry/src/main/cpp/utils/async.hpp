@@ -0,0 +1,302 @@
+//
+// Created on 2026/10/18.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef HIGIT_ASYNC_HPP
+#define HIGIT_ASYNC_HPP
+#include "napi/native_api.h"
+#include "metrics.h"
+#include "repo_executor.h"
+#include "tracer.h"
+#include "utils/log.hpp"
+#include "utils/messages.hpp"
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace Async {
+
+/**
+ * @brief 在工作线程执行 execute，回到 JS 线程执行 complete 并兑现 Promise
+ * execute 中不能访问任何 napi_value；complete 的返回值作为 Promise 的结果，execute 抛出异常时 Promise 被拒绝
+ * 开启追踪时分别记录排队、执行和结果转换三段耗时
+ */
+struct PromiseTask {
+    napi_async_work work = nullptr;
+    napi_threadsafe_function tsfn = nullptr;
+    napi_deferred deferred = nullptr;
+    bool failed = false;
+    const char *name = nullptr; ///< 任务名，用作追踪事件名
+    int64_t queuedAt = -1;      ///< 入队时间，-1 表示未开启追踪
+    std::function<void()> execute;
+    std::function<napi_value(napi_env)> complete;
+
+    PromiseTask(const char *taskName, std::function<void()> run, std::function<napi_value(napi_env)> finish)
+        : name(taskName), queuedAt(Tracer::Shared().enabled() ? Tracer::NowMicros() : -1), execute(std::move(run)),
+          complete(std::move(finish)) {}
+
+    // 在工作线程调用
+    void Run() {
+        if (queuedAt >= 0) {
+            Tracer::Shared().complete("queue", name, queuedAt, Tracer::NowMicros() - queuedAt);
+        }
+        TraceSpan span("work", name);
+        try {
+            execute();
+        } catch (...) {
+            OH_LOG_ERROR(LOG_APP, "Async task threw an exception");
+            failed = true;
+        }
+    }
+
+    // 在 JS 线程调用，兑现或拒绝 Promise
+    void Settle(napi_env env, bool ok) {
+        TraceSpan span("marshal", name);
+        if (!ok || failed) {
+            napi_value message = nullptr;
+            napi_value error = nullptr;
+            napi_create_string_utf8(env, "native task failed", NAPI_AUTO_LENGTH, &message);
+            napi_create_error(env, nullptr, message, &error);
+            napi_reject_deferred(env, deferred, error);
+            return;
+        }
+        napi_value value = complete(env);
+        if (value == nullptr) {
+            napi_get_undefined(env, &value);
+        }
+        napi_resolve_deferred(env, deferred, value);
+    }
+};
+
+inline napi_value RunPromise(napi_env env, const char *name, std::function<void()> execute,
+                             std::function<napi_value(napi_env)> complete) {
+    napi_value promise = nullptr;
+    auto *task = new PromiseTask(name, std::move(execute), std::move(complete));
+
+    if (napi_create_promise(env, &task->deferred, &promise) != napi_ok) {
+        OH_LOG_ERROR(LOG_APP, "%{public}s - napi_create_promise failed", name);
+        delete task;
+        return nullptr;
+    }
+
+    napi_value resourceName = nullptr;
+    napi_create_string_utf8(env, name, NAPI_AUTO_LENGTH, &resourceName);
+    napi_status status = napi_create_async_work(
+        env, nullptr, resourceName, [](napi_env, void *data) { static_cast<PromiseTask *>(data)->Run(); },
+        [](napi_env env, napi_status status, void *data) {
+            auto *task = static_cast<PromiseTask *>(data);
+            task->Settle(env, status == napi_ok);
+            napi_delete_async_work(env, task->work);
+            delete task;
+        },
+        task, &task->work);
+    if (status != napi_ok || napi_queue_async_work(env, task->work) != napi_ok) {
+        OH_LOG_ERROR(LOG_APP, "%{public}s - queue async work failed", name);
+        napi_value undefined = nullptr;
+        napi_get_undefined(env, &undefined);
+        napi_reject_deferred(env, task->deferred, undefined);
+        if (task->work != nullptr) {
+            napi_delete_async_work(env, task->work);
+        }
+        delete task;
+    }
+    return promise;
+}
+
+/**
+ * @brief 与 RunPromise 相同，但 execute 以指定的访问方式在仓库执行器上运行
+ * 执行完毕后通过线程安全函数回到 JS 线程执行 complete
+ */
+inline napi_value RunPromiseOn(napi_env env, const char *name, const std::shared_ptr<RepoExecutor> &executor,
+                               RepoExecutor::Access access, std::function<void()> execute,
+                               std::function<napi_value(napi_env)> complete) {
+    napi_value promise = nullptr;
+    auto *task = new PromiseTask(name, std::move(execute), std::move(complete));
+
+    if (napi_create_promise(env, &task->deferred, &promise) != napi_ok) {
+        OH_LOG_ERROR(LOG_APP, "%{public}s - napi_create_promise failed", name);
+        delete task;
+        return nullptr;
+    }
+
+    napi_value resourceName = nullptr;
+    napi_create_string_utf8(env, name, NAPI_AUTO_LENGTH, &resourceName);
+    // 队列不限长度，工作线程投递结果时不会因 JS 线程繁忙而阻塞
+    napi_status status = napi_create_threadsafe_function(
+        env, nullptr, nullptr, resourceName, 0, 1, nullptr, nullptr, nullptr,
+        [](napi_env env, napi_value, void *, void *data) {
+            auto *task = static_cast<PromiseTask *>(data);
+            if (env != nullptr) {
+                task->Settle(env, true);
+            }
+            delete task;
+        },
+        &task->tsfn);
+    if (status != napi_ok) {
+        OH_LOG_ERROR(LOG_APP, "%{public}s - napi_create_threadsafe_function failed: %{public}d", name, status);
+        napi_value undefined = nullptr;
+        napi_get_undefined(env, &undefined);
+        napi_reject_deferred(env, task->deferred, undefined);
+        delete task;
+        return promise;
+    }
+
+    executor->submit(access, [task] {
+        task->Run();
+        napi_threadsafe_function tsfn = task->tsfn;
+        if (napi_call_threadsafe_function(tsfn, task, napi_tsfn_blocking) != napi_ok) {
+            // 环境已销毁，Promise 不会再被使用
+            delete task;
+        }
+        napi_release_threadsafe_function(tsfn, napi_tsfn_release);
+    });
+    return promise;
+}
+
+/**
+ * @brief 把已有结果包装为已兑现的 Promise，同步调用时原样返回
+ * value 为空表示参数错误且异常已抛出，此时直接返回空
+ */
+inline napi_value Settle(napi_env env, bool async, napi_value value) {
+    if (!async || value == nullptr) {
+        return value;
+    }
+    napi_deferred deferred = nullptr;
+    napi_value promise = nullptr;
+    if (napi_create_promise(env, &deferred, &promise) != napi_ok) {
+        return nullptr;
+    }
+    napi_resolve_deferred(env, deferred, value);
+    return promise;
+}
+
+/**
+ * @brief 同一操作的同步和异步两种调用方式
+ * 参数解析和结果转换都在 JS 线程完成，异步时只有 work 放到工作线程执行；
+ * work 的返回值交给 complete 转换为 napi_value，同步调用直接返回，异步调用用它兑现 Promise
+ *
+ * 指定 executor 时 work 按 access 在该执行器上调度：共享访问之间并行，独占访问与其他任务互斥；
+ * 同步调用在 JS 线程上最多等待 RepoExecutor::SYNC_WAIT：共享访问只等正在运行的独占任务，不受排队任务影响；
+ * 超时仍无法执行时返回 BUSY_MESSAGE 失败结果。同步调用中 work 抛出的异常转换为失败结果，不会传出 N-API 接口
+ * name 同时用作追踪事件名，须在任务结束前保持有效（通常为字符串字面量）
+ */
+/// 同步调用无法执行时返回的提示
+constexpr const char *BUSY_MESSAGE = "仓库正在执行其他操作，请稍后重试";
+/// 同步调用中任务抛出异常时返回的提示
+constexpr const char *FAILED_MESSAGE = "操作执行失败";
+
+template <typename Work, typename Complete>
+napi_value Dispatch(napi_env env, const char *name, bool async, const std::shared_ptr<RepoExecutor> &executor,
+                    RepoExecutor::Access access, Work work, Complete complete) {
+    using Result = std::invoke_result_t<Work &>;
+    auto result = std::make_shared<std::optional<Result>>();
+    if (!async) {
+        auto run = [&result, &work, name] {
+            TraceSpan span("work", name);
+            result->emplace(work());
+        };
+        try {
+            if (executor == nullptr) {
+                run();
+            } else if (!executor->tryRun(access, run, RepoExecutor::SYNC_WAIT)) {
+                OH_LOG_WARN(LOG_APP, "%{public}s - repository busy, sync call rejected", name);
+                return Messages::NewResultMessage(env, false, BUSY_MESSAGE);
+            }
+        } catch (const std::exception &e) {
+            OH_LOG_ERROR(LOG_APP, "%{public}s - sync task threw: %{public}s", name, e.what());
+            return Messages::NewResultMessage(env, false, FAILED_MESSAGE);
+        } catch (...) {
+            OH_LOG_ERROR(LOG_APP, "%{public}s - sync task threw an exception", name);
+            return Messages::NewResultMessage(env, false, FAILED_MESSAGE);
+        }
+        TraceSpan span("marshal", name);
+        return complete(env, **result);
+    }
+    auto execute = [result, work = std::move(work)]() mutable { result->emplace(work()); };
+    auto finish = [result, complete = std::move(complete)](napi_env env) mutable -> napi_value {
+        return complete(env, **result);
+    };
+    if (executor != nullptr) {
+        return RunPromiseOn(env, name, executor, access, std::move(execute), std::move(finish));
+    }
+    return RunPromise(env, name, std::move(execute), std::move(finish));
+}
+
+template <typename Work, typename Complete>
+napi_value Dispatch(napi_env env, const char *name, bool async, Work work, Complete complete) {
+    return Dispatch(env, name, async, nullptr, RepoExecutor::Access::Exclusive, std::move(work), std::move(complete));
+}
+
+/**
+ * @brief 线程安全的字符串回调
+ * 工作线程通过 Post 把数据投递到 JS 回调 callback(data: string)，队列满时阻塞以限制内存占用
+ */
+class StreamCallback {
+public:
+    StreamCallback(const StreamCallback &) = delete;
+    StreamCallback &operator=(const StreamCallback &) = delete;
+
+    ~StreamCallback() { Release(); }
+
+    static std::shared_ptr<StreamCallback> Create(napi_env env, napi_value callback, const char *name,
+                                                  size_t maxQueueSize = 8) {
+        napi_value resourceName = nullptr;
+        napi_create_string_utf8(env, name, NAPI_AUTO_LENGTH, &resourceName);
+
+        napi_threadsafe_function tsfn = nullptr;
+        napi_status status = napi_create_threadsafe_function(env, callback, nullptr, resourceName, maxQueueSize, 1,
+                                                             nullptr, nullptr, nullptr, &StreamCallback::CallJs, &tsfn);
+        if (status != napi_ok) {
+            OH_LOG_ERROR(LOG_APP, "%{public}s - napi_create_threadsafe_function failed: %{public}d", name, status);
+            return nullptr;
+        }
+        return std::shared_ptr<StreamCallback>(new StreamCallback(tsfn));
+    }
+
+    bool Post(std::string data) {
+        if (tsfn_ == nullptr) {
+            return false;
+        }
+        auto *payload = new std::string(std::move(data));
+        if (napi_call_threadsafe_function(tsfn_, payload, napi_tsfn_blocking) != napi_ok) {
+            delete payload;
+            return false;
+        }
+        return true;
+    }
+
+    void Release() {
+        if (tsfn_ != nullptr) {
+            napi_release_threadsafe_function(tsfn_, napi_tsfn_release);
+            tsfn_ = nullptr;
+        }
+    }
+
+private:
+    explicit StreamCallback(napi_threadsafe_function tsfn) : tsfn_(tsfn) {}
+
+    static void CallJs(napi_env env, napi_value jsCallback, void *, void *data) {
+        std::unique_ptr<std::string> payload(static_cast<std::string *>(data));
+        if (env == nullptr || jsCallback == nullptr) {
+            return;
+        }
+        Metrics::Shared().add(Metrics::Counter::MarshalledBytes, payload->size());
+        napi_value argv[1];
+        napi_create_string_utf8(env, payload->c_str(), payload->size(), &argv[0]);
+        napi_status status = napi_call_function(env, nullptr, jsCallback, 1, argv, nullptr);
+        if (status != napi_ok) {
+            OH_LOG_ERROR(LOG_APP, "StreamCallback call js failed with status: %{public}d", status);
+        }
+    }
+
+    napi_threadsafe_function tsfn_;
+};
+
+} // namespace Async
+
+#endif // HIGIT_ASYNC_HPP
@@ -0,0 +1,228 @@
+//
+// Created on 2026/10/18.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef HIGIT_COLUMNAR_HPP
+#define HIGIT_COLUMNAR_HPP
+#include "metrics.h"
+#include "napi/native_api.h"
+#include "utils/log.hpp"
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * 列式二进制结果格式（小端）：
+ *
+ * | 偏移 | 内容                                                                   |
+ * |------|------------------------------------------------------------------------|
+ * | 0    | 头部 24 字节：magic "HGCB"、version(u16)、列数(u16)、行数(u32)、       |
+ * |      | 字符串堆偏移(u32)、字符串堆长度(u32)、保留(u32)                        |
+ * | 24   | 列描述，每列 16 字节：类型(u8)、保留(3字节)、列名在堆中的偏移(u32)、   |
+ * |      | 列名长度(u32)、列数据偏移(u32)                                         |
+ * | ...  | 各列数据，按 8 字节对齐，每行定长                                      |
+ * | ...  | 字符串堆（UTF-8）                                                      |
+ *
+ * 字符串列每行保存 (堆内偏移 u32, 长度 u32)，对象ID列每行保存 20 字节原始ID
+ * ArkTS 侧的解码器见 ets/utils/ColumnarTable.ets
+ */
+namespace Columnar {
+
+constexpr uint32_t MAGIC = 0x42434748; // "HGCB"
+constexpr uint16_t VERSION = 1;
+constexpr size_t HEADER_SIZE = 24;
+constexpr size_t COLUMN_DESC_SIZE = 16;
+
+enum class ColumnType : uint8_t {
+    UINT32 = 1,
+    INT32 = 2,
+    FLOAT64 = 3,
+    BOOL = 4,
+    STRING = 5,
+    OID = 6,
+};
+
+inline size_t ColumnWidth(ColumnType type) {
+    switch (type) {
+    case ColumnType::UINT32:
+    case ColumnType::INT32:
+        return 4;
+    case ColumnType::FLOAT64:
+    case ColumnType::STRING:
+        return 8;
+    case ColumnType::BOOL:
+        return 1;
+    case ColumnType::OID:
+        return 20;
+    }
+    return 0;
+}
+
+/**
+ * @brief 列式结果构建器
+ * 先用 addColumn 声明所有列，再按行列写入，最后 finish 得到完整的缓冲区
+ */
+class TableBuilder {
+public:
+    explicit TableBuilder(size_t rowCount) : rowCount_(rowCount) {}
+
+    size_t addColumn(const char *name, ColumnType type) {
+        Column column;
+        column.name = name;
+        column.type = type;
+        column.width = ColumnWidth(type);
+        column.data.assign(column.width * rowCount_, 0);
+        columns_.push_back(std::move(column));
+        return columns_.size() - 1;
+    }
+
+    void setUint32(size_t column, size_t row, uint32_t value) { write(column, row, &value, sizeof(value)); }
+
+    void setInt32(size_t column, size_t row, int32_t value) { write(column, row, &value, sizeof(value)); }
+
+    void setFloat64(size_t column, size_t row, double value) { write(column, row, &value, sizeof(value)); }
+
+    void setBool(size_t column, size_t row, bool value) { columns_[column].data[row] = value ? 1 : 0; }
+
+    void setString(size_t column, size_t row, std::string_view value) {
+        uint32_t ref[2] = {appendHeap(value), static_cast<uint32_t>(value.size())};
+        write(column, row, ref, sizeof(ref));
+    }
+
+    void setOid(size_t column, size_t row, const unsigned char *raw) { write(column, row, raw, 20); }
+
+    /**
+     * @brief 由40位十六进制字符串写入对象ID，格式不正确时保持全零
+     */
+    void setOidHex(size_t column, size_t row, const std::string &hex) {
+        if (hex.size() != 40) {
+            return;
+        }
+        unsigned char raw[20];
+        for (size_t i = 0; i < 20; ++i) {
+            int high = HexValue(hex[i * 2]);
+            int low = HexValue(hex[i * 2 + 1]);
+            if (high < 0 || low < 0) {
+                return;
+            }
+            raw[i] = static_cast<unsigned char>((high << 4) | low);
+        }
+        setOid(column, row, raw);
+    }
+
+    std::unique_ptr<std::vector<uint8_t>> finish() {
+        std::vector<uint32_t> nameOffsets;
+        for (auto &column : columns_) {
+            nameOffsets.push_back(appendHeap(column.name));
+        }
+
+        size_t offset = HEADER_SIZE + COLUMN_DESC_SIZE * columns_.size();
+        std::vector<size_t> dataOffsets;
+        for (auto &column : columns_) {
+            offset = Align8(offset);
+            dataOffsets.push_back(offset);
+            offset += column.data.size();
+        }
+        size_t heapOffset = Align8(offset);
+
+        auto buffer = std::make_unique<std::vector<uint8_t>>(heapOffset + heap_.size(), 0);
+        uint8_t *out = buffer->data();
+        PutU32(out, MAGIC);
+        PutU16(out + 4, VERSION);
+        PutU16(out + 6, static_cast<uint16_t>(columns_.size()));
+        PutU32(out + 8, static_cast<uint32_t>(rowCount_));
+        PutU32(out + 12, static_cast<uint32_t>(heapOffset));
+        PutU32(out + 16, static_cast<uint32_t>(heap_.size()));
+
+        for (size_t i = 0; i < columns_.size(); ++i) {
+            uint8_t *desc = out + HEADER_SIZE + COLUMN_DESC_SIZE * i;
+            desc[0] = static_cast<uint8_t>(columns_[i].type);
+            PutU32(desc + 4, nameOffsets[i]);
+            PutU32(desc + 8, static_cast<uint32_t>(columns_[i].name.size()));
+            PutU32(desc + 12, static_cast<uint32_t>(dataOffsets[i]));
+            if (!columns_[i].data.empty()) {
+                std::memcpy(out + dataOffsets[i], columns_[i].data.data(), columns_[i].data.size());
+            }
+        }
+        if (!heap_.empty()) {
+            std::memcpy(out + heapOffset, heap_.data(), heap_.size());
+        }
+        return buffer;
+    }
+
+private:
+    struct Column {
+        std::string name;
+        ColumnType type;
+        size_t width;
+        std::vector<uint8_t> data;
+    };
+
+    size_t rowCount_;
+    std::vector<Column> columns_;
+    std::string heap_;
+
+    // 目标平台（arm64/x86_64）均为小端，按内存布局直接写入
+    void write(size_t column, size_t row, const void *value, size_t size) {
+        std::memcpy(columns_[column].data.data() + row * columns_[column].width, value, size);
+    }
+
+    uint32_t appendHeap(std::string_view value) {
+        auto offset = static_cast<uint32_t>(heap_.size());
+        heap_.append(value);
+        return offset;
+    }
+
+    static size_t Align8(size_t value) { return (value + 7) & ~static_cast<size_t>(7); }
+
+    static void PutU16(uint8_t *out, uint16_t value) { std::memcpy(out, &value, sizeof(value)); }
+
+    static void PutU32(uint8_t *out, uint32_t value) { std::memcpy(out, &value, sizeof(value)); }
+
+    static int HexValue(char c) {
+        if (c >= '0' && c <= '9') {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f') {
+            return c - 'a' + 10;
+        }
+        if (c >= 'A' && c <= 'F') {
+            return c - 'A' + 10;
+        }
+        return -1;
+    }
+};
+
+/**
+ * @brief 把缓冲区交给JS，不复制数据
+ * 缓冲区的所有权转移给ArrayBuffer，由GC回收时释放；运行时不支持外部缓冲区时退化为复制一次
+ */
+inline napi_value ToArrayBuffer(napi_env env, std::unique_ptr<std::vector<uint8_t>> buffer) {
+    napi_value arrayBuffer = nullptr;
+    auto *raw = buffer.get();
+    Metrics::Shared().add(Metrics::Counter::MarshalledBinaryBytes, raw->size());
+    napi_status status = napi_create_external_arraybuffer(
+        env, raw->data(), raw->size(),
+        [](napi_env, void *, void *hint) { delete static_cast<std::vector<uint8_t> *>(hint); }, raw, &arrayBuffer);
+    if (status == napi_ok) {
+        buffer.release();
+        return arrayBuffer;
+    }
+
+    void *data = nullptr;
+    if (napi_create_arraybuffer(env, raw->size(), &data, &arrayBuffer) != napi_ok) {
+        OH_LOG_ERROR(LOG_APP, "Columnar::ToArrayBuffer - create arraybuffer failed");
+        return nullptr;
+    }
+    std::memcpy(data, raw->data(), raw->size());
+    return arrayBuffer;
+}
+
+} // namespace Columnar
+
+#endif // HIGIT_COLUMNAR_HPP
@@ -0,0 +1,75 @@
+//
+// Created on 2026/10/18.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef HIGIT_LOG_HPP
+#define HIGIT_LOG_HPP
+
+// 日志接口：设备上直接使用 hilog；其他平台（工作站上的基准测试）提供同名宏，输出到 stderr。
+// 调用方统一写 OH_LOG_*(LOG_APP, ...)，格式串中的 {public}/{private} 修饰在非 OHOS 平台上去掉
+#if defined(__OHOS__)
+#include <hilog/log.h>
+#else
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+enum LogType { LOG_APP = 0 };
+
+namespace Log {
+
+enum Level { Debug = 3, Info = 4, Warn = 5, Error = 6, Fatal = 7 };
+
+// 低于该级别的日志不输出
+inline std::atomic<int> &MinLevel() {
+    static std::atomic<int> level{Info};
+    return level;
+}
+
+inline void SetMinLevel(Level level) { MinLevel().store(level, std::memory_order_relaxed); }
+
+// 去掉 hilog 的隐私修饰，%{public}s -> %s
+inline std::string StripPrivacy(const char *format) {
+    std::string result;
+    result.reserve(std::strlen(format));
+    for (const char *p = format; *p != '\0'; ++p) {
+        result.push_back(*p);
+        if (*p != '%' || p[1] != '{') {
+            continue;
+        }
+        const char *close = std::strchr(p + 1, '}');
+        if (close != nullptr) {
+            p = close;
+        }
+    }
+    return result;
+}
+
+inline void Print(Level level, const char *format, ...) {
+    if (level < MinLevel().load(std::memory_order_relaxed)) {
+        return;
+    }
+    static constexpr char LEVEL_NAMES[] = {'D', 'I', 'W', 'E', 'F'};
+    char line[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), StripPrivacy(format).c_str(), args);
+    va_end(args);
+    // 整行一次写出，避免多线程交错
+    fprintf(stderr, "[%s] %c %s\n", LOG_TAG, LEVEL_NAMES[level - Debug], line);
+}
+
+} // namespace Log
+
+#define OH_LOG_DEBUG(type, ...) ((void)(type), Log::Print(Log::Debug, __VA_ARGS__))
+#define OH_LOG_INFO(type, ...) ((void)(type), Log::Print(Log::Info, __VA_ARGS__))
+#define OH_LOG_WARN(type, ...) ((void)(type), Log::Print(Log::Warn, __VA_ARGS__))
+#define OH_LOG_ERROR(type, ...) ((void)(type), Log::Print(Log::Error, __VA_ARGS__))
+#define OH_LOG_FATAL(type, ...) ((void)(type), Log::Print(Log::Fatal, __VA_ARGS__))
+#endif
+
+#endif // HIGIT_LOG_HPP
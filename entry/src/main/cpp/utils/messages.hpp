@@ -6,6 +6,7 @@
 
 #ifndef TEST_MESSAGES_CPP_H
 #define TEST_MESSAGES_CPP_H
+#include "metrics.h"
 #include <cstdint>
 #include <js_native_api.h>
 #include <js_native_api_types.h>
@@ -16,6 +17,7 @@ namespace Messages {
 
 inline napi_value NewResultMessage(napi_env env, bool success, const std::string &message,
                                    const std::string &data = "") {
+    Metrics::Shared().add(Metrics::Counter::MarshalledBytes, message.size() + data.size());
     napi_value object = nullptr;
     napi_create_object(env, &object);
 
@@ -40,6 +42,19 @@ inline napi_value NewResultMessage(napi_env env, bool success, const std::string
     return object;
 }
 
+/**
+ * @brief 结果消息附带二进制数据，data 为空字符串，数据放在 buffer 字段（ArrayBuffer）
+ */
+inline napi_value NewBinaryResultMessage(napi_env env, bool success, const std::string &message, napi_value buffer) {
+    napi_value object = NewResultMessage(env, success, message);
+    if (buffer != nullptr) {
+        napi_value bufferName = nullptr;
+        napi_create_string_utf8(env, "buffer", NAPI_AUTO_LENGTH, &bufferName);
+        napi_set_property(env, object, bufferName, buffer);
+    }
+    return object;
+}
+
 
 } // namespace Messages
 
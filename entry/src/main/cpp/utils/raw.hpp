@@ -5,7 +5,7 @@
 // please include "napi/native_api.h".
 #ifndef TEST_RAW_H
 #define TEST_RAW_H
-#include <hilog/log.h>
+#include "utils/log.hpp"
 #include <memory>
 #include <rawfile/raw_file_manager.h>
 
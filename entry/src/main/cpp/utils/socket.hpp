@@ -0,0 +1,110 @@
+//
+// Created on 2026/10/18.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef HIGIT_SOCKET_HPP
+#define HIGIT_SOCKET_HPP
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// 自有传输层（TLS流、SSH子传输）共用的TCP连接工具
+namespace Socket {
+
+// 带超时的非阻塞连接，完成后恢复阻塞模式
+inline int ConnectWithTimeout(int fd, const sockaddr *addr, socklen_t addrlen, int timeoutMs) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+
+    int ret = ::connect(fd, addr, addrlen);
+    if (ret != 0 && errno == EINPROGRESS) {
+        pollfd pfd{fd, POLLOUT, 0};
+        do {
+            ret = poll(&pfd, 1, timeoutMs);
+        } while (ret < 0 && errno == EINTR);
+        if (ret == 0) {
+            errno = ETIMEDOUT;
+            ret = -1;
+        } else if (ret > 0) {
+            int error = 0;
+            socklen_t len = sizeof(error);
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len);
+            errno = error;
+            ret = error == 0 ? 0 : -1;
+        }
+    }
+
+    fcntl(fd, F_SETFL, flags);
+    return ret;
+}
+
+inline void SetReceiveTimeout(int fd, int timeoutMs) {
+    timeval tv{timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+}
+
+inline void SetSendTimeout(int fd, int timeoutMs) {
+    timeval tv{timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+// 最多等待 timeoutMs 后可以读取（有数据或对端已关闭），默认不等待
+[[nodiscard]] inline bool Readable(int fd, int timeoutMs = 0) {
+    pollfd pfd{fd, POLLIN, 0};
+    return poll(&pfd, 1, timeoutMs) > 0;
+}
+
+// 依次尝试解析出的地址，返回已连接的套接字，失败返回 -1 并写入 error
+[[nodiscard]] inline int Connect(const std::string &host, const std::string &port, int connectTimeoutMs,
+                                 int ioTimeoutMs, std::string &error) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *result = nullptr;
+    int ret = getaddrinfo(host.c_str(), port.c_str(), &hints, &result);
+    if (ret != 0) {
+        error = "failed to resolve address for " + host + ": " + gai_strerror(ret);
+        return -1;
+    }
+
+    int connected = -1;
+    int lastError = 0;
+    for (addrinfo *addr = result; addr != nullptr; addr = addr->ai_next) {
+        int fd = socket(addr->ai_family, addr->ai_socktype | SOCK_CLOEXEC, addr->ai_protocol);
+        if (fd < 0) {
+            lastError = errno;
+            continue;
+        }
+        if (ConnectWithTimeout(fd, addr->ai_addr, addr->ai_addrlen, connectTimeoutMs) == 0) {
+            connected = fd;
+            break;
+        }
+        lastError = errno;
+        ::close(fd);
+    }
+    freeaddrinfo(result);
+
+    if (connected < 0) {
+        error = "failed to connect to " + host + ":" + port + ": " + std::strerror(lastError);
+        return -1;
+    }
+
+    SetReceiveTimeout(connected, ioTimeoutMs);
+    SetSendTimeout(connected, ioTimeoutMs);
+    int one = 1;
+    setsockopt(connected, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return connected;
+}
+
+} // namespace Socket
+
+#endif // HIGIT_SOCKET_HPP
@@ -0,0 +1,82 @@
+//
+// Created on 2026/10/18.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef HIGIT_UTF16_HPP
+#define HIGIT_UTF16_HPP
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Utf16 {
+
+/**
+ * @brief 把 UTF-8 字节偏移换算为 UTF-16 码元偏移
+ * 原生代码中的高亮、匹配区间都是字节偏移，ArkTS 的字符串按 UTF-16 码元索引，序列化前须换算。
+ * 非法或被截断的字节序列按一个码元计算，与 JSON 序列化时替换为 U+FFFD 的结果一致；
+ * 落在多字节字符中间的偏移取该字符起点，超出文本的偏移取文本末尾
+ *
+ * 按递增顺序换算时只扫描一遍文本
+ */
+class OffsetMap {
+public:
+    explicit OffsetMap(std::string_view text) : text_(text) {}
+
+    uint32_t operator()(size_t byteOffset) {
+        if (byteOffset > text_.size()) {
+            byteOffset = text_.size();
+        }
+        if (byteOffset < byte_) {
+            byte_ = 0;
+            units_ = 0;
+        }
+        while (byte_ < byteOffset) {
+            size_t length = SequenceLength(byte_);
+            if (byte_ + length > byteOffset) {
+                break;
+            }
+            units_ += length == 4 ? 2 : 1;
+            byte_ += length;
+        }
+        return units_;
+    }
+
+    /**
+     * @brief 换算左闭右开的区间列表
+     */
+    std::vector<std::pair<uint32_t, uint32_t>> ranges(const std::vector<std::pair<uint32_t, uint32_t>> &ranges) {
+        std::vector<std::pair<uint32_t, uint32_t>> result;
+        result.reserve(ranges.size());
+        for (const auto &range : ranges) {
+            uint32_t first = (*this)(range.first);
+            uint32_t second = (*this)(range.second);
+            result.emplace_back(first, second);
+        }
+        return result;
+    }
+
+private:
+    // 从 pos 开始的字符占用的字节数；非法序列只算已读到的前导字节和续字节
+    size_t SequenceLength(size_t pos) const {
+        auto lead = static_cast<unsigned char>(text_[pos]);
+        size_t expected = lead >= 0xF0 && lead <= 0xF4 ? 4 : lead >= 0xE0 && lead < 0xF0 ? 3 : lead >= 0xC2 && lead < 0xE0 ? 2 : 1;
+        size_t length = 1;
+        while (length < expected && pos + length < text_.size() &&
+               (static_cast<unsigned char>(text_[pos + length]) & 0xC0) == 0x80) {
+            ++length;
+        }
+        return length;
+    }
+
+    std::string_view text_;
+    size_t byte_ = 0;    ///< 已换算到的字节偏移
+    uint32_t units_ = 0; ///< byte_ 对应的 UTF-16 码元偏移
+};
+
+} // namespace Utf16
+
+#endif // HIGIT_UTF16_HPP
@@ -6,11 +6,15 @@
 
 #ifndef TEST_UTILS_CPP_H
 #define TEST_UTILS_CPP_H
+#include "utils/log.hpp"
+#if defined(__OHOS__)
 #include <ace/xcomponent/native_interface_xcomponent.h>
+#endif
+#include <cmath>
 #include <core.h>
 #include <cstdint>
+#include <filesystem>
 #include <fstream>
-#include <hilog/log.h>
 #include <js_native_api.h>
 #include <js_native_api_types.h>
 #include <optional>
@@ -22,6 +26,7 @@ namespace Utils {
 
 constexpr const char *FILES_DIR = "/data/storage/el2/base/haps/entry/files";
 
+#if defined(__OHOS__)
 [[nodiscard]] inline bool CheckXComponentResult(int32_t result, char const *from, char const *message) noexcept {
     if (result == OH_NATIVEXCOMPONENT_RESULT_SUCCESS) {
         return true;
@@ -39,6 +44,7 @@ constexpr const char *FILES_DIR = "/data/storage/el2/base/haps/entry/files";
     OH_LOG_ERROR(LOG_APP, "%{public}s - %{public}s. Unknown error code %{public}d", from, message, result);
     return false;
 }
+#endif
 
 [[nodiscard]] inline std::string getFilesPath(const std::string &path) {
     if (!path.empty() && path.front() == '/') {
@@ -215,6 +221,34 @@ constexpr float degToRad(float degrees) { return degrees * (M_PI / 180.0f); }
     return std::nullopt;
 }
 
+// 提取对象的可选属性，属性不存在或为 undefined/null 时返回空
+[[nodiscard]] inline std::optional<napi_value> extractOptionalProperty(napi_env env, napi_value object,
+                                                                      char const *name, char const *from) noexcept {
+    napi_valuetype type;
+    if (!checkNAPIResult(napi_typeof(env, object, &type), env, from, "Can't get options type") ||
+        type != napi_object) {
+        return std::nullopt;
+    }
+
+    bool hasProperty = false;
+    if (!checkNAPIResult(napi_has_named_property(env, object, name, &hasProperty), env, from,
+                         "Can't check property") ||
+        !hasProperty) {
+        return std::nullopt;
+    }
+
+    napi_value value = nullptr;
+    if (!checkNAPIResult(napi_get_named_property(env, object, name, &value), env, from, "Can't get property")) {
+        return std::nullopt;
+    }
+
+    if (!checkNAPIResult(napi_typeof(env, value, &type), env, from, "Can't get property type") ||
+        type == napi_undefined || type == napi_null) {
+        return std::nullopt;
+    }
+    return value;
+}
+
 // 提取参数,并且检查是否符合长度
 [[nodiscard]] inline bool extractParameters(napi_env env, napi_callback_info info, const size_t expected, size_t *argc,
                                             napi_value *argv, const char *from) {
@@ -232,7 +266,8 @@ constexpr float degToRad(float degrees) { return degrees * (M_PI / 180.0f); }
     return true;
 }
 
-[[nodiscard]] inline RepoManager *FindRepoManager(napi_env env, napi_callback_info info, const char *from) {
+[[nodiscard]] inline std::shared_ptr<RepoManager> FindRepoManager(napi_env env, napi_callback_info info,
+                                                                  const char *from) {
     constexpr size_t expectedParams = 1U;
     constexpr size_t repoURLIdx = 0U;
 